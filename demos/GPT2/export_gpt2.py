@@ -3,106 +3,95 @@ import struct
 import numpy as np
 from transformers import GPT2LMHeadModel
 
-def save_tensor(f, tensor):
-    # Flatten and write float data
+# Axon checkpoint v2 (see include/axon/serialization.hpp):
+# header table with name, dtype, shape and a 64-byte aligned offset per tensor, then the data.
+MAGIC = 0x41584F32  # 'AXO2'
+VERSION = 2
+ALIGNMENT = 64
+DTYPE_F32 = 0
+
+def align_up(n):
+    return (n + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+
+def to_array(tensor):
     data = tensor.detach().cpu().numpy().astype(np.float32)
     # Force contiguous if not
-    if not data.flags['C_CONTIGUOUS']:
-        data = np.ascontiguousarray(data)
-    
-    # Write Rank
-    f.write(struct.pack('I', len(data.shape)))
-    # Write Shape
-    for s in data.shape:
-        f.write(struct.pack('I', s))
-    # Write Data
-    f.write(data.tobytes())
+    return np.ascontiguousarray(data)
+
+def save_checkpoint(path, tensors):
+    # the header size fixes every data offset
+    header_bytes = 24
+    for name, data in tensors:
+        header_bytes += 2 + len(name.encode()) + 2 + 8 * (data.ndim + 2)
+    data_start = align_up(header_bytes)
+
+    header = struct.pack('<IIIIQ', MAGIC, VERSION, len(tensors), 0, data_start)
+    offsets = []
+    offset = data_start
+    for name, data in tensors:
+        encoded = name.encode()
+        header += struct.pack('<H', len(encoded)) + encoded
+        header += struct.pack('<BB', DTYPE_F32, data.ndim)
+        header += struct.pack('<%dQ' % data.ndim, *data.shape)
+        header += struct.pack('<QQ', offset, data.nbytes)
+        offsets.append(offset)
+        offset = align_up(offset + data.nbytes)
+    assert len(header) == header_bytes
+
+    with open(path, "wb") as f:
+        f.write(header)
+        for (name, data), offset in zip(tensors, offsets):
+            f.write(b'\0' * (offset - f.tell()))
+            f.write(data.tobytes())
 
 def export():
     print("Loading GPT-2 from HuggingFace...")
     model = GPT2LMHeadModel.from_pretrained('gpt2')
     model.eval()
 
-    # Axon Binary Format Header (ASCII 'AXON')
-    MAGIC = 0x41584F4E
-    
-    with open("gpt2_axon.bin", "wb") as f:
-        f.write(struct.pack('I', MAGIC))
-        f.write(struct.pack('I', 0)) # Placeholder for count
-
-        count = 0
-        
-        # 1. WTE
-        save_tensor(f, model.transformer.wte.weight)
-        count += 1
-
-        # 2. WPE
-        save_tensor(f, model.transformer.wpe.weight)
-        count += 1
-
-        # 3. Blocks
-        for i, block in enumerate(model.transformer.h):
-            # LN 1
-            save_tensor(f, block.ln_1.weight) # Gamma
-            save_tensor(f, block.ln_1.bias)   # Beta
-            count += 2
-
-            # ATTENTION (Split HF Conv1D to Q, K, V)
-            qkv_w = block.attn.c_attn.weight # (768, 2304)
-            qkv_b = block.attn.c_attn.bias   # (2304)
-            
-            # HF Conv1D weights are (Hidden, 3*Hidden). Axon Linear is (In, Out).
-            # So no transpose needed for shapes, just split.
-            q_w, k_w, v_w = torch.split(qkv_w, 768, dim=1)
-            q_b, k_b, v_b = torch.split(qkv_b, 768, dim=0)
-
-            save_tensor(f, q_w); save_tensor(f, q_b)
-            save_tensor(f, k_w); save_tensor(f, k_b)
-            save_tensor(f, v_w); save_tensor(f, v_b)
-            count += 6
-
-            # Attn Output Proj
-            save_tensor(f, block.attn.c_proj.weight)
-            save_tensor(f, block.attn.c_proj.bias)
-            count += 2
-
-            # LN 2
-            save_tensor(f, block.ln_2.weight)
-            save_tensor(f, block.ln_2.bias)
-            count += 2
-
-            # MLP
-            save_tensor(f, block.mlp.c_fc.weight)
-            save_tensor(f, block.mlp.c_fc.bias)
-            
-            save_tensor(f, block.mlp.c_proj.weight)
-            save_tensor(f, block.mlp.c_proj.bias)
-            count += 4
-            
-            print(f"Saved Block {i}")
-
-        # 4. Final LN
-        save_tensor(f, model.transformer.ln_f.weight)
-        save_tensor(f, model.transformer.ln_f.bias)
-        count += 2
-
-        # 5. LM Head
-        # HF ties weights (wte == lm_head). 
-        # But HF Linear weight is (Out, In) = (50257, 768).
-        # Axon Linear expects (In, Out) = (768, 50257).
-        # We must Transpose!
-        save_tensor(f, model.lm_head.weight.t()) 
-        
-        # Bias (Explicit Zeros as HF GPT2 has no bias on head)
-        save_tensor(f, torch.zeros(50257))
-        count += 2
-        
-        print("Saved Final Layers")
-
-        # Go back and write count
-        f.seek(4)
-        f.write(struct.pack('I', count))
-        print(f"Done. Total Tensors: {count}")
+    # Names follow axon::nn::GPT2::named_parameters()
+    tensors = []
+    def add(name, tensor):
+        tensors.append((name, to_array(tensor)))
+
+    add("wte.weight", model.transformer.wte.weight)
+    add("wpe.weight", model.transformer.wpe.weight)
+
+    for i, block in enumerate(model.transformer.h):
+        p = f"h.{i}."
+        add(p + "ln_1.gamma", block.ln_1.weight)
+        add(p + "ln_1.beta", block.ln_1.bias)
+
+        # ATTENTION (Split HF Conv1D to Q, K, V)
+        # HF Conv1D weights are (Hidden, 3*Hidden). Axon Linear is (In, Out).
+        # So no transpose needed for shapes, just split.
+        q_w, k_w, v_w = torch.split(block.attn.c_attn.weight, 768, dim=1)
+        q_b, k_b, v_b = torch.split(block.attn.c_attn.bias, 768, dim=0)
+        add(p + "attn.w_q.weight", q_w); add(p + "attn.w_q.bias", q_b)
+        add(p + "attn.w_k.weight", k_w); add(p + "attn.w_k.bias", k_b)
+        add(p + "attn.w_v.weight", v_w); add(p + "attn.w_v.bias", v_b)
+        add(p + "attn.c_proj.weight", block.attn.c_proj.weight)
+        add(p + "attn.c_proj.bias", block.attn.c_proj.bias)
+
+        add(p + "ln_2.gamma", block.ln_2.weight)
+        add(p + "ln_2.beta", block.ln_2.bias)
+
+        add(p + "mlp.c_fc.weight", block.mlp.c_fc.weight)
+        add(p + "mlp.c_fc.bias", block.mlp.c_fc.bias)
+        add(p + "mlp.c_proj.weight", block.mlp.c_proj.weight)
+        add(p + "mlp.c_proj.bias", block.mlp.c_proj.bias)
+
+    add("ln_f.gamma", model.transformer.ln_f.weight)
+    add("ln_f.beta", model.transformer.ln_f.bias)
+
+    # HF ties weights (wte == lm_head), and HF Linear weight is (Out, In) = (50257, 768).
+    # Axon Linear expects (In, Out) = (768, 50257): transpose.
+    add("lm_head.weight", model.lm_head.weight.t())
+    # Bias (Explicit Zeros as HF GPT2 has no bias on head)
+    add("lm_head.bias", torch.zeros(50257))
+
+    save_checkpoint("gpt2_axon.bin", tensors)
+    print(f"Done. Total Tensors: {len(tensors)}")
 
 if __name__ == "__main__":
-    export()
\ No newline at end of file
+    export()
@@ -1,9 +1,15 @@
 #include "axon/tensor.hpp"
 #include "axon/nn.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/serialization.hpp"
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <unistd.h>
 
 // Helper to find the index of the maximum value (Greedy Decoding)
 int argmax(const float* ptr, size_t size) {
@@ -18,20 +24,42 @@ int argmax(const float* ptr, size_t size) {
     return max_idx;
 }
 
-int main() {
+// resident set size in MB, from /proc/self/statm
+long rss_mb() {
+    std::ifstream statm("/proc/self/statm");
+    long pages_total = 0, pages_resident = 0;
+    statm >> pages_total >> pages_resident;
+    return pages_resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+int main(int argc, char** argv) {
+    // --int8: quantize the weights after loading (about 4x less memory, faster decoding);
+    // the tokens should match the float32 run and validate.py
+    bool int8 = argc > 1 && std::string(argv[1]) == "--int8";
+
+    auto start = std::chrono::high_resolution_clock::now();
+
     // 1. Initialize Model
+    // Parameters are only shapes at this point: the mapped file provides their memory
+    axon::nn::SkipInitGuard skip_init;
     axon::nn::GPT2 model;
     std::cout << "Created GPT-2 Model.\n";
     
-    std::cout << "Loading weights from gpt2_axon.bin ...\n";
+    std::cout << "Mapping weights from gpt2_axon.bin ...\n";
     try {
-        auto params = model.parameters();
-        axon::load_model(params, "gpt2_axon.bin");
+        auto params = model.named_parameters();
+        axon::load_checkpoint_mmap(params, "gpt2_axon.bin");
     } catch (const std::exception& e) {
         std::cerr << "Error loading model: " << e.what() << "\n";
         return 1;
     }
-    std::cout << "Weights loaded successfully!\n\n";
+    if (int8) {
+        axon::nn::quantize_model(model);
+        std::cout << "Quantized weights to int8.\n";
+    }
+    double startup_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Weights loaded successfully! (" << std::fixed << std::setprecision(1) << startup_ms
+              << " ms, RSS " << rss_mb() << " MB)\n\n";
 
     // 2. Prepare Input
     // Prompt: "The capital of France is"
@@ -45,32 +73,37 @@ int main() {
     std::cout << "--------------------------------------------------\n";
 
     // 3. Generation Loop
+    // Inference only: no autograd state at all, and keys/values of earlier tokens come from the cache
+    axon::InferenceModeGuard inference;
+    axon::nn::KVCache cache = model.make_cache(1, input_ids.size() + max_new_tokens);
+
+    // the first step feeds the whole prompt, every later step only the newest token
+    std::vector<int> step_ids = input_ids;
+
     for (int i = 0; i < max_new_tokens; ++i) {
-        // Create Input Tensor (Batch=1, Seq=Current Length)
-        int seq_len = input_ids.size();
-        axon::Tensor input = axon::Tensor::zeros({1, seq_len});
+        int step_len = step_ids.size();
+        axon::Tensor input = axon::Tensor::empty({1, step_len}, axon::DType::Int32);
         
         // Fill data
-        float* ptr = input.data_ptr();
-        for(int j=0; j<seq_len; ++j) {
-            ptr[j] = static_cast<float>(input_ids[j]);
+        int32_t* ptr = input.data_as<int32_t>();
+        for(int j=0; j<step_len; ++j) {
+            ptr[j] = step_ids[j];
         }
 
-        // Forward Pass
-        // Note: For a real optimization, we would cache Key/Values (KV-Cache).
-        // Here we re-compute everything for simplicity (slower but correct).
-        axon::Tensor logits = model.forward(input); // Output: (1, Seq, 50257)
+        // Forward Pass over the new positions only
+        axon::Tensor logits = model.forward_step(input, cache, cache.length); // Output: (1, step_len, 50257)
 
         // Get logits for the LAST token only
-        // Offset = (Batch=0) + (Seq-1) * VocabSize
+        // Offset = (Batch=0) + (step_len-1) * VocabSize
         size_t vocab_size = 50257;
-        float* last_token_logits = logits.data_ptr() + (seq_len - 1) * vocab_size;
+        float* last_token_logits = logits.data_ptr() + (step_len - 1) * vocab_size;
 
         // Greedy Decode (Argmax)
         int next_token = argmax(last_token_logits, vocab_size);
         
         // Append to input for next iteration
         input_ids.push_back(next_token);
+        step_ids = {next_token};
         
         std::cout << next_token << " " << std::flush;
     }
@@ -79,6 +112,7 @@ int main() {
     std::cout << "Final Token Sequence: [ ";
     for(int id : input_ids) std::cout << id << ", ";
     std::cout << "]\n";
+    std::cout << "RSS after generation: " << rss_mb() << " MB\n";
 
     return 0;
 }
\ No newline at end of file
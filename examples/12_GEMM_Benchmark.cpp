@@ -0,0 +1,173 @@
+#include "axon/kernels.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using namespace axon;
+
+using GemmFn = void (*)(bool, bool, size_t, size_t, size_t, float,
+                        const float*, size_t, const float*, size_t, float, float*, size_t) noexcept;
+
+// Reference: straightforward triple loop in double precision
+void reference_matmul(size_t M, size_t N, size_t K, const float* a, const float* b, float* out) {
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < N; j++) {
+            double acc = 0.0;
+            for (size_t k = 0; k < K; k++) {
+                acc += (double)a[i * K + k] * b[k * N + j];
+            }
+            out[i * N + j] = (float)acc;
+        }
+    }
+}
+
+void fill_random(std::vector<float>& v) {
+    for (auto& x : v) {
+        x = (float)rand() / RAND_MAX - 0.5f;
+    }
+}
+
+bool check_correctness(GemmFn gemm, size_t M, size_t N, size_t K) {
+    std::vector<float> a(M * K), b(K * N), out(M * N), ref(M * N);
+    fill_random(a);
+    fill_random(b);
+
+    // garbage in the output: the kernel must overwrite, not accumulate
+    for (auto& x : out) x = 1e30f;
+
+    gemm(false, false, M, N, K, 1.0f, a.data(), K, b.data(), N, 0.0f, out.data(), N);
+    reference_matmul(M, N, K, a.data(), b.data(), ref.data());
+
+    float max_err = 0.0f;
+    for (size_t i = 0; i < M * N; i++) {
+        max_err = std::max(max_err, std::abs(out[i] - ref[i]));
+    }
+
+    bool ok = max_err < 1e-3f * std::sqrt((float)K);
+    std::cout << "  (" << M << ", " << N << ", " << K << ") max_err=" << max_err
+              << (ok ? "  OK\n" : "  FAIL\n");
+    return ok;
+}
+
+// sgemm semantics: transposed storage, padded leading dims, alpha/beta accumulation
+bool check_sgemm(GemmFn gemm, bool ta, bool tb, size_t M, size_t N, size_t K, float alpha, float beta) {
+    size_t pad = 3;
+    size_t lda = (ta ? M : K) + pad, ldb = (tb ? K : N) + pad, ldc = N + pad;
+    std::vector<float> a((ta ? K : M) * lda), b((tb ? N : K) * ldb), c(M * ldc), c0;
+    fill_random(a);
+    fill_random(b);
+    fill_random(c);
+    c0 = c;
+
+    gemm(ta, tb, M, N, K, alpha, a.data(), lda, b.data(), ldb, beta, c.data(), ldc);
+
+    float max_err = 0.0f;
+    for (size_t i = 0; i < M; i++) {
+        for (size_t j = 0; j < N; j++) {
+            double acc = 0.0;
+            for (size_t k = 0; k < K; k++) {
+                double av = ta ? a[k * lda + i] : a[i * lda + k];
+                double bv = tb ? b[j * ldb + k] : b[k * ldb + j];
+                acc += av * bv;
+            }
+            double ref = alpha * acc + (beta != 0.0f ? beta * c0[i * ldc + j] : 0.0);
+            max_err = std::max(max_err, (float)std::abs(c[i * ldc + j] - ref));
+        }
+        // padding columns must be untouched
+        for (size_t j = N; j < ldc; j++) {
+            if (c[i * ldc + j] != c0[i * ldc + j]) max_err = 1e30f;
+        }
+    }
+
+    bool ok = max_err < 1e-3f * std::sqrt((float)K + 1);
+    std::cout << "  trans=(" << ta << "," << tb << ") (" << M << ", " << N << ", " << K << ") alpha=" << alpha
+              << " beta=" << beta << " max_err=" << max_err << (ok ? "  OK\n" : "  FAIL\n");
+    return ok;
+}
+
+double bench(GemmFn gemm, size_t M, size_t N, size_t K) {
+    std::vector<float> a(M * K), b(K * N), out(M * N);
+    fill_random(a);
+    fill_random(b);
+
+    // warmup
+    gemm(false, false, M, N, K, 1.0f, a.data(), K, b.data(), N, 0.0f, out.data(), N);
+
+    double flops = 2.0 * M * N * K;
+    int iters = std::max(1, (int)(2e10 / flops));
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; i++) {
+        gemm(false, false, M, N, K, 1.0f, a.data(), K, b.data(), N, 0.0f, out.data(), N);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double sec = std::chrono::duration<double>(end - start).count() / iters;
+    return flops / sec * 1e-9;
+}
+
+int main() {
+    // gemm_f32 is cblas_sgemm when built with -DAXON_BLAS=..., otherwise the built-in kernel again
+    std::string backend = kernels::cpu::blas_backend();
+    bool has_blas = backend != "builtin";
+
+    std::vector<std::pair<std::string, GemmFn>> impls = {{"builtin", kernels::cpu::gemm_f32_builtin}};
+    if (has_blas) {
+        impls.push_back({backend, kernels::cpu::gemm_f32});
+    }
+
+    bool ok = true;
+    for (const auto& [name, gemm] : impls) {
+        std::cout << "[TEST] GEMM correctness, " << name << " (edge tiles, K blocking, small M)...\n";
+        ok &= check_correctness(gemm, 1, 1, 1);
+        ok &= check_correctness(gemm, 3, 50, 17);
+        ok &= check_correctness(gemm, 7, 33, 300);
+        ok &= check_correctness(gemm, 6, 16, 256);
+        ok &= check_correctness(gemm, 170, 70, 513);
+        ok &= check_correctness(gemm, 64, 4100, 40);
+        ok &= check_sgemm(gemm, true, false, 3, 40, 9, 1.0f, 0.0f);
+        ok &= check_sgemm(gemm, false, true, 37, 29, 300, 0.5f, 1.0f);
+        ok &= check_sgemm(gemm, true, true, 50, 21, 270, -2.0f, 0.25f);
+        ok &= check_sgemm(gemm, false, false, 13, 18, 0, 1.0f, 3.0f);
+    }
+    if (!ok) {
+        std::cerr << "GEMM correctness check failed.\n";
+        return 1;
+    }
+
+    std::cout << "\n[BENCH] GEMM throughput in GFLOP/s (single call, row-major)\n";
+    std::cout << std::setw(8) << "M" << std::setw(8) << "N" << std::setw(8) << "K";
+    for (const auto& impl : impls) {
+        std::cout << std::setw(12) << impl.first;
+    }
+    std::cout << "\n";
+
+    struct Shape { size_t M, N, K; };
+    std::vector<Shape> shapes = {
+        {256, 256, 256},
+        {512, 512, 512},
+        {1024, 1024, 1024},
+        // GPT-2 small, T = 128 tokens
+        {128, 768, 768},    // q/k/v/c_proj
+        {128, 3072, 768},   // mlp c_fc
+        {128, 768, 3072},   // mlp c_proj
+        {128, 50257, 768},  // lm_head
+        // decoding, one token
+        {1, 3072, 768},
+        {1, 50257, 768},
+    };
+
+    for (const auto& s : shapes) {
+        std::cout << std::setw(8) << s.M << std::setw(8) << s.N << std::setw(8) << s.K;
+        for (const auto& impl : impls) {
+            std::cout << std::setw(12) << std::fixed << std::setprecision(1) << bench(impl.second, s.M, s.N, s.K);
+        }
+        std::cout << "\n";
+    }
+
+    return 0;
+}
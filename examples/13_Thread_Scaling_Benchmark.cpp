@@ -0,0 +1,100 @@
+#include "axon/kernels.hpp"
+#include "axon/thread_pool.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <cstdlib>
+
+using namespace axon;
+
+// Runs `fn` enough times to take ~0.2s and returns milliseconds per call
+double time_ms(const std::function<void()>& fn) {
+    fn(); // warmup
+
+    int iters = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    double elapsed = 0.0;
+    while (elapsed < 0.2) {
+        fn();
+        iters++;
+        elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    return elapsed * 1e3 / iters;
+}
+
+int main() {
+    std::vector<size_t> counts = {1, 2, 4, 8};
+    size_t hw = std::thread::hardware_concurrency();
+    if (hw > 8) counts.push_back(hw);
+
+    // parallel_for sanity: every index visited exactly once
+    {
+        set_num_threads(4);
+        std::vector<int> hits(100003, 0);
+        parallel_for(0, hits.size(), 64, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; i++) hits[i]++;
+        });
+        for (int h : hits) {
+            if (h != 1) {
+                std::cerr << "parallel_for visited an index " << h << " times\n";
+                return 1;
+            }
+        }
+    }
+
+    const size_t N = 1 << 24;
+    std::vector<float> a(N), b(N), out(N);
+    for (size_t i = 0; i < N; i++) {
+        a[i] = (float)rand() / RAND_MAX;
+        b[i] = (float)rand() / RAND_MAX + 0.5f;
+    }
+
+    // GPT-2 shaped row kernels: (T=1024 * 12 heads) x 1024 scores, (1024) x 768 activations
+    const size_t S_ROWS = 12 * 1024, S_COLS = 1024;
+    const size_t L_ROWS = 1024, L_COLS = 768;
+    std::vector<float> gamma(L_COLS, 1.0f), beta(L_COLS, 0.0f);
+
+    const size_t M = 512, K = 768, NN = 3072;
+
+    struct Case {
+        std::string name;
+        std::function<void()> fn;
+    };
+
+    std::vector<Case> cases = {
+        {"add_f32 (16M)", [&] { kernels::cpu::add_f32(N, a.data(), b.data(), out.data()); }},
+        {"gelu_f32 (16M)", [&] { kernels::cpu::gelu_f32(N, a.data(), out.data()); }},
+        {"softmax_f32 (12K x 1024)", [&] { kernels::cpu::softmax_f32(S_ROWS, S_COLS, a.data(), out.data()); }},
+        {"log_softmax_f32 (12K x 1024)", [&] { kernels::cpu::log_softmax_f32(S_ROWS, S_COLS, a.data(), out.data()); }},
+        {"layernorm_f32 (1024 x 768)", [&] {
+            kernels::cpu::layernorm_forward_f32(L_ROWS, L_COLS, a.data(), gamma.data(), beta.data(), out.data(), 1e-5f);
+        }},
+        {"matmul_f32 (512x768 @ 768x3072)", [&] { kernels::cpu::matmul_f32(M, NN, K, a.data(), b.data(), out.data()); }},
+    };
+
+    std::cout << "[BENCH] Intra-op scaling (hardware threads: " << hw << ")\n";
+    std::cout << std::left << std::setw(34) << "kernel";
+    for (size_t t : counts) {
+        std::cout << std::right << std::setw(10) << (std::to_string(t) + "T");
+    }
+    std::cout << "\n";
+
+    for (const auto& c : cases) {
+        std::vector<double> ms;
+        for (size_t t : counts) {
+            set_num_threads(t);
+            ms.push_back(time_ms(c.fn));
+        }
+
+        std::cout << std::left << std::setw(34) << c.name;
+        for (double m : ms) {
+            std::cout << std::right << std::setw(9) << std::fixed << std::setprecision(2) << ms[0] / m << "x";
+        }
+        std::cout << "   (" << std::setprecision(3) << ms[0] << " ms @1T)\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/grad_mode.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using namespace axon;
+
+void fill_random(Tensor& t, float scale) {
+    for (size_t i = 0; i < t.numel(); i++) {
+        t.data_ptr()[i] = ((float)rand() / RAND_MAX - 0.5f) * scale;
+    }
+}
+
+float max_abs_diff(const float* a, const float* b, size_t n) {
+    float m = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        m = std::max(m, std::abs(a[i] - b[i]));
+    }
+    return m;
+}
+
+double ms_since(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void test_block_cache() {
+    std::cout << "[TEST] Block::forward_step matches the full forward...\n";
+
+    int B = 2, T = 9, C = 32, H = 4, L = 2;
+    std::vector<nn::Block> blocks;
+    for (int i = 0; i < L; i++) blocks.emplace_back(C, H);
+
+    Tensor x = Tensor::zeros({B, T, C});
+    fill_random(x, 2.0f);
+
+    Tensor full = x;
+    for (auto& blk : blocks) full = blk.forward(full);
+
+    // prefill 4 positions, then one position per step
+    nn::KVCache cache(L, B, H, T, C / H);
+    int pos = 0;
+    float err = 0.0f;
+    while (pos < T) {
+        int n = pos == 0 ? 4 : 1;
+
+        Tensor chunk = Tensor::zeros({B, n, C});
+        for (int b = 0; b < B; b++) {
+            for (int t = 0; t < n; t++) {
+                for (int c = 0; c < C; c++) chunk.at({b, t, c}) = x.at({b, pos + t, c});
+            }
+        }
+
+        Tensor y = chunk;
+        for (int l = 0; l < L; l++) y = blocks[l].forward_step(y, cache.k[l], cache.v[l], pos);
+
+        for (int b = 0; b < B; b++) {
+            for (int t = 0; t < n; t++) {
+                for (int c = 0; c < C; c++) {
+                    err = std::max(err, std::abs(y.at({b, t, c}) - full.at({b, pos + t, c})));
+                }
+            }
+        }
+        pos += n;
+    }
+
+    if (err > 1e-4f) {
+        std::cerr << "Cached attention mismatch, max err " << err << "\n";
+        exit(1);
+    }
+    std::cout << "  -> max err " << err << "\n";
+}
+
+int main() {
+    InferenceModeGuard inference;
+
+    test_block_cache();
+
+    std::cout << "[TEST] GPT2::forward_step logits vs full recompute...\n";
+    nn::GPT2 model;
+    fill_random(model.wte.weight, 0.2f);
+    fill_random(model.wpe.weight, 0.2f);
+
+    std::vector<int> ids = {464, 3225, 286, 4881, 318};
+    const size_t V = 50257;
+    int steps = 4;
+
+    nn::KVCache cache = model.make_cache(1, 64);
+    int pos = 0;
+    std::vector<int> step_ids = ids;
+    for (int s = 0; s <= steps; s++) {
+        int n = step_ids.size();
+        Tensor inp = Tensor::zeros({1, n});
+        for (int j = 0; j < n; j++) inp.data_ptr()[j] = (float)step_ids[j];
+
+        Tensor cached = model.forward_step(inp, cache, pos);
+        pos += n;
+
+        Tensor full_inp = Tensor::zeros({1, (int)ids.size()});
+        for (size_t j = 0; j < ids.size(); j++) full_inp.data_ptr()[j] = (float)ids[j];
+        Tensor full = model.forward(full_inp);
+
+        float err = max_abs_diff(cached.data_ptr() + (n - 1) * V, full.data_ptr() + (ids.size() - 1) * V, V);
+        std::cout << "  len " << ids.size() << ": max |logit diff| = " << err << "\n";
+        if (err > 1e-3f) {
+            std::cerr << "KV cache logits diverge from the full forward pass\n";
+            return 1;
+        }
+
+        // feed back a deterministic "next token"
+        int next = (ids.back() * 31 + 7) % (int)V;
+        ids.push_back(next);
+        step_ids = {next};
+    }
+
+    std::cout << "[TEST] a batch the cache wasn't made for...\n";
+    bool threw = false;
+    try {
+        nn::KVCache small = model.make_cache(1, 16);
+        model.forward_step(Tensor::zeros({2, 3}), small, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    // write_cache is public: it checks on its own too
+    try {
+        nn::MultiHeadAttention& attn = model.h[0].attn;
+        attn.write_cache(Tensor::zeros({3, 1, 768}), Tensor::zeros({1, attn.n_head, 16, attn.head_dim}), 0);
+        threw = false;
+    } catch (const std::invalid_argument&) {}
+    if (!threw) {
+        std::cerr << "a batch larger than the cache's must throw\n";
+        return 1;
+    }
+    std::cout << "  -> Passed.\n";
+
+    std::cout << "\n[BENCH] Per-token latency: full recompute vs KV cache\n";
+    std::cout << std::setw(8) << "pos" << std::setw(16) << "full (ms)" << std::setw(16) << "cached (ms)" << "\n";
+
+    nn::KVCache big = model.make_cache(1, 1024);
+    Tensor one = Tensor::zeros({1, 1});
+    one.data_ptr()[0] = 318.0f;
+
+    for (int p : {16, 64, 256, 512}) {
+        double full_ms = -1.0;
+        if (p <= 256) {
+            Tensor seq = Tensor::zeros({1, p + 1});
+            for (int j = 0; j <= p; j++) seq.data_ptr()[j] = (float)((j * 97) % V);
+            auto start = std::chrono::high_resolution_clock::now();
+            model.forward(seq);
+            full_ms = ms_since(start);
+        }
+
+        // latency only depends on how many positions are cached, not on their contents
+        big.length = p;
+        int reps = 5;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < reps; r++) {
+            model.forward_step(one, big, p);
+        }
+        double step_ms = ms_since(start) / reps;
+
+        std::cout << std::setw(8) << p << std::setw(16) << std::fixed << std::setprecision(1);
+        if (full_ms < 0) std::cout << "-"; else std::cout << full_ms;
+        std::cout << std::setw(16) << step_ms << "\n";
+    }
+
+    return 0;
+}
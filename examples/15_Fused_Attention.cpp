@@ -0,0 +1,146 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/grad_mode.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sys/resource.h>
+
+using namespace axon;
+
+Tensor random_tensor(std::vector<int> shape) {
+    Tensor t = Tensor::zeros(shape);
+    for (size_t i = 0; i < t.numel(); i++) {
+        t.data_ptr()[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    return t;
+}
+
+// The unfused path MultiHeadAttention used to take: scores, scale, mask, softmax, @ v
+Tensor reference_attention(Tensor q, Tensor k, Tensor v, bool causal) {
+    int Tq = q.get_shape()[2];
+    int Tk = k.get_shape()[2];
+    int D = q.get_shape()[3];
+
+    Tensor scores = axon::matmul(q, axon::transpose(k, 2, 3));
+    Tensor scale = Tensor::zeros({1});
+    scale.data_ptr()[0] = 1.0f / std::sqrt((float)D);
+    scores = axon::mul(scores, scale);
+
+    if (causal) {
+        Tensor mask = Tensor::zeros({Tq, Tk});
+        for (int i = 0; i < Tq; i++) {
+            for (int j = 0; j < Tk; j++) {
+                if (j > i + Tk - Tq) mask.data_ptr()[i * Tk + j] = -1e9f;
+            }
+        }
+        scores = axon::add(scores, mask);
+    }
+
+    return axon::matmul(axon::softmax(scores), v);
+}
+
+float max_diff(Tensor a, Tensor b) {
+    Tensor ac = a.contiguous();
+    Tensor bc = b.contiguous();
+    float m = 0.0f;
+    for (size_t i = 0; i < ac.numel(); i++) {
+        m = std::max(m, std::abs(ac.data_ptr()[i] - bc.data_ptr()[i]));
+    }
+    return m;
+}
+
+bool check(int B, int H, int Tq, int Tk, int D, bool causal) {
+    // q comes in as a transposed (B, T, H, D) projection, like in MultiHeadAttention
+    Tensor q_src = random_tensor({B, Tq, H, D});
+    Tensor k = random_tensor({B, H, Tk, D});
+    Tensor v = random_tensor({B, H, Tk, D});
+    Tensor w = random_tensor({B, H, Tq, D}); // loss = sum(out * w)
+
+    q_src.set_requires_grad(true);
+    k.set_requires_grad(true);
+    v.set_requires_grad(true);
+
+    Tensor q = axon::transpose(q_src, 1, 2);
+
+    Tensor out = axon::scaled_dot_product_attention(q, k, v, causal);
+    axon::sum(axon::mul(out, w)).backward();
+    Tensor gq = *q_src.get_grad(), gk = *k.get_grad(), gv = *v.get_grad();
+
+    q_src.zero_grad(); q.zero_grad(); k.zero_grad(); v.zero_grad();
+
+    Tensor ref = reference_attention(q, k, v, causal);
+    axon::sum(axon::mul(ref, w)).backward();
+
+    float e_out = max_diff(out, ref);
+    float e_q = max_diff(gq, *q_src.get_grad());
+    float e_k = max_diff(gk, *k.get_grad());
+    float e_v = max_diff(gv, *v.get_grad());
+
+    bool ok = std::max({e_out, e_q, e_k, e_v}) < 1e-4f;
+    std::cout << "  B=" << B << " H=" << H << " Tq=" << Tq << " Tk=" << Tk << " D=" << D
+              << (causal ? " causal" : "       ") << "  out " << e_out << "  dq " << e_q
+              << "  dk " << e_k << "  dv " << e_v << (ok ? "  OK\n" : "  FAIL\n");
+    return ok;
+}
+
+double time_ms(const std::function<void()>& fn, int reps) {
+    fn(); // warmup
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / reps;
+}
+
+long peak_rss_mb() {
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss / 1024;
+}
+
+int main() {
+    std::cout << "[TEST] scaled_dot_product_attention vs unfused reference (forward + grads)...\n";
+    bool ok = true;
+    ok &= check(2, 3, 7, 7, 16, true);
+    ok &= check(1, 2, 70, 70, 32, false);
+    ok &= check(1, 2, 150, 150, 64, true);
+    ok &= check(2, 2, 3, 200, 64, true); // decode-style: few new queries, long key cache
+    ok &= check(1, 1, 1, 1, 8, true);
+    if (!ok) {
+        std::cerr << "Fused attention mismatch.\n";
+        return 1;
+    }
+
+    std::cout << "\n[BENCH] GPT-2 small attention (B=1, H=12, D=64), causal, forward only\n";
+    std::cout << std::setw(8) << "T" << std::setw(14) << "unfused ms" << std::setw(14) << "fused ms"
+              << std::setw(20) << "score bytes (MB)" << "\n";
+
+    NoGradGuard no_grad;
+    std::vector<int> lengths = {128, 512, 1024};
+    std::vector<double> fused_ms;
+
+    // fused first, so the peak RSS right after it is not inflated by the unfused run
+    for (int T : lengths) {
+        Tensor q = random_tensor({1, 12, T, 64}), k = random_tensor({1, 12, T, 64}), v = random_tensor({1, 12, T, 64});
+        fused_ms.push_back(time_ms([&] { axon::scaled_dot_product_attention(q, k, v, true); }, 3));
+    }
+    long rss_fused = peak_rss_mb();
+
+    for (size_t i = 0; i < lengths.size(); i++) {
+        int T = lengths[i];
+        Tensor q = random_tensor({1, 12, T, 64}), k = random_tensor({1, 12, T, 64}), v = random_tensor({1, 12, T, 64});
+        double ref_ms = time_ms([&] { reference_attention(q, k, v, true); }, 3);
+        double score_mb = 12.0 * T * T * sizeof(float) / (1024.0 * 1024.0);
+
+        std::cout << std::setw(8) << T << std::setw(14) << std::fixed << std::setprecision(2) << ref_ms
+                  << std::setw(14) << fused_ms[i] << std::setw(20) << std::setprecision(1) << score_mb << "\n";
+    }
+    long rss_ref = peak_rss_mb();
+
+    std::cout << "peak RSS after fused runs: " << rss_fused << " MB, after unfused runs: " << rss_ref << " MB\n";
+    return 0;
+}
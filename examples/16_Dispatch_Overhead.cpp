@@ -0,0 +1,121 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/grad_mode.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <cassert>
+#include <stdexcept>
+
+using namespace axon;
+
+// Tiny tensors, so the time per call is almost all framework overhead:
+// shape checks, Tensor/Storage/TensorState allocation, GradFn construction
+double ns_per_call(const std::function<void()>& fn) {
+    for (int i = 0; i < 1000; i++) fn(); // warmup
+
+    int iters = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    double elapsed = 0.0;
+    while (elapsed < 0.2) {
+        for (int i = 0; i < 1000; i++) fn();
+        iters += 1000;
+        elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    return elapsed * 1e9 / iters;
+}
+
+int main() {
+    std::cout << "[TEST] InferenceMode semantics...\n";
+    {
+        Tensor w = Tensor::ones({4, 4});
+        w.set_requires_grad(true);
+
+        InferenceModeGuard guard;
+        Tensor x = Tensor::ones({2, 4});
+        assert(!x.requires_grad());
+        assert(x.get_grad() == nullptr && x.get_grad_fn() == nullptr && x.is_leaf());
+
+        Tensor y = axon::matmul(x, w);
+        assert(!y.requires_grad() && y.get_grad_fn() == nullptr);
+        assert(y.at({1, 3}) == 4.0f);
+
+        // an inference tensor can't be made to need a gradient, through any copy
+        Tensor z = Tensor::zeros({3});
+        Tensor z_copy = z;
+        bool threw = false;
+        try { z_copy.set_requires_grad(true); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw && !z.requires_grad());
+        threw = false;
+        try { z.set_grad(std::make_shared<Tensor>(Tensor::ones({3}))); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw && z_copy.get_grad() == nullptr);
+        z.set_requires_grad(false);
+        z.set_grad(nullptr);
+    }
+    {
+        // ...while copies of a normal tensor share its state
+        Tensor z = Tensor::zeros({3});
+        Tensor z_copy = z;
+        z.set_requires_grad(true);
+        assert(z_copy.requires_grad());
+        z_copy.set_grad(std::make_shared<Tensor>(Tensor::ones({3})));
+        assert(z.get_grad() == z_copy.get_grad());
+    }
+    {
+        Tensor a = Tensor::ones({3});
+        a.set_requires_grad(true);
+        Tensor b = axon::mul(a, a);
+        assert(b.requires_grad() && b.get_grad_fn() != nullptr); // guard restored autograd
+    }
+    std::cout << "  -> Passed.\n";
+
+    Tensor a = Tensor::ones({1, 64});
+    Tensor b = Tensor::ones({1, 64});
+    Tensor s = Tensor::ones({1});
+    Tensor w = Tensor::ones({64, 64});
+    Tensor gamma = Tensor::ones({64});
+    Tensor beta = Tensor::zeros({64});
+    for (Tensor* t : {&a, &b, &s, &w, &gamma, &beta}) t -> set_requires_grad(true);
+
+    struct Case {
+        std::string name;
+        std::function<void()> fn;
+    };
+
+    std::vector<Case> cases = {
+        {"add (1,64) + (1,64)", [&] { axon::add(a, b); }},
+        {"mul (1,64) * (1)", [&] { axon::mul(a, s); }},
+        {"gelu (1,64)", [&] { axon::gelu(a); }},
+        {"view + transpose", [&] { axon::transpose(axon::view(a, {8, 8}), 0, 1); }},
+        {"matmul (1,64) @ (64,64)", [&] { axon::matmul(a, w); }},
+        {"layer_norm (1,64)", [&] { axon::layer_norm(a, gamma, beta); }},
+    };
+
+    std::cout << "\n[BENCH] Per-op dispatch overhead (ns/call)\n";
+    std::cout << std::left << std::setw(28) << "op" << std::right
+              << std::setw(12) << "autograd" << std::setw(12) << "no_grad" << std::setw(12) << "inference" << "\n";
+
+    for (const auto& c : cases) {
+        double t_grad = ns_per_call(c.fn);
+
+        double t_nograd;
+        {
+            NoGradGuard g;
+            t_nograd = ns_per_call(c.fn);
+        }
+
+        double t_inf;
+        {
+            InferenceModeGuard g;
+            t_inf = ns_per_call(c.fn);
+        }
+
+        std::cout << std::left << std::setw(28) << c.name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(12) << t_grad << std::setw(12) << t_nograd << std::setw(12) << t_inf << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/allocator.hpp"
+#include "axon/grad_mode.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <cassert>
+
+using namespace axon;
+
+double us_per_iter(const std::function<void()>& fn, int iters) {
+    fn(); // warmup
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iters; i++) fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / iters;
+}
+
+void test_reuse() {
+    std::cout << "[TEST] Freed blocks are reused and accounted for...\n";
+    CachingCPUAllocator& alloc = CachingCPUAllocator::instance();
+    alloc.empty_cache();
+
+    AllocatorStats before = alloc.stats();
+    void* p = alloc.allocate(1000);
+    assert(reinterpret_cast<uintptr_t>(p) % CachingCPUAllocator::ALIGNMENT == 0);
+    assert(alloc.stats().allocated_bytes == before.allocated_bytes + 1024); // rounded to 1KB
+
+    alloc.deallocate(p);
+    assert(alloc.stats().cached_bytes == 1024);
+
+    // same size class comes back as the same block
+    void* q = alloc.allocate(700);
+    assert(q == p);
+    alloc.deallocate(q);
+
+    // large blocks: 5MB rounds to a quarter step of 4MB
+    void* big = alloc.allocate(5u << 20);
+    alloc.deallocate(big);
+    void* big2 = alloc.allocate((5u << 20) - 100);
+    assert(big2 == big);
+    alloc.deallocate(big2);
+
+    AllocatorStats after = alloc.stats();
+    assert(after.allocated_bytes == before.allocated_bytes);
+    assert(after.cache_hits >= before.cache_hits + 2);
+
+    alloc.empty_cache();
+    assert(alloc.stats().cached_bytes == 0);
+    std::cout << "  -> Passed.\n";
+}
+
+void test_cache_limit() {
+    std::cout << "[TEST] Cache limit sends frees back to the system and trims the cache...\n";
+    CachingCPUAllocator& alloc = CachingCPUAllocator::instance();
+    alloc.empty_cache();
+    alloc.set_cache_limit(8u << 20);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 4; i++) blocks.push_back(alloc.allocate(4u << 20));
+    for (void* p : blocks) alloc.deallocate(p);
+    assert(alloc.stats().cached_bytes == 8u << 20);
+
+    // small blocks in the thread cache count too
+    alloc.set_cache_limit(0);
+    assert(alloc.stats().cached_bytes == 0);
+    void* small = alloc.allocate(256);
+    alloc.deallocate(small);
+    assert(alloc.stats().cached_bytes == 0);
+
+    // lowering the limit trims what is already cached
+    alloc.set_cache_limit(size_t(1024) << 20);
+    blocks.clear();
+    for (int i = 0; i < 4; i++) blocks.push_back(alloc.allocate(4u << 20));
+    for (int i = 0; i < 4; i++) blocks.push_back(alloc.allocate(4096));
+    for (void* p : blocks) alloc.deallocate(p);
+    assert(alloc.stats().cached_bytes == (16u << 20) + 4 * 4096);
+    alloc.set_cache_limit(4u << 20);
+    assert(alloc.stats().cached_bytes <= 4u << 20);
+    alloc.set_cache_limit(0);
+    assert(alloc.stats().cached_bytes == 0);
+
+    alloc.set_cache_limit(size_t(1024) << 20);
+    alloc.empty_cache();
+    std::cout << "  -> Passed.\n";
+}
+
+void test_threads() {
+    std::cout << "[TEST] Blocks freed on another thread...\n";
+    CachingCPUAllocator& alloc = CachingCPUAllocator::instance();
+    size_t base = alloc.stats().allocated_bytes;
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 32; i++) blocks.push_back(alloc.allocate(256));
+
+    std::thread t([&] {
+        for (void* p : blocks) alloc.deallocate(p);
+        for (int i = 0; i < 16; i++) alloc.deallocate(alloc.allocate(4096));
+    });
+    t.join();
+
+    assert(alloc.stats().allocated_bytes == base);
+    alloc.empty_cache();
+    std::cout << "  -> Passed.\n";
+}
+
+int main() {
+    test_reuse();
+    test_cache_limit();
+    test_threads();
+
+    std::cout << "\n[TEST] Tensors through set_allocator...\n";
+    {
+        CachingCPUAllocator& alloc = CachingCPUAllocator::instance();
+        size_t base = alloc.stats().allocated_bytes;
+
+        CPUAllocator system_alloc;
+        set_allocator(DeviceType::CPU, &system_alloc);
+        Tensor a = Tensor::ones({3, 3});
+        assert(alloc.stats().allocated_bytes == base);
+
+        set_allocator(DeviceType::CPU, nullptr);
+        Tensor b = Tensor::ones({3, 3});
+        assert(alloc.stats().allocated_bytes == base + 64);
+        assert(axon::add(a, b).at({2, 2}) == 2.0f);
+    }
+    std::cout << "  -> Passed.\n";
+
+    std::cout << "\n[BENCH] system aligned_alloc vs caching allocator (us/iter)\n";
+    std::cout << std::left << std::setw(36) << "workload" << std::right
+              << std::setw(12) << "system" << std::setw(12) << "caching" << "\n";
+
+    InferenceModeGuard inference;
+    Tensor x = Tensor::ones({64, 768});
+    Tensor w = Tensor::ones({768, 768});
+    Tensor bias = Tensor::zeros({768});
+
+    struct Case {
+        std::string name;
+        std::function<void()> fn;
+        int iters;
+    };
+
+    std::vector<Case> cases = {
+        {"zeros (1024, 1024) x4", [] {
+            for (int i = 0; i < 4; i++) Tensor::zeros({1024, 1024});
+        }, 200},
+        {"zeros (64) x64", [] {
+            for (int i = 0; i < 64; i++) Tensor::zeros({64});
+        }, 2000},
+        {"linear + gelu + add (64, 768)", [&] {
+            Tensor h = axon::add(axon::matmul(x, w), bias);
+            axon::add(axon::gelu(h), x);
+        }, 50},
+    };
+
+    CPUAllocator system_alloc;
+    for (const auto& c : cases) {
+        set_allocator(DeviceType::CPU, &system_alloc);
+        double t_sys = us_per_iter(c.fn, c.iters);
+        set_allocator(DeviceType::CPU, nullptr);
+        double t_cache = us_per_iter(c.fn, c.iters);
+
+        std::cout << std::left << std::setw(36) << c.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << t_sys << std::setw(12) << t_cache << "\n";
+    }
+
+    AllocatorStats s = CachingCPUAllocator::instance().stats();
+    std::cout << "\nsystem allocs: " << s.system_allocs << ", cache hits: " << s.cache_hits
+              << ", peak: " << s.peak_allocated_bytes / 1024 << " KB, cached: " << s.cached_bytes / 1024 << " KB\n";
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/allocator.hpp"
+#include "axon/grad_mode.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+using namespace axon;
+
+// Hands out the same blocks as the default allocator but memsets each one, i.e. what
+// every op output cost when ops built their outputs with Tensor::zeros
+class ZeroFillAllocator : public Allocator {
+public:
+    size_t bytes_zeroed = 0;
+
+    void* allocate(size_t nbytes) override {
+        void* ptr = CachingCPUAllocator::instance().allocate(nbytes);
+        std::memset(ptr, 0, nbytes);
+        bytes_zeroed += nbytes;
+        return ptr;
+    }
+
+    void deallocate(void* ptr) override {
+        CachingCPUAllocator::instance().deallocate(ptr);
+    }
+
+    void set_zero(void* ptr, size_t nbytes) override {
+        std::memset(ptr, 0, nbytes);
+    }
+};
+
+// best of `rounds` for each allocator, alternating them so drift on the host hits both equally
+void time_both(const std::function<void()>& fn, int rounds, ZeroFillAllocator& zero_fill, double& zeroed_ms, double& empty_ms) {
+    auto run = [&] {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+
+    fn(); // warmup, so both start from a cache holding the output's block
+    zeroed_ms = empty_ms = 1e30;
+    for (int r = 0; r < rounds; r++) {
+        set_allocator(DeviceType::CPU, &zero_fill);
+        zeroed_ms = std::min(zeroed_ms, run());
+        set_allocator(DeviceType::CPU, nullptr);
+        empty_ms = std::min(empty_ms, run());
+    }
+}
+
+// Memory-bound ops with large outputs: reading the input and writing the output is all they
+// do, so zero-filling the output first is a third pass over memory.
+void bench_ops() {
+    std::cout << "\n[BENCH] one op, zero-filled vs uninitialized output (best of 20)\n";
+    std::cout << std::setw(28) << "op" << std::setw(12) << "output MB" << std::setw(14) << "zeroed ms"
+              << std::setw(14) << "empty ms" << std::setw(10) << "saved" << "\n";
+
+    std::vector<int> shape = {8, 1024, 768};
+    Tensor x = Tensor::empty(shape), y = Tensor::empty(shape);
+    for (size_t i = 0; i < x.numel(); i++) {
+        x.data_ptr()[i] = (float)rand() / RAND_MAX - 0.5f;
+        y.data_ptr()[i] = (float)rand() / RAND_MAX - 0.5f;
+    }
+    Tensor gamma = Tensor::ones({768}), beta = Tensor::zeros({768});
+
+    struct Op {
+        std::string name;
+        std::function<void()> fn;
+    };
+    std::vector<Op> ops = {
+        {"add (8,1024,768)", [&] { axon::add(x, y); }},
+        {"gelu (8,1024,768)", [&] { axon::gelu(x); }},
+        {"softmax (8,1024,768)", [&] { axon::softmax(x); }},
+        {"layer_norm (8,1024,768)", [&] { axon::layer_norm(x, gamma, beta); }},
+    };
+
+    double mb = x.numel() * sizeof(float) / (1024.0 * 1024.0);
+    for (Op& op : ops) {
+        ZeroFillAllocator zero_fill;
+        double zeroed_ms, empty_ms;
+        time_both(op.fn, 20, zero_fill, zeroed_ms, empty_ms);
+        std::cout << std::setw(28) << op.name << std::fixed << std::setprecision(1) << std::setw(12) << mb
+                  << std::setprecision(2) << std::setw(14) << zeroed_ms << std::setw(14) << empty_ms
+                  << std::setprecision(0) << std::setw(9) << 100.0 * (1.0 - empty_ms / zeroed_ms) << "%\n";
+    }
+}
+
+int main() {
+    std::cout << "[TEST] empty() outputs match zero-filled outputs...\n";
+    {
+        Tensor a = Tensor::ones({4, 5});
+        Tensor b = Tensor::ones({5, 3});
+        ZeroFillAllocator zero_fill;
+
+        // fill the cache with garbage so empty() really hands back dirty memory
+        for (int i = 0; i < 8; i++) {
+            Tensor junk = Tensor::empty({4, 3});
+            std::memset(junk.data_ptr(), 0xff, junk.numel() * sizeof(float));
+        }
+        Tensor fast = axon::add(axon::gelu(axon::matmul(a, b)), axon::softmax(axon::matmul(a, b)));
+
+        set_allocator(DeviceType::CPU, &zero_fill);
+        Tensor ref = axon::add(axon::gelu(axon::matmul(a, b)), axon::softmax(axon::matmul(a, b)));
+        set_allocator(DeviceType::CPU, nullptr);
+
+        for (size_t i = 0; i < ref.numel(); i++) {
+            if (fast.data_ptr()[i] != ref.data_ptr()[i]) {
+                std::cerr << "Output depends on uninitialized memory at " << i << "\n";
+                return 1;
+            }
+        }
+    }
+    std::cout << "  -> Passed.\n";
+
+    InferenceModeGuard inference;
+    bench_ops();
+
+    // for context: the forward is GEMM-bound, so the write pass saved above is within the noise here
+    std::cout << "\n[BENCH] GPT-2 small forward, zero-filled vs uninitialized op outputs\n";
+    std::cout << std::setw(8) << "T" << std::setw(14) << "zeroed ms" << std::setw(14) << "empty ms"
+              << std::setw(16) << "MB not written" << std::setw(16) << "memset ms" << "\n";
+
+    nn::GPT2 model;
+
+    for (int T : {64, 256, 512}) {
+        Tensor idx = Tensor::empty({1, T});
+        for (int j = 0; j < T; j++) idx.data_ptr()[j] = (float)((j * 97) % 50257);
+
+        int rounds = T <= 64 ? 8 : 4;
+
+        ZeroFillAllocator zero_fill;
+        double zeroed_ms, empty_ms;
+        time_both([&] { model.forward(idx); }, rounds, zero_fill, zeroed_ms, empty_ms);
+        size_t bytes = zero_fill.bytes_zeroed / rounds;
+        double mb = bytes / (1024.0 * 1024.0);
+
+        // the write pass on its own, for scale against the end-to-end difference
+        std::vector<char> buf(bytes);
+        auto start = std::chrono::high_resolution_clock::now();
+        std::memset(buf.data(), 0, bytes);
+        std::memset(buf.data(), 1, bytes);
+        double memset_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / 2;
+
+        std::cout << std::setw(8) << T << std::fixed << std::setprecision(1) << std::setw(14) << zeroed_ms
+                  << std::setw(14) << empty_ms << std::setw(16) << mb << std::setw(16) << memset_ms << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/grad_mode.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace axon;
+
+// RssAnon / RssFile from /proc/self/status, in MB: private memory vs file-backed pages
+// that every process mapping the same file shares
+long rss_field_mb(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    long kb;
+    while (status >> key) {
+        if (key == field + ":") {
+            status >> kb;
+            return kb / 1024;
+        }
+        status.ignore(256, '\n');
+    }
+    return -1;
+}
+
+double ms_since(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+struct LoadResult {
+    double load_ms;
+    double first_forward_ms;
+    long anon_after_load;
+    long anon_after_forward, file_after_forward;
+    float logit_checksum;
+};
+
+// runs in a fresh child process, so RSS is not polluted by the other mode
+LoadResult run(bool use_mmap, const std::string& path) {
+    InferenceModeGuard inference;
+    LoadResult r;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::unique_ptr<nn::GPT2> model;
+    {
+        if (use_mmap) {
+            nn::SkipInitGuard skip_init;
+            model = std::make_unique<nn::GPT2>();
+        } else {
+            model = std::make_unique<nn::GPT2>();
+        }
+
+        std::cout.setstate(std::ios::failbit); // silence the loader
+        auto params = model -> parameters();
+        if (use_mmap) {
+            load_model_mmap(params, path);
+        } else {
+            load_model(params, path);
+        }
+        std::cout.clear();
+    }
+    r.load_ms = ms_since(start);
+    r.anon_after_load = rss_field_mb("RssAnon");
+
+    Tensor idx = Tensor::empty({1, 8});
+    for (int j = 0; j < 8; j++) idx.data_ptr()[j] = (float)(j * 1000 + 17);
+
+    start = std::chrono::high_resolution_clock::now();
+    Tensor logits = model -> forward(idx);
+    r.first_forward_ms = ms_since(start);
+    r.anon_after_forward = rss_field_mb("RssAnon");
+    r.file_after_forward = rss_field_mb("RssFile");
+
+    r.logit_checksum = 0.0f;
+    for (size_t i = 0; i < logits.numel(); i += 97) r.logit_checksum += logits.data_ptr()[i];
+    return r;
+}
+
+LoadResult run_in_child(bool use_mmap, const std::string& path) {
+    int fds[2];
+    if (pipe(fds) != 0) exit(1);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        LoadResult r = run(use_mmap, path);
+        if (write(fds[1], &r, sizeof(r)) != sizeof(r)) _exit(1);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    LoadResult r{};
+    if (read(fds[0], &r, sizeof(r)) != sizeof(r)) {
+        std::cerr << "child failed\n";
+        exit(1);
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return r;
+}
+
+int main() {
+    std::string path = "/tmp/axon_mmap_gpt2.bin";
+
+    std::cout << "[TEST] load_model_mmap on a small model...\n";
+    {
+        nn::Linear a(5, 7);
+        nn::LayerNorm ln(7);
+        std::vector<Tensor> params = a.parameters();
+        params.push_back(ln.gamma);
+        params.push_back(ln.beta);
+        save_model(params, "/tmp/axon_mmap_small.bin");
+
+        nn::SkipInitGuard skip_init;
+        nn::Linear b(5, 7);
+        nn::LayerNorm ln2(7);
+        std::vector<Tensor> params2 = b.parameters();
+        params2.push_back(ln2.gamma);
+        params2.push_back(ln2.beta);
+        load_model_mmap(params2, "/tmp/axon_mmap_small.bin");
+
+        // the module's own tensors see the mapped data, 64-byte aligned
+        for (size_t i = 0; i < b.weight.numel(); i++) {
+            if (b.weight.data_ptr()[i] != a.weight.data_ptr()[i]) {
+                std::cerr << "Mapped weight mismatch\n";
+                return 1;
+            }
+        }
+        if (reinterpret_cast<uintptr_t>(b.weight.data_ptr()) % 64 != 0 || ln2.gamma.at({3}) != 1.0f) {
+            std::cerr << "Mapped layout mismatch\n";
+            return 1;
+        }
+
+        // writes go to a private copy of the page, never to the file
+        b.weight.data_ptr()[0] = 123.0f;
+        nn::Linear c(5, 7);
+        std::vector<Tensor> params3 = c.parameters();
+        params3.push_back(ln2.gamma);
+        params3.push_back(ln2.beta);
+        load_model(params3, "/tmp/axon_mmap_small.bin");
+        if (c.weight.data_ptr()[0] != a.weight.data_ptr()[0]) {
+            std::cerr << "Write through a mapped parameter reached the file\n";
+            return 1;
+        }
+    }
+    {
+        // a mismatch on a later parameter leaves the earlier ones as they were
+        nn::Linear d(5, 7);
+        nn::LayerNorm ln3(8);
+        std::vector<Tensor> params4 = d.parameters();
+        params4.push_back(ln3.gamma);
+        params4.push_back(ln3.beta);
+        const void* weight_data = d.weight.get_storage() -> data;
+        float first = d.weight.data_ptr()[0];
+        bool threw = false;
+        try {
+            load_model_mmap(params4, "/tmp/axon_mmap_small.bin");
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw || d.weight.get_storage() -> data != weight_data || d.weight.data_ptr()[0] != first) {
+            std::cerr << "A failed load_model_mmap left the model half mapped\n";
+            return 1;
+        }
+    }
+    std::cout << "  -> Passed.\n";
+
+    std::cout << "\n[BENCH] GPT-2 small (124M params): construct + load, separate processes\n";
+    {
+        nn::GPT2 model;
+        for (Tensor t : {model.wte.weight, model.wpe.weight}) {
+            for (size_t i = 0; i < t.numel(); i++) t.data_ptr()[i] = ((float)rand() / RAND_MAX - 0.5f) * 0.2f;
+        }
+        std::cout.setstate(std::ios::failbit);
+        save_model(model.parameters(), path);
+        std::cout.clear();
+    }
+    empty_cache(); // children start from this process's memory
+
+    LoadResult stream = run_in_child(false, path);
+    LoadResult mapped = run_in_child(true, path);
+
+    if (std::abs(stream.logit_checksum - mapped.logit_checksum) > 1e-3f * std::abs(stream.logit_checksum) + 1e-3f) {
+        std::cerr << "Mapped model computes different logits\n";
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(30) << "" << std::right << std::setw(14) << "load_model" << std::setw(16) << "load_model_mmap" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(30) << "construct + load (ms)" << std::right << std::setw(14) << stream.load_ms << std::setw(16) << mapped.load_ms << "\n";
+    std::cout << std::left << std::setw(30) << "private RSS after load (MB)" << std::right << std::setw(14) << stream.anon_after_load << std::setw(16) << mapped.anon_after_load << "\n";
+    std::cout << std::left << std::setw(30) << "first forward, T=8 (ms)" << std::right << std::setw(14) << stream.first_forward_ms << std::setw(16) << mapped.first_forward_ms << "\n";
+    std::cout << std::left << std::setw(30) << "private RSS after fwd (MB)" << std::right << std::setw(14) << stream.anon_after_forward << std::setw(16) << mapped.anon_after_forward << "\n";
+    std::cout << std::left << std::setw(30) << "shared file RSS after fwd (MB)" << std::right << std::setw(14) << stream.file_after_forward << std::setw(16) << mapped.file_after_forward << "\n";
+    std::cout << "(file RSS is page cache: one copy for every process that maps the checkpoint)\n";
+
+    unlink(path.c_str());
+    unlink("/tmp/axon_mmap_small.bin");
+    return 0;
+}
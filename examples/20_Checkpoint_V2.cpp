@@ -0,0 +1,164 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/serialization.hpp"
+#include "axon/thread_pool.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace axon;
+
+double ms_since(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+bool same(const Tensor& a, const Tensor& b) {
+    if (a.numel() != b.numel()) return false;
+    for (size_t i = 0; i < a.numel(); i++) {
+        if (a.data_ptr()[i] != b.data_ptr()[i]) return false;
+    }
+    return true;
+}
+
+void test_named_roundtrip() {
+    std::cout << "[TEST] Named save/load, any order, partial...\n";
+    nn::Block a(16, 4);
+    for (auto& [name, t] : a.named_parameters()) {
+        for (size_t i = 0; i < t.numel(); i++) t.data_ptr()[i] = (float)rand() / RAND_MAX;
+    }
+    save_checkpoint(a.named_parameters(), "/tmp/axon_v2_block.bin");
+
+    CheckpointReader reader("/tmp/axon_v2_block.bin");
+    if (reader.version() < 2 || reader.tensors().size() != a.parameters().size()) fail("bad index");
+    for (const TensorInfo& info : reader.tensors()) {
+        if (info.offset % 64 != 0) fail("unaligned tensor " + info.name);
+    }
+    const TensorInfo* w = reader.find("attn.w_k.weight");
+    if (!w || w -> shape != std::vector<int>({16, 16}) || w -> dtype != DType::Float32) fail("bad entry");
+
+    // loading does not care about parameter order
+    nn::Block b(16, 4);
+    NamedTensors params = b.named_parameters();
+    std::reverse(params.begin(), params.end());
+    load_checkpoint(params, "/tmp/axon_v2_block.bin");
+    if (!same(a.mlp.c_fc.weight, b.mlp.c_fc.weight) || !same(a.ln_2.beta, b.ln_2.beta)) fail("named load mismatch");
+
+    // one tensor on its own
+    if (!same(reader.load("attn.c_proj.bias"), a.attn.c_proj.bias)) fail("single tensor mismatch");
+
+    // a subset of a bigger model: strict fails on the missing names, non-strict skips them
+    nn::Block c(16, 4);
+    NamedTensors extra = c.named_parameters();
+    extra.push_back({"not.in.file", Tensor::zeros({3})});
+    bool threw = false;
+    try {
+        load_checkpoint(extra, "/tmp/axon_v2_block.bin");
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    if (!threw) fail("strict load accepted a missing tensor");
+    if (reader.load_named(extra, false) != extra.size() - 1) fail("non-strict load count");
+    if (!same(a.attn.w_v.weight, c.attn.w_v.weight)) fail("non-strict load mismatch");
+
+    // mapped, name-keyed
+    nn::SkipInitGuard skip_init;
+    nn::Block d(16, 4);
+    NamedTensors mapped = d.named_parameters();
+    load_checkpoint_mmap(mapped, "/tmp/axon_v2_block.bin");
+    if (!same(a.attn.w_q.weight, d.attn.w_q.weight)) fail("mapped load mismatch");
+
+    unlink("/tmp/axon_v2_block.bin");
+    std::cout << "  -> Passed.\n";
+}
+
+// the positional stream every older checkpoint uses
+void write_v1(const std::vector<Tensor>& params, const std::string& path) {
+    std::ofstream f(path, std::ios::binary);
+    uint32_t magic = 0x41584F4E, count = params.size();
+    f.write(reinterpret_cast<const char*>(&magic), 4);
+    f.write(reinterpret_cast<const char*>(&count), 4);
+    for (const Tensor& t : params) {
+        uint32_t rank = t.get_shape().size();
+        f.write(reinterpret_cast<const char*>(&rank), 4);
+        for (int s : t.get_shape()) {
+            uint32_t d = s;
+            f.write(reinterpret_cast<const char*>(&d), 4);
+        }
+        f.write(reinterpret_cast<const char*>(t.data_ptr()), t.numel() * sizeof(float));
+    }
+}
+
+void test_v1_reader() {
+    std::cout << "[TEST] v1 files still load...\n";
+    nn::Linear a(7, 3);
+    nn::LayerNorm ln(3);
+    std::vector<Tensor> params = a.parameters();
+    params.push_back(ln.gamma);
+    write_v1(params, "/tmp/axon_v1.bin");
+
+    nn::Linear b(7, 3);
+    std::vector<Tensor> params2 = b.parameters();
+    params2.push_back(Tensor::zeros({3}));
+    load_model(params2, "/tmp/axon_v1.bin");
+    if (!same(a.weight, b.weight) || params2[2].at({1}) != 1.0f) fail("v1 load mismatch");
+
+    CheckpointReader reader("/tmp/axon_v1.bin");
+    if (reader.version() != 1 || !reader.find("1") || reader.find("1") -> shape != std::vector<int>({1, 3})) fail("v1 index");
+
+    // cut the file short: the index notices
+    truncate("/tmp/axon_v1.bin", 40);
+    bool threw = false;
+    try {
+        CheckpointReader truncated("/tmp/axon_v1.bin");
+    } catch (const std::exception&) {
+        threw = true;
+    }
+    if (!threw) fail("truncated v1 file accepted");
+
+    unlink("/tmp/axon_v1.bin");
+    std::cout << "  -> Passed.\n";
+}
+
+int main() {
+    test_named_roundtrip();
+    test_v1_reader();
+
+    std::cout << "\n[BENCH] GPT-2 small checkpoint, warm page cache\n";
+    std::string path = "/tmp/axon_v2_gpt2.bin";
+    nn::SkipInitGuard skip_init;
+    {
+        nn::GPT2 model;
+        for (auto& [name, t] : model.named_parameters()) t.get_storage() -> materialize();
+        save_checkpoint(model.named_parameters(), path);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    CheckpointReader reader(path);
+    double index_ms = ms_since(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    Tensor head = reader.load("lm_head.weight");
+    double head_ms = ms_since(start);
+
+    nn::GPT2 model;
+    NamedTensors params = model.named_parameters();
+    start = std::chrono::high_resolution_clock::now();
+    reader.load_named(params);
+    double full_ms = ms_since(start);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  open + read index (" << reader.tensors().size() << " tensors)   " << std::setw(10) << index_ms << " ms\n";
+    std::cout << "  load lm_head.weight only (147 MB)    " << std::setw(10) << head_ms << " ms\n";
+    std::cout << "  load all (" << get_num_threads() << " threads)                 " << std::setw(10) << full_ms << " ms\n";
+
+    unlink(path.c_str());
+    return 0;
+}
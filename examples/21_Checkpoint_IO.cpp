@@ -0,0 +1,173 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/serialization.hpp"
+#include "axon/thread_pool.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace axon;
+
+double ms_since(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+bool same(const Tensor& a, const Tensor& b) {
+    if (a.numel() != b.numel()) return false;
+    for (size_t i = 0; i < a.numel(); i++) {
+        if (a.data_ptr()[i] != b.data_ptr()[i]) return false;
+    }
+    return true;
+}
+
+void flip_byte(const std::string& path, uint64_t offset) {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekg(offset);
+    char c;
+    f.read(&c, 1);
+    c ^= 0x10;
+    f.seekp(offset);
+    f.write(&c, 1);
+}
+
+// what save_model used to be: one ofstream write per tensor on the calling thread (v1)
+void save_stream(const std::vector<Tensor>& params, const std::string& path) {
+    std::ofstream f(path, std::ios::binary);
+    uint32_t magic = 0x41584F4E, count = params.size();
+    f.write(reinterpret_cast<const char*>(&magic), 4);
+    f.write(reinterpret_cast<const char*>(&count), 4);
+    for (const Tensor& t : params) {
+        uint32_t rank = t.get_shape().size();
+        f.write(reinterpret_cast<const char*>(&rank), 4);
+        for (int s : t.get_shape()) {
+            uint32_t d = s;
+            f.write(reinterpret_cast<const char*>(&d), 4);
+        }
+        f.write(reinterpret_cast<const char*>(t.data_ptr()), t.numel() * sizeof(float));
+    }
+}
+
+void test_checksums() {
+    std::cout << "[TEST] Checksums catch corruption...\n";
+    std::string path = "/tmp/axon_crc.bin";
+
+    // big enough that the embedding spans several I/O chunks
+    nn::Embedding emb(3000, 512);
+    nn::Linear lin(8, 4);
+    NamedTensors params{{"emb", emb.weight}, {"lin.w", lin.weight}, {"lin.b", lin.bias}};
+    save_checkpoint(params, path);
+    if (access((path + ".tmp").c_str(), F_OK) == 0) fail("temporary file left behind");
+
+    CheckpointReader reader(path);
+    if (reader.version() != 3 || !reader.find("emb") -> has_checksum) fail("no checksum in the index");
+    reader.verify();
+
+    nn::Embedding emb2(3000, 512);
+    reader.load_into("emb", emb2.weight);
+    if (!same(emb.weight, emb2.weight)) fail("chunked load mismatch");
+
+    // one flipped bit deep inside the embedding
+    flip_byte(path, reader.find("emb") -> offset + 5'000'001);
+    CheckpointReader corrupt(path);
+    if (!throws([&] { corrupt.verify(); })) fail("verify missed a corrupt tensor");
+    if (!throws([&] { corrupt.load_into("emb", emb2.weight); })) fail("load missed a corrupt tensor");
+    corrupt.load_into("lin.w", lin.weight); // the others are still fine
+
+    // cut short: the index no longer fits the file
+    truncate(path.c_str(), reader.find("lin.b") -> offset + 4);
+    if (!throws([&] { CheckpointReader truncated(path); })) fail("truncated file accepted");
+
+    unlink(path.c_str());
+    std::cout << "  -> Passed.\n";
+}
+
+void test_async() {
+    std::cout << "[TEST] save_checkpoint_async snapshots its inputs...\n";
+    std::string path = "/tmp/axon_async.bin";
+
+    nn::Linear a(64, 32);
+    Tensor expected = Tensor::empty({32, 64});
+    for (size_t i = 0; i < a.weight.numel(); i++) expected.data_ptr()[i] = a.weight.data_ptr()[i];
+
+    std::future<void> done = save_checkpoint_async(a.named_parameters(), path);
+    // the next "training step" scribbles on the weights while the save runs
+    for (size_t i = 0; i < a.weight.numel(); i++) a.weight.data_ptr()[i] = -1.0f;
+    done.get();
+
+    nn::Linear b(64, 32);
+    NamedTensors params = b.named_parameters();
+    load_checkpoint(params, path);
+    if (!same(b.weight, expected)) fail("async save saw later writes");
+
+    // errors come back through the future
+    std::future<void> bad = save_checkpoint_async(a.named_parameters(), "/nonexistent/dir/x.bin");
+    if (!throws([&] { bad.get(); })) fail("async save error lost");
+
+    unlink(path.c_str());
+    std::cout << "  -> Passed.\n";
+}
+
+int main() {
+    test_checksums();
+    test_async();
+
+    std::cout << "\n[BENCH] GPT-2 small checkpoint (" << get_num_threads() << " threads, warm page cache)\n";
+    std::string v1_path = "/tmp/axon_io_v1.bin", v3_path = "/tmp/axon_io_v3.bin";
+    nn::GPT2 model;
+    std::vector<Tensor> params = model.parameters();
+    NamedTensors named = model.named_parameters();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    save_stream(params, v1_path);
+    double stream_save = ms_since(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    save_checkpoint(named, v3_path);
+    double chunked_save = ms_since(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::future<void> pending = save_checkpoint_async(named, v3_path);
+    double async_blocked = ms_since(start);
+    pending.get();
+    double async_total = ms_since(start);
+
+    // periodic saves during training: the previous snapshot's blocks come back from the allocator cache
+    start = std::chrono::high_resolution_clock::now();
+    pending = save_checkpoint_async(named, v3_path);
+    double async_again = ms_since(start);
+    pending.get();
+
+    std::cout.setstate(std::ios::failbit);
+    start = std::chrono::high_resolution_clock::now();
+    load_model(params, v1_path);
+    double v1_load = ms_since(start);
+    std::cout.clear();
+
+    start = std::chrono::high_resolution_clock::now();
+    load_checkpoint(named, v3_path);
+    double v3_load = ms_since(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    CheckpointReader(v3_path).verify();
+    double verify_ms = ms_since(start);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  save, ofstream per tensor (old)       " << std::setw(9) << stream_save << " ms\n";
+    std::cout << "  save_checkpoint, chunked + CRC32C     " << std::setw(9) << chunked_save << " ms\n";
+    std::cout << "  save_checkpoint_async, caller blocked " << std::setw(9) << async_blocked << " ms (done after " << async_total << " ms)\n";
+    std::cout << "  ... again, allocator cache warm       " << std::setw(9) << async_again << " ms\n";
+    std::cout << "  load v1, no checksums                 " << std::setw(9) << v1_load << " ms\n";
+    std::cout << "  load v3, CRC32C verified              " << std::setw(9) << v3_load << " ms\n";
+    std::cout << "  verify only                           " << std::setw(9) << verify_ms << " ms\n";
+
+    unlink(v1_path.c_str());
+    unlink(v3_path.c_str());
+    return 0;
+}
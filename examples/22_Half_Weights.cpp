@@ -0,0 +1,219 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/kernels.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/serialization.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <unistd.h>
+
+using namespace axon;
+
+void test_conversions() {
+    std::cout << "[TEST] fp16 / bf16 conversions...\n";
+
+    // every half survives half -> float -> half, through both the scalar and the vector path
+    std::vector<uint16_t> all(65536), back(65536);
+    std::vector<float> wide(65536);
+    for (uint32_t h = 0; h < 65536; h++) all[h] = static_cast<uint16_t>(h);
+    kernels::cpu::cast_f16_to_f32(65536, all.data(), wide.data());
+    kernels::cpu::cast_f32_to_f16(65536, wide.data(), back.data());
+    for (uint32_t h = 0; h < 65536; h++) {
+        bool nan = (h & 0x7C00) == 0x7C00 && (h & 0x3FF);
+        if (nan) continue;
+        if (f16_to_float(h) != wide[h]) fail("f16 widen mismatch at " + std::to_string(h));
+        if (back[h] != h || float_to_f16(wide[h]) != h) fail("f16 round trip at " + std::to_string(h));
+    }
+
+    // narrowing: vector kernels agree with the scalar reference on awkward values
+    std::vector<float> vals = {0.0f, -0.0f, 1.0f, 65504.0f, 65519.0f, 65520.0f, 1e-8f, 2.9802322e-8f, 6.1e-5f,
+                               1.00048828125f, 1.000732421875f, std::numeric_limits<float>::infinity(),
+                               -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN(), 3.0e38f};
+    for (int i = 0; i < 4000; i++) {
+        uint32_t bits = (uint32_t)rand() * 2654435761u ^ (uint32_t)rand();
+        float f;
+        std::memcpy(&f, &bits, 4);
+        vals.push_back(f);
+    }
+    std::vector<uint16_t> h16(vals.size()), b16(vals.size());
+    kernels::cpu::cast_f32_to_f16(vals.size(), vals.data(), h16.data());
+    kernels::cpu::cast_f32_to_bf16(vals.size(), vals.data(), b16.data());
+    for (size_t i = 0; i < vals.size(); i++) {
+        if (is_nan(vals[i])) {
+            if (!is_nan(f16_to_float(h16[i])) || !is_nan(bf16_to_float(b16[i]))) fail("NaN lost");
+            continue;
+        }
+        if (h16[i] != float_to_f16(vals[i])) fail("f16 narrowing mismatch for " + std::to_string(vals[i]));
+        if (b16[i] != float_to_bf16(vals[i])) fail("bf16 narrowing mismatch for " + std::to_string(vals[i]));
+    }
+    if (float_to_f16(65520.0f) != 0x7C00 || float_to_f16(65519.0f) != 0x7BFF) fail("f16 overflow rounding");
+    if (float_to_bf16(1.00390625f) != 0x3F80) fail("bf16 tie not to even");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_matmul() {
+    std::cout << "[TEST] matmul / embedding with 16-bit weights...\n";
+
+    struct Case { int M, K, N; bool trans; };
+    for (Case c : std::vector<Case>{{1, 64, 40}, {3, 100, 33}, {37, 300, 70}, {130, 257, 529}, {5, 48, 17, true}, {64, 96, 50, true}}) {
+        for (DType dt : {DType::Float16, DType::BFloat16}) {
+            Tensor a = random_tensor({c.M, c.K});
+            Tensor w = c.trans ? random_tensor({c.N, c.K}) : random_tensor({c.K, c.N});
+            Tensor w16 = w.to(dt);
+
+            // reference: the same rounded weights, in float32
+            Tensor w_rounded = w16.to(DType::Float32);
+            Tensor b_ref = c.trans ? transpose(w_rounded, 0, 1) : w_rounded;
+            Tensor b_half = c.trans ? transpose(w16, 0, 1) : w16;
+
+            Tensor ref = matmul(a, b_ref);
+            Tensor out = matmul(a, b_half);
+            if (out.dtype() != DType::Float32 || max_abs_diff(ref, out) > 1e-4f * c.K) {
+                fail("matmul mismatch " + std::to_string(c.M) + "x" + std::to_string(c.K) + "x" + std::to_string(c.N) + " " + dtype_name(dt));
+            }
+        }
+    }
+
+    // batched activations against one 16-bit weight
+    Tensor x = random_tensor({2, 9, 48});
+    Tensor w = random_tensor({48, 24}).to(DType::BFloat16);
+    if (max_abs_diff(matmul(x, w), matmul(x, w.to(DType::Float32))) > 1e-4f) fail("batched matmul mismatch");
+
+    Tensor table = random_tensor({50, 20});
+    Tensor idx = Tensor::empty({2, 3});
+    for (int i = 0; i < 6; i++) idx.data_ptr()[i] = (float)(i * 7);
+    for (DType dt : {DType::Float16, DType::BFloat16}) {
+        Tensor t16 = table.to(dt);
+        if (max_abs_diff(embedding(idx, t16), embedding(idx, t16.to(DType::Float32))) != 0.0f) fail("embedding mismatch");
+    }
+
+    // everything else insists on float32
+    bool threw = false;
+    try {
+        add(w, w);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    if (!threw) fail("add accepted a bf16 tensor");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_checkpoint() {
+    std::cout << "[TEST] checkpoints keep the dtype...\n";
+    std::string path = "/tmp/axon_bf16.bin";
+
+    nn::Block a(32, 4);
+    Tensor w_before = a.mlp.c_fc.weight.to(DType::BFloat16).to(DType::Float32);
+    a.cast_weights(DType::BFloat16);
+    if (a.mlp.c_fc.weight.dtype() != DType::BFloat16 || a.mlp.c_fc.bias.dtype() != DType::Float32) fail("cast_weights picked the wrong tensors");
+    save_checkpoint(a.named_parameters(), path);
+
+    CheckpointReader reader(path);
+    const TensorInfo* info = reader.find("mlp.c_fc.weight");
+    if (info -> dtype != DType::BFloat16 || info -> nbytes != info -> numel() * 2) fail("bf16 tensor stored wrong");
+
+    // into float32 parameters: converted on load
+    nn::Block b(32, 4);
+    NamedTensors params = b.named_parameters();
+    reader.load_named(params);
+    if (max_abs_diff(b.mlp.c_fc.weight, w_before) != 0.0f) fail("bf16 -> f32 load mismatch");
+
+    // mapped: the parameters become bf16
+    nn::SkipInitGuard skip_init;
+    nn::Block c(32, 4);
+    NamedTensors mapped = c.named_parameters();
+    load_checkpoint_mmap(mapped, path);
+    if (c.mlp.c_fc.weight.dtype() != DType::BFloat16 || max_abs_diff(c.mlp.c_fc.weight.to(DType::Float32), w_before) != 0.0f) fail("mapped bf16 mismatch");
+
+    unlink(path.c_str());
+    std::cout << "  -> Passed.\n";
+}
+
+size_t weight_bytes(nn::Module& m) {
+    size_t n = 0;
+    for (auto& [name, p] : m.named_parameters()) n += p.numel() * dtype_size(p.dtype());
+    return n;
+}
+
+double time_forward(nn::GPT2& model, const Tensor& idx, int rounds) {
+    double best = 1e30;
+    model.forward(idx);
+    for (int r = 0; r < rounds; r++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        model.forward(idx);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+    }
+    return best;
+}
+
+double time_decode(nn::GPT2& model, int steps) {
+    nn::KVCache cache = model.make_cache(1, steps + 8);
+    Tensor prompt = Tensor::empty({1, 8});
+    for (int j = 0; j < 8; j++) prompt.data_ptr()[j] = (float)(j * 101 + 7);
+    model.forward_step(prompt, cache, 0);
+
+    Tensor tok = Tensor::empty({1, 1});
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int s = 0; s < steps; s++) {
+        tok.data_ptr()[0] = (float)(s * 37 % 50257);
+        model.forward_step(tok, cache, cache.length);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / steps;
+}
+
+int main() {
+    test_conversions();
+    test_matmul();
+    test_checkpoint();
+
+    std::cout << "\n[BENCH] GPT-2 small, float32 vs 16-bit weights\n";
+    InferenceModeGuard inference;
+    nn::GPT2 model;
+    // scale the embeddings like real weights, the default init leaves them at -0.5
+    for (Tensor t : {model.wte.weight, model.wpe.weight}) {
+        for (size_t i = 0; i < t.numel(); i++) t.data_ptr()[i] = rand_float() * 0.1f;
+    }
+
+    Tensor idx = Tensor::empty({1, 64});
+    for (int j = 0; j < 64; j++) idx.data_ptr()[j] = (float)((j * 97) % 50257);
+
+    Tensor ref = model.forward(idx);
+    size_t f32_bytes = weight_bytes(model);
+    double f32_prompt = time_forward(model, idx, 3);
+    double f32_decode = time_decode(model, 16);
+
+    std::cout << std::setw(10) << "weights" << std::setw(14) << "param MB" << std::setw(18) << "prompt T=64 ms"
+              << std::setw(18) << "decode ms/tok" << std::setw(20) << "max |logit diff|" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(10) << "float32" << std::setw(14) << f32_bytes / 1048576.0 << std::setw(18) << f32_prompt
+              << std::setw(18) << f32_decode << std::setw(20) << "-" << "\n";
+
+    for (DType dt : {DType::BFloat16, DType::Float16}) {
+        nn::GPT2 half;
+        NamedTensors src = model.named_parameters(), dst = half.named_parameters();
+        for (size_t i = 0; i < src.size(); i++) {
+            std::memcpy(dst[i].second.data_ptr(), src[i].second.data_ptr(), src[i].second.numel() * sizeof(float));
+        }
+        half.cast_weights(dt);
+
+        float diff = max_abs_diff(ref, half.forward(idx));
+        double prompt_ms = time_forward(half, idx, 3);
+        double decode_ms = time_decode(half, 16);
+
+        std::cout << std::setw(10) << dtype_name(dt) << std::setw(14) << weight_bytes(half) / 1048576.0 << std::setw(18) << prompt_ms
+                  << std::setw(18) << decode_ms << std::setw(20) << std::setprecision(4) << diff << std::setprecision(1) << "\n";
+    }
+
+    return 0;
+}
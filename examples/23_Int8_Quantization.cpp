@@ -0,0 +1,236 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/kernels.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/serialization.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace axon;
+
+// q * scale as float32, per column (dim 1) or per row (dim 0)
+Tensor dequantize(const Tensor& q, const Tensor& scale, int dim) {
+    Tensor out = q.to(DType::Float32);
+    int rows = q.get_shape()[0], cols = q.get_shape()[1];
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) out.data_ptr()[i * cols + j] *= scale.data_ptr()[dim == 1 ? j : i];
+    }
+    return out;
+}
+
+void test_quantize() {
+    std::cout << "[TEST] quantize_int8 / casts...\n";
+
+    Tensor w = random_tensor({37, 21});
+    for (int i = 0; i < 37; i++) w.data_ptr()[i * 21 + 5] = 0.0f; // an all-zero output channel
+    for (int dim : {0, 1}) {
+        auto [q, scale] = quantize_int8(w, dim);
+        if (q.dtype() != DType::Int8 || scale.numel() != (size_t)(dim == 1 ? 21 : 37)) fail("quantize_int8 shapes");
+        Tensor back = dequantize(q, scale, dim);
+        for (int i = 0; i < 37; i++) {
+            for (int j = 0; j < 21; j++) {
+                float s = scale.data_ptr()[dim == 1 ? j : i];
+                if (std::abs(back.data_ptr()[i * 21 + j] - w.data_ptr()[i * 21 + j]) > 0.5f * s + 1e-7f) fail("quantization error above half a step");
+            }
+        }
+        if (dim == 1 && scale.data_ptr()[5] != 0.0f) fail("zero channel got a scale");
+    }
+
+    std::vector<float> vals = {0.0f, 0.5f, 1.5f, 2.5f, -2.5f, 126.6f, 127.5f, 300.0f, -128.4f, -129.0f, -1e9f, 1e9f, 3.49f, -0.51f};
+    for (int i = 0; i < 100; i++) vals.push_back(rand_float() * 200.0f);
+    std::vector<int8_t> out(vals.size());
+    kernels::cpu::cast_f32_to_i8(vals.size(), vals.data(), out.data());
+    for (size_t i = 0; i < vals.size(); i++) {
+        long expect = std::lrint(std::min(std::max(vals[i], -128.0f), 127.0f));
+        if (out[i] != expect) fail("cast_f32_to_i8 wrong for " + std::to_string(vals[i]));
+    }
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_matmul() {
+    std::cout << "[TEST] quantized_matmul / quantized_embedding...\n";
+
+    struct Case { std::vector<int> a_shape; int N; };
+    for (Case c : std::vector<Case>{{{1, 64}, 40}, {{3, 100}, 33}, {{37, 300}, 70}, {{2, 65, 257}, 529}, {{48}, 17}}) {
+        int K = c.a_shape.back();
+        Tensor a = random_tensor(c.a_shape);
+        auto [q, scale] = quantize_int8(random_tensor({K, c.N}), 1);
+
+        Tensor ref = matmul(a, dequantize(q, scale, 1));
+        Tensor out = quantized_matmul(a, q, scale);
+        if (out.get_shape() != ref.get_shape() || max_abs_diff(ref, out) > 1e-5f * K) {
+            fail("quantized_matmul mismatch, K=" + std::to_string(K) + " N=" + std::to_string(c.N));
+        }
+    }
+
+    // gradients reach the input, as through the dequantized weight
+    Tensor x = random_tensor({5, 24});
+    x.set_requires_grad(true);
+    auto [q, scale] = quantize_int8(random_tensor({24, 16}), 1);
+    sum(quantized_matmul(x, q, scale)).backward();
+    Tensor grad_q = *x.get_grad();
+
+    Tensor x2 = Tensor::empty({5, 24});
+    std::memcpy(x2.data_ptr(), x.data_ptr(), x.numel() * sizeof(float));
+    x2.set_requires_grad(true);
+    sum(matmul(x2, dequantize(q, scale, 1))).backward();
+    if (max_abs_diff(grad_q, *x2.get_grad()) > 1e-4f) fail("quantized_matmul gradient mismatch");
+
+    auto [table, row_scale] = quantize_int8(random_tensor({50, 20}), 0);
+    Tensor idx = Tensor::empty({2, 3});
+    for (int i = 0; i < 6; i++) idx.data_ptr()[i] = (float)(i * 7);
+    if (max_abs_diff(quantized_embedding(idx, table, row_scale), embedding(idx, dequantize(table, row_scale, 0))) > 1e-6f) fail("quantized_embedding mismatch");
+
+    // plain matmul / embedding refuse int8, the scales would be silently dropped
+    if (!throws([&] { matmul(x, q); }) || !throws([&] { embedding(idx, table); })) fail("int8 accepted without scales");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_modules() {
+    std::cout << "[TEST] Linear::quantize, checkpoints...\n";
+    std::string path = "/tmp/axon_int8.bin";
+
+    nn::Block a(32, 4);
+    Tensor x = random_tensor({2, 5, 32});
+    Tensor before = a.forward(x);
+    nn::Linear& fc = a.mlp.c_fc;
+    Tensor w_f32 = Tensor::empty(fc.weight.get_shape());
+    std::memcpy(w_f32.data_ptr(), fc.weight.data_ptr(), w_f32.numel() * sizeof(float));
+
+    fc.quantize();
+    if (fc.weight.dtype() != DType::Int8 || !fc.weight_scale || a.parameters().size() != 17) fail("quantize did not swap the weight");
+    float max_scale = 0.0f;
+    for (size_t j = 0; j < fc.weight_scale -> numel(); j++) max_scale = std::max(max_scale, fc.weight_scale -> data_ptr()[j]);
+    if (max_abs_diff(dequantize(fc.weight, *fc.weight_scale, 1), w_f32) > 0.5f * max_scale + 1e-7f) fail("quantized weight off");
+    Tensor after = a.forward(x);
+    if (max_abs_diff(before, after) > 0.05f) fail("quantized block drifted");
+
+    save_checkpoint(a.named_parameters(), path);
+    CheckpointReader reader(path);
+    if (reader.find("mlp.c_fc.weight") -> dtype != DType::Int8 || !reader.find("mlp.c_fc.weight_scale")) fail("int8 tensor stored wrong");
+    Tensor loaded = reader.load("mlp.c_fc.weight");
+    if (loaded.dtype() != DType::Int8 || std::memcmp(loaded.raw_data_ptr(), fc.weight.raw_data_ptr(), loaded.numel()) != 0) fail("load() of an int8 tensor");
+
+    // a float32 model cannot take int8 weights, quantize it first
+    nn::Block b(32, 4);
+    NamedTensors params = b.named_parameters();
+    if (!throws([&] { reader.load_named(params, false); })) fail("int8 loaded into float32");
+    b.mlp.c_fc.quantize();
+    params = b.named_parameters();
+    reader.load_named(params);
+    if (max_abs_diff(b.forward(x), after) != 0.0f) fail("quantized load mismatch");
+
+    // mapped: a skip-init module quantizes to shapes only, then takes the file's data
+    nn::SkipInitGuard skip_init;
+    nn::Block c(32, 4);
+    c.mlp.c_fc.quantize();
+    NamedTensors mapped = c.named_parameters();
+    load_checkpoint_mmap(mapped, path);
+    if (max_abs_diff(c.forward(x), after) != 0.0f) fail("mapped quantized mismatch");
+
+    unlink(path.c_str());
+    std::cout << "  -> Passed.\n";
+}
+
+size_t weight_bytes(nn::Module& m) {
+    size_t n = 0;
+    for (auto& [name, p] : m.named_parameters()) n += p.numel() * dtype_size(p.dtype());
+    return n;
+}
+
+double time_forward(nn::GPT2& model, const Tensor& idx, int rounds) {
+    double best = 1e30;
+    model.forward(idx);
+    for (int r = 0; r < rounds; r++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        model.forward(idx);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+    }
+    return best;
+}
+
+double time_decode(nn::GPT2& model, int steps) {
+    nn::KVCache cache = model.make_cache(1, steps + 8);
+    Tensor prompt = Tensor::empty({1, 8});
+    for (int j = 0; j < 8; j++) prompt.data_ptr()[j] = (float)(j * 101 + 7);
+    model.forward_step(prompt, cache, 0);
+
+    Tensor tok = Tensor::empty({1, 1});
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int s = 0; s < steps; s++) {
+        tok.data_ptr()[0] = (float)(s * 37 % 50257);
+        model.forward_step(tok, cache, cache.length);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / steps;
+}
+
+// positions whose argmax token is the same in both (T, V) logit tensors
+int same_argmax(const Tensor& a, const Tensor& b, int T, int V) {
+    int same = 0;
+    for (int t = 0; t < T; t++) {
+        const float* ra = a.data_ptr() + (size_t)t * V;
+        const float* rb = b.data_ptr() + (size_t)t * V;
+        same += std::max_element(ra, ra + V) - ra == std::max_element(rb, rb + V) - rb;
+    }
+    return same;
+}
+
+int main() {
+    test_quantize();
+    test_matmul();
+    test_modules();
+
+    std::cout << "\n[BENCH] GPT-2 small, float32 vs int8 weights\n";
+    InferenceModeGuard inference;
+    nn::GPT2 model;
+    // scale the embeddings like real weights, the default init leaves them at -0.5
+    for (Tensor t : {model.wte.weight, model.wpe.weight}) {
+        for (size_t i = 0; i < t.numel(); i++) t.data_ptr()[i] = rand_float() * 0.1f;
+    }
+
+    Tensor idx = Tensor::empty({1, 64});
+    for (int j = 0; j < 64; j++) idx.data_ptr()[j] = (float)((j * 97) % 50257);
+
+    Tensor ref = model.forward(idx);
+    size_t f32_bytes = weight_bytes(model);
+    double f32_prompt = time_forward(model, idx, 3);
+    double f32_decode = time_decode(model, 16);
+
+    nn::GPT2 quant;
+    NamedTensors src = model.named_parameters(), dst = quant.named_parameters();
+    for (size_t i = 0; i < src.size(); i++) {
+        std::memcpy(dst[i].second.data_ptr(), src[i].second.data_ptr(), src[i].second.numel() * sizeof(float));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    nn::quantize_model(quant);
+    double quantize_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    Tensor out = quant.forward(idx);
+    float diff = max_abs_diff(ref, out);
+    int agree = same_argmax(ref, out, 64, 50257);
+    double int8_prompt = time_forward(quant, idx, 3);
+    double int8_decode = time_decode(quant, 16);
+
+    std::cout << std::setw(10) << "weights" << std::setw(14) << "param MB" << std::setw(18) << "prompt T=64 ms"
+              << std::setw(18) << "decode ms/tok" << std::setw(20) << "max |logit diff|" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::setw(10) << "float32" << std::setw(14) << f32_bytes / 1048576.0 << std::setw(18) << f32_prompt
+              << std::setw(18) << f32_decode << std::setw(20) << "-" << "\n";
+    std::cout << std::setw(10) << "int8" << std::setw(14) << weight_bytes(quant) / 1048576.0 << std::setw(18) << int8_prompt
+              << std::setw(18) << int8_decode << std::setw(20) << std::setprecision(4) << diff << std::setprecision(1) << "\n";
+    std::cout << "  quantize_model: " << quantize_ms << " ms, same argmax token at " << agree << " / 64 positions\n";
+
+    return 0;
+}
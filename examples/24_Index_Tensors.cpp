@@ -0,0 +1,171 @@
+#include "axon/tensor.hpp"
+#include "axon/nn.hpp"
+#include "axon/grad_mode.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace axon;
+
+bool same(const Tensor& a, const Tensor& b) {
+    if (a.get_shape() != b.get_shape()) return false;
+    return std::memcmp(a.raw_data_ptr(), b.raw_data_ptr(), a.numel() * dtype_size(a.dtype())) == 0;
+}
+
+template <typename T>
+Tensor ids_tensor(const std::vector<int>& shape, const std::vector<int64_t>& ids, DType dtype) {
+    Tensor t = Tensor::empty(shape, dtype);
+    for (size_t i = 0; i < ids.size(); i++) t.data_as<T>()[i] = static_cast<T>(ids[i]);
+    return t;
+}
+
+void test_embedding() {
+    std::cout << "[TEST] embedding with int32 / int64 ids...\n";
+
+    Tensor table = random_tensor({50, 16});
+    std::vector<int64_t> ids = {3, 0, 49, 7, 7, 21};
+    Tensor f = ids_tensor<float>({2, 3}, ids, DType::Float32);
+    Tensor i32 = ids_tensor<int32_t>({2, 3}, ids, DType::Int32);
+    Tensor i64 = ids_tensor<int64_t>({2, 3}, ids, DType::Int64);
+
+    Tensor ref = embedding(f, table);
+    if (!same(ref, embedding(i32, table)) || !same(ref, embedding(i64, table))) fail("int ids gather different rows");
+    for (DType dt : {DType::Float16, DType::BFloat16}) {
+        if (!same(embedding(f, table.to(dt)), embedding(i64, table.to(dt)))) fail("16-bit table with int ids");
+    }
+
+    // strided ids
+    Tensor i64_t = transpose(ids_tensor<int64_t>({3, 2}, ids, DType::Int64), 0, 1);
+    Tensor f_t = transpose(ids_tensor<float>({3, 2}, ids, DType::Float32), 0, 1);
+    if (!same(embedding(i64_t, table), embedding(f_t, table))) fail("non-contiguous int ids");
+
+    // the same gradient whatever the id type
+    table.set_requires_grad(true);
+    sum(embedding(i32, table)).backward();
+    Tensor grad_int = *table.get_grad();
+    table.zero_grad();
+    sum(embedding(f, table)).backward();
+    if (!same(grad_int, *table.get_grad())) fail("embedding gradient with int ids");
+
+    // above 2^24 float ids collapse onto their neighbours, int32 ones do not
+    int rows = (1 << 24) + 4;
+    Tensor big = Tensor::empty({rows, 1});
+    for (int r = 0; r < rows; r++) big.data_ptr()[r] = (float)(r & 0xFFFF);
+    std::vector<int64_t> high = {(1 << 24) + 1, (1 << 24) + 3};
+    Tensor got = embedding(ids_tensor<int32_t>({2}, high, DType::Int32), big);
+    if (got.data_ptr()[0] != 1.0f || got.data_ptr()[1] != 3.0f) fail("int32 ids above 2^24");
+    Tensor as_float = embedding(ids_tensor<float>({2}, high, DType::Float32), big);
+    if (as_float.data_ptr()[0] == 1.0f && as_float.data_ptr()[1] == 3.0f) fail("float ids were expected to round here");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_conversions() {
+    std::cout << "[TEST] index dtype conversions...\n";
+
+    std::vector<int64_t> ids = {0, 1, -5, 123456789, (int64_t)1 << 40};
+    Tensor i64 = ids_tensor<int64_t>({5}, ids, DType::Int64);
+    Tensor back = i64.to(DType::Int32).to(DType::Int64);
+    for (int i = 0; i < 4; i++) {
+        if (back.data_as<int64_t>()[i] != ids[i]) fail("int64 -> int32 -> int64 lost " + std::to_string(ids[i]));
+    }
+    Tensor f = ids_tensor<float>({3}, {2, 7, 9}, DType::Float32).to(DType::Int64);
+    if (f.dtype() != DType::Int64 || f.data_as<int64_t>()[1] != 7) fail("float -> int64");
+    if (i64.to(DType::Float32).data_ptr()[3] != 123456789.0f) fail("int64 -> float");
+
+    Tensor m = ids_tensor<int64_t>({2, 3}, {1, 2, 3, 4, 5, 6}, DType::Int64);
+    Tensor mt = transpose(m, 0, 1).contiguous();
+    if (mt.data_as<int64_t>()[1] != 4 || mt.data_as<int64_t>()[2] != 2) fail("int64 contiguous()");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_nll_loss() {
+    std::cout << "[TEST] nll_loss with class indices...\n";
+
+    Tensor logits = random_tensor({4, 5});
+    std::vector<int64_t> classes = {2, 0, 4, 2};
+
+    Tensor onehot = Tensor::zeros({4, 5});
+    for (int i = 0; i < 4; i++) onehot.data_ptr()[i * 5 + classes[i]] = 1.0f;
+
+    Tensor x1 = Tensor::empty({4, 5}), x2 = Tensor::empty({4, 5});
+    std::memcpy(x1.data_ptr(), logits.data_ptr(), 20 * sizeof(float));
+    std::memcpy(x2.data_ptr(), logits.data_ptr(), 20 * sizeof(float));
+    x1.set_requires_grad(true);
+    x2.set_requires_grad(true);
+
+    Tensor l1 = nll_loss(log_softmax(x1), onehot);
+    Tensor l2 = nll_loss(log_softmax(x2), ids_tensor<int64_t>({4}, classes, DType::Int64));
+    if (std::abs(l1.data_ptr()[0] - l2.data_ptr()[0]) > 1e-6f) fail("index nll_loss value");
+
+    l1.backward();
+    l2.backward();
+    for (int i = 0; i < 20; i++) {
+        if (std::abs(x1.get_grad() -> data_ptr()[i] - x2.get_grad() -> data_ptr()[i]) > 1e-6f) fail("index nll_loss gradient");
+    }
+
+    bool threw = false;
+    try {
+        nll_loss(log_softmax(x1), ids_tensor<int32_t>({4}, {0, 1, 5, 2}, DType::Int32));
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    if (!threw) fail("out of range class accepted");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_gpt2() {
+    std::cout << "[TEST] GPT-2 forward with int32 ids...\n";
+    InferenceModeGuard inference;
+    nn::GPT2 model;
+
+    std::vector<int64_t> ids;
+    for (int j = 0; j < 12; j++) ids.push_back((j * 4099) % 50257);
+    Tensor a = model.forward(ids_tensor<float>({1, 12}, ids, DType::Float32));
+    Tensor b = model.forward(ids_tensor<int32_t>({1, 12}, ids, DType::Int32));
+    if (!same(a, b)) fail("GPT-2 logits depend on the id dtype");
+
+    std::cout << "  -> Passed.\n";
+}
+
+double bench_gather(const Tensor& table, const Tensor& ids, int rounds) {
+    embedding(ids, table);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; r++) embedding(ids, table);
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / rounds;
+}
+
+int main() {
+    test_embedding();
+    test_conversions();
+    test_nll_loss();
+    test_gpt2();
+
+    std::cout << "\n[BENCH] embedding gather from a 50257 x 768 table (us per call)\n";
+    InferenceModeGuard inference;
+    Tensor table = random_tensor({50257, 768});
+
+    std::cout << std::setw(12) << "tokens" << std::setw(16) << "float32 ids" << std::setw(14) << "int32 ids"
+              << std::setw(14) << "int64 ids" << std::setw(14) << "GB/s (int32)" << "\n";
+    for (int n : {64, 512, 4096}) {
+        std::vector<int64_t> ids;
+        for (int j = 0; j < n; j++) ids.push_back(((int64_t)j * 7919 + 13) % 50257);
+        double t_f = bench_gather(table, ids_tensor<float>({n}, ids, DType::Float32), 200);
+        double t_32 = bench_gather(table, ids_tensor<int32_t>({n}, ids, DType::Int32), 200);
+        double t_64 = bench_gather(table, ids_tensor<int64_t>({n}, ids, DType::Int64), 200);
+        double gbps = 2.0 * n * 768 * sizeof(float) / (t_32 * 1e3);
+        std::cout << std::fixed << std::setprecision(1) << std::setw(12) << n << std::setw(16) << t_f << std::setw(14) << t_32
+                  << std::setw(14) << t_64 << std::setw(14) << gbps << "\n";
+    }
+
+    return 0;
+}
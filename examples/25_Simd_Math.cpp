@@ -0,0 +1,225 @@
+#include "axon/tensor.hpp"
+#include "axon/kernels.hpp"
+#include "axon/simd_math.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+using namespace axon;
+
+float from_bits(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, 4);
+    return f;
+}
+
+// |got - exact| in units of the last place of the exact result (as a float)
+double ulp_error(float got, double exact) {
+    int e = std::max(std::ilogb(static_cast<float>(exact)), -126);
+    return std::abs(static_cast<double>(got) - exact) / std::ldexp(1.0, e - 23);
+}
+
+// every float in [lo, hi] whose bit pattern is a multiple of `stride`, padded to whole vectors
+std::vector<float> float_range(float lo, float hi, uint32_t stride) {
+    std::vector<float> out;
+    for (uint32_t sign : {0u, 0x80000000u}) {
+        for (uint32_t u = 0; u < 0x7F800000u; u += stride) {
+            float x = from_bits(u | sign);
+            if (x >= lo && x <= hi) out.push_back(x);
+        }
+    }
+    while (out.size() % 16) out.push_back(lo);
+    return out;
+}
+
+struct Exp {
+    template <typename O> static typename O::V run(typename O::V v) { return simd::exp<O>(v); }
+};
+
+struct Log {
+    template <typename O> static typename O::V run(typename O::V v) { return simd::log<O>(v); }
+};
+
+struct Tanh {
+    template <typename O> static typename O::V run(typename O::V v) { return simd::tanh<O>(v); }
+};
+
+template <typename O, typename F>
+std::vector<float> apply(const std::vector<float>& in) {
+    std::vector<float> out(in.size());
+    for (size_t i = 0; i < in.size(); i += O::width) O::store(out.data() + i, F::template run<O>(O::load(in.data() + i)));
+    return out;
+}
+
+template <typename O, typename F, typename G>
+double max_ulp_error(const std::vector<float>& x, G exact, float& worst_at) {
+    std::vector<float> got = apply<O, F>(x);
+    double worst = 0.0;
+    for (size_t i = 0; i < x.size(); i++) {
+        double e = ulp_error(got[i], exact(static_cast<double>(x[i])));
+        if (e > worst) {
+            worst = e;
+            worst_at = x[i];
+        }
+    }
+    return worst;
+}
+
+template <typename F, typename G>
+void check_accuracy(const char* name, float lo, float hi, G exact, double bound) {
+    // a stride coprime to the mantissa walks every exponent; the header's bounds come from stride 1
+    std::vector<float> x = float_range(lo, hi, 61);
+    float worst_at = 0.0f;
+    double worst = max_ulp_error<simd::Native, F>(x, exact, worst_at);
+    std::cout << "  " << std::setw(5) << name << ": max " << std::setprecision(3) << worst << " ulp at " << std::setprecision(9) << worst_at
+              << " (" << x.size() << " values)\n";
+    if (worst > bound) fail(std::string(name) + " exceeds its documented bound");
+
+    // the scalar tails and narrower vectors stay within it too
+    if (max_ulp_error<simd::Scalar, F>(x, exact, worst_at) > bound) fail(std::string(name) + ": scalar version exceeds the bound");
+#if defined(__AVX2__) && defined(__FMA__)
+    if (max_ulp_error<simd::Avx2, F>(x, exact, worst_at) > bound) fail(std::string(name) + ": AVX2 version exceeds the bound");
+#endif
+}
+
+void test_accuracy() {
+    std::cout << "[TEST] exp / log / tanh against libm...\n";
+
+    check_accuracy<Exp>("exp", -87.33f, 88.72f, [](double x) { return std::exp(x); }, 1.01);
+    check_accuracy<Log>("log", std::numeric_limits<float>::min(), std::numeric_limits<float>::max(), [](double x) { return std::log(x); }, 0.83);
+    check_accuracy<Tanh>("tanh", -12.0f, 12.0f, [](double x) { return std::tanh(x); }, 1.33);
+
+    // edges
+    float inf = std::numeric_limits<float>::infinity();
+    // volatile: stops -ffast-math folding these at compile time, with its own rules
+    auto exp = [](float x) { volatile float v = x; return simd::exp<simd::Scalar>(v); };
+    auto log = [](float x) { volatile float v = x; return simd::log<simd::Scalar>(v); };
+    auto tanh = [](float x) { volatile float v = x; return simd::tanh<simd::Scalar>(v); };
+
+    if (exp(89.0f) != inf || exp(inf) != inf || exp(-200.0f) != 0.0f || exp(-inf) != 0.0f) fail("exp overflow / underflow");
+    if (exp(0.0f) != 1.0f) fail("exp(0)");
+    if (log(0.0f) != -inf || log(inf) != inf || !is_nan(log(-1.0f)) || log(1.0f) != 0.0f) fail("log specials");
+    if (tanh(9.1f) != 1.0f || tanh(-50.0f) != -1.0f) fail("tanh saturation");
+    if (tanh(0.0f) != 0.0f || tanh(1e-30f) != 1e-30f || tanh(-1e-30f) != -1e-30f) fail("tanh near zero");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_kernels() {
+    std::cout << "[TEST] softmax / log_softmax / gelu kernels against libm...\n";
+    namespace cpu = kernels::cpu;
+
+    // odd widths leave scalar tails behind every vector loop
+    for (size_t cols : {1, 7, 33, 1024}) {
+        size_t rows = 5;
+        std::vector<float> x(rows * cols), sm(rows * cols), lsm(rows * cols);
+        for (float& v : x) v = rand_float() * 20.0f;
+        cpu::softmax_f32(rows, cols, x.data(), sm.data());
+        cpu::log_softmax_f32(rows, cols, x.data(), lsm.data());
+
+        for (size_t r = 0; r < rows; r++) {
+            const float* row = x.data() + r * cols;
+            double m = *std::max_element(row, row + cols), sum = 0.0;
+            for (size_t c = 0; c < cols; c++) sum += std::exp(row[c] - m);
+            for (size_t c = 0; c < cols; c++) {
+                double p = std::exp(row[c] - m) / sum;
+                double lp = row[c] - m - std::log(sum);
+                if (std::abs(sm[r * cols + c] - p) > 1e-6 * std::max(1.0, p * 10)) fail("softmax mismatch, cols " + std::to_string(cols));
+                if (std::abs(lsm[r * cols + c] - lp) > 1e-5 * std::max(1.0, std::abs(lp))) fail("log_softmax mismatch, cols " + std::to_string(cols));
+            }
+        }
+    }
+
+    const double k = std::sqrt(2.0 / M_PI), c = 0.044715;
+    size_t n = 3 * 3072 + 5;
+    std::vector<float> x(n), g(n), y(n), dx(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = rand_float() * 8.0f;
+        g[i] = rand_float();
+    }
+    cpu::gelu_f32(n, x.data(), y.data());
+    cpu::gelu_backward_f32(n, x.data(), g.data(), dx.data());
+    for (size_t i = 0; i < n; i++) {
+        double xi = x[i];
+        double t = std::tanh(k * (xi + c * xi * xi * xi));
+        double ref = 0.5 * xi * (1.0 + t);
+        double dref = g[i] * (0.5 * (1.0 + t) + 0.5 * xi * (1.0 - t * t) * k * (1.0 + 3.0 * c * xi * xi));
+        if (std::abs(y[i] - ref) > 1e-6 * std::max(1.0, std::abs(ref))) fail("gelu mismatch at " + std::to_string(xi));
+        if (std::abs(dx[i] - dref) > 1e-6 * std::max(1.0, std::abs(dref))) fail("gelu backward mismatch at " + std::to_string(xi));
+    }
+
+    std::cout << "  -> Passed.\n";
+}
+
+// keeps the compiler from dropping stores nobody reads
+void escape(void* p) {
+    asm volatile("" : : "r"(p) : "memory");
+}
+
+void bench_functions() {
+    // with -ffast-math and glibc the libm loops are vectorized too (libmvec)
+    std::cout << "\n[BENCH] 1M floats, ns per element\n";
+    size_t n = 1 << 20;
+    std::vector<float> x(n), y(n);
+    for (float& v : x) v = rand_float() * 10.0f;
+    std::vector<float> pos(n);
+    for (size_t i = 0; i < n; i++) pos[i] = std::abs(x[i]) + 1e-3f;
+
+    auto row = [&](const char* name, auto libm, auto f, const std::vector<float>& in) {
+        using F = decltype(f);
+        double t_libm = time_us([&] {
+            for (size_t i = 0; i < n; i++) y[i] = libm(in[i]);
+            escape(y.data());
+        }, 20);
+        double t_vec = time_us([&] {
+            using O = simd::Native;
+            for (size_t i = 0; i < n; i += O::width) O::store(y.data() + i, F::template run<O>(O::load(in.data() + i)));
+            escape(y.data());
+        }, 20);
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << name << std::setw(12) << t_libm * 1e3 / n << std::setw(12)
+                  << t_vec * 1e3 / n << std::setw(10) << std::setprecision(1) << t_libm / t_vec << "x\n";
+    };
+
+    std::cout << std::setw(8) << "" << std::setw(12) << "libm" << std::setw(12) << "simd" << std::setw(11) << "speedup" << "\n";
+    row("exp", [](float v) { return std::exp(v); }, Exp{}, x);
+    row("log", [](float v) { return std::log(v); }, Log{}, pos);
+    row("tanh", [](float v) { return std::tanh(v); }, Tanh{}, x);
+}
+
+void bench_kernels() {
+    std::cout << "\n[BENCH] kernels (us per call)\n";
+    namespace cpu = kernels::cpu;
+
+    size_t T = 1024;
+    std::vector<float> s(12 * T * T), p(12 * T * T);
+    for (float& v : s) v = rand_float() * 8.0f;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  softmax, 12 heads x 1024 x 1024:      " << time_us([&] { cpu::softmax_f32(12 * T, T, s.data(), p.data()); }, 5) << "\n";
+    std::cout << "  log_softmax, 64 x 50257:              "
+              << time_us([&] { cpu::log_softmax_f32(64, 50257, s.data(), p.data()); }, 10) << "\n";
+
+    size_t n = 64 * 3072;
+    std::vector<float> g(n), dx(n);
+    for (size_t i = 0; i < n; i++) g[i] = rand_float();
+    std::cout << "  gelu, 64 x 3072:                      " << time_us([&] { cpu::gelu_f32(n, s.data(), p.data()); }, 50) << "\n";
+    std::cout << "  gelu_backward, 64 x 3072:             "
+              << time_us([&] { cpu::gelu_backward_f32(n, s.data(), g.data(), dx.data()); }, 50) << "\n";
+    std::cout << "  exp, 64 x 3072:                       " << time_us([&] { cpu::exp_f32(n, s.data(), p.data()); }, 50) << "\n";
+}
+
+int main() {
+    test_accuracy();
+    test_kernels();
+    bench_functions();
+    bench_kernels();
+    return 0;
+}
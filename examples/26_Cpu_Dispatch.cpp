@@ -0,0 +1,196 @@
+#include "axon/tensor.hpp"
+#include "axon/kernels.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// Runs every kernel on each instruction set this CPU supports and checks the builds agree.
+// AXON_ISA=scalar|avx2|avx512 picks the starting one, e.g. AXON_ISA=scalar ./26_Cpu_Dispatch
+
+using namespace axon;
+namespace cpu = kernels::cpu;
+
+// outputs of one run of every kernel, in order
+std::vector<std::vector<float>> run_kernels() {
+    srand(7);
+    std::vector<std::vector<float>> out;
+
+    // odd sizes leave a tail behind every vector loop
+    size_t n = 8 * 4096 + 13;
+    auto a = random_vec(n), b = random_vec(n), pos = random_vec(n);
+    for (size_t i = 0; i < n; i++) {
+        b[i] += b[i] >= 0.0f ? 0.5f : -0.5f;
+        pos[i] = std::abs(pos[i]) + 0.1f;
+    }
+
+    auto unary = [&](void (*f)(size_t, const float*, float*) noexcept, const std::vector<float>& x) {
+        std::vector<float> y(n);
+        f(n, x.data(), y.data());
+        out.push_back(y);
+    };
+    auto binary = [&](void (*f)(size_t, const float*, const float*, float*) noexcept) {
+        std::vector<float> y(n);
+        f(n, a.data(), b.data(), y.data());
+        out.push_back(y);
+    };
+
+    binary(cpu::add_f32);
+    binary(cpu::sub_f32);
+    binary(cpu::mul_f32);
+    binary(cpu::div_f32);
+    unary(cpu::relu_f32, a);
+    unary(cpu::sqrt_f32, pos);
+    unary(cpu::exp_f32, a);
+    unary(cpu::neg_f32, a);
+    unary(cpu::gelu_f32, a);
+
+    std::vector<float> y(n);
+    cpu::gelu_backward_f32(n, a.data(), b.data(), y.data());
+    out.push_back(y);
+    cpu::fill_f32(n, 3.5f, y.data());
+    out.push_back(y);
+
+    size_t rows = 7, cols = 501;
+    std::vector<float> sm(rows * cols), lsm(rows * cols), g(rows * cols);
+    cpu::softmax_f32(rows, cols, a.data(), sm.data());
+    cpu::log_softmax_f32(rows, cols, a.data(), lsm.data());
+    out.push_back(sm);
+    out.push_back(lsm);
+    cpu::softmax_backward_f32(rows, cols, b.data(), sm.data(), g.data());
+    out.push_back(g);
+    cpu::log_softmax_backward_f32(rows, cols, b.data(), lsm.data(), g.data());
+    out.push_back(g);
+
+    std::vector<float> ln(rows * cols), dx(rows * cols), dg(cols), db(cols);
+    cpu::layernorm_forward_f32(rows, cols, a.data(), pos.data(), b.data(), ln.data(), 1e-5f);
+    cpu::layernorm_backward_f32(rows, cols, b.data(), a.data(), pos.data(), 1e-5f, dx.data(), dg.data(), db.data());
+    out.push_back(ln);
+    out.push_back(dx);
+    out.push_back(dg);
+
+    // GEMM: every layout, edge tiles in both directions, each B storage type
+    size_t M = 70, N = 83, K = 300;
+    for (bool ta : {false, true}) {
+        for (bool tb : {false, true}) {
+            std::vector<float> c(M * N, 1.0f);
+            cpu::gemm_f32_builtin(ta, tb, M, N, K, 0.5f, a.data(), ta ? M : K, b.data(), tb ? K : N, 2.0f, c.data(), N);
+            out.push_back(c);
+        }
+    }
+    std::vector<uint16_t> h(K * N), bf(K * N);
+    std::vector<int8_t> q(K * N);
+    cpu::cast_f32_to_f16(K * N, b.data(), h.data());
+    cpu::cast_f32_to_bf16(K * N, b.data(), bf.data());
+    cpu::cast_f32_to_i8(K * N, a.data(), q.data());
+    for (size_t m : {size_t(3), M}) {
+        std::vector<float> c(m * N);
+        cpu::gemm_f32_f16(false, false, m, N, K, 1.0f, a.data(), K, h.data(), N, 0.0f, c.data(), N);
+        out.push_back(c);
+        cpu::gemm_f32_bf16(false, true, m, N, K, 1.0f, a.data(), K, bf.data(), K, 0.0f, c.data(), N);
+        out.push_back(c);
+        cpu::gemm_f32_i8(false, false, m, N, K, a.data(), K, q.data(), N, pos.data(), c.data(), N);
+        out.push_back(c);
+    }
+
+    std::vector<float> back(K * N);
+    cpu::cast_f16_to_f32(K * N, h.data(), back.data());
+    out.push_back(back);
+    cpu::cast_bf16_to_f32(K * N, bf.data(), back.data());
+    out.push_back(back);
+    cpu::cast_i8_to_f32(K * N, q.data(), back.data());
+    out.push_back(back);
+
+    std::vector<int32_t> ids = {5, 0, 299, 17, 17};
+    std::vector<float> rows_out(ids.size() * N);
+    cpu::embedding_forward_i8<int32_t>(K, N, ids.size(), q.data(), pos.data(), ids.data(), rows_out.data());
+    out.push_back(rows_out);
+    cpu::embedding_forward_bf16<int32_t>(K, N, ids.size(), bf.data(), ids.data(), rows_out.data());
+    out.push_back(rows_out);
+
+    // attention, causal, with a tail block of queries and keys
+    size_t T = 77, D = 32;
+    cpu::AttentionStrides st{T * D, T * D, D};
+    auto qv = random_vec(T * D), kv = random_vec(T * D), vv = random_vec(T * D), go = random_vec(T * D);
+    std::vector<float> o(T * D), lse(T), gq(T * D), gk(T * D), gv(T * D);
+    cpu::attention_forward_f32(1, 1, T, T, D, 0.2f, true, qv.data(), st, kv.data(), st, vv.data(), st, o.data(), st, lse.data());
+    cpu::attention_backward_f32(1, 1, T, T, D, 0.2f, true, qv.data(), st, kv.data(), st, vv.data(), st, o.data(), st,
+                                go.data(), st, lse.data(), gq.data(), st, gk.data(), st, gv.data(), st);
+    out.push_back(o);
+    out.push_back(gq);
+    out.push_back(gk);
+    return out;
+}
+
+void test_dispatch() {
+    std::cout << "[TEST] every instruction set against the scalar build...\n";
+    std::cout << "  active: " << cpu::cpu_isa_name(cpu::cpu_isa()) << ", supported:";
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) std::cout << " " << cpu::cpu_isa_name(isa);
+    std::cout << "\n";
+
+    cpu::CpuIsa start = cpu::cpu_isa();
+    if (!cpu::set_cpu_isa(cpu::CpuIsa::Scalar)) fail("scalar must always be available");
+    auto ref = run_kernels();
+
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        if (cpu::cpu_isa() != isa) fail("set_cpu_isa did not switch");
+        auto got = run_kernels();
+
+        // FMA contraction, exp polynomials and summation order differ, the results stay close
+        double worst = 0.0;
+        for (size_t k = 0; k < ref.size(); k++) {
+            for (size_t i = 0; i < ref[k].size(); i++) {
+                double err = std::abs(got[k][i] - ref[k][i]) / std::max(1.0, std::abs((double)ref[k][i]));
+                if (err > 1e-4) fail(std::string(cpu::cpu_isa_name(isa)) + ": kernel " + std::to_string(k) + " differs at " + std::to_string(i));
+                worst = std::max(worst, err);
+            }
+        }
+        std::cout << "  " << std::setw(6) << cpu::cpu_isa_name(isa) << ": " << ref.size() << " kernels, max rel diff " << worst << "\n";
+    }
+
+    if (!cpu::cpu_isa_supported(cpu::CpuIsa::Avx512) && cpu::set_cpu_isa(cpu::CpuIsa::Avx512)) fail("switched to an unsupported ISA");
+    cpu::set_cpu_isa(start);
+
+    std::cout << "  -> Passed.\n";
+}
+
+void bench() {
+    std::cout << "\n[BENCH] per instruction set (us per call; GEMM in GFLOP/s)\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    size_t S = 768;
+    auto a = random_vec(S * S), b = random_vec(S * 4 * S);
+    std::vector<float> c(S * 4 * S);
+    size_t n = 1 << 20;
+    auto x = random_vec(n, 4.0f), y = random_vec(n);
+    std::vector<float> z(n);
+    std::vector<float> logits = random_vec(64 * 50257, 8.0f), lsm(64 * 50257);
+
+    std::cout << std::setw(8) << "" << std::setw(14) << "gemm 768^2x3k" << std::setw(12) << "add 1M" << std::setw(12) << "gelu 1M"
+              << std::setw(16) << "log_softmax" << "\n";
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        double t_gemm = time_us([&] { cpu::gemm_f32_builtin(false, false, S, 4 * S, S, 1.0f, a.data(), S, b.data(), 4 * S, 0.0f, c.data(), 4 * S); }, 5);
+        double t_add = time_us([&] { cpu::add_f32(n, x.data(), y.data(), z.data()); }, 50);
+        double t_gelu = time_us([&] { cpu::gelu_f32(n, x.data(), z.data()); }, 20);
+        double t_lsm = time_us([&] { cpu::log_softmax_f32(64, 50257, logits.data(), lsm.data()); }, 5);
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << cpu::cpu_isa_name(isa) << std::setw(14)
+                  << 2.0 * S * S * 4 * S / (t_gemm * 1e3) << std::setw(12) << t_add << std::setw(12) << t_gelu << std::setw(16) << t_lsm << "\n";
+    }
+
+    cpu::set_cpu_isa(start);
+}
+
+int main() {
+    test_dispatch();
+    bench();
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include "axon/tensor.hpp"
+#include "axon/kernels.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+
+// Masked loop tails on every instruction set: each kernel at every length around the vector
+// width, checked against a double reference and for writes past the end. Then the AVX2 and
+// AVX-512 builds side by side on the GPT-2 small layer shapes (B*T = 1024, C = 768).
+
+using namespace axon;
+namespace cpu = kernels::cpu;
+
+constexpr float CANARY = 12345.0f;
+constexpr size_t PAD = 40;
+
+// n outputs followed by PAD canaries
+struct Out {
+    std::vector<float> buf;
+    size_t n;
+    explicit Out(size_t n) : buf(n + PAD, CANARY), n(n) {}
+    float* data() { return buf.data(); }
+    float operator[](size_t i) const { return buf[i]; }
+
+    void check(const std::string& what) const {
+        for (size_t i = n; i < buf.size(); i++) {
+            if (buf[i] != CANARY) fail(what + ": wrote past the end at " + std::to_string(i) + " (n = " + std::to_string(n) + ")");
+        }
+    }
+};
+
+double gelu_ref(double x) {
+    return 0.5 * x * (1.0 + std::tanh(0.7978845608028654 * (x + 0.044715 * x * x * x)));
+}
+
+void test_elementwise() {
+    for (size_t n = 0; n <= 3 * 16 + 5; n++) {
+        auto a = random_vec(n), b = random_vec(n), pos = random_vec(n);
+        for (size_t i = 0; i < n; i++) {
+            b[i] += b[i] >= 0.0f ? 0.5f : -0.5f;
+            pos[i] = std::abs(pos[i]) + 0.1f;
+        }
+        std::string at = " at n = " + std::to_string(n);
+
+        Out add(n), sub(n), mul(n), div(n), relu(n), relu_bw(n), neg(n), sqr(n), ex(n), gelu(n), fill(n);
+        cpu::add_f32(n, a.data(), b.data(), add.data());
+        cpu::sub_f32(n, a.data(), b.data(), sub.data());
+        cpu::mul_f32(n, a.data(), b.data(), mul.data());
+        cpu::div_f32(n, a.data(), b.data(), div.data());
+        cpu::relu_f32(n, a.data(), relu.data());
+        cpu::relu_backward_f32(n, a.data(), b.data(), relu_bw.data());
+        cpu::neg_f32(n, a.data(), neg.data());
+        cpu::sqrt_f32(n, pos.data(), sqr.data());
+        cpu::exp_f32(n, a.data(), ex.data());
+        cpu::gelu_f32(n, a.data(), gelu.data());
+        cpu::fill_f32(n, 2.5f, fill.data());
+
+        for (size_t i = 0; i < n; i++) {
+            // exact in any instruction set
+            if (add[i] != a[i] + b[i] || sub[i] != a[i] - b[i] || mul[i] != a[i] * b[i]) fail("add/sub/mul" + at);
+            if (relu[i] != std::max(a[i], 0.0f) || neg[i] != -a[i] || fill[i] != 2.5f) fail("relu/neg/fill" + at);
+            if (relu_bw[i] != (a[i] > 0.0f ? b[i] : 0.0f)) fail("relu_backward" + at);
+
+            expect_close("div" + at, div[i], (double)a[i] / b[i], 1e-6);
+            expect_close("sqrt" + at, sqr[i], std::sqrt((double)pos[i]), 1e-6);
+            expect_close("exp" + at, ex[i], std::exp((double)a[i]), 1e-6);
+            expect_close("gelu" + at, gelu[i], gelu_ref(a[i]), 1e-5);
+        }
+        for (const Out* o : {&add, &sub, &mul, &div, &relu, &relu_bw, &neg, &sqr, &ex, &gelu, &fill}) o->check("elementwise" + at);
+    }
+}
+
+void test_rows() {
+    for (size_t cols = 1; cols <= 3 * 16 + 5; cols++) {
+        size_t rows = 3, n = rows * cols;
+        auto x = random_vec(n, 3.0f), g = random_vec(n), gamma = random_vec(cols), beta = random_vec(cols);
+        std::string at = " at cols = " + std::to_string(cols);
+
+        // sum / sum over the last dim / over the middle dim
+        float total;
+        cpu::sum_f32(n, x.data(), &total);
+        double want = 0.0;
+        for (float v : x) want += v;
+        expect_close("sum" + at, total, want, 1e-5);
+
+        Out last(rows), mid(cols);
+        cpu::sum_dim_f32(rows, cols, 1, x.data(), last.data());
+        cpu::sum_dim_f32(1, rows, cols, x.data(), mid.data());
+        for (size_t r = 0; r < rows; r++) {
+            double s = 0.0;
+            for (size_t c = 0; c < cols; c++) s += x[r * cols + c];
+            expect_close("sum_dim last" + at, last[r], s, 1e-5);
+        }
+        for (size_t c = 0; c < cols; c++) {
+            expect_close("sum_dim mid" + at, mid[c], (double)x[c] + x[cols + c] + x[2 * cols + c], 1e-5);
+        }
+        last.check("sum_dim" + at);
+        mid.check("sum_dim" + at);
+
+        // softmax / log_softmax and their backwards
+        Out sm(n), lsm(n), sm_bw(n), lsm_bw(n);
+        cpu::softmax_f32(rows, cols, x.data(), sm.data());
+        cpu::log_softmax_f32(rows, cols, x.data(), lsm.data());
+        cpu::softmax_backward_f32(rows, cols, g.data(), sm.data(), sm_bw.data());
+        cpu::log_softmax_backward_f32(rows, cols, g.data(), lsm.data(), lsm_bw.data());
+        for (size_t r = 0; r < rows; r++) {
+            const float* xr = x.data() + r * cols;
+            const float* gr = g.data() + r * cols;
+            double mx = *std::max_element(xr, xr + cols), z = 0.0, gsum = 0.0, dot = 0.0;
+            for (size_t c = 0; c < cols; c++) z += std::exp(xr[c] - mx);
+            for (size_t c = 0; c < cols; c++) {
+                double p = std::exp(xr[c] - mx) / z;
+                gsum += gr[c];
+                dot += gr[c] * p;
+            }
+            for (size_t c = 0; c < cols; c++) {
+                double p = std::exp(xr[c] - mx) / z;
+                expect_close("softmax" + at, sm[r * cols + c], p, 1e-5);
+                expect_close("log_softmax" + at, lsm[r * cols + c], std::log(p), 1e-5);
+                expect_close("softmax_backward" + at, sm_bw[r * cols + c], p * (gr[c] - dot), 1e-5);
+                expect_close("log_softmax_backward" + at, lsm_bw[r * cols + c], gr[c] - p * gsum, 1e-5);
+            }
+        }
+        for (const Out* o : {&sm, &lsm, &sm_bw, &lsm_bw}) o->check("softmax" + at);
+
+        // layernorm forward / backward
+        float eps = 1e-5f;
+        Out ln(n), dx(n), dgamma(cols), dbeta(cols);
+        cpu::layernorm_forward_f32(rows, cols, x.data(), gamma.data(), beta.data(), ln.data(), eps);
+        cpu::layernorm_backward_f32(rows, cols, g.data(), x.data(), gamma.data(), eps, dx.data(), dgamma.data(), dbeta.data());
+        std::vector<double> want_dgamma(cols, 0.0), want_dbeta(cols, 0.0);
+        for (size_t r = 0; r < rows; r++) {
+            const float* xr = x.data() + r * cols;
+            const float* gr = g.data() + r * cols;
+            double mean = 0.0, var = 0.0;
+            for (size_t c = 0; c < cols; c++) mean += xr[c];
+            mean /= cols;
+            for (size_t c = 0; c < cols; c++) var += (xr[c] - mean) * (xr[c] - mean);
+            double inv_std = 1.0 / std::sqrt(var / cols + eps);
+
+            double sum_d = 0.0, sum_dx = 0.0;
+            for (size_t c = 0; c < cols; c++) {
+                double xc = (xr[c] - mean) * inv_std;
+                expect_close("layernorm" + at, ln[r * cols + c], xc * gamma[c] + beta[c], 1e-4);
+                want_dgamma[c] += gr[c] * xc;
+                want_dbeta[c] += gr[c];
+                sum_d += gr[c] * gamma[c];
+                sum_dx += gr[c] * gamma[c] * xc;
+            }
+            for (size_t c = 0; c < cols; c++) {
+                double xc = (xr[c] - mean) * inv_std;
+                double want_dx = inv_std / cols * (cols * gr[c] * gamma[c] - sum_d - xc * sum_dx);
+                expect_close("layernorm_backward dx" + at, dx[r * cols + c], want_dx, 1e-3);
+            }
+        }
+        for (size_t c = 0; c < cols; c++) {
+            expect_close("layernorm_backward dgamma" + at, dgamma[c], want_dgamma[c], 1e-4);
+            expect_close("layernorm_backward dbeta" + at, dbeta[c], want_dbeta[c], 1e-5);
+        }
+        for (const Out* o : {&ln, &dx, &dgamma, &dbeta}) o->check("layernorm" + at);
+    }
+}
+
+// edge tiles in both directions, C with a wider row pitch whose padding must survive
+void test_gemm_edges() {
+    size_t K = 37;
+    for (size_t M : {size_t(1), size_t(5), size_t(13), size_t(25)}) {
+        for (size_t N = 1; N <= 70; N += (N < 34 ? 1 : 5)) {
+            for (float beta : {0.0f, 0.5f}) {
+                size_t ldc = N + 7;
+                auto a = random_vec(M * K), b = random_vec(K * N);
+                std::vector<float> c(M * ldc, CANARY);
+                for (size_t i = 0; i < M; i++) {
+                    for (size_t j = 0; j < N; j++) c[i * ldc + j] = (float)(i + j);
+                }
+                auto c0 = c;
+
+                cpu::gemm_f32_builtin(false, false, M, N, K, 1.5f, a.data(), K, b.data(), N, beta, c.data(), ldc);
+
+                std::string at = " at M = " + std::to_string(M) + ", N = " + std::to_string(N);
+                for (size_t i = 0; i < M; i++) {
+                    for (size_t j = 0; j < ldc; j++) {
+                        if (j >= N) {
+                            if (c[i * ldc + j] != CANARY) fail("gemm wrote into the row padding" + at);
+                            continue;
+                        }
+                        double want = beta * c0[i * ldc + j];
+                        for (size_t k = 0; k < K; k++) want += 1.5 * a[i * K + k] * b[k * N + j];
+                        expect_close("gemm" + at, c[i * ldc + j], want, 1e-4);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void test_tails() {
+    std::cout << "[TEST] masked tails, every length around the vector width...\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        srand(3);
+        test_elementwise();
+        test_rows();
+        test_gemm_edges();
+        std::cout << "  " << std::setw(6) << cpu::cpu_isa_name(isa) << ": ok\n";
+    }
+    cpu::set_cpu_isa(start);
+    std::cout << "  -> Passed.\n";
+}
+
+void bench() {
+    if (!cpu::cpu_isa_supported(cpu::CpuIsa::Avx512)) {
+        std::cout << "\n[BENCH] skipped, this CPU has no AVX-512\n";
+        return;
+    }
+    std::cout << "\n[BENCH] GPT-2 small layer shapes, B*T = 1024, C = 768 (us per call)\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    size_t BT = 1024, C = 768, H = 12, T = 256, V = 50257, LR = 256;
+    auto x = random_vec(BT * 4 * C), y = random_vec(BT * 4 * C), w = random_vec(4 * C * 3 * C);
+    auto gamma = random_vec(C), beta = random_vec(C), att = random_vec(BT / T * H * T * T, 4.0f);
+    auto logits = random_vec(LR * V, 8.0f);
+    std::vector<float> out(std::max(BT * 4 * C, LR * V)), out2(BT * 4 * C), dg(C), db(C);
+
+    struct Row {
+        std::string name, shape;
+        std::function<void()> run;
+        int rounds;
+    };
+    auto gemm = [&](size_t M, size_t N, size_t K) {
+        return [&, M, N, K] { cpu::gemm_f32_builtin(false, false, M, N, K, 1.0f, x.data(), K, w.data(), N, 0.0f, out.data(), N); };
+    };
+    std::vector<Row> rows = {
+        {"gemm qkv", "1024x2304x768", gemm(BT, 3 * C, C), 3},
+        {"gemm attn proj", "1024x768x768", gemm(BT, C, C), 5},
+        {"gemm fc", "1024x3072x768", gemm(BT, 4 * C, C), 3},
+        {"gemm fc proj", "1024x768x3072", gemm(BT, C, 4 * C), 3},
+        {"residual add", "1024x768", [&] { cpu::add_f32(BT * C, x.data(), y.data(), out.data()); }, 200},
+        {"layernorm", "1024x768", [&] { cpu::layernorm_forward_f32(BT, C, x.data(), gamma.data(), beta.data(), out.data(), 1e-5f); }, 100},
+        {"layernorm bwd", "1024x768", [&] { cpu::layernorm_backward_f32(BT, C, y.data(), x.data(), gamma.data(), 1e-5f, out.data(), dg.data(), db.data()); }, 50},
+        {"gelu", "1024x3072", [&] { cpu::gelu_f32(BT * 4 * C, x.data(), out.data()); }, 20},
+        {"gelu bwd", "1024x3072", [&] { cpu::gelu_backward_f32(BT * 4 * C, x.data(), y.data(), out.data()); }, 20},
+        {"attn softmax", "4x12x256x256", [&] { cpu::softmax_f32(BT / T * H * T, T, att.data(), out.data()); }, 20},
+        {"bias grad sum", "1024x768 -> 768", [&] { cpu::sum_dim_f32(1, BT, C, x.data(), out2.data()); }, 100},
+        {"loss log_softmax", "256x50257", [&] { cpu::log_softmax_f32(LR, V, logits.data(), out.data()); }, 5},
+    };
+
+    std::cout << std::left << std::setw(18) << "op" << std::setw(18) << "shape" << std::right << std::setw(12) << "avx2"
+              << std::setw(12) << "avx512" << std::setw(10) << "speedup" << "\n";
+    for (const Row& r : rows) {
+        cpu::set_cpu_isa(cpu::CpuIsa::Avx2);
+        double t2 = time_us(r.run, r.rounds);
+        cpu::set_cpu_isa(cpu::CpuIsa::Avx512);
+        double t512 = time_us(r.run, r.rounds);
+        std::cout << std::left << std::setw(18) << r.name << std::setw(18) << r.shape << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << t2 << std::setw(12) << t512 << std::setprecision(2) << std::setw(9) << t2 / t512 << "x\n";
+    }
+
+    cpu::set_cpu_isa(start);
+}
+
+int main() {
+    test_tails();
+    bench();
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/kernels.hpp"
+#include "axon/thread_pool.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+// sum / mean / max / min / argmax: accuracy of the pairwise sum, every reduction layout against
+// a reference on each instruction set, and the cost of the unbroadcast-shaped reductions.
+
+using namespace axon;
+namespace cpu = kernels::cpu;
+
+void test_sum_accuracy() {
+    std::cout << "[TEST] sum_f32 accuracy and thread independence...\n";
+
+    // 0.1 is not exact in binary, so every add rounds
+    size_t n = 1 << 24;
+    std::vector<float> x(n, 0.1f);
+    double exact = (double)0.1f * n;
+
+    float naive = 0.0f;
+    for (size_t i = 0; i < n; i++) naive = naive + x[i];
+
+    float pairwise;
+    cpu::sum_f32(n, x.data(), &pairwise);
+    double rel = std::abs(pairwise - exact) / exact;
+    std::cout << "  2^24 x 0.1f: one accumulator rel err " << std::abs(naive - exact) / exact << ", sum_f32 " << rel << "\n";
+    if (rel > 1e-6) fail("sum_f32 error too large");
+
+    // the block layout is fixed, so the thread count does not change the bits
+    auto r = random_tensor({(int)n / 4});
+    float results[3];
+    size_t threads[3] = {1, 3, 8};
+    size_t start = get_num_threads();
+    for (int i = 0; i < 3; i++) {
+        set_num_threads(threads[i]);
+        cpu::sum_f32(r.numel(), r.data_ptr(), &results[i]);
+    }
+    set_num_threads(start);
+    if (results[0] != results[1] || results[0] != results[2]) fail("sum_f32 depends on the thread count");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_layouts() {
+    std::cout << "[TEST] sum / mean / max / min / argmax over each dim...\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    std::vector<std::vector<int>> shapes = {{7}, {3, 37}, {5, 19, 3}, {2, 33, 17}, {4, 1, 70}, {65, 2}};
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        srand(11);
+
+        for (const auto& shape : shapes) {
+            Tensor t = random_tensor(shape);
+            // ties: the first position has to win
+            for (size_t i = 0; i < t.numel(); i += 5) t.data_ptr()[i] = 0.999f;
+            for (size_t i = 2; i < t.numel(); i += 7) t.data_ptr()[i] = -0.999f;
+
+            for (int dim = 0; dim < (int)shape.size(); dim++) {
+                size_t outer = 1, size = shape[dim], inner = 1;
+                for (int i = 0; i < dim; i++) outer *= shape[i];
+                for (size_t i = dim + 1; i < shape.size(); i++) inner *= shape[i];
+                std::string at = std::string(cpu::cpu_isa_name(isa)) + " dim " + std::to_string(dim) + " of " + std::to_string(t.numel());
+
+                Tensor s = sum(t, dim), m = mean(t, dim, true), mx = max(t, dim), mn = min(t, dim, true), am = argmax(t, -(int)shape.size() + dim);
+                if (am.dtype() != DType::Int64) fail("argmax must be int64");
+                if (m.get_shape().size() != shape.size()) fail("keepdim dropped the dim");
+
+                for (size_t o = 0; o < outer; o++) {
+                    for (size_t i = 0; i < inner; i++) {
+                        const float* x = t.data_ptr() + o * size * inner + i;
+                        double want_sum = 0.0;
+                        float want_max = x[0], want_min = x[0];
+                        int64_t want_arg = 0;
+                        for (size_t d = 0; d < size; d++) {
+                            float v = x[d * inner];
+                            want_sum += v;
+                            if (v > want_max) want_max = v, want_arg = d;
+                            want_min = std::min(want_min, v);
+                        }
+
+                        size_t j = o * inner + i;
+                        expect_close("sum " + at, s.data_ptr()[j], want_sum, 1e-5);
+                        expect_close("mean " + at, m.data_ptr()[j], want_sum / size, 1e-5);
+                        if (mx.data_ptr()[j] != want_max || mn.data_ptr()[j] != want_min) fail("max / min " + at);
+                        if (am.data_as<int64_t>()[j] != want_arg) fail("argmax " + at);
+                    }
+                }
+            }
+
+            // whole tensor
+            float want_max = *std::max_element(t.data_ptr(), t.data_ptr() + t.numel());
+            int64_t want_arg = std::max_element(t.data_ptr(), t.data_ptr() + t.numel()) - t.data_ptr();
+            if (max(t).data_ptr()[0] != want_max) fail("max of everything");
+            if (min(t).data_ptr()[0] != *std::min_element(t.data_ptr(), t.data_ptr() + t.numel())) fail("min of everything");
+            if (argmax(t).data_as<int64_t>()[0] != want_arg) fail("argmax of everything");
+        }
+    }
+    cpu::set_cpu_isa(start);
+
+    // strided input goes through a contiguous copy
+    Tensor t = random_tensor({6, 9});
+    Tensor tt = transpose(t, 0, 1);
+    for (int j = 0; j < 9; j++) {
+        int64_t want = 0;
+        for (int i = 1; i < 6; i++) if (t.data_ptr()[i * 9 + j] > t.data_ptr()[want * 9 + j]) want = i;
+        if (argmax(tt, 1).data_as<int64_t>()[j] != want) fail("argmax of a transposed tensor");
+    }
+
+    bool threw = false;
+    try { max(Tensor::empty({3, 0}), 1); } catch (const std::invalid_argument&) { threw = true; }
+    if (!threw) fail("max over an empty dim must throw");
+    threw = false;
+    try { argmax(t, 2); } catch (const std::invalid_argument&) { threw = true; }
+    if (!threw) fail("argmax over a missing dim must throw");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_mean_grad() {
+    std::cout << "[TEST] mean gradient...\n";
+    Tensor x = random_tensor({4, 5});
+    x.set_requires_grad(true);
+    mean(x).backward();
+    for (size_t i = 0; i < x.numel(); i++) expect_close("d mean / dx", x.get_grad() -> data_ptr()[i], 1.0 / 20, 1e-6);
+    std::cout << "  -> Passed.\n";
+}
+
+void bench() {
+    std::cout << "\n[BENCH] reductions per instruction set (us per call)\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    size_t n = 1 << 24, BT = 1024, C = 768, R = 64, V = 50257;
+    Tensor x = random_tensor({(int)n});
+    std::vector<float> out(V);
+    std::vector<int64_t> idx(R);
+    float s;
+
+    // what sum_f32 / sum_dim_f32 used to do
+    double t_naive_sum = time_us([&] {
+        float acc = 0.0f;
+        for (size_t i = 0; i < n; i++) acc = acc + x.data_ptr()[i];
+        s = acc;
+    }, 5);
+    double t_naive_dim = time_us([&] {
+        for (size_t i = 0; i < C; i++) out[i] = 0.0f;
+        for (size_t d = 0; d < BT; d++) {
+            for (size_t i = 0; i < C; i++) out[i] += x.data_ptr()[d * C + i];
+        }
+    }, 50);
+    std::cout << "  one accumulator: sum 16M " << std::fixed << std::setprecision(1) << t_naive_sum
+              << ", sum (1024, 768) over dim 0 " << t_naive_dim << "\n";
+
+    std::cout << std::setw(8) << "" << std::setw(12) << "sum 16M" << std::setw(22) << "(1024,768) dim 0" << std::setw(22) << "(1024,768) dim 1"
+              << std::setw(22) << "argmax (64,50257)" << "\n";
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        double t_sum = time_us([&] { cpu::sum_f32(n, x.data_ptr(), &s); }, 10);
+        double t_cols = time_us([&] { cpu::sum_dim_f32(1, BT, C, x.data_ptr(), out.data()); }, 100);
+        double t_rows = time_us([&] { cpu::sum_dim_f32(BT, C, 1, x.data_ptr(), out.data()); }, 100);
+        double t_arg = time_us([&] { cpu::max_dim_f32(R, V, 1, x.data_ptr(), out.data(), idx.data()); }, 20);
+        std::cout << std::setw(8) << cpu::cpu_isa_name(isa) << std::setw(12) << t_sum << std::setw(22) << t_cols << std::setw(22) << t_rows
+                  << std::setw(22) << t_arg << "\n";
+    }
+    cpu::set_cpu_isa(start);
+}
+
+int main() {
+    test_sum_accuracy();
+    test_layouts();
+    test_mean_grad();
+    bench();
+    return 0;
+}
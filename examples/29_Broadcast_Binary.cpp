@@ -0,0 +1,175 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/kernels.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+// add / sub / mul / div on broadcast and strided operands: every pattern against a reference on
+// each instruction set, and the iterator against the old recursive std::function walk.
+
+using namespace axon;
+namespace cpu = kernels::cpu;
+
+Tensor nonzero_tensor(const std::vector<int>& shape) {
+    Tensor t = Tensor::empty(shape);
+    // away from 0 so div stays well conditioned
+    for (size_t i = 0; i < t.numel(); i++) {
+        float v = rand_float();
+        t.data_ptr()[i] = v + (v >= 0.0f ? 0.5f : -0.5f);
+    }
+    return t;
+}
+
+// element j (row-major in `shape`) of x broadcast to `shape`, read straight from a contiguous copy
+float broadcast_at(const Tensor& xc, const std::vector<int>& shape, size_t j) {
+    const auto& xs = xc.get_shape();
+    size_t lead = shape.size() - xs.size(), off = 0, step = 1;
+    for (size_t d = shape.size(); d-- > 0;) {
+        size_t i = j % shape[d];
+        j /= shape[d];
+        if (d < lead) continue;
+        size_t n = xs[d - lead];
+        if (n != 1) off += i * step;
+        step *= n;
+    }
+    return xc.data_ptr()[off];
+}
+
+struct Case {
+    std::string name;
+    Tensor a, b;
+};
+
+std::vector<Case> cases() {
+    srand(5);
+    std::vector<Case> out;
+    out.push_back({"bias row (4,33,70)+(70)", nonzero_tensor({4, 33, 70}), nonzero_tensor({70})});
+    out.push_back({"column (37,19)+(37,1)", nonzero_tensor({37, 19}), nonzero_tensor({37, 1})});
+    out.push_back({"scalar (1001)+(1)", nonzero_tensor({1001}), nonzero_tensor({1})});
+    out.push_back({"scalar first (1)+(3,67)", nonzero_tensor({1}), nonzero_tensor({3, 67})});
+    out.push_back({"outer (29,1)+(1,31)", nonzero_tensor({29, 1}), nonzero_tensor({1, 31})});
+    out.push_back({"transposed (45,23)^T+(23,45)", transpose(nonzero_tensor({45, 23}), 0, 1), nonzero_tensor({23, 45})});
+    out.push_back({"both transposed", transpose(nonzero_tensor({17, 40}), 0, 1), transpose(nonzero_tensor({17, 40}), 0, 1)});
+    out.push_back({"permuted (2,5,7,3)", permute(nonzero_tensor({3, 5, 2, 7}), {2, 1, 3, 0}), nonzero_tensor({7, 3})});
+    out.push_back({"middle broadcast (6,1,50)+(6,9,50)", nonzero_tensor({6, 1, 50}), nonzero_tensor({6, 9, 50})});
+    out.push_back({"size-1 dims (1,13,1,1)+(13,1)", nonzero_tensor({1, 13, 1, 1}), nonzero_tensor({13, 1})});
+    out.push_back({"empty (0,8)+(8)", nonzero_tensor({0, 8}), nonzero_tensor({8})});
+    out.push_back({"large bias (64,1024)+(1024)", nonzero_tensor({64, 1024}), nonzero_tensor({1024})});
+    return out;
+}
+
+void test_patterns() {
+    std::cout << "[TEST] broadcast / strided binary ops against a reference...\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    using OpFn = Tensor (*)(Tensor, Tensor);
+    OpFn ops[4] = {add, sub, mul, div};
+    float (*ref[4])(float, float) = {
+        [](float x, float y) { return x + y; },
+        [](float x, float y) { return x - y; },
+        [](float x, float y) { return x * y; },
+        [](float x, float y) { return x / y; },
+    };
+    const char* names[4] = {"add", "sub", "mul", "div"};
+
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        for (const Case& c : cases()) {
+            Tensor ac = c.a.contiguous(), bc = c.b.contiguous();
+            for (int k = 0; k < 4; k++) {
+                Tensor out = ops[k](c.a, c.b);
+                const auto& shape = out.get_shape();
+                for (size_t j = 0; j < out.numel(); j++) {
+                    float want = ref[k](broadcast_at(ac, shape, j), broadcast_at(bc, shape, j));
+                    if (std::abs(out.data_ptr()[j] - want) > 1e-5f * std::max(1.0f, std::abs(want))) {
+                        fail(std::string(cpu::cpu_isa_name(isa)) + " " + names[k] + " " + c.name + ": differs at " + std::to_string(j));
+                    }
+                }
+            }
+        }
+        std::cout << "  " << std::setw(6) << cpu::cpu_isa_name(isa) << ": " << cases().size() << " patterns x 4 ops ok\n";
+    }
+    cpu::set_cpu_isa(start);
+
+    // the gradient path reduces the broadcast back out
+    Tensor x = nonzero_tensor({3, 4}), bias = nonzero_tensor({4});
+    bias.set_requires_grad(true);
+    sum(mul(x, bias)).backward();
+    for (int i = 0; i < 4; i++) {
+        float want = 0.0f;
+        for (int r = 0; r < 3; r++) want += x.data_ptr()[r * 4 + i];
+        if (std::abs(bias.get_grad() -> data_ptr()[i] - want) > 1e-5f) fail("d sum(x * bias) / d bias");
+    }
+
+    std::cout << "  -> Passed.\n";
+}
+
+// what the strided path used to be: one std::function call per element, a recursive call per row
+void old_rec(int dim, const std::vector<int>& shape, int off_a, const std::vector<int>& sa, int off_b, const std::vector<int>& sb,
+             int off_o, const std::vector<int>& so, const float* pa, const float* pb, float* po, std::function<float(float, float)> op) {
+    if (dim == (int)shape.size() - 1) {
+        for (int i = 0; i < shape[dim]; i++) po[off_o + i * so[dim]] = op(pa[off_a + i * sa[dim]], pb[off_b + i * sb[dim]]);
+        return;
+    }
+    for (int i = 0; i < shape[dim]; i++) {
+        old_rec(dim + 1, shape, off_a + i * sa[dim], sa, off_b + i * sb[dim], sb, off_o + i * so[dim], so, pa, pb, po, op);
+    }
+}
+
+Tensor old_add(const Tensor& a, const Tensor& b) {
+    std::vector<int> shape = a.get_shape().size() >= b.get_shape().size() ? a.get_shape() : b.get_shape();
+    for (size_t d = 0; d < shape.size(); d++) {
+        size_t da = d + a.get_shape().size() - shape.size(), db = d + b.get_shape().size() - shape.size();
+        if (da < a.get_shape().size()) shape[d] = std::max(shape[d], a.get_shape()[da]);
+        if (db < b.get_shape().size()) shape[d] = std::max(shape[d], b.get_shape()[db]);
+    }
+    Tensor ae = a.expand(shape), be = b.expand(shape), out = Tensor::empty(shape);
+    old_rec(0, shape, 0, ae.get_stride(), 0, be.get_stride(), 0, out.get_stride(), ae.data_ptr(), be.data_ptr(), out.data_ptr(),
+            [](float x, float y) { return x + y; });
+    return out;
+}
+
+void bench() {
+    std::cout << "\n[BENCH] add over broadcast patterns, 4M outputs (us per call)\n";
+    srand(9);
+
+    struct Pattern {
+        std::string name;
+        Tensor a, b;
+    };
+    std::vector<Pattern> patterns = {
+        {"bias (8,512,1024)+(1024)", nonzero_tensor({8, 512, 1024}), nonzero_tensor({1024})},
+        {"column (4096,1024)+(4096,1)", nonzero_tensor({4096, 1024}), nonzero_tensor({4096, 1})},
+        {"scalar (4M)+(1)", nonzero_tensor({1 << 22}), nonzero_tensor({1})},
+        {"outer (2048,1)+(1,2048)", nonzero_tensor({2048, 1}), nonzero_tensor({1, 2048})},
+        {"transposed (2048,2048)^T", transpose(nonzero_tensor({2048, 2048}), 0, 1), nonzero_tensor({2048, 2048})},
+    };
+
+    std::cout << std::setw(30) << "" << std::setw(14) << "std::function";
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) std::cout << std::setw(10) << cpu::cpu_isa_name(isa);
+    std::cout << "\n";
+
+    cpu::CpuIsa start = cpu::cpu_isa();
+    for (const Pattern& p : patterns) {
+        std::cout << std::setw(30) << p.name << std::fixed << std::setprecision(0) << std::setw(14) << time_us([&] { old_add(p.a, p.b); }, 5);
+        for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+            cpu::set_cpu_isa(isa);
+            std::cout << std::setw(10) << time_us([&] { add(p.a, p.b); }, 10);
+        }
+        std::cout << "\n";
+    }
+    cpu::set_cpu_isa(start);
+}
+
+int main() {
+    test_patterns();
+    bench();
+    return 0;
+}
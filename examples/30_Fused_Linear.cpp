@@ -0,0 +1,145 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/kernels.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/nn.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+// linear(x, w, b, act): the GEMM epilogue against matmul + add + activation on each
+// instruction set, its gradients against the unfused graph, and the GPT-2 MLP timings.
+
+using namespace axon;
+namespace cpu = kernels::cpu;
+
+Tensor unfused(const Tensor& x, const Tensor& w, const Tensor& b, Activation act) {
+    Tensor y = add(matmul(x, w), b);
+    if (act == Activation::Relu) return relu(y);
+    if (act == Activation::Gelu) return gelu(y);
+    return y;
+}
+
+void expect_close(const std::string& what, const Tensor& got, const Tensor& want, float tol) {
+    if (got.get_shape() != want.get_shape()) fail(what + ": shape mismatch");
+    for (size_t i = 0; i < want.numel(); i++) {
+        float g = got.data_ptr()[i], w = want.data_ptr()[i];
+        if (!(std::abs(g - w) <= tol * std::max(1.0f, std::abs(w)))) {
+            fail(what + ": differs at " + std::to_string(i) + " (" + std::to_string(g) + " vs " + std::to_string(w) + ")");
+        }
+    }
+}
+
+const char* act_name(Activation act) {
+    return act == Activation::Relu ? "relu" : act == Activation::Gelu ? "gelu" : "none";
+}
+
+void test_forward() {
+    std::cout << "[TEST] linear against matmul + add + activation...\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    // edge tiles both ways, the small-M path (M <= 4), several K blocks, a 3D input
+    struct Shape {
+        std::vector<int> x;
+        int n;
+    };
+    std::vector<Shape> shapes = {{{1, 37}, 53}, {{3, 64}, 100}, {{25, 300}, 77}, {{2, 13, 96}, 129}, {{70, 600}, 40}, {{5, 0}, 19}};
+
+    NoGradGuard no_grad;
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        srand(3);
+        for (const Shape& s : shapes) {
+            int K = s.x.back();
+            Tensor x = random_tensor(s.x), w = random_tensor({K, s.n}), b = random_tensor({1, s.n});
+            // a transposed view of an (out, in) weight goes to the GEMM without a copy
+            Tensor wt = transpose(random_tensor({s.n, K}), 0, 1);
+
+            for (Activation act : {Activation::None, Activation::Relu, Activation::Gelu}) {
+                std::string at = std::string(cpu::cpu_isa_name(isa)) + " " + act_name(act) + " K=" + std::to_string(K) + " N=" + std::to_string(s.n);
+                expect_close(at, linear(x, w, b, act), unfused(x, w, b, act), 1e-4f);
+                expect_close(at + " transposed w", linear(x, wt, b, act), unfused(x, wt, b, act), 1e-4f);
+            }
+        }
+        std::cout << "  " << std::setw(6) << cpu::cpu_isa_name(isa) << ": ok\n";
+    }
+    cpu::set_cpu_isa(start);
+
+    bool threw = false;
+    try { linear(random_tensor({2, 3}), random_tensor({4, 5}), random_tensor({5})); } catch (const std::invalid_argument&) { threw = true; }
+    if (!threw) fail("an inner shape mismatch must throw");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_backward() {
+    std::cout << "[TEST] linear gradients against the unfused graph...\n";
+    srand(4);
+
+    for (Activation act : {Activation::None, Activation::Relu, Activation::Gelu}) {
+        Tensor x0 = random_tensor({2, 9, 40}), w0 = random_tensor({40, 70}), b0 = random_tensor({70}), up = random_tensor({2, 9, 70});
+
+        std::vector<Tensor> grads[2];
+        for (int fused = 0; fused < 2; fused++) {
+            Tensor x = x0.contiguous(), w = w0.contiguous(), b = b0.contiguous();
+            x.set_requires_grad(true);
+            w.set_requires_grad(true);
+            b.set_requires_grad(true);
+            Tensor y = fused ? linear(x, w, b, act) : unfused(x, w, b, act);
+            sum(mul(y, up)).backward();
+            grads[fused] = {*x.get_grad(), *w.get_grad(), *b.get_grad()};
+        }
+
+        const char* names[3] = {"dx", "dw", "db"};
+        for (int i = 0; i < 3; i++) expect_close(std::string(act_name(act)) + " " + names[i], grads[1][i], grads[0][i], 1e-4f);
+    }
+
+    // the Linear / FeedForward modules go through it by default
+    nn::FeedForward mlp(16);
+    Tensor x = random_tensor({3, 16});
+    Tensor want = mlp.c_proj.forward(gelu(add(matmul(x, mlp.c_fc.weight), mlp.c_fc.bias)));
+    expect_close("FeedForward", mlp.forward(x), want, 1e-4f);
+
+    std::cout << "  -> Passed.\n";
+}
+
+void bench() {
+    std::cout << "\n[BENCH] GPT-2 MLP c_fc, (4, 128, 768) @ (768, 3072) + bias, GELU (ms per call)\n";
+    srand(5);
+    Tensor x = random_tensor({4, 128, 768}), w = random_tensor({768, 3072}), b = random_tensor({1, 3072});
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    std::cout << std::setw(8) << "" << std::setw(16) << "unfused" << std::setw(12) << "fused" << std::setw(20) << "unfused fwd+bwd" << std::setw(16) << "fused fwd+bwd" << "\n";
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        double t_unfused, t_fused;
+        {
+            NoGradGuard no_grad;
+            t_unfused = time_ms([&] { unfused(x, w, b, Activation::Gelu); }, 5);
+            t_fused = time_ms([&] { linear(x, w, b, Activation::Gelu); }, 5);
+        }
+
+        Tensor xg = x.contiguous(), wg = w.contiguous(), bg = b.contiguous();
+        wg.set_requires_grad(true);
+        bg.set_requires_grad(true);
+        double t_unfused_train = time_ms([&] { sum(unfused(xg, wg, bg, Activation::Gelu)).backward(); }, 3);
+        double t_fused_train = time_ms([&] { sum(linear(xg, wg, bg, Activation::Gelu)).backward(); }, 3);
+
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << cpu::cpu_isa_name(isa) << std::setw(16) << t_unfused << std::setw(12) << t_fused
+                  << std::setw(20) << t_unfused_train << std::setw(16) << t_fused_train << "\n";
+    }
+    cpu::set_cpu_isa(start);
+}
+
+int main() {
+    test_forward();
+    test_backward();
+    bench();
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/kernels.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/lazy.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+// LazyGuard: recorded elementwise chains against running them op by op on each instruction set,
+// the sync points, the fused-loop dump, and GELU / LayerNorm-shaped chains timed both ways.
+// AXON_LAZY_DUMP=1 ./31_Lazy_Fusion prints every sync's loops.
+
+using namespace axon;
+namespace cpu = kernels::cpu;
+
+// uniform in [lo - 1, lo + 1]
+Tensor shifted_tensor(const std::vector<int>& shape, float lo) {
+    Tensor t = Tensor::empty(shape);
+    for (size_t i = 0; i < t.numel(); i++) t.data_ptr()[i] = lo + rand_float();
+    return t;
+}
+
+Tensor scalar(float v) {
+    Tensor t = Tensor::empty({1});
+    t.data_ptr()[0] = v;
+    return t;
+}
+
+bool pending(const Tensor& t) {
+    return t.get_storage() -> pending;
+}
+
+// 0.5 x (1 + tanh(u)), u = sqrt(2/pi) (x + 0.044715 x^3), tanh(u) = 1 - 2 / (exp(2u) + 1):
+// 13 ops, 6 operands
+Tensor gelu_chain(const Tensor& x) {
+    Tensor one = scalar(1.0f), two = scalar(2.0f);
+    Tensor u = mul(scalar(0.7978845608f), add(x, mul(scalar(0.044715f), mul(x, mul(x, x)))));
+    Tensor t = sub(one, div(two, add(exp(mul(two, u)), one)));
+    return mul(mul(scalar(0.5f), x), add(one, t));
+}
+
+// the elementwise half of a LayerNorm: mean and variance come in as (..., 1)
+Tensor layernorm_chain(const Tensor& x, const Tensor& mu, const Tensor& var, const Tensor& gamma, const Tensor& beta) {
+    Tensor rstd = div(scalar(1.0f), sqrt(add(var, scalar(1e-5f))));
+    return add(mul(mul(sub(x, mu), rstd), gamma), beta);
+}
+
+struct Case {
+    std::string name;
+    std::function<std::vector<Tensor>()> run;
+};
+
+std::vector<Case> cases() {
+    srand(21);
+    Tensor x = random_tensor({3, 7, 70}), y = shifted_tensor({3, 7, 70}, 2.0f);
+    Tensor mu = random_tensor({3, 7, 1}), var = shifted_tensor({3, 7, 1}, 1.5f), gamma = random_tensor({70}), beta = random_tensor({70});
+    Tensor xt = transpose(random_tensor({70, 21}), 0, 1);
+    Tensor big = random_tensor({1000});
+
+    return {
+        {"gelu chain", [=] { return std::vector<Tensor>{gelu_chain(x)}; }},
+        {"layernorm chain", [=] { return std::vector<Tensor>{layernorm_chain(x, mu, var, gamma, beta)}; }},
+        {"unary ops", [=] { return std::vector<Tensor>{gelu(relu(neg(exp(sqrt(y)))))}; }},
+        // d is read by two ops, and also kept
+        {"diamond, kept intermediate", [=] {
+            Tensor d = sub(x, mu);
+            return std::vector<Tensor>{d, div(mul(d, d), add(d, y))};
+        }},
+        {"transposed input", [=] { return std::vector<Tensor>{mul(add(xt, scalar(3.0f)), view(x, {21, 70}))}; }},
+        {"broadcast both ways", [=] { return std::vector<Tensor>{sub(mul(mu, gamma), exp(view(beta, {1, 1, 70})))}; }},
+        // more registers than one loop has
+        {"long chain", [=] {
+            Tensor acc = big;
+            for (int i = 0; i < 40; i++) acc = add(mul(acc, scalar(0.9f)), scalar(0.01f * i));
+            return std::vector<Tensor>{acc};
+        }},
+        {"empty", [=] { return std::vector<Tensor>{exp(add(Tensor::empty({0, 4}), scalar(1.0f)))}; }},
+    };
+}
+
+void test_against_eager() {
+    std::cout << "[TEST] recorded chains against eager execution...\n";
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        for (const Case& c : cases()) {
+            std::vector<Tensor> want = c.run();
+            std::vector<Tensor> got = [&] {
+                LazyGuard lazy;
+                auto out = c.run();
+                if (!pending(out.back())) fail(c.name + ": not recorded");
+                return out;
+            }();
+            for (size_t i = 0; i < want.size(); i++) {
+                if (pending(got[i])) fail(c.name + ": still pending after the guard");
+                expect_equal(std::string(cpu::cpu_isa_name(isa)) + " " + c.name, got[i], want[i]);
+            }
+        }
+        std::cout << "  " << std::setw(6) << cpu::cpu_isa_name(isa) << ": " << cases().size() << " chains ok\n";
+    }
+    cpu::set_cpu_isa(start);
+    std::cout << "  -> Passed.\n";
+}
+
+void test_sync_points() {
+    std::cout << "[TEST] sync points...\n";
+    srand(22);
+    Tensor x = random_tensor({4, 33}), w = random_tensor({33, 5});
+    LazyGuard lazy;
+
+    // reading the data
+    Tensor a = exp(x);
+    if (!pending(a)) fail("exp was not recorded");
+    float first = a.data_ptr()[0];
+    if (pending(a) || std::abs(first - std::exp(x.data_ptr()[0])) > 1e-6f * first) fail("data_ptr did not sync");
+
+    // an op that is not recorded reads its input
+    Tensor m = matmul(relu(x), w);
+    if (pending(m)) fail("matmul is not recorded");
+    expect_equal("matmul of a pending input", m, matmul(relu(x).contiguous(), w));
+
+    // a view of a pending tensor is read through memory
+    Tensor b = neg(x);
+    Tensor c = add(transpose(b, 0, 1), scalar(1.0f));
+    if (pending(b) || !pending(c)) fail("a transposed pending input must sync first");
+
+    // gradients: runs now, and builds the graph
+    Tensor p = random_tensor({4, 33});
+    p.set_requires_grad(true);
+    Tensor q = mul(p, x);
+    if (pending(q) || !q.get_grad_fn()) fail("an op needing a gradient must run eagerly");
+
+    // nested guards sync at the outermost
+    Tensor d = x;
+    {
+        LazyGuard inner;
+        d = sqrt(exp(x));
+    }
+    if (!pending(d)) fail("the inner guard synced");
+    lazy::sync();
+    if (pending(d)) fail("lazy::sync left it pending");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_dump() {
+    std::cout << "[TEST] fused loop dump...\n";
+    srand(23);
+    Tensor x = random_tensor({2, 5, 64}), mu = random_tensor({2, 5, 1}), var = shifted_tensor({2, 5, 1}, 1.5f);
+    Tensor gamma = random_tensor({64}), beta = random_tensor({64});
+
+    LazyGuard lazy;
+    Tensor y = layernorm_chain(x, mu, var, gamma, beta);
+    std::string dump = lazy::describe();
+    std::cout << dump;
+    // rstd over (2, 5, 1) is one loop, the normalize over (2, 5, 64) the other; only y is written
+    if (dump.find("2 fused loops, 2 outputs written") == std::string::npos) fail("unexpected grouping");
+    lazy::sync();
+    std::cout << "  -> Passed.\n";
+}
+
+void bench() {
+    std::cout << "\n[BENCH] (8, 512, 768) chains, eager vs recorded (ms per call)\n";
+    srand(24);
+    std::vector<int> shape = {8, 512, 768};
+    Tensor x = random_tensor(shape), mu = random_tensor({8, 512, 1}), var = shifted_tensor({8, 512, 1}, 1.5f);
+    Tensor gamma = random_tensor({768}), beta = random_tensor({768});
+    NoGradGuard no_grad;
+    cpu::CpuIsa start = cpu::cpu_isa();
+
+    std::cout << std::setw(8) << "" << std::setw(14) << "gelu eager" << std::setw(14) << "gelu fused" << std::setw(12) << "gelu op"
+              << std::setw(12) << "ln eager" << std::setw(12) << "ln fused" << "\n";
+    for (cpu::CpuIsa isa : cpu::supported_cpu_isas()) {
+        cpu::set_cpu_isa(isa);
+        double t_gelu = time_ms([&] { gelu_chain(x); }, 3);
+        double t_gelu_fused = time_ms([&] { LazyGuard lazy; Tensor y = gelu_chain(x); lazy::sync(); }, 3);
+        double t_gelu_op = time_ms([&] { gelu(x); }, 3);
+        double t_ln = time_ms([&] { layernorm_chain(x, mu, var, gamma, beta); }, 3);
+        double t_ln_fused = time_ms([&] { LazyGuard lazy; Tensor y = layernorm_chain(x, mu, var, gamma, beta); lazy::sync(); }, 3);
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << cpu::cpu_isa_name(isa) << std::setw(14) << t_gelu << std::setw(14) << t_gelu_fused
+                  << std::setw(12) << t_gelu_op << std::setw(12) << t_ln << std::setw(12) << t_ln_fused << "\n";
+    }
+    cpu::set_cpu_isa(start);
+}
+
+int main() {
+    test_against_eager();
+    test_sync_points();
+    test_dump();
+    bench();
+    return 0;
+}
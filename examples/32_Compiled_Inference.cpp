@@ -0,0 +1,198 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/nn.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/allocator.hpp"
+#include "axon/compile.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+// compile(module, example): replayed plans against eager forward() on every recorded op, what
+// the trace refuses, and GPT-2 small latency / peak memory / allocations, eager vs compiled.
+// AXON_COMPILE_DUMP=1 prints the GPT-2 plan.
+
+using namespace axon;
+
+// every recorded op at least once, with views, broadcasts and a strided copy in between
+struct Mixer : public nn::Module {
+    nn::Embedding emb;
+    nn::LayerNorm ln;
+    nn::Linear proj, q8, half;
+    Tensor eps;
+
+    Mixer() : emb(50, 32), ln(32), proj(32, 32), q8(32, 32), half(32, 32), eps(Tensor::ones({1})) {
+        fill_random(emb.weight);
+        q8.quantize();
+        half.cast_weights(DType::BFloat16);
+    }
+
+    Tensor forward(Tensor idx) override {
+        int B = idx.get_shape()[0];
+        int T = idx.get_shape()[1];
+
+        Tensor x = emb.forward(idx);
+        Tensor h = proj.forward(ln.forward(x), Activation::Relu);
+        Tensor att = softmax(matmul(h, transpose(h, 1, 2)));
+        Tensor y = add(matmul(att, x), q8.forward(x));
+        y = half.forward(y, Activation::Gelu);
+
+        // (B, 32, T) copy, then elementwise over a broadcast mean
+        Tensor z = view(permute(y, {0, 2, 1}), {B, 32 * T});
+        Tensor mu = div(matmul(z, Tensor::ones({32 * T, 1})), eps);
+        z = div(exp(neg(sub(z, mu))), sqrt(add(mul(z, z), eps)));
+
+        // host-built ids are a constant of the plan
+        Tensor pos = Tensor::empty({T}, DType::Int32);
+        for (int i = 0; i < T; i++) pos.data_as<int32_t>()[i] = i;
+        return add(view(z, {B, 32, T}), view(emb.forward(pos), {1, 32, T}));
+    }
+
+    std::vector<Tensor> parameters() override {
+        std::vector<Tensor> params;
+        for (nn::Module* m : std::vector<nn::Module*>{&emb, &ln, &proj, &q8, &half}) {
+            for (Tensor& p : m -> parameters()) params.push_back(p);
+        }
+        return params;
+    }
+};
+
+// sum is not recorded
+struct Unsupported : public nn::Module {
+    Tensor forward(Tensor x) override {
+        return mul(x, sum(x));
+    }
+    std::vector<Tensor> parameters() override { return {}; }
+};
+
+// ...but on constants it runs once, while tracing, as does the div: only the mul is replayed
+struct Folded : public nn::Module {
+    Tensor w = random_tensor({16});
+    Tensor forward(Tensor x) override {
+        return mul(x, div(w, sum(w)));
+    }
+    std::vector<Tensor> parameters() override { return {w}; }
+};
+
+// a recorded op on constants has its result while tracing, so sum can read it
+struct FoldedChain : public nn::Module {
+    Tensor w = random_tensor({16});
+    Tensor forward(Tensor x) override {
+        return add(x, sum(mul(w, w)));
+    }
+    std::vector<Tensor> parameters() override { return {w}; }
+};
+
+void test_against_eager() {
+    std::cout << "[TEST] compiled plans against eager forward()...\n";
+    srand(31);
+
+    Mixer mixer;
+    nn::Block block(64, 4);
+    nn::FeedForward mlp(48);
+
+    struct Case {
+        std::string name;
+        nn::Module& module;
+        std::vector<Tensor> inputs;
+    };
+    std::vector<Case> cases = {
+        {"mixer", mixer, {random_ids({2, 7}, 50), random_ids({2, 7}, 50), random_ids({2, 7}, 50)}},
+        {"block", block, {random_tensor({3, 11, 64}), random_tensor({3, 11, 64})}},
+        {"mlp", mlp, {random_tensor({5, 48}), random_tensor({5, 48})}},
+    };
+
+    InferenceModeGuard inference;
+    for (Case& c : cases) {
+        CompiledModule plan = compile(c.module, c.inputs[0]);
+        // different values through the same arena
+        for (size_t i = 0; i < c.inputs.size(); i++) {
+            Tensor got = plan.run(c.inputs[i]);
+            expect_equal(c.name + " input " + std::to_string(i), got, c.module.forward(c.inputs[i]));
+        }
+        std::cout << "  " << std::setw(6) << c.name << ": " << plan.num_steps() << " steps, arena " << plan.arena_bytes() << " bytes\n";
+    }
+
+    // the shape is part of the plan
+    CompiledModule plan = compile(block, random_tensor({1, 4, 64}));
+    bool threw = false;
+    try { plan.run(random_tensor({1, 5, 64})); } catch (const std::invalid_argument&) { threw = true; }
+    if (!threw) fail("a different shape must throw");
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_trace_rules() {
+    std::cout << "[TEST] what the trace records, folds and refuses...\n";
+    srand(32);
+
+    Unsupported unsupported;
+    bool threw = false;
+    try { compile(unsupported, random_tensor({16})); } catch (const std::runtime_error&) { threw = true; }
+    if (!threw) fail("an unrecorded op on a traced value must throw");
+
+    Folded folded;
+    CompiledModule plan = compile(folded, random_tensor({16}));
+    if (plan.num_steps() != 1) fail("the sum and div should be folded, got " + std::to_string(plan.num_steps()) + " steps");
+    Tensor x = random_tensor({16});
+    expect_equal("folded", plan.run(x), folded.forward(x));
+
+    FoldedChain chain;
+    plan = compile(chain, random_tensor({16}));
+    if (plan.num_steps() != 1) fail("the mul and sum should be folded, got " + std::to_string(plan.num_steps()) + " steps");
+    expect_equal("folded chain", plan.run(x), chain.forward(x));
+
+    std::cout << "  -> Passed.\n";
+}
+
+size_t allocations() {
+    AllocatorStats s = CachingCPUAllocator::instance().stats();
+    return s.system_allocs + s.cache_hits;
+}
+
+void bench() {
+    std::cout << "\n[BENCH] GPT-2 small, random weights, eager forward() vs compiled run()\n";
+    srand(33);
+    nn::GPT2 model;
+    fill_random(model.wte.weight, 0.02f);
+    fill_random(model.wpe.weight, 0.02f);
+    InferenceModeGuard inference;
+    CachingCPUAllocator& alloc = CachingCPUAllocator::instance();
+
+    std::cout << std::setw(10) << "(B, T)" << std::setw(12) << "eager ms" << std::setw(12) << "run ms" << std::setw(16) << "eager peak MB"
+              << std::setw(12) << "arena MB" << std::setw(14) << "eager allocs" << std::setw(12) << "run allocs" << "\n";
+    for (auto [B, T] : std::vector<std::pair<int, int>>{{1, 16}, {1, 128}, {4, 64}}) {
+        Tensor idx = random_ids({B, T}, 50257);
+        CompiledModule plan = compile(model, idx);
+        if (B == 1 && T == 16 && std::getenv("AXON_COMPILE_DUMP")) std::cout << plan.describe();
+        expect_equal("GPT-2", plan.run(idx), model.forward(idx));
+
+        alloc.reset_peak_stats();
+        size_t base = alloc.stats().allocated_bytes, a0 = allocations();
+        model.forward(idx);
+        size_t eager_peak = alloc.stats().peak_allocated_bytes - base, eager_allocs = allocations() - a0;
+
+        a0 = allocations();
+        plan.run(idx);
+        size_t run_allocs = allocations() - a0;
+
+        double t_eager = time_ms([&] { model.forward(idx); }, 3);
+        double t_run = time_ms([&] { plan.run(idx); }, 3);
+        std::string bt = "(" + std::to_string(B) + ", " + std::to_string(T) + ")";
+        std::cout << std::fixed << std::setprecision(1) << std::setw(10) << bt << std::setw(12) << t_eager << std::setw(12) << t_run
+                  << std::setw(16) << eager_peak / 1048576.0 << std::setw(12) << plan.arena_bytes() / 1048576.0
+                  << std::setw(14) << eager_allocs << std::setw(12) << run_allocs << "\n";
+    }
+}
+
+int main() {
+    test_against_eager();
+    test_trace_rules();
+    bench();
+    return 0;
+}
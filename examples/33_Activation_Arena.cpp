@@ -0,0 +1,289 @@
+#include "axon/tensor.hpp"
+#include "axon/ops.hpp"
+#include "axon/nn.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/allocator.hpp"
+#include "axon/lazy.hpp"
+#include "axon/compile.hpp"
+#include "common.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ArenaScope: stack reuse, out-of-order frees, tensors escaping the scope, nesting; the in-place
+// ops against their out-of-place versions (b overlapping a included), what they refuse, and how
+// they trace; GPT-2 inside an arena against eager, and the peak RSS of a 1024-token forward both
+// ways (each in its own process, so the high watermarks don't mix).
+
+using namespace axon;
+
+const void* address(const Tensor& t) {
+    return t.get_storage() -> data;
+}
+
+void test_arena() {
+    std::cout << "[TEST] ArenaScope allocation...\n";
+
+    {
+        ArenaScope arena;
+        {
+            Tensor a = Tensor::empty({1000});
+            const void* b_addr;
+            {
+                Tensor b = Tensor::empty({1000});
+                b_addr = address(b);
+                if (b_addr <= address(a)) fail("blocks must stack upwards");
+            }
+            // b was the top block: the next one takes its place
+            Tensor c = Tensor::empty({10, 100});
+            if (address(c) != b_addr) fail("the freed top block was not reused");
+
+            // a's block is under c's: a hole until c goes too
+            size_t used = arena.used_bytes();
+            a = c;
+            if (arena.used_bytes() != used) fail("a block under a live one was reclaimed");
+        }
+        if (arena.used_bytes() != 0) fail("the stack did not unwind, " + std::to_string(arena.used_bytes()) + " bytes used");
+        if (arena.peak_bytes() != 2 * 4032) fail("unexpected peak " + std::to_string(arena.peak_bytes()));
+    }
+
+    // outliving the scope
+    Tensor kept = Tensor::empty({1});
+    {
+        ArenaScope arena;
+        Tensor tmp = Tensor::ones({4096});
+        kept = mul(tmp, tmp);
+        kept.data_ptr()[7] = 3.0f;
+    }
+    Tensor other = Tensor::zeros({4096});
+    if (kept.data_ptr()[0] != 1.0f || kept.data_ptr()[7] != 3.0f || kept.data_ptr()[4095] != 1.0f) fail("a tensor from a closed scope lost its data");
+    kept = other;
+
+    // nesting, and chunks past the first one
+    {
+        ArenaScope outer(1 << 20);
+        Tensor x = Tensor::ones({64});
+        size_t outer_used = outer.used_bytes();
+        {
+            ArenaScope inner(1 << 20);
+            std::vector<Tensor> big;
+            for (int i = 0; i < 5; i++) big.push_back(Tensor::ones({300000}));
+            Tensor y = add(big[0], big[4]);
+            if (y.data_ptr()[299999] != 2.0f || inner.reserved_bytes() < 6 * 300000 * sizeof(float)) fail("chunk growth");
+        }
+        if (outer.used_bytes() != outer_used) fail("the inner scope allocated from the outer one");
+        if (x.data_ptr()[63] != 1.0f) fail("the outer scope's data changed");
+    }
+
+    std::cout << "  -> Passed.\n";
+}
+
+// sums in place stay bit for bit what the out-of-place ops give
+void test_in_place() {
+    std::cout << "[TEST] relu_ / gelu_ / add_ against relu / gelu / add...\n";
+    srand(41);
+    Tensor base = random_tensor({6, 37});
+    Tensor base_t = random_tensor({37, 6});
+    Tensor bias = random_tensor({37});
+    Tensor zero = Tensor::zeros({1});
+
+    {
+        // a gradient is being recorded for them
+        Tensor p = random_tensor({4});
+        p.set_requires_grad(true);
+        expect_throw("relu_ of a tensor that requires grad", [&] { relu_(p); });
+        expect_throw("add_ of a tensor that requires grad", [&] { add_(Tensor::ones({4}), p); });
+        if (can_modify_in_place(Tensor::ones({4}))) fail("can_modify_in_place with grad mode on");
+    }
+
+    NoGradGuard no_grad;
+    // fresh copies: contiguous, and transposed
+    std::vector<std::pair<std::string, std::function<Tensor()>>> makers = {
+        {"contiguous", [&] { return add(base, zero); }},
+        {"transposed", [&] { return transpose(add(base_t, zero), 0, 1); }},
+    };
+    for (auto& [name, make] : makers) {
+        Tensor a = make();
+        Tensor r = relu_(a);
+        if (address(r) != address(a)) fail("relu_ must return a");
+        expect_equal(name + " relu_", a, relu(make()));
+        expect_equal(name + " gelu_", gelu_(make()), gelu(make()));
+        expect_equal(name + " add_ broadcast", add_(make(), bias), add(make(), bias));
+        expect_equal(name + " add_", add_(make(), make()), add(make(), make()));
+    }
+
+    // b another view of a's storage: shifted either way, and transposed
+    {
+        Tensor x = add(base, zero);
+        auto window = [&](int offset) { return Tensor::from_storage(x.get_storage(), {5, 37}, {37, 1}, offset); };
+        for (auto [a_off, b_off] : {std::pair<int, int>{37, 0}, {0, 37}}) {
+            Tensor want = add(window(a_off).contiguous(), window(b_off).contiguous());
+            add_(window(a_off), window(b_off));
+            expect_equal("add_ of overlapping views at " + std::to_string(a_off) + " / " + std::to_string(b_off), window(a_off), want);
+        }
+        Tensor m = random_tensor({37, 37});
+        Tensor want = add(m, transpose(m, 0, 1));
+        expect_equal("add_ of a's transpose", add_(m, transpose(m, 0, 1)), want);
+    }
+
+    expect_throw("add_ that would broadcast a", [] { add_(Tensor::ones({3, 1}), Tensor::ones({3, 4})); });
+    expect_throw("relu_ of an expanded tensor", [] { relu_(Tensor::ones({1, 4}).expand({3, 4})); });
+
+    Tensor fresh = random_tensor({8});
+    if (!can_modify_in_place(fresh)) fail("a fresh tensor can be modified in place");
+    {
+        Tensor v = view(fresh, {2, 4});
+        if (can_modify_in_place(fresh)) fail("a view shares it");
+    }
+    {
+        LazyGuard lazy;
+        if (can_modify_in_place(fresh)) fail("not under LazyGuard");
+
+        // a recorded op reads a: it runs before add_ overwrites a
+        Tensor a = add(base, zero);
+        lazy::sync();
+        Tensor y = exp(a);
+        add_(a, bias);
+        expect_equal("exp recorded before add_", y, exp(add(base, zero)));
+        expect_equal("add_ under LazyGuard", a, add(base, bias));
+    }
+
+    std::cout << "  -> Passed.\n";
+}
+
+// relu_ on a traced value is a step; on a constant it runs once, while tracing
+struct InPlace : public nn::Module {
+    Tensor w = random_tensor({4, 16});
+    Tensor forward(Tensor x) override {
+        Tensor h = relu_(add(x, x));
+        Tensor c = relu_(sum(w, 0, true));
+        return gelu_(add_(h, c));
+    }
+    std::vector<Tensor> parameters() override { return {w}; }
+};
+
+// ...but a traced value can't be added into a constant
+struct IntoConstant : public nn::Module {
+    Tensor w = random_tensor({4, 16});
+    Tensor forward(Tensor x) override {
+        return add_(sum(w, 0, true), x);
+    }
+    std::vector<Tensor> parameters() override { return {w}; }
+};
+
+void test_traced() {
+    std::cout << "[TEST] in-place ops under compile()...\n";
+    srand(42);
+    InferenceModeGuard inference;
+
+    InPlace in_place;
+    CompiledModule plan = compile(in_place, random_tensor({4, 16}));
+    if (plan.num_steps() != 4) fail("expected add, relu_, add_, gelu_, got " + std::to_string(plan.num_steps()) + " steps");
+    for (int i = 0; i < 3; i++) {
+        Tensor x = random_tensor({4, 16});
+        expect_equal("in-place plan", plan.run(x), in_place.forward(x));
+    }
+
+    IntoConstant into_constant;
+    expect_throw("add_ of a traced value into a constant", [&] { compile(into_constant, random_tensor({1, 16})); });
+
+    std::cout << "  -> Passed.\n";
+}
+
+void test_gpt2() {
+    std::cout << "[TEST] GPT-2 in an ArenaScope against eager...\n";
+    srand(43);
+    nn::GPT2 model;
+    fill_random(model.wte.weight, 0.02f);
+    fill_random(model.wpe.weight, 0.02f);
+    InferenceModeGuard inference;
+
+    Tensor idx = random_ids({2, 24}, 50257);
+    Tensor want = model.forward(idx);
+    {
+        ArenaScope arena;
+        expect_equal("forward", model.forward(idx), want);
+
+        // the prompt through the KV cache path too
+        nn::KVCache cache = model.make_cache(2, 32);
+        expect_equal("forward_step", model.forward_step(idx, cache, 0), want);
+        std::cout << "  arena peak " << std::fixed << std::setprecision(2) << arena.peak_bytes() / 1048576.0 << " MB\n";
+    }
+
+    std::cout << "  -> Passed.\n";
+}
+
+// from /proc/self/status, in kB
+size_t status_kb(const std::string& key) {
+    std::ifstream f("/proc/self/status");
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.rfind(key, 0) == 0) return std::stoull(line.substr(key.size()));
+    }
+    return 0;
+}
+
+void forward_once(bool use_arena, int T) {
+    srand(44);
+    nn::GPT2 model;
+    fill_random(model.wte.weight, 0.02f);
+    fill_random(model.wpe.weight, 0.02f);
+    InferenceModeGuard inference;
+    Tensor idx = random_ids({1, T}, 50257);
+
+    CachingCPUAllocator& alloc = CachingCPUAllocator::instance();
+    alloc.reset_peak_stats();
+    size_t rss = status_kb("VmRSS:"), base = alloc.stats().allocated_bytes, activations;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (use_arena) {
+        ArenaScope arena;
+        Tensor logits = model.forward(idx);
+        activations = arena.peak_bytes();
+    } else {
+        Tensor logits = model.forward(idx);
+        activations = alloc.stats().peak_allocated_bytes - base;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    size_t peak = status_kb("VmHWM:");
+    std::cout << std::fixed << std::setprecision(1) << std::setw(10) << (use_arena ? "arena" : "eager") << std::setw(12) << ms
+              << std::setw(14) << rss / 1024.0 << std::setw(14) << peak / 1024.0 << std::setw(14) << (peak - rss) / 1024.0
+              << std::setw(18) << activations / 1048576.0 << "\n";
+}
+
+void bench() {
+    int T = 1024;
+    std::cout << "\n[BENCH] GPT-2 small, one (1, " << T << ") forward per process, random weights\n";
+    std::cout << std::setw(10) << "" << std::setw(12) << "ms" << std::setw(14) << "RSS before" << std::setw(14) << "peak RSS"
+              << std::setw(14) << "forward MB" << std::setw(18) << "activations MB" << "\n";
+    for (bool use_arena : {false, true}) {
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            forward_once(use_arena, T);
+            std::cout.flush();
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) fail("the forward process failed");
+    }
+}
+
+int main() {
+    test_arena();
+    test_in_place();
+    test_traced();
+    test_gpt2();
+    bench();
+    return 0;
+}
@@ -138,11 +138,134 @@ void test_batch_autograd() {
     std::cout << "  -> Autograd Passed.\n";
 }
 
+void test_strided_operands() {
+    std::cout << "[TEST] Strided / Transposed Operands (attention layout)...\n";
+
+    // x: (B=2, T=5, C=12) viewed as (B, T, H=3, D=4) and split into heads,
+    // exactly like MultiHeadAttention: q = (B, H, T, D), k_t = (B, H, D, T)
+    int B = 2, T = 5, H = 3, D = 4;
+    Tensor x = Tensor::zeros({B, T, H * D});
+    for (size_t i = 0; i < x.numel(); i++) {
+        x.data_ptr()[i] = (float)((i * 7) % 13) - 6.0f;
+    }
+
+    Tensor q = axon::transpose(axon::view(x, {B, T, H, D}), 1, 2);
+    Tensor k_t = axon::transpose(q, 2, 3);
+
+    Tensor scores = axon::matmul(q, k_t);
+
+    for (int b = 0; b < B; b++) {
+        for (int h = 0; h < H; h++) {
+            for (int i = 0; i < T; i++) {
+                for (int j = 0; j < T; j++) {
+                    float ref = 0.0f;
+                    for (int d = 0; d < D; d++) {
+                        ref += q.at({b, h, i, d}) * q.at({b, h, j, d});
+                    }
+                    if (std::abs(scores.at({b, h, i, j}) - ref) > 1e-4f) {
+                        std::cerr << "Strided matmul mismatch at (" << b << "," << h << "," << i << "," << j << ")\n";
+                        exit(1);
+                    }
+                }
+            }
+        }
+    }
+
+    // broadcast a 2D weight against a batched, transposed left operand
+    Tensor W = Tensor::zeros({T, 3});
+    for (size_t i = 0; i < W.numel(); i++) W.data_ptr()[i] = (float)i * 0.5f;
+    Tensor xt = axon::transpose(x, 1, 2); // (B, C, T), column-major matrices
+    Tensor y = axon::matmul(xt, W);        // (B, C, 3)
+
+    for (int b = 0; b < B; b++) {
+        for (int c = 0; c < H * D; c++) {
+            for (int n = 0; n < 3; n++) {
+                float ref = 0.0f;
+                for (int t = 0; t < T; t++) {
+                    ref += xt.at({b, c, t}) * W.at({t, n});
+                }
+                assert(std::abs(y.at({b, c, n}) - ref) < 1e-4f);
+            }
+        }
+    }
+
+    std::cout << "  -> Strided Operands Passed.\n";
+}
+
+void test_broadcast_weight_grad() {
+    std::cout << "[TEST] Broadcast 2D Operand Gradients (batch reduced in GEMM)...\n";
+
+    // Linear-style: x (B, T, K) @ W (K, N). With loss = sum(y),
+    // dL/dW[k, n] = sum over (b, t) of x[b, t, k] and dL/dx[b, t, k] = sum_n W[k, n]
+    int B = 3, T = 4, K = 5, N = 2;
+    Tensor x = Tensor::zeros({B, T, K});
+    Tensor W = Tensor::zeros({K, N});
+    for (size_t i = 0; i < x.numel(); i++) x.data_ptr()[i] = (float)((i * 5) % 11) - 5.0f;
+    for (size_t i = 0; i < W.numel(); i++) W.data_ptr()[i] = (float)i - 3.0f;
+
+    // same values, but stored (B, K, T): the transposed view takes the per-batch path,
+    // the contiguous x folds into a single GEMM
+    Tensor xt = axon::transpose(axon::transpose(x, 1, 2).contiguous(), 1, 2);
+
+    x.set_requires_grad(true);
+    xt.set_requires_grad(true);
+    W.set_requires_grad(true);
+
+    for (Tensor* in : {&x, &xt}) {
+        W.zero_grad();
+        Tensor loss = axon::sum(axon::matmul(*in, W));
+        loss.backward();
+
+        Tensor gW = *W.get_grad();
+        assert(gW.get_shape().size() == 2);
+        for (int k = 0; k < K; k++) {
+            float ref = 0.0f;
+            for (int b = 0; b < B; b++) {
+                for (int t = 0; t < T; t++) ref += in -> at({b, t, k});
+            }
+            for (int n = 0; n < N; n++) {
+                if (std::abs(gW.at({k, n}) - ref) > 1e-4f) {
+                    std::cerr << "Weight grad mismatch at (" << k << "," << n << "): "
+                              << gW.at({k, n}) << " vs " << ref << "\n";
+                    exit(1);
+                }
+            }
+        }
+
+        Tensor gx = *in -> get_grad();
+        for (int k = 0; k < K; k++) {
+            assert(std::abs(gx.at({1, 2, k}) - (W.at({k, 0}) + W.at({k, 1}))) < 1e-4f);
+        }
+    }
+
+    // and the mirrored case: a 2D left operand against a batched right one
+    Tensor A = Tensor::zeros({N, T});
+    for (size_t i = 0; i < A.numel(); i++) A.data_ptr()[i] = (float)i * 0.25f;
+    A.set_requires_grad(true);
+    Tensor loss = axon::sum(axon::matmul(A, x)); // (N, T) @ (B, T, K)
+    loss.backward();
+
+    Tensor gA = *A.get_grad();
+    assert(gA.get_shape().size() == 2);
+    for (int t = 0; t < T; t++) {
+        float ref = 0.0f;
+        for (int b = 0; b < B; b++) {
+            for (int k = 0; k < K; k++) ref += x.at({b, t, k});
+        }
+        assert(std::abs(gA.at({0, t}) - ref) < 1e-4f);
+        assert(std::abs(gA.at({1, t}) - ref) < 1e-4f);
+    }
+
+    std::cout << "  -> Broadcast Gradients Passed.\n";
+}
+
 int main() {
     test_simple_batch();
     test_pointer_offset_logic();
     test_transformer_broadcast();
     test_batch_autograd();
+    test_strided_operands();
+    test_broadcast_weight_grad();
     std::cout << "---------------------------------\n";
     std::cout << "ALL BATCH MATMUL TESTS PASSED.\n";
 }
\ No newline at end of file
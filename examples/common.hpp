@@ -0,0 +1,108 @@
+#pragma once
+
+#include "axon/tensor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// What the examples share: failing a check, random data, comparing tensors, and timing.
+// Include it as "common.hpp", after the axon headers the example needs.
+
+inline void fail(const std::string& msg) {
+    std::cerr << msg << "\n";
+    exit(1);
+}
+
+// uniform in [-1, 1], from rand(): srand() makes a run repeatable
+inline float rand_float() {
+    return ((float)rand() / RAND_MAX - 0.5f) * 2.0f;
+}
+
+inline std::vector<float> random_vec(size_t n, float scale = 1.0f) {
+    std::vector<float> v(n);
+    for (float& x : v) x = rand_float() * scale;
+    return v;
+}
+
+inline void fill_random(axon::Tensor& t, float scale = 1.0f) {
+    for (size_t i = 0; i < t.numel(); i++) t.data_ptr()[i] = scale * rand_float();
+}
+
+inline axon::Tensor random_tensor(const std::vector<int>& shape) {
+    axon::Tensor t = axon::Tensor::empty(shape);
+    fill_random(t);
+    return t;
+}
+
+inline axon::Tensor random_ids(const std::vector<int>& shape, int vocab) {
+    axon::Tensor t = axon::Tensor::empty(shape, axon::DType::Int32);
+    for (size_t i = 0; i < t.numel(); i++) t.data_as<int32_t>()[i] = rand() % vocab;
+    return t;
+}
+
+// on the bits: -ffast-math lets std::isnan assume there are no NaNs
+inline bool is_nan(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, 4);
+    return (bits & 0x7FFFFFFF) > 0x7F800000;
+}
+
+// contiguous float32 tensors of the same size
+inline float max_abs_diff(const axon::Tensor& a, const axon::Tensor& b) {
+    float m = 0.0f;
+    for (size_t i = 0; i < a.numel(); i++) m = std::max(m, std::abs(a.data_ptr()[i] - b.data_ptr()[i]));
+    return m;
+}
+
+// bit for bit (a NaN matches a NaN)
+inline void expect_equal(const std::string& what, const axon::Tensor& got, const axon::Tensor& want) {
+    if (got.get_shape() != want.get_shape()) fail(what + ": shape mismatch");
+    axon::Tensor g = got.contiguous(), w = want.contiguous();
+    for (size_t i = 0; i < w.numel(); i++) {
+        if (g.data_ptr()[i] != w.data_ptr()[i] && !(is_nan(g.data_ptr()[i]) && is_nan(w.data_ptr()[i]))) {
+            fail(what + ": differs at " + std::to_string(i) + " (" + std::to_string(g.data_ptr()[i]) + " vs " + std::to_string(w.data_ptr()[i]) + ")");
+        }
+    }
+}
+
+// relative to max(1, |want|)
+inline void expect_close(const std::string& what, double got, double want, double tol) {
+    if (!(std::abs(got - want) <= tol * std::max(1.0, std::abs(want)))) {
+        fail(what + ": got " + std::to_string(got) + ", expected " + std::to_string(want));
+    }
+}
+
+template <typename Fn>
+bool throws(Fn fn) {
+    try {
+        fn();
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+template <typename Fn>
+void expect_throw(const std::string& what, Fn fn) {
+    if (!throws(fn)) fail(what + " should throw");
+}
+
+// average over `rounds` calls, after one warmup call
+template <typename F>
+double time_us(F f, int rounds) {
+    f();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; r++) f();
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / rounds;
+}
+
+template <typename F>
+double time_ms(F f, int rounds) {
+    return time_us(f, rounds) / 1000.0;
+}
@@ -85,17 +85,95 @@ namespace axon {
         }
     };
 
-    inline Allocator* get_allocator(DeviceType device) {
-        static CPUAllocator cpu_alloc;
-        static CUDAAllocator cuda_alloc;
-
-        if (device == DeviceType::CPU) {
-            return &cpu_alloc;
-        } else if (device == DeviceType::CUDA) {
-            return &cuda_alloc;
-        } 
-        
-        throw std::runtime_error("[ALLOCATOR] Error: Unknown allocator");
+    struct AllocatorStats {
+        size_t allocated_bytes;      // handed out and not yet returned (rounded block sizes)
+        size_t peak_allocated_bytes; // high watermark of allocated_bytes since the last reset
+        size_t cached_bytes;         // sitting in free lists, ready for reuse
+        size_t system_allocs;        // blocks that had to come from aligned_alloc
+        size_t cache_hits;           // allocations served from a free list
+        size_t frees;
+    };
+
+    // CPU allocator that keeps freed blocks for reuse instead of returning them to the
+    // system, so steady-state forward passes stop paying for malloc/munmap and page faults.
+    //
+    // Sizes round up to a power of two up to 1MB and to quarter steps of a power of two
+    // above that. Small blocks go through a per-thread cache first, everything else (and
+    // the per-thread overflow) through a shared pool. Once the cached bytes, per-thread
+    // caches included, would exceed the limit (AXON_CPU_CACHE_LIMIT_MB, default 1024) freed
+    // blocks go straight back to the system.
+    class CachingCPUAllocator : public Allocator {
+    public:
+        static constexpr size_t ALIGNMENT = 64;
+
+        static CachingCPUAllocator& instance();
+
+        void* allocate(size_t nbytes) override;
+        void deallocate(void* ptr) override;
+
+        void set_zero(void* ptr, size_t nbytes) override {
+            std::memset(ptr, 0, nbytes);
+        }
+
+        // frees the shared pool and the calling thread's cache
+        // (other threads' caches are small and drain when those threads exit)
+        void empty_cache();
+
+        AllocatorStats stats() const;
+        void reset_peak_stats();
+        // also frees cached blocks (the shared pool's, then this thread's) down to the new limit
+        void set_cache_limit(size_t bytes);
+
+    private:
+        CachingCPUAllocator() = default;
+    };
+
+    // Scoped activation memory for inference. While an ArenaScope is alive, new CPU Storage
+    // created on this thread is carved out of large mmapped chunks by bumping a pointer.
+    // Freeing the newest block moves the pointer back; a block freed out of order is reclaimed
+    // once everything above it is gone. So a forward pass whose temporaries die at the end of
+    // each layer reuses the same bytes layer after layer, with no free lists or size classes.
+    // The chunks are unmapped when the scope closes. A tensor that outlives the scope keeps its
+    // chunk mapped until it is freed (contiguous() a copy outside the scope to avoid that).
+    //
+    //   InferenceModeGuard inference;
+    //   ArenaScope arena;
+    //   Tensor logits = model.forward(idx);
+    //
+    // Scopes nest; the innermost one serves the allocations.
+    class ArenaScope {
+    public:
+        // chunks are reserved, not touched: only the pages actually used count towards RSS
+        static constexpr size_t DEFAULT_CHUNK_BYTES = size_t(256) << 20;
+
+        explicit ArenaScope(size_t chunk_bytes = DEFAULT_CHUNK_BYTES);
+        ~ArenaScope();
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator= (const ArenaScope&) = delete;
+
+        size_t used_bytes() const;     // from the bottom of the stack to the top, holes included
+        size_t peak_bytes() const;     // high watermark of used_bytes
+        size_t reserved_bytes() const; // mapped chunks
+
+        struct Arena;
+
+    private:
+        Arena* arena;
+        Arena* prev;
+    };
+
+    // Allocator used for new Storage on `device`. The CPU default is the caching
+    // allocator (AXON_CPU_ALLOCATOR=system switches to plain aligned_alloc), or the
+    // calling thread's innermost ArenaScope.
+    Allocator* get_allocator(DeviceType device);
+
+    // Plug in a different allocator (nullptr restores the default). Existing Storage
+    // keeps the allocator it was created with, so swapping at runtime is safe.
+    void set_allocator(DeviceType device, Allocator* allocator);
+
+    inline void empty_cache() {
+        CachingCPUAllocator::instance().empty_cache();
     }
 
 } // namespace axon
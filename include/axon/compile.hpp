@@ -0,0 +1,92 @@
+#pragma once
+
+#include "tensor.hpp"
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace axon {
+    namespace nn {
+        struct Module;
+    }
+
+    // Fixed-shape inference plans. compile() runs module.forward once without computing
+    // anything: the ops only work out their output shapes and keep their kernel calls. The
+    // intermediates are then packed into one arena by liveness (two values share bytes when
+    // no step needs both), and run() replays the kernel calls in order: no shape or broadcast
+    // logic, no tensor allocations.
+    //
+    //   CompiledModule plan = compile(model, Tensor::empty({1, 128}, DType::Int32));
+    //   Tensor logits = plan.run(idx);   // idx must be (1, 128) int32, like the example
+    //
+    // Recorded: the elementwise ops, linear, matmul, quantized_matmul, embedding,
+    // quantized_embedding, layer_norm, softmax, scaled_dot_product_attention and
+    // contiguous(); views are free. A recorded op none of whose inputs is traced (only parameters
+    // or host-built tensors like GPT2's position ids) runs once while tracing instead, and so can
+    // any other op on its result. Any other op that reads a traced value throws. CPU only, no
+    // autograd. The steps read the weights at every run(), so changes to them after compile()
+    // are seen, but values computed from constants alone keep what they had at compile().
+    class CompiledModule {
+    public:
+        // Copies `input` into the plan and runs it. The result lives in the arena: the
+        // returned tensor is the same one every call, overwritten by the next run()
+        // (contiguous() it to keep it). One run() at a time.
+        Tensor run(const Tensor& input);
+
+        size_t arena_bytes() const;
+        size_t num_steps() const;
+
+        // the steps and where their outputs sit in the arena, for debugging
+        std::string describe() const;
+
+        struct Plan;
+
+    private:
+        std::shared_ptr<Plan> plan;
+        friend CompiledModule compile(nn::Module& module, const Tensor& example_input);
+    };
+
+    // Traces module.forward(example_input) into a plan for inputs of exactly that shape and dtype
+    // (the example's values are not used).
+    CompiledModule compile(nn::Module& module, const Tensor& example_input);
+
+    // what the ops use while compile() traces
+    namespace trace {
+        bool is_active();
+
+        // an op's output with no memory yet: its place in the arena is decided after the trace
+        Tensor output(const std::vector<int>& shape, DType dtype = DType::Float32);
+
+        // keeps `fn` (the op's kernel calls) for replay; `reads` / `writes` are the tensors it
+        // touches, for the liveness of their buffers. With no traced value among `reads`, runs
+        // `fn` now on real outputs instead
+        void record(const char* op, std::initializer_list<const Tensor*> reads, std::initializer_list<const Tensor*> writes, std::function<void()> fn);
+
+        // what reading a traced value's data does: throws
+        [[noreturn]] void read_traced();
+
+        // a tensor's first element, looked up when the kernel runs: recorded kernel calls
+        // hold these, as the intermediates only get their memory after the trace
+        struct DataRef {
+            Storage* storage;
+            size_t byte_offset;
+
+            explicit DataRef(const Tensor& t)
+                : storage(t.get_storage().get()), byte_offset(static_cast<size_t>(t.get_offset()) * dtype_size(t.dtype())) {
+                // what data_ptr() does first, outside a trace
+                if (!is_active()) t.sync_pending();
+            }
+
+            float* f32() const {
+                return as<float>();
+            }
+
+            template <typename T>
+            T* as() const {
+                return reinterpret_cast<T*>(storage -> ptr<char>() + byte_offset);
+            }
+        };
+    } // namespace trace
+} // namespace axon
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace axon {
+
+    // Element type of tensor data. The values are what checkpoints store, keep them stable.
+    // Float16 / BFloat16 are storage types for weights: matmul (as the right-hand operand)
+    // and embedding read them directly, widening to float32 on the fly. Int8 holds quantized
+    // weights, only meaningful next to their scales (see quantize_int8 in ops.hpp). Int32 /
+    // Int64 are indices: token ids for embedding, class targets for nll_loss. Every other op
+    // wants Float32.
+    enum class DType : uint8_t {
+        Float32 = 0,
+        Float16 = 1,
+        BFloat16 = 2,
+        Int8 = 3,
+        Int32 = 4,
+        Int64 = 5
+    };
+
+    inline size_t dtype_size(DType dtype) {
+        switch (dtype) {
+            case DType::Float32: return 4;
+            case DType::Float16: return 2;
+            case DType::BFloat16: return 2;
+            case DType::Int8: return 1;
+            case DType::Int32: return 4;
+            case DType::Int64: return 8;
+        }
+        throw std::invalid_argument("[DTYPE] Error: Unknown dtype " + std::to_string(static_cast<int>(dtype)));
+    }
+
+    inline const char* dtype_name(DType dtype) {
+        switch (dtype) {
+            case DType::Float32: return "float32";
+            case DType::Float16: return "float16";
+            case DType::BFloat16: return "bfloat16";
+            case DType::Int8: return "int8";
+            case DType::Int32: return "int32";
+            case DType::Int64: return "int64";
+        }
+        return "unknown";
+    }
+
+    // Scalar conversions, round-to-nearest-even. The bulk ones are kernels::cpu::cast_*.
+
+    inline float bf16_to_float(uint16_t h) {
+        uint32_t bits = static_cast<uint32_t>(h) << 16;
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    inline uint16_t float_to_bf16(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+            return static_cast<uint16_t>((bits >> 16) | 0x40); // keep NaNs quiet
+        }
+        bits += 0x7FFF + ((bits >> 16) & 1);
+        return static_cast<uint16_t>(bits >> 16);
+    }
+
+    inline float f16_to_float(uint16_t h) {
+        uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+        uint32_t exp = (h >> 10) & 0x1F;
+        uint32_t mant = h & 0x3FF;
+
+        if (exp == 0) {
+            // zero or subnormal: mant * 2^-24, exact in float
+            float f = static_cast<float>(mant) * 5.9604644775390625e-8f;
+            return sign ? -f : f;
+        }
+
+        uint32_t bits = exp == 0x1F
+            ? sign | 0x7F800000 | (mant << 13)
+            : sign | ((exp + 112) << 23) | (mant << 13);
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    inline uint16_t float_to_f16(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t abs = bits & 0x7FFFFFFF;
+
+        if (abs >= 0x7F800000) {
+            // inf, or a quiet NaN keeping the top of the payload (what F16C does)
+            return static_cast<uint16_t>(abs == 0x7F800000 ? sign | 0x7C00 : sign | 0x7E00 | ((abs >> 13) & 0x3FF));
+        }
+        if (abs >= 0x477FF000) {
+            return static_cast<uint16_t>(sign | 0x7C00); // rounds past 65504
+        }
+
+        uint32_t h, rem, halfway;
+        if (abs < 0x38800000) {
+            // below 2^-14: a subnormal half, mant * 2^(e - 150) in units of 2^-24
+            if (abs < 0x33000000) {
+                return static_cast<uint16_t>(sign);
+            }
+            uint32_t mant = (abs & 0x7FFFFF) | 0x800000;
+            uint32_t shift = 126 - (abs >> 23);
+            h = mant >> shift;
+            rem = mant & ((1u << shift) - 1);
+            halfway = 1u << (shift - 1);
+        } else {
+            h = (abs - 0x38000000) >> 13; // rebias the exponent from 127 to 15
+            rem = abs & 0x1FFF;
+            halfway = 0x1000;
+        }
+
+        if (rem > halfway || (rem == halfway && (h & 1))) {
+            h++;
+        }
+        return static_cast<uint16_t>(sign | h);
+    }
+
+} // namespace axon
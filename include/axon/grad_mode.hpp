@@ -24,4 +24,35 @@ namespace axon {
             GradMode::set_enable(prev_state);
         }
     };
+
+    // Stronger than NoGradGuard, for serving: tensors created while it is active carry no
+    // autograd state at all (requires_grad() is always false, and set_requires_grad(true) or
+    // set_grad() on them throws) and, with GradMode off, ops never build a GradFn.
+    class InferenceMode {
+    public:
+        static bool enabled;
+        static bool is_enabled() {
+            return enabled;
+        }
+
+        static void set_enable(bool b) {
+            enabled = b;
+        }
+    };
+
+    struct InferenceModeGuard {
+        bool prev_inference;
+        bool prev_grad;
+        InferenceModeGuard() {
+            prev_inference = InferenceMode::is_enabled();
+            prev_grad = GradMode::is_enabled();
+            InferenceMode::set_enable(true);
+            GradMode::set_enable(false);
+        }
+
+        ~InferenceModeGuard() {
+            InferenceMode::set_enable(prev_inference);
+            GradMode::set_enable(prev_grad);
+        }
+    };
 } // namespace axon
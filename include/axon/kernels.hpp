@@ -1,6 +1,8 @@
 #pragma once 
 
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 #if defined(_MSC_VER)
     #define AXON_RESTRICT __restrict
@@ -17,9 +19,183 @@ namespace axon::kernels {
         void sub_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept;
         void mul_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept;
         void div_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept;
+
+        // One row of a strided / broadcasting binary op: out[i * so] = a[i * sa] op b[i * sb] for
+        // i < n, strides in elements, 0 repeating a single value. Runs on the calling thread, the
+        // caller splits the work (see src/tensor_iterator.hpp).
+        enum class BinaryOp {
+            Add,
+            Sub,
+            Mul,
+            Div
+        };
+
+        void binary_strided_f32(BinaryOp op, size_t n, const float* a, ptrdiff_t sa, const float* b, ptrdiff_t sb, float* out, ptrdiff_t so) noexcept;
+
+        // A chain of elementwise ops fused into one loop (built by src/lazy.cpp). The program runs
+        // over one strided row of n elements a tile at a time: Load brings operand `a` into
+        // register `dst`, the ops compute register dst from registers a (and b), Store writes
+        // register `a` to operand `dst`. Intermediates stay in cache-resident tiles, so each
+        // operand is read or written once. Runs on the calling thread.
+        enum class FusedOp : uint8_t {
+            Load,
+            Store,
+            Add,
+            Sub,
+            Mul,
+            Div,
+            Neg,
+            Sqrt,
+            Exp,
+            Relu,
+            Gelu
+        };
+
+        struct FusedInstr {
+            FusedOp op;
+            uint8_t dst, a, b;
+        };
+
+        // registers, and operands, per program
+        constexpr size_t FUSED_MAX_OPERANDS = 32;
+
+        // operands[k] / strides[k]: first element and stride (in elements, 0 broadcasts) of operand k
+        void fused_elementwise_f32(const FusedInstr* code, size_t n_code, size_t n, float* const* operands, const ptrdiff_t* strides) noexcept;
         
         // Matrix Multiplication
         void matmul_f32(size_t M, size_t N, size_t K, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept;
+
+        // sgemm: out (M x N, leading dim ldc) = alpha * op(A) @ op(B) + beta * out, everything row-major
+        // op(A) is M x K: A is stored M x K, or K x M when trans_a (lda = row pitch of the stored matrix)
+        // op(B) is K x N: B is stored K x N, or N x K when trans_b
+        // beta == 0 never reads `out`, so it may be uninitialized
+        // Goes through cblas_sgemm when the library was configured with AXON_BLAS=openblas|blis|mkl
+        void gemm_f32(
+            bool trans_a, bool trans_b,
+            size_t M, size_t N, size_t K,
+            float alpha,
+            const float* AXON_RESTRICT a, size_t lda,
+            const float* AXON_RESTRICT b, size_t ldb,
+            float beta,
+            float* AXON_RESTRICT out, size_t ldc
+        ) noexcept;
+
+        // Same contract, always the built-in packed kernel (benchmarks / fallback)
+        void gemm_f32_builtin(
+            bool trans_a, bool trans_b,
+            size_t M, size_t N, size_t K,
+            float alpha,
+            const float* AXON_RESTRICT a, size_t lda,
+            const float* AXON_RESTRICT b, size_t ldb,
+            float beta,
+            float* AXON_RESTRICT out, size_t ldc
+        ) noexcept;
+
+        // Same contract with B stored as 16-bit floats (fp16 / bf16 bits), widened to float32
+        // while B is packed (or, for a handful of rows of A, as it is streamed). Always the
+        // built-in kernel: BLAS has no mixed-precision sgemm.
+        void gemm_f32_f16(
+            bool trans_a, bool trans_b,
+            size_t M, size_t N, size_t K,
+            float alpha,
+            const float* AXON_RESTRICT a, size_t lda,
+            const uint16_t* AXON_RESTRICT b, size_t ldb,
+            float beta,
+            float* AXON_RESTRICT out, size_t ldc
+        ) noexcept;
+
+        void gemm_f32_bf16(
+            bool trans_a, bool trans_b,
+            size_t M, size_t N, size_t K,
+            float alpha,
+            const float* AXON_RESTRICT a, size_t lda,
+            const uint16_t* AXON_RESTRICT b, size_t ldb,
+            float beta,
+            float* AXON_RESTRICT out, size_t ldc
+        ) noexcept;
+
+        // out (M x N) = op(A) @ (op(B) * scale), B stored as int8 with one float scale per
+        // column of op(B) (null: no scaling). B is widened while packed like the 16-bit
+        // variants, so the arithmetic stays float32; the win is reading a quarter of the bytes.
+        void gemm_f32_i8(
+            bool trans_a, bool trans_b,
+            size_t M, size_t N, size_t K,
+            const float* AXON_RESTRICT a, size_t lda,
+            const int8_t* AXON_RESTRICT b, size_t ldb,
+            const float* AXON_RESTRICT scale,
+            float* AXON_RESTRICT out, size_t ldc
+        ) noexcept;
+
+        enum class Activation {
+            None,
+            Relu,
+            Gelu
+        };
+
+        // out (M x N) = act(op(A) @ op(B) + bias), bias (N values, null for none) added to every
+        // row. The bias and activation are applied by the micro-kernel on the last K block, while
+        // each tile is still in registers, so the output is written once. Always the built-in
+        // kernel: BLAS has no epilogue to hook into.
+        void gemm_f32_bias_act(
+            bool trans_a, bool trans_b,
+            size_t M, size_t N, size_t K,
+            const float* AXON_RESTRICT a, size_t lda,
+            const float* AXON_RESTRICT b, size_t ldb,
+            const float* AXON_RESTRICT bias, Activation act,
+            float* AXON_RESTRICT out, size_t ldc
+        ) noexcept;
+
+        // "builtin", or the AXON_BLAS backend gemm_f32 was compiled against
+        const char* blas_backend() noexcept;
+
+        // Instruction set the CPU kernels run on. Every kernel is built for all three, and the
+        // widest one this CPU supports is picked on first use; AXON_ISA=scalar|avx2|avx512
+        // asks for a narrower one. avx2 also needs FMA and F16C.
+        enum class CpuIsa {
+            Scalar,
+            Avx2,
+            Avx512
+        };
+
+        CpuIsa cpu_isa() noexcept;
+        bool cpu_isa_supported(CpuIsa isa) noexcept;
+        // the ones cpu_isa_supported accepts, narrowest first
+        std::vector<CpuIsa> supported_cpu_isas();
+        // false (and nothing changes) when the CPU lacks `isa`. Must not race with running kernels.
+        bool set_cpu_isa(CpuIsa isa) noexcept;
+        // "scalar", "avx2" or "avx512"
+        const char* cpu_isa_name(CpuIsa isa) noexcept;
+
+        // Fused attention: out = softmax(scale * q @ k^T) @ v without materializing the scores.
+        // q/out: (B, H, Tq, D), k/v: (B, H, Tk, D), each addressed through its strides with unit
+        // stride along D. Causal masking is bottom-right aligned: query i sees keys j <= i + Tk - Tq.
+        // lse (B * H * Tq, contiguous, may be null) gets the log-sum-exp of every scaled score row.
+        struct AttentionStrides {
+            size_t batch, head, row;
+        };
+
+        void attention_forward_f32(
+            size_t B, size_t H, size_t Tq, size_t Tk, size_t D, float scale, bool causal,
+            const float* q, AttentionStrides q_st,
+            const float* k, AttentionStrides k_st,
+            const float* v, AttentionStrides v_st,
+            float* out, AttentionStrides out_st,
+            float* lse
+        ) noexcept;
+
+        // Accumulates into grad_q / grad_k / grad_v, so they must start zeroed
+        void attention_backward_f32(
+            size_t B, size_t H, size_t Tq, size_t Tk, size_t D, float scale, bool causal,
+            const float* q, AttentionStrides q_st,
+            const float* k, AttentionStrides k_st,
+            const float* v, AttentionStrides v_st,
+            const float* out, AttentionStrides out_st,
+            const float* grad_out, AttentionStrides gout_st,
+            const float* lse,
+            float* grad_q, AttentionStrides gq_st,
+            float* grad_k, AttentionStrides gk_st,
+            float* grad_v, AttentionStrides gv_st
+        ) noexcept;
         
         // Activation & Others
         void relu_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT out) noexcept;
@@ -34,21 +210,50 @@ namespace axon::kernels {
         void softmax_f32(size_t rows, size_t cols, const float* AXON_RESTRICT input, float* AXON_RESTRICT out) noexcept;
         void softmax_backward_f32(size_t rows, size_t cols, const float* AXON_RESTRICT grad_output, const float* AXON_RESTRICT output, float* AXON_RESTRICT grad_input) noexcept;
 
+        // Reductions. sum_f32 adds fixed 4096-element blocks, then the block sums pairwise: the
+        // rounding error grows with log n, and the result does not depend on the thread count.
         void sum_f32(size_t n, const float* AXON_RESTRICT inp, float* AXON_RESTRICT out) noexcept;
+        // input is (outer, dim, inner), output (outer, inner) gets the sum over dim
         void sum_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept;
+        // max / min over dim of an (outer, dim, inner) input. indices (may be null) get the position
+        // of the first max / min along dim. NaNs are not propagated.
+        void max_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT values, int64_t* AXON_RESTRICT indices) noexcept;
+        void min_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT values, int64_t* AXON_RESTRICT indices) noexcept;
         
         void sqrt_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept;
         void exp_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept;
         void neg_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept;
         
         // Embeddings & Norms
+        // indices are int32 or int64 row ids; ids outside [0, vocab_size) read row 0 (and get
+        // no gradient)
+        template <typename Index>
         void embedding_forward_f32(
             size_t vocab_size, size_t dim, size_t num_indices,
-            const float* AXON_RESTRICT weight, const float* AXON_RESTRICT indices, float* AXON_RESTRICT out
+            const float* AXON_RESTRICT weight, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out
+        ) noexcept;
+        // weight rows stored as fp16 / bf16, widened into the float32 output
+        template <typename Index>
+        void embedding_forward_f16(
+            size_t vocab_size, size_t dim, size_t num_indices,
+            const uint16_t* AXON_RESTRICT weight, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out
+        ) noexcept;
+        template <typename Index>
+        void embedding_forward_bf16(
+            size_t vocab_size, size_t dim, size_t num_indices,
+            const uint16_t* AXON_RESTRICT weight, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out
+        ) noexcept;
+        // int8 rows, each multiplied by its own scale (row_scale[vocab_size])
+        template <typename Index>
+        void embedding_forward_i8(
+            size_t vocab_size, size_t dim, size_t num_indices,
+            const int8_t* AXON_RESTRICT weight, const float* AXON_RESTRICT row_scale,
+            const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out
         ) noexcept;
+        template <typename Index>
         void embedding_backward_f32(
             size_t vocab_size, size_t dim, size_t num_indices,
-            const float* AXON_RESTRICT grad_output, const float* AXON_RESTRICT indices, float* AXON_RESTRICT grad_weight
+            const float* AXON_RESTRICT grad_output, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT grad_weight
         ) noexcept;
 
         void layernorm_forward_f32(
@@ -65,6 +270,15 @@ namespace axon::kernels {
         ) noexcept;
 
         void fill_f32(size_t n, float value, float* AXON_RESTRICT out) noexcept;
+
+        // dtype conversions, round-to-nearest-even when narrowing
+        void cast_f32_to_f16(size_t n, const float* AXON_RESTRICT src, uint16_t* AXON_RESTRICT dst) noexcept;
+        void cast_f16_to_f32(size_t n, const uint16_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept;
+        void cast_f32_to_bf16(size_t n, const float* AXON_RESTRICT src, uint16_t* AXON_RESTRICT dst) noexcept;
+        void cast_bf16_to_f32(size_t n, const uint16_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept;
+        // plain value casts, float -> int8 saturates to [-128, 127]
+        void cast_f32_to_i8(size_t n, const float* AXON_RESTRICT src, int8_t* AXON_RESTRICT dst) noexcept;
+        void cast_i8_to_f32(size_t n, const int8_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept;
     } // namespace cpu
 
     namespace gpu {
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "tensor.hpp"
+#include "kernels.hpp"
+#include <string>
+#include <vector>
+
+namespace axon {
+    // Lazy elementwise fusion. While a LazyGuard is alive the elementwise ops (add, sub, mul, div
+    // with broadcasting; neg, sqrt, exp, relu, gelu) are recorded instead of run, and return
+    // tensors whose data does not exist yet. At the next sync point the recorded graph is cut into
+    // groups of ops over the same shape, each group runs as one fused loop
+    // (kernels::cpu::fused_elementwise_f32), and only values still referenced from outside the
+    // graph, or read by another group, are written to memory.
+    //
+    // Sync points: the outermost guard going out of scope, lazy::sync(), and the first access to
+    // a pending tensor's data (data_ptr(), at(), or any op that is not recorded). Ops whose
+    // result needs a gradient, and non-CPU tensors, run eagerly as usual.
+    // The inputs of recorded ops must not be written to before the sync, and a trace belongs to
+    // the thread that recorded it. AXON_LAZY_DUMP=1 prints the fused groups at every sync.
+    //
+    //   {
+    //       LazyGuard lazy;
+    //       Tensor y = mul(sub(x, mu), rstd);   // recorded
+    //       y = add(mul(y, gamma), beta);       // recorded
+    //   }                                       // one loop over x writes y
+    namespace lazy {
+        bool is_enabled();
+
+        // run everything recorded so far
+        void sync();
+
+        // the fused loops the pending ops would run as, for debugging
+        std::string describe();
+
+        // used by the ops: records op(a) / op(a, b) with the broadcast output `shape`, and
+        // returns its pending output
+        Tensor record(kernels::cpu::FusedOp op, const std::vector<int>& shape, const Tensor& a, const Tensor* b);
+    } // namespace lazy
+
+    struct LazyGuard {
+        LazyGuard();
+        ~LazyGuard();
+
+        LazyGuard(const LazyGuard&) = delete;
+        LazyGuard& operator= (const LazyGuard&) = delete;
+    };
+} // namespace axon
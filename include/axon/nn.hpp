@@ -2,19 +2,119 @@
 
 #include "tensor.hpp"
 #include "ops.hpp"
+#include "grad_mode.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <optional>
 #include <random>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace axon::nn {
+    // Parameters created while this is alive get their shape but no memory and no initial
+    // values. For models whose weights come straight from load_model / load_model_mmap,
+    // so they are not allocated and randomly initialized only to be overwritten.
+    struct SkipInitGuard {
+        inline static bool enabled = false;
+        bool prev_state;
+        SkipInitGuard() {
+            prev_state = enabled;
+            enabled = true;
+        }
+
+        ~SkipInitGuard() {
+            enabled = prev_state;
+        }
+    };
+
+    // a freshly built parameter needs a gradient, unless the module is built under
+    // InferenceModeGuard: then it is an inference tensor, with no autograd state to set
+    inline void make_trainable(Tensor& p) {
+        if (!InferenceMode::is_enabled()) {
+            p.set_requires_grad(true);
+        }
+    }
+
+    // uninitialized parameter tensor, or only its shape under SkipInitGuard
+    inline Tensor new_parameter(const std::vector<int>& shape, DType dtype = DType::Float32) {
+        if (!SkipInitGuard::enabled) {
+            return Tensor::empty(shape, dtype);
+        }
+
+        std::vector<int> stride(shape.size());
+        size_t numel = 1;
+        for (int i = static_cast<int>(shape.size()) - 1; i >= 0; --i) {
+            stride[i] = static_cast<int>(numel);
+            numel *= shape[i];
+        }
+        auto storage = std::make_shared<Storage>(nullptr, numel * dtype_size(dtype), Device(DeviceType::CPU));
+        storage -> dtype = dtype;
+        return Tensor::from_storage(storage, shape, stride, 0);
+    }
+
+    // Swaps parameter `p`'s data for `converted`'s (same shape, any dtype) in place: the
+    // Storage is shared with the module's own tensor, so that one sees the change too.
+    inline void replace_data(Tensor& p, const Tensor& converted, const std::string& name) {
+        std::shared_ptr<Storage> storage = p.get_storage();
+        if (!p.is_contiguous() || p.get_offset() != 0) {
+            throw std::runtime_error("[REPLACE_DATA] Error: " + name + " is not a contiguous parameter");
+        }
+        storage -> rebind(const_cast<void*>(converted.raw_data_ptr()), converted.numel() * dtype_size(converted.dtype()), converted.get_storage());
+        storage -> dtype = converted.dtype();
+    }
+
+    // the same for a parameter with no memory yet (SkipInitGuard): only its dtype changes
+    inline void set_unmaterialized_dtype(Tensor& p, DType dtype) {
+        p.get_storage() -> nbytes = p.numel() * dtype_size(dtype);
+        p.get_storage() -> dtype = dtype;
+    }
+
     // the base module
     // similar to `torch.nn.Module`
     struct Module { 
         virtual ~Module() = default;
         virtual Tensor forward(Tensor x) = 0;
         virtual std::vector<Tensor> parameters() = 0;
+
+        // parameters() with stable dotted names ("h.0.attn.w_q.weight"), same order.
+        // Checkpoints keyed by these names do not depend on parameter order.
+        NamedTensors named_parameters() {
+            NamedTensors out;
+            collect_named("", out);
+            return out;
+        }
+
+        // appends this module's parameters under `prefix`; modules that don't
+        // override it just number theirs
+        virtual void collect_named(const std::string& prefix, NamedTensors& out) {
+            std::vector<Tensor> params = parameters();
+            for (size_t i = 0; i < params.size(); i++) {
+                out.push_back({prefix + std::to_string(i), params[i]});
+            }
+        }
         
         
+        // Stores the matmul weights and embedding tables (the parameters named `weight`) as
+        // `dtype`, in place. DType::BFloat16 / Float16 halve their memory and the bandwidth
+        // matmul spends reading them; biases and LayerNorm stay float32. For inference:
+        // converted weights stop requiring grad.
+        void cast_weights(DType dtype) {
+            for (auto& [name, p] : named_parameters()) {
+                // int8 weights are quantized, see quantize_model
+                if (!(name == "weight" || name.ends_with(".weight")) || p.dtype() == dtype || p.dtype() == DType::Int8) {
+                    continue;
+                }
+                if (!p.get_storage() -> data) {
+                    throw std::runtime_error("[CAST_WEIGHTS] Error: " + name + " has no data to convert");
+                }
+
+                replace_data(p, p.to(dtype), name);
+                p.set_requires_grad(false);
+            }
+        }
+        
         // training mode flag for Dropout/BatchNorm later on
         bool is_training = true;
         
@@ -31,57 +131,137 @@ namespace axon::nn {
     public:
         Tensor weight;
         Tensor bias;
+        // (1, out_features) per-output-channel scales, once quantize() made the weight int8
+        std::optional<Tensor> weight_scale;
 
         Linear(int in_features, int out_features)
-            : weight(Tensor::zeros({in_features, out_features})),
-              bias(Tensor::zeros({1, out_features})) {
+            : weight(new_parameter({in_features, out_features})),
+              bias(new_parameter({1, out_features})) {
         
-            float limit = std::sqrt(6.0f / (float)(in_features + out_features));
-
-            float* w_data = weight.data_ptr();
-            size_t w_size = weight.numel();
-            float r;
-            for (size_t i = 0; i < w_size; i++) {
-                r = (float)rand() / RAND_MAX;
-                w_data[i] = (r * 2 * limit) - limit;
+            if (!SkipInitGuard::enabled) {
+                float limit = std::sqrt(6.0f / (float)(in_features + out_features));
+
+                float* w_data = weight.data_ptr();
+                size_t w_size = weight.numel();
+                float r;
+                for (size_t i = 0; i < w_size; i++) {
+                    r = (float)rand() / RAND_MAX;
+                    w_data[i] = (r * 2 * limit) - limit;
+                }
+                std::memset(bias.data_ptr(), 0, bias.numel() * sizeof(float));
             }
 
-            weight.set_requires_grad(true);
-            bias.set_requires_grad(true);
+            make_trainable(weight);
+            make_trainable(bias);
         }
 
         Tensor forward(Tensor x) override {
-            // y = x @ w + b
-            return axon::add(axon::matmul(x, weight), bias);
+            return forward(x, Activation::None);
+        }
+
+        // y = act(x @ w + b), bias and activation fused into the GEMM (see axon::linear)
+        Tensor forward(Tensor x, Activation act) {
+            if (weight_scale) {
+                Tensor y = axon::quantized_matmul(x, weight, *weight_scale);
+                // inference: bias and activation go over the GEMM output itself
+                if (axon::can_modify_in_place(y)) {
+                    y = axon::add_(y, bias);
+                    if (act == Activation::Relu) y = axon::relu_(y);
+                    if (act == Activation::Gelu) y = axon::gelu_(y);
+                    return y;
+                }
+                y = axon::add(y, bias);
+                if (act == Activation::Relu) return axon::relu(y);
+                if (act == Activation::Gelu) return axon::gelu(y);
+                return y;
+            }
+            return axon::linear(x, weight, bias, act);
+        }
+
+        // Int8 weight, one scale per output channel, in place. For inference: the weight
+        // stops requiring grad (inputs still get theirs).
+        void quantize() {
+            if (weight_scale) return;
+            if (!weight.get_storage() -> data) {
+                set_unmaterialized_dtype(weight, DType::Int8);
+                weight_scale = new_parameter({1, weight.get_shape()[1]});
+                return;
+            }
+            auto [q, scale] = axon::quantize_int8(weight, 1);
+            replace_data(weight, q, "weight");
+            weight.set_requires_grad(false);
+            weight_scale = scale;
         }
 
         std::vector<Tensor> parameters() override {
+            if (weight_scale) {
+                return {weight, bias, *weight_scale};
+            }
             return {weight, bias};
         }
+
+        void collect_named(const std::string& prefix, NamedTensors& out) override {
+            out.push_back({prefix + "weight", weight});
+            out.push_back({prefix + "bias", bias});
+            if (weight_scale) {
+                out.push_back({prefix + "weight_scale", *weight_scale});
+            }
+        }
     };
 
     class Embedding : public Module {
     public:
         Tensor weight;
+        // (num_embeddings, 1) per-row scales, once quantize() made the table int8
+        std::optional<Tensor> weight_scale;
         Embedding(int num_embeddings, int embedding_dims) :
-            weight(Tensor::zeros({num_embeddings, embedding_dims})) {
+            weight(new_parameter({num_embeddings, embedding_dims})) {
             
-            float* d = weight.data_ptr();
-            size_t w_size = weight.numel();
+            if (!SkipInitGuard::enabled) {
+                float* d = weight.data_ptr();
+                size_t w_size = weight.numel();
 
-            for(size_t i = 0; i < w_size; i++) {
-                d[i] = (float)(rand() / RAND_MAX) - 0.5f;
+                for(size_t i = 0; i < w_size; i++) {
+                    d[i] = (float)(rand() / RAND_MAX) - 0.5f;
+                }
             }
-            weight.set_requires_grad(true);
+            make_trainable(weight);
         }
 
         Tensor forward(Tensor x) override {
+            if (weight_scale) {
+                return axon::quantized_embedding(x, weight, *weight_scale);
+            }
             return axon::embedding(x, weight);
         }
 
+        // Int8 table, one scale per row, in place; see Linear::quantize
+        void quantize() {
+            if (weight_scale) return;
+            if (!weight.get_storage() -> data) {
+                set_unmaterialized_dtype(weight, DType::Int8);
+                weight_scale = new_parameter({weight.get_shape()[0], 1});
+                return;
+            }
+            auto [q, scale] = axon::quantize_int8(weight, 0);
+            replace_data(weight, q, "weight");
+            weight.set_requires_grad(false);
+            weight_scale = scale;
+        }
+
         std::vector<Tensor> parameters() override {
+            if (weight_scale) {
+                return { weight, *weight_scale };
+            }
             return { weight };
         }
+
+        void collect_named(const std::string& prefix, NamedTensors& out) override {
+            out.push_back({prefix + "weight", weight});
+            if (weight_scale) {
+                out.push_back({prefix + "weight_scale", *weight_scale});
+            }
+        }
     };
 
     class LayerNorm : public Module {
@@ -91,12 +271,17 @@ namespace axon::nn {
         float eps;
 
         LayerNorm(int normalized_shape, float eps = 1e-5) 
-            : gamma(Tensor::ones({normalized_shape})), 
-              beta(Tensor::zeros({normalized_shape})), 
+            : gamma(new_parameter({normalized_shape})), 
+              beta(new_parameter({normalized_shape})), 
               eps(eps) {
+
+            if (!SkipInitGuard::enabled) {
+                std::fill(gamma.data_ptr(), gamma.data_ptr() + normalized_shape, 1.0f);
+                std::fill(beta.data_ptr(), beta.data_ptr() + normalized_shape, 0.0f);
+            }
             
-            gamma.set_requires_grad(true);
-            beta.set_requires_grad(true);
+            make_trainable(gamma);
+            make_trainable(beta);
         }
 
         Tensor forward(Tensor x) override {
@@ -106,6 +291,11 @@ namespace axon::nn {
         std::vector<Tensor> parameters() override {
             return {gamma, beta};
         }
+
+        void collect_named(const std::string& prefix, NamedTensors& out) override {
+            out.push_back({prefix + "gamma", gamma});
+            out.push_back({prefix + "beta", beta});
+        }
     };
 
     class MultiHeadAttention : public Module {
@@ -135,32 +325,35 @@ namespace axon::nn {
             k = axon::transpose(k, 1, 2);
             v = axon::transpose(v, 1, 2);
 
-            Tensor k_t = axon::transpose(k, 2, 3);
-            Tensor scores = axon::matmul(q, k_t);
+            return attend(q, k, v);
+        }
 
-            float scale = 1.0f / std::sqrt((float)head_dim);
-            Tensor scale_t = Tensor::zeros({1});
-            scale_t.data_ptr()[0] = scale;
-            scores = axon::mul(scores, scale_t);
-            
-            Tensor mask = Tensor::zeros({T, T});
-            float* m_ptr = mask.data_ptr();
+        // Incremental decoding (inference only, the cache writes are not tracked by autograd).
+        // x: (B, T, C) holds the new positions [pos, pos + T). Their keys/values go into
+        // k_cache/v_cache (B, n_head, max_len, head_dim) and the new queries attend to
+        // everything cached up to pos + T.
+        Tensor forward_step(Tensor x, Tensor k_cache, Tensor v_cache, int pos) {
+            int B = x.get_shape()[0];
+            int T = x.get_shape()[1];
 
-            float neg_inf = -1e9f;
+            Tensor q = w_q.forward(x);
+            write_cache(w_k.forward(x), k_cache, pos);
+            write_cache(w_v.forward(x), v_cache, pos);
 
-            for (int i = 0; i < T; i++) {
-                for (int j = 0; j < T; j++) {
-                    if (j > i) {
-                        m_ptr[i * T + j] = neg_inf;
-                    }
-                }
-            }
+            q = axon::view(q, {B, T, n_head, head_dim});
+            q = axon::transpose(q, 1, 2);
 
-            scores = axon::add(scores, mask);
+            return attend(q, cached_prefix(k_cache, pos + T), cached_prefix(v_cache, pos + T));
+        }
 
-            Tensor attn = axon::softmax(scores);
+        // q: (B, H, Tq, D), k/v: (B, H, Tk, D) -> c_proj((B, Tq, C))
+        // The queries are the last Tq of the Tk positions, so the causal mask stays right for a KV cache.
+        Tensor attend(Tensor q, Tensor k, Tensor v) {
+            int B = q.get_shape()[0];
+            int T = q.get_shape()[2];
 
-            Tensor context = axon::matmul(attn, v);
+            // fused scores / mask / softmax / @ v: no (B, H, Tq, Tk) tensor is ever built
+            Tensor context = axon::scaled_dot_product_attention(q, k, v, true);
 
             context = axon::transpose(context, 1, 2);
 
@@ -169,6 +362,42 @@ namespace axon::nn {
             return c_proj.forward(context);
         }
 
+        // (B, T, n_head * head_dim) rows -> cache[:, :, pos:pos + T, :]
+        void write_cache(Tensor src, Tensor cache, int pos) {
+            Tensor src_c = src.is_contiguous() ? src : src.contiguous();
+            int B = src_c.get_shape()[0];
+            int T = src_c.get_shape()[1];
+            int max_len = cache.get_shape()[2];
+
+            // the copy below trusts these: a bigger batch or a later position would write past the cache
+            if (B != cache.get_shape()[0]) {
+                throw std::invalid_argument("[MHA] Error: write_cache batch " + std::to_string(B) +
+                                            " does not match the cache's " + std::to_string(cache.get_shape()[0]));
+            }
+            if (pos < 0 || pos + T > max_len) {
+                throw std::out_of_range("[MHA] Error: write_cache positions [" + std::to_string(pos) + ", " + std::to_string(pos + T) +
+                                        ") outside the cache's " + std::to_string(max_len));
+            }
+
+            const float* s = src_c.data_ptr();
+            float* d = cache.data_ptr();
+            for (int b = 0; b < B; b++) {
+                for (int t = 0; t < T; t++) {
+                    for (int hd = 0; hd < n_head; hd++) {
+                        std::memcpy(d + ((size_t)(b * n_head + hd) * max_len + pos + t) * head_dim,
+                                    s + ((size_t)(b * T + t) * n_head + hd) * head_dim,
+                                    head_dim * sizeof(float));
+                    }
+                }
+            }
+        }
+
+        // cache[:, :, 0:len, :] as a strided view, no copy
+        static Tensor cached_prefix(const Tensor& cache, int len) {
+            const std::vector<int>& s = cache.get_shape();
+            return Tensor::from_storage(cache.get_storage(), {s[0], s[1], len, s[3]}, cache.get_stride(), cache.get_offset());
+        }
+
         std::vector<Tensor> parameters() override {
             std::vector<Tensor> params;
             auto p_q = w_q.parameters(); params.insert(params.end(), p_q.begin(), p_q.end());
@@ -177,6 +406,13 @@ namespace axon::nn {
             auto p_c = c_proj.parameters(); params.insert(params.end(), p_c.begin(), p_c.end());
             return params;
         }
+
+        void collect_named(const std::string& prefix, NamedTensors& out) override {
+            w_q.collect_named(prefix + "w_q.", out);
+            w_k.collect_named(prefix + "w_k.", out);
+            w_v.collect_named(prefix + "w_v.", out);
+            c_proj.collect_named(prefix + "c_proj.", out);
+        }
     };
 
     class FeedForward : public Module {
@@ -189,8 +425,7 @@ namespace axon::nn {
             c_proj(4 * n_embd, n_embd) {}
 
         Tensor forward(Tensor x) override {
-            Tensor h = c_fc.forward(x);
-            h = axon::gelu(h);
+            Tensor h = c_fc.forward(x, Activation::Gelu);
             return c_proj.forward(h);
         }
 
@@ -200,6 +435,11 @@ namespace axon::nn {
             p1.insert(p1.end(), p2.begin(), p2.end());
             return p1;
         }
+
+        void collect_named(const std::string& prefix, NamedTensors& out) override {
+            c_fc.collect_named(prefix + "c_fc.", out);
+            c_proj.collect_named(prefix + "c_proj.", out);
+        }
     }; 
 
     class Block : public Module {
@@ -218,16 +458,32 @@ namespace axon::nn {
             // 1. Attention Block: x = x + attn(ln1(x))
             Tensor h1 = ln_1.forward(x);
             Tensor attn_out = attn.forward(h1);
-            x = axon::add(x, attn_out);
+            x = residual(x, attn_out);
 
             // 2. MLP Block: x = x + mlp(ln2(x))
             Tensor h2 = ln_2.forward(x);
             Tensor mlp_out = mlp.forward(h2);
-            x = axon::add(x, mlp_out);
+            x = residual(x, mlp_out);
+
+            return x;
+        }
+
+        Tensor forward_step(Tensor x, Tensor k_cache, Tensor v_cache, int pos) {
+            Tensor attn_out = attn.forward_step(ln_1.forward(x), k_cache, v_cache, pos);
+            x = residual(x, attn_out);
+
+            Tensor mlp_out = mlp.forward(ln_2.forward(x));
+            x = residual(x, mlp_out);
 
             return x;
         }
 
+        // x + y, into x when nothing else holds it (under no-grad, the stream GPT2 hands from
+        // block to block, or the first sum when the caller kept its x)
+        static Tensor residual(Tensor& x, const Tensor& y) {
+            return axon::can_modify_in_place(x) ? axon::add_(x, y) : axon::add(x, y);
+        }
+
         std::vector<Tensor> parameters() override {
             std::vector<Tensor> params;
             auto p_l1 = ln_1.parameters(); params.insert(params.end(), p_l1.begin(), p_l1.end());
@@ -236,6 +492,35 @@ namespace axon::nn {
             auto p_mlp = mlp.parameters(); params.insert(params.end(), p_mlp.begin(), p_mlp.end());
             return params;
         }
+
+        void collect_named(const std::string& prefix, NamedTensors& out) override {
+            ln_1.collect_named(prefix + "ln_1.", out);
+            attn.collect_named(prefix + "attn.", out);
+            ln_2.collect_named(prefix + "ln_2.", out);
+            mlp.collect_named(prefix + "mlp.", out);
+        }
+    };
+
+    // Keys/values of every layer for incremental decoding.
+    // k[l], v[l]: (B, n_head, max_len, head_dim), allocated once; `length` positions are filled.
+    struct KVCache {
+        std::vector<Tensor> k;
+        std::vector<Tensor> v;
+        int max_len;
+        int length = 0;
+
+        KVCache(int n_layer, int batch, int n_head, int max_len, int head_dim) : max_len(max_len) {
+            k.reserve(n_layer);
+            v.reserve(n_layer);
+            for (int i = 0; i < n_layer; i++) {
+                k.push_back(Tensor::zeros({batch, n_head, max_len, head_dim}));
+                v.push_back(Tensor::zeros({batch, n_head, max_len, head_dim}));
+            }
+        }
+
+        void reset() {
+            length = 0;
+        }
     };
 
     class GPT2 : public Module {
@@ -267,27 +552,28 @@ namespace axon::nn {
         }
 
         Tensor forward(Tensor idx) override {
-            // idx: (Batch, Seq) of Integer Tokens
+            // idx: (Batch, Seq) of token ids, int32 / int64 (or float32)
             int B = idx.get_shape()[0];
             int T = idx.get_shape()[1];
 
             // 1. Token Embeddings
-            Tensor tok_emb = wte.forward(idx); // (B, T, 768)
+            Tensor x = wte.forward(idx); // (B, T, 768)
 
             // 2. Position Embeddings
             // Create position indices [0, 1, 2, ... T-1]
-            Tensor pos_idx = Tensor::zeros({T});
-            for(int i=0; i<T; ++i) pos_idx.data_ptr()[i] = (float)i;
+            Tensor pos_idx = Tensor::empty({T}, DType::Int32);
+            for(int i=0; i<T; ++i) pos_idx.data_as<int32_t>()[i] = i;
             
             // Expand to batch (B, T) if necessary, or let broadcasting handle it.
             // Axon broadcasting: (B, T, C) + (T, C) works fine.
             Tensor pos_emb = wpe.forward(pos_idx); 
 
-            Tensor x = axon::add(tok_emb, pos_emb);
+            x = Block::residual(x, pos_emb);
 
             // 3. Blocks
+            // (x is moved in: with no other handle on it, each block adds into it in place)
             for(auto& block : h) {
-                x = block.forward(x);
+                x = block.forward(std::move(x));
             }
 
             // 4. Final Norm
@@ -298,13 +584,54 @@ namespace axon::nn {
             return lm_head.forward(x);
         }
 
+        KVCache make_cache(int batch, int max_len = 1024) {
+            return KVCache((int)h.size(), batch, h[0].attn.n_head, max_len, h[0].attn.head_dim);
+        }
+
+        // Same as forward() for the tokens idx (B, T) placed at positions [pos, pos + T),
+        // reusing the keys/values of positions [0, pos) from `cache`.
+        // Prefill with the prompt at pos = 0, then feed one token per call.
+        // Returns (B, T, 50257) logits for the new positions only.
+        Tensor forward_step(Tensor idx, KVCache& cache, int pos) {
+            int T = idx.get_shape()[1];
+
+            if (pos < 0 || pos > cache.length) {
+                throw std::invalid_argument("[GPT2] Error: forward_step position " + std::to_string(pos) +
+                                            " skips past the " + std::to_string(cache.length) + " cached tokens");
+            }
+            if (pos + T > cache.max_len || pos + T > wpe.weight.get_shape()[0]) {
+                throw std::out_of_range("[GPT2] Error: sequence length " + std::to_string(pos + T) +
+                                        " exceeds the KV cache / context size");
+            }
+            if (idx.get_shape()[0] != cache.k[0].get_shape()[0]) {
+                throw std::invalid_argument("[GPT2] Error: forward_step batch " + std::to_string(idx.get_shape()[0]) +
+                                            " does not match the KV cache's " + std::to_string(cache.k[0].get_shape()[0]));
+            }
+
+            Tensor x = wte.forward(idx);
+
+            Tensor pos_idx = Tensor::empty({T}, DType::Int32);
+            for (int i = 0; i < T; ++i) pos_idx.data_as<int32_t>()[i] = pos + i;
+            Tensor pos_emb = wpe.forward(pos_idx);
+
+            x = Block::residual(x, pos_emb);
+
+            for (size_t l = 0; l < h.size(); l++) {
+                x = h[l].forward_step(std::move(x), cache.k[l], cache.v[l], pos);
+            }
+            cache.length = pos + T;
+
+            x = ln_f.forward(x);
+            return lm_head.forward(x);
+        }
+
         std::vector<Tensor> parameters() override {
             std::vector<Tensor> params;
             // Order is CRITICAL for loading!
             // 1. WTE
-            params.push_back(wte.weight);
+            auto p_wte = wte.parameters(); params.insert(params.end(), p_wte.begin(), p_wte.end());
             // 2. WPE
-            params.push_back(wpe.weight);
+            auto p_wpe = wpe.parameters(); params.insert(params.end(), p_wpe.begin(), p_wpe.end());
             // 3. Blocks
             for(auto& block : h) {
                 auto p = block.parameters();
@@ -314,10 +641,35 @@ namespace axon::nn {
             params.push_back(ln_f.gamma);
             params.push_back(ln_f.beta);
             // 5. LM Head
-            params.push_back(lm_head.weight);
-            params.push_back(lm_head.bias);
+            auto p_head = lm_head.parameters(); params.insert(params.end(), p_head.begin(), p_head.end());
             
             return params;
         }
+
+        void collect_named(const std::string& prefix, NamedTensors& out) override {
+            wte.collect_named(prefix + "wte.", out);
+            wpe.collect_named(prefix + "wpe.", out);
+            for (size_t i = 0; i < h.size(); i++) {
+                h[i].collect_named(prefix + "h." + std::to_string(i) + ".", out);
+            }
+            ln_f.collect_named(prefix + "ln_f.", out);
+            lm_head.collect_named(prefix + "lm_head.", out);
+        }
     };
+
+    // Int8 weight-only quantization of every Linear and Embedding of `model`, in place:
+    // about 4x less weight memory, and a quarter of the bytes per decode step. LayerNorm and
+    // biases stay float32. Built under SkipInitGuard (no weights yet), the model only
+    // switches dtypes and gains the scale parameters, ready to load a quantized checkpoint.
+    inline void quantize_model(GPT2& model) {
+        model.wte.quantize();
+        model.wpe.quantize();
+        for (Block& block : model.h) {
+            for (Linear* l : {&block.attn.w_q, &block.attn.w_k, &block.attn.w_v, &block.attn.c_proj,
+                              &block.mlp.c_fc, &block.mlp.c_proj}) {
+                l -> quantize();
+            }
+        }
+        model.lm_head.quantize();
+    }
 }
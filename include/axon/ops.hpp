@@ -1,6 +1,8 @@
 #pragma once 
 
 #include "tensor.hpp"
+#include "kernels.hpp"
+#include <utility>
 
 namespace axon {
     Tensor add(Tensor a, Tensor b);
@@ -17,25 +19,80 @@ namespace axon {
     Tensor permute(Tensor t, const std::vector<int>& dims);
 
     Tensor matmul(Tensor a, Tensor b);
+
+    using Activation = kernels::cpu::Activation;
+
+    // act(x @ w + b) for x (..., in), w (in, out), b (out) or (1, out): one GEMM that adds the
+    // bias and applies the activation to each output tile while it is in registers, instead of
+    // matmul, a broadcast add and an activation pass. With gradients and GELU the pre-activation
+    // is kept for the backward, so GELU runs as a second pass. CPU only; other devices and
+    // 16-bit weights fall back to the separate ops.
+    Tensor linear(Tensor x, Tensor w, Tensor b, Activation act = Activation::None);
     Tensor sum(Tensor a);
     Tensor sum(Tensor t, int dim, bool keepdims = false);
+    Tensor mean(Tensor a);
+    Tensor mean(Tensor t, int dim, bool keepdims = false);
+
+    // max / min values, and argmax as int64 positions (the first one on ties). No gradients.
+    Tensor max(Tensor a);
+    Tensor max(Tensor t, int dim, bool keepdims = false);
+    Tensor min(Tensor a);
+    Tensor min(Tensor t, int dim, bool keepdims = false);
+    // argmax(a) indexes the flattened tensor
+    Tensor argmax(Tensor a);
+    Tensor argmax(Tensor t, int dim, bool keepdims = false);
 
     Tensor relu(Tensor t);
 
     Tensor log_softmax(Tensor t);
-    // negative log likelihood
+    // negative log likelihood, averaged over the batch. target is one-hot (float32, input's
+    // shape) or holds class indices (int32 / int64, shape (N) for an (N, C) input)
     Tensor nll_loss(Tensor input, Tensor target); 
 
     Tensor gelu(Tensor t);
 
     Tensor softmax(Tensor t);
 
+    // In-place variants, for inference: they overwrite a and return it (b broadcasts to a's
+    // shape). float32 CPU tensors only; they throw when a gradient is being recorded for a or b,
+    // or when a's elements overlap (an expand()ed tensor). A b that is another view of a's
+    // storage is copied first. Every other handle on a's storage sees the change, see
+    // can_modify_in_place.
+    Tensor relu_(Tensor a);
+    Tensor gelu_(Tensor a);
+    Tensor add_(Tensor a, Tensor b);
+
+    // True when nothing else can see an in-place op on t: it holds the only handle on its
+    // storage (no copy, view or recorded op shares it), it is a float32 CPU tensor, and no
+    // graph or LazyGuard chain is being recorded. nn updates fresh activations in place when
+    // this holds.
+    bool can_modify_in_place(const Tensor& t);
+
     // Embedding: Look up indices in weight
-    // Input: (B, T) or (N). Weight: (Vocab, Dim). Output: (B, T, Dim)
+    // Input: (B, T) or (N) int32 / int64 ids (float32 ids still work, exact below 2^24).
+    // Weight: (Vocab, Dim). Output: (B, T, Dim)
     Tensor embedding(Tensor input, Tensor weight); 
 
+    // Int8 weights, for inference. quantize_int8 quantizes a 2D float32 weight symmetrically,
+    // one scale (max |w| / 127) per slice along `dim`: 1 gives per-column scales (1, cols), the
+    // output channels of a Linear weight (in, out); 0 gives per-row scales (rows, 1), e.g. the
+    // tokens of an embedding table. Returns {int8 values, float32 scales}.
+    std::pair<Tensor, Tensor> quantize_int8(Tensor w, int dim);
+
+    // a (..., K) @ (w * scale) for an int8 (K, N) weight with per-column scales.
+    // Gradients flow to `a` only, the weight is frozen.
+    Tensor quantized_matmul(Tensor a, Tensor w, Tensor scale);
+
+    // embedding() over an int8 table with per-row scales. No gradients.
+    Tensor quantized_embedding(Tensor input, Tensor weight, Tensor scale);
+
     Tensor layer_norm(Tensor input, Tensor gamma, Tensor beta, float eps = 1e-5);
 
+    // Fused softmax(q @ k^T / sqrt(D)) @ v over (B, H, T, D) tensors, never materializing
+    // the (B, H, Tq, Tk) scores. causal masks keys after each query, aligned to the end
+    // of k when Tk > Tq (queries are the newest positions, as with a KV cache).
+    Tensor scaled_dot_product_attention(Tensor q, Tensor k, Tensor v, bool causal = false);
+
     inline Tensor operator+ (const Tensor& a, const Tensor& b) {
         return add(a, b);
     }
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "tensor.hpp"
+#include "dtype.hpp"
+#include <cstdint>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace axon {
+
+    // Checkpoint formats
+    //
+    // v1 ("AXON"): u32 magic, u32 count, then per tensor u32 rank, u32 dims[rank], f32 data.
+    //   The aligned variant ("AXOA") zero-pads before each data block to a 64-byte boundary.
+    //   Positional only: loading walks the stream and relies on parameter order.
+    //
+    // v2 ("AXO2"): a header table, then the data.
+    //   u32 magic, u32 version, u32 count, u32 reserved, u64 data_start
+    //   per tensor: u16 name_len, name, u8 dtype, u8 rank, u64 dims[rank], u64 offset, u64 nbytes
+    //   Offsets are absolute and 64-byte aligned, so any tensor can be read (or mapped)
+    //   on its own, in any order. All integers little-endian.
+    //
+    // v3: v2 with a u32 CRC32C of the tensor's bytes after each entry's nbytes. Loading
+    //   verifies it and rejects a corrupt tensor. v2 files still load, unchecked.
+
+    // One entry of a checkpoint's tensor table
+    struct TensorInfo {
+        std::string name;
+        DType dtype;
+        std::vector<int> shape;
+        uint64_t offset; // absolute byte offset of the data in the file
+        uint64_t nbytes;
+        uint32_t checksum = 0; // CRC32C of the data, if has_checksum (v3 and up)
+        bool has_checksum = false;
+
+        size_t numel() const {
+            size_t n = 1;
+            for (int s : shape) n *= s;
+            return n;
+        }
+    };
+
+    // Writes a checkpoint in the current format. Names must be unique. Tensor data is
+    // written in parallel chunks at precomputed offsets, to a temporary file that
+    // replaces `filepath` only once complete and fsynced (the directory too), so a crash or
+    // power loss leaves either the old checkpoint or the new one.
+    void save_checkpoint(const NamedTensors& tensors, const std::string& filepath);
+
+    // Copies the tensors (so they may be modified right after the call returns) and
+    // writes them on a background thread. get() on the future rethrows any write error.
+    std::future<void> save_checkpoint_async(const NamedTensors& tensors, const std::string& filepath);
+    std::future<void> save_model_async(const std::vector<Tensor>& params, const std::string& filepath);
+
+    // Random access to a checkpoint file. Opening it reads only the header table; tensor
+    // data is read on demand with pread, so single tensors or subsets (e.g. only
+    // "lm_head.weight") cost only their own bytes. v1 files work too, with their tensors
+    // named "0", "1", ... in file order.
+    class CheckpointReader {
+    public:
+        explicit CheckpointReader(const std::string& filepath);
+        ~CheckpointReader();
+
+        CheckpointReader(const CheckpointReader&) = delete;
+        CheckpointReader& operator= (const CheckpointReader&) = delete;
+
+        uint32_t version() const {
+            return format_version;
+        }
+
+        const std::vector<TensorInfo>& tensors() const {
+            return entries;
+        }
+
+        // nullptr if the checkpoint has no tensor called `name`
+        const TensorInfo* find(const std::string& name) const;
+
+        // a new CPU tensor holding `name`, in the dtype it is stored in
+        Tensor load(const std::string& name) const;
+
+        // reads `name` into an existing contiguous CPU tensor of the same numel, converting
+        // to that tensor's dtype if the file stores another one
+        void load_into(const std::string& name, Tensor& dst) const;
+        void load_into(const TensorInfo& info, Tensor& dst) const;
+
+        // Reads every entry of `params` found in the file, in chunks spread over the thread
+        // pool. With `strict`, a name missing from the file is an error; otherwise it is
+        // skipped. Returns how many tensors were loaded.
+        size_t load_named(NamedTensors& params, bool strict = true) const;
+
+        // Checks every tensor against its stored checksum without loading anything, e.g.
+        // before load_checkpoint_mmap (which never reads the data up front, so never checks it)
+        void verify() const;
+
+    private:
+        int fd;
+        std::string path;
+        uint32_t format_version;
+        uint64_t file_size;
+        std::vector<TensorInfo> entries;
+        std::unordered_map<std::string, size_t> by_name;
+
+        void read_v1_index(bool aligned);
+        void read_v2_index();
+        void read_tensors(const std::vector<const TensorInfo*>& infos, NamedTensors& dsts) const;
+    };
+
+    // Name-keyed counterparts of load_model / load_model_mmap, e.g. with
+    // model.named_parameters(). See CheckpointReader::load_named for `strict`.
+    // load_checkpoint converts to each parameter's dtype; the mmap variant cannot, so
+    // parameters take the dtype stored in the file (a bf16 checkpoint maps as bf16 weights).
+    void load_checkpoint(NamedTensors& params, const std::string& filepath, bool strict = true);
+    void load_checkpoint_mmap(NamedTensors& params, const std::string& filepath, bool strict = true);
+
+} // namespace axon
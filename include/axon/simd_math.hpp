@@ -0,0 +1,481 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <immintrin.h>
+
+// Polynomial exp / log / tanh for the CPU kernels, on AVX-512, AVX2 + FMA or plain floats.
+// Every function is one template over the instruction set; loops finish with a masked partial
+// vector (load_n / store_n), so tails go through the same code as the body.
+//
+// Max error against the exact result, checked over every float in range against double
+// libm, built with the library's flags (-ffast-math), for all three instruction sets;
+// see examples/25_Simd_Math.cpp:
+//   exp   1.01 ulp on [-87.3, 88.7]; inf above, gradual underflow to 0 below
+//   log   0.83 ulp for x > 0; log(0) = -inf, log(x < 0) = NaN
+//   tanh  1.33 ulp; |tanh(x)| is exactly 1 from |x| > 9.1
+// Without FMA (the scalar build) log<Scalar> can reach ~2 ulp in a loop the compiler
+// auto-vectorizes, since the vectorizer does not keep the barriers below; the kernels only
+// call it once per row.
+// Subnormal inputs and results are handled, unless the FPU flushes them (FTZ / DAZ, which
+// -ffast-math executables turn on at startup). NaN inputs give NaN only when built without
+// -ffinite-math-only: under -ffast-math the compiler may reorder the min / max clamps.
+// Range reduction and polynomials follow Cephes.
+//
+// The library compiles this header once per instruction set (src/cpu_dispatch.cpp), and even
+// the Scalar functions come out different each time; the inline namespace gives every build
+// its own symbols, so the linker cannot hand the scalar kernels an AVX-512 copy of exp<Scalar>.
+
+// MSVC has no __FMA__, but /arch:AVX2 implies it
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define AXON_SIMD_FMA 1
+#endif
+
+// -ffast-math may reassociate plain float arithmetic, which undoes the split-constant range
+// reductions below (with FMA the intrinsics / std::fma keep their order); this fences each
+// scalar op off where the compiler has a way to
+#if defined(__has_builtin)
+    #if __has_builtin(__builtin_assoc_barrier)
+        #define AXON_SIMD_ASSOC_BARRIER(x) __builtin_assoc_barrier(x)
+    #endif
+#endif
+#ifndef AXON_SIMD_ASSOC_BARRIER
+    #define AXON_SIMD_ASSOC_BARRIER(x) (x)
+#endif
+
+#if defined(__AVX512F__)
+    #define AXON_SIMD_ABI avx512
+#elif defined(__AVX2__) && defined(AXON_SIMD_FMA)
+    #define AXON_SIMD_ABI avx2
+#else
+    #define AXON_SIMD_ABI scalar
+#endif
+
+namespace axon::simd::inline AXON_SIMD_ABI {
+
+    // One struct per instruction set, all with the same static members; the functions
+    // below take it as their template argument.
+    struct Scalar {
+        using V = float;
+        using Mask = bool;
+        static constexpr size_t width = 1;
+
+        static float load(const float* p) noexcept { return *p; }
+        static void store(float* p, float v) noexcept { *p = v; }
+        static float set1(float v) noexcept { return v; }
+
+        // Loop tails: the first n < width lanes. load_n reads the rest as `fill`, store_n leaves
+        // them alone, and neither touches memory past p + n. With one lane, n is always 0.
+        static bool first_n(size_t n) noexcept { return n != 0; }
+        static float load_n(const float* p, size_t n, float fill = 0.0f) noexcept { return n ? *p : fill; }
+        static void store_n(float* p, float v, size_t n) noexcept {
+            if (n) *p = v;
+        }
+
+        static float add(float a, float b) noexcept { return AXON_SIMD_ASSOC_BARRIER(a + b); }
+        static float sub(float a, float b) noexcept { return AXON_SIMD_ASSOC_BARRIER(a - b); }
+        static float mul(float a, float b) noexcept { return AXON_SIMD_ASSOC_BARRIER(a * b); }
+        static float div(float a, float b) noexcept { return a / b; }
+#ifdef AXON_SIMD_FMA
+        static float fmadd(float a, float b, float c) noexcept { return std::fma(a, b, c); }
+        static float fnmadd(float a, float b, float c) noexcept { return std::fma(-a, b, c); }
+#else
+        // std::fma would be a libm call here
+        static float fmadd(float a, float b, float c) noexcept { return AXON_SIMD_ASSOC_BARRIER(a * b + c); }
+        static float fnmadd(float a, float b, float c) noexcept { return AXON_SIMD_ASSOC_BARRIER(c - a * b); }
+#endif
+
+        // same operand order as minps / maxps: the second operand wins when unordered
+        static float min(float a, float b) noexcept { return a < b ? a : b; }
+        static float max(float a, float b) noexcept { return a > b ? a : b; }
+        static float sqrt(float a) noexcept { return std::sqrt(a); }
+#ifdef __SSE4_1__
+        static float round(float a) noexcept { return std::nearbyint(a); }
+#else
+        // no roundss before SSE4.1, and nearbyint is a libm call; cvtss2si is fine for |a| < 2^31
+        static float round(float a) noexcept { return static_cast<float>(std::lrint(a)); }
+#endif
+
+        static bool lt(float a, float b) noexcept { return a < b; }
+        static bool eq(float a, float b) noexcept { return a == b; }
+        static float select(bool m, float a, float b) noexcept { return m ? a : b; }
+
+        static float abs(float a) noexcept { return from_bits(bits(a) & 0x7FFFFFFF); }
+        static float copysign(float mag, float sign) noexcept { return from_bits(bits(mag) | (bits(sign) & 0x80000000)); }
+
+        // the raw biased exponent, 0 ... 255
+        static float exponent_field(float a) noexcept { return static_cast<float>((bits(a) >> 23) & 0xFF); }
+        // the mantissa with the exponent replaced, in [0.5, 1)
+        static float mantissa_half(float a) noexcept { return from_bits((bits(a) & 0x007FFFFF) | 0x3F000000); }
+        // y * 2^n for y in [0.5, 2) and integral n in [-150, 128]: past one exponent field, so
+        // in two halves. The first goes straight onto y's exponent bits; as two multiplies,
+        // -ffast-math may reassociate them into y * (2^64 * 2^64) = y * inf.
+        static float ldexp(float y, float n) noexcept {
+            float h = round(n * 0.5f);
+            uint32_t e = static_cast<uint32_t>(static_cast<int32_t>(h)) << 23;
+            return from_bits(bits(y) + e) * pow2(n - h);
+        }
+
+        static float reduce_add(float a) noexcept { return a; }
+        static float reduce_max(float a) noexcept { return a; }
+
+    private:
+        // 2^n for integral n in [-126, 127]
+        static float pow2(float n) noexcept { return from_bits(static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23); }
+
+        static uint32_t bits(float f) noexcept {
+            uint32_t u;
+            std::memcpy(&u, &f, sizeof(u));
+            return u;
+        }
+
+        static float from_bits(uint32_t u) noexcept {
+            float f;
+            std::memcpy(&f, &u, sizeof(f));
+            return f;
+        }
+    };
+
+#if defined(__AVX2__) && defined(AXON_SIMD_FMA)
+    struct Avx2 {
+        using V = __m256;
+        using Mask = __m256;
+        static constexpr size_t width = 8;
+
+        static __m256 load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+        static void store(float* p, __m256 v) noexcept { _mm256_storeu_ps(p, v); }
+        static __m256 set1(float v) noexcept { return _mm256_set1_ps(v); }
+
+        // vmaskmovps, masked-off lanes do not fault
+        static Mask first_n(size_t n) noexcept { return _mm256_castsi256_ps(lane_mask(n)); }
+        static __m256 load_n(const float* p, size_t n, float fill = 0.0f) noexcept {
+            __m256i m = lane_mask(n);
+            return _mm256_blendv_ps(_mm256_set1_ps(fill), _mm256_maskload_ps(p, m), _mm256_castsi256_ps(m));
+        }
+        static void store_n(float* p, __m256 v, size_t n) noexcept { _mm256_maskstore_ps(p, lane_mask(n), v); }
+
+        static __m256 add(__m256 a, __m256 b) noexcept { return _mm256_add_ps(a, b); }
+        static __m256 sub(__m256 a, __m256 b) noexcept { return _mm256_sub_ps(a, b); }
+        static __m256 mul(__m256 a, __m256 b) noexcept { return _mm256_mul_ps(a, b); }
+        static __m256 div(__m256 a, __m256 b) noexcept { return _mm256_div_ps(a, b); }
+        static __m256 fmadd(__m256 a, __m256 b, __m256 c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+        static __m256 fnmadd(__m256 a, __m256 b, __m256 c) noexcept { return _mm256_fnmadd_ps(a, b, c); }
+
+        static __m256 min(__m256 a, __m256 b) noexcept { return _mm256_min_ps(a, b); }
+        static __m256 max(__m256 a, __m256 b) noexcept { return _mm256_max_ps(a, b); }
+        static __m256 sqrt(__m256 a) noexcept { return _mm256_sqrt_ps(a); }
+        static __m256 round(__m256 a) noexcept { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        static Mask lt(__m256 a, __m256 b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static Mask eq(__m256 a, __m256 b) noexcept { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        static __m256 select(Mask m, __m256 a, __m256 b) noexcept { return _mm256_blendv_ps(b, a, m); }
+
+        static __m256 abs(__m256 a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+        static __m256 copysign(__m256 mag, __m256 sign) noexcept { return _mm256_or_ps(mag, _mm256_and_ps(sign, _mm256_set1_ps(-0.0f))); }
+
+        static __m256 exponent_field(__m256 a) noexcept {
+            __m256i e = _mm256_and_si256(_mm256_srli_epi32(_mm256_castps_si256(a), 23), _mm256_set1_epi32(0xFF));
+            return _mm256_cvtepi32_ps(e);
+        }
+
+        static __m256 mantissa_half(__m256 a) noexcept {
+            __m256i m = _mm256_and_si256(_mm256_castps_si256(a), _mm256_set1_epi32(0x007FFFFF));
+            return _mm256_castsi256_ps(_mm256_or_si256(m, _mm256_set1_epi32(0x3F000000)));
+        }
+
+        static __m256 ldexp(__m256 y, __m256 n) noexcept {
+            __m256 h = round(_mm256_mul_ps(n, _mm256_set1_ps(0.5f)));
+            __m256i e = _mm256_slli_epi32(_mm256_cvtps_epi32(h), 23);
+            __m256 yh = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_castps_si256(y), e));
+            return _mm256_mul_ps(yh, pow2(_mm256_sub_ps(n, h)));
+        }
+
+        static float reduce_add(__m256 a) noexcept {
+            __m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+            s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+            s = _mm_add_ss(s, _mm_movehdup_ps(s));
+            return _mm_cvtss_f32(s);
+        }
+
+        static float reduce_max(__m256 a) noexcept {
+            __m128 s = _mm_max_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+            s = _mm_max_ps(s, _mm_movehl_ps(s, s));
+            s = _mm_max_ss(s, _mm_movehdup_ps(s));
+            return _mm_cvtss_f32(s);
+        }
+
+    private:
+        // n set lanes: an unaligned window into 8 x -1 followed by 8 x 0
+        static __m256i lane_mask(size_t n) noexcept {
+            static constexpr int32_t window[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(window + 8 - n));
+        }
+
+        static __m256 pow2(__m256 n) noexcept {
+            __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+            return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+        }
+    };
+#endif
+
+#ifdef __AVX512F__
+    struct Avx512 {
+        using V = __m512;
+        using Mask = __mmask16;
+        static constexpr size_t width = 16;
+
+        static __m512 load(const float* p) noexcept { return _mm512_loadu_ps(p); }
+        static void store(float* p, __m512 v) noexcept { _mm512_storeu_ps(p, v); }
+        static __m512 set1(float v) noexcept { return _mm512_set1_ps(v); }
+
+        static Mask first_n(size_t n) noexcept { return static_cast<__mmask16>((1u << n) - 1); }
+        static __m512 load_n(const float* p, size_t n, float fill = 0.0f) noexcept {
+            return _mm512_mask_loadu_ps(_mm512_set1_ps(fill), first_n(n), p);
+        }
+        static void store_n(float* p, __m512 v, size_t n) noexcept { _mm512_mask_storeu_ps(p, first_n(n), v); }
+
+        static __m512 add(__m512 a, __m512 b) noexcept { return _mm512_add_ps(a, b); }
+        static __m512 sub(__m512 a, __m512 b) noexcept { return _mm512_sub_ps(a, b); }
+        static __m512 mul(__m512 a, __m512 b) noexcept { return _mm512_mul_ps(a, b); }
+        static __m512 div(__m512 a, __m512 b) noexcept { return _mm512_div_ps(a, b); }
+        static __m512 fmadd(__m512 a, __m512 b, __m512 c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+        static __m512 fnmadd(__m512 a, __m512 b, __m512 c) noexcept { return _mm512_fnmadd_ps(a, b, c); }
+
+        static __m512 min(__m512 a, __m512 b) noexcept { return _mm512_min_ps(a, b); }
+        static __m512 max(__m512 a, __m512 b) noexcept { return _mm512_max_ps(a, b); }
+        static __m512 sqrt(__m512 a) noexcept { return _mm512_sqrt_ps(a); }
+        static __m512 round(__m512 a) noexcept { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        static Mask lt(__m512 a, __m512 b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+        static Mask eq(__m512 a, __m512 b) noexcept { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+        static __m512 select(Mask m, __m512 a, __m512 b) noexcept { return _mm512_mask_blend_ps(m, b, a); }
+
+        static __m512 abs(__m512 a) noexcept { return _mm512_abs_ps(a); }
+
+        static __m512 copysign(__m512 mag, __m512 sign) noexcept {
+            __m512i s = _mm512_and_si512(_mm512_castps_si512(sign), _mm512_set1_epi32(static_cast<int>(0x80000000)));
+            return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(mag), s));
+        }
+
+        static __m512 exponent_field(__m512 a) noexcept {
+            __m512i e = _mm512_and_si512(_mm512_srli_epi32(_mm512_castps_si512(a), 23), _mm512_set1_epi32(0xFF));
+            return _mm512_cvtepi32_ps(e);
+        }
+
+        static __m512 mantissa_half(__m512 a) noexcept {
+            __m512i m = _mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x007FFFFF));
+            return _mm512_castsi512_ps(_mm512_or_si512(m, _mm512_set1_epi32(0x3F000000)));
+        }
+
+        // vscalefps does the whole range in one go
+        static __m512 ldexp(__m512 y, __m512 n) noexcept { return _mm512_scalef_ps(y, n); }
+
+        static float reduce_add(__m512 a) noexcept { return _mm512_reduce_add_ps(a); }
+        static float reduce_max(__m512 a) noexcept { return _mm512_reduce_max_ps(a); }
+    };
+#endif
+
+    // The widest instruction set this translation unit was compiled for
+#if defined(__AVX512F__)
+    using Native = Avx512;
+#elif defined(__AVX2__) && defined(AXON_SIMD_FMA)
+    using Native = Avx2;
+#else
+    using Native = Scalar;
+#endif
+
+    template <typename O>
+    inline typename O::V exp(typename O::V x) noexcept {
+        using V = typename O::V;
+
+        // outside [-104, 89] the result is 0 / inf anyway; constant first so NaN passes through
+        x = O::max(O::set1(-104.0f), O::min(O::set1(89.0f), x));
+
+        // x = n ln2 + r, |r| <= ln2 / 2, with ln2 split in two so n * C1 is exact
+        V n = O::round(O::mul(x, O::set1(1.44269504088896341f)));
+        V r = O::fnmadd(n, O::set1(0.693359375f), x);
+        r = O::fnmadd(n, O::set1(-2.12194440e-4f), r);
+
+        V p = O::set1(1.9875691500e-4f);
+        p = O::fmadd(p, r, O::set1(1.3981999507e-3f));
+        p = O::fmadd(p, r, O::set1(8.3334519073e-3f));
+        p = O::fmadd(p, r, O::set1(4.1665795894e-2f));
+        p = O::fmadd(p, r, O::set1(1.6666665459e-1f));
+        p = O::fmadd(p, r, O::set1(5.0000001201e-1f));
+        V y = O::add(O::fmadd(p, O::mul(r, r), r), O::set1(1.0f));
+
+        return O::ldexp(y, n);
+    }
+
+    template <typename O>
+    inline typename O::V log(typename O::V x) noexcept {
+        using V = typename O::V;
+
+        // subnormals: scale into the normal range first
+        typename O::Mask tiny = O::lt(x, O::set1(1.17549435e-38f));
+        V xs = O::select(tiny, O::mul(x, O::set1(8388608.0f)), x);
+        V field = O::exponent_field(xs);
+        V e = O::sub(field, O::select(tiny, O::set1(149.0f), O::set1(126.0f)));
+
+        // x = 2^e m, m in [sqrt(1/2), sqrt(2)), then log(x) = e ln2 + log1p(m - 1)
+        V m = O::mantissa_half(xs);
+        typename O::Mask low = O::lt(m, O::set1(0.707106781186547524f));
+        e = O::select(low, O::sub(e, O::set1(1.0f)), e);
+        m = O::sub(O::select(low, O::add(m, m), m), O::set1(1.0f));
+
+        V z = O::mul(m, m);
+        V p = O::set1(7.0376836292e-2f);
+        p = O::fmadd(p, m, O::set1(-1.1514610310e-1f));
+        p = O::fmadd(p, m, O::set1(1.1676998740e-1f));
+        p = O::fmadd(p, m, O::set1(-1.2420140846e-1f));
+        p = O::fmadd(p, m, O::set1(1.4249322787e-1f));
+        p = O::fmadd(p, m, O::set1(-1.6668057665e-1f));
+        p = O::fmadd(p, m, O::set1(2.0000714765e-1f));
+        p = O::fmadd(p, m, O::set1(-2.4999993993e-1f));
+        p = O::fmadd(p, m, O::set1(3.3333331174e-1f));
+
+        V y = O::mul(O::mul(p, m), z);
+        y = O::fmadd(e, O::set1(-2.12194440e-4f), y);
+        y = O::fnmadd(z, O::set1(0.5f), y);
+        V out = O::fmadd(e, O::set1(0.693359375f), O::add(m, y));
+
+        // inf and NaN map to themselves, then x < 0 -> NaN, 0 -> -inf
+        out = O::select(O::eq(field, O::set1(255.0f)), x, out);
+        out = O::select(O::lt(x, O::set1(0.0f)), O::set1(std::numeric_limits<float>::quiet_NaN()), out);
+        return O::select(O::eq(x, O::set1(0.0f)), O::set1(-std::numeric_limits<float>::infinity()), out);
+    }
+
+    template <typename O>
+    inline typename O::V tanh(typename O::V x) noexcept {
+        using V = typename O::V;
+        V a = O::abs(x);
+
+        // |x| < 0.625: odd polynomial
+        V z = O::mul(x, x);
+        V p = O::set1(-5.70498872745e-3f);
+        p = O::fmadd(p, z, O::set1(2.06390887954e-2f));
+        p = O::fmadd(p, z, O::set1(-5.37397155531e-2f));
+        p = O::fmadd(p, z, O::set1(1.33314422036e-1f));
+        p = O::fmadd(p, z, O::set1(-3.33332819422e-1f));
+        V small = O::fmadd(O::mul(p, z), x, x);
+
+        // otherwise 1 - 2 / (exp(2|x|) + 1); past |x| = 20 that is 1 in float, and capping
+        // the argument there keeps exp finite for the refinement below
+        V e = exp<O>(O::min(O::set1(40.0f), O::add(a, a)));
+        V d = O::add(e, O::set1(1.0f));
+        V q = O::div(O::set1(2.0f), d);
+        // -ffast-math turns vector division into rcp + one Newton step; one more makes it exact enough
+        q = O::fmadd(O::fnmadd(q, d, O::set1(2.0f)), O::mul(q, O::set1(0.5f)), q);
+        V big = O::sub(O::set1(1.0f), q);
+        big = O::copysign(big, x);
+
+        return O::select(O::lt(a, O::set1(0.625f)), small, big);
+    }
+
+    // GPT-2's GELU, 0.5 x (1 + tanh(sqrt(2/pi) (x + 0.044715 x^3))), and its derivative times grad.
+    // Shared by the elementwise kernels and the fused GEMM epilogue.
+    constexpr float GELU_SQRT_2_OVER_PI = 0.79788456080286535587989f;
+    constexpr float GELU_COEF = 0.044715f;
+
+    // 0.5 * (1 + tanh(u)) is the logistic sigmoid of 2u: one exp and one divide instead of a
+    // tanh, and no 1 + tanh cancellation for negative x. Returns that sigmoid, and e = exp(-2u)
+    // for the backward (1 - s = e * s); e is capped where s is 0 in float anyway.
+    template <typename O>
+    inline typename O::V gelu_gate(typename O::V x, typename O::V x2, typename O::V& e) noexcept {
+        auto inner = O::mul(O::set1(GELU_SQRT_2_OVER_PI), O::fmadd(O::mul(O::set1(GELU_COEF), x2), x, x));
+        e = exp<O>(O::min(O::set1(80.0f), O::mul(O::set1(-2.0f), inner)));
+        return O::div(O::set1(1.0f), O::add(O::set1(1.0f), e));
+    }
+
+    template <typename O>
+    inline typename O::V gelu(typename O::V x) noexcept {
+        typename O::V e;
+        return O::mul(x, gelu_gate<O>(x, O::mul(x, x), e));
+    }
+
+    // d/dx = 0.5 (1 + t) + 0.5 x (1 - t^2) sqrt(2/pi) (1 + 3 c x^2), with t = tanh(inner)
+    //      = s + 2 x s (1 - s) sqrt(2/pi) (1 + 3 c x^2)
+    template <typename O>
+    inline typename O::V gelu_grad(typename O::V x, typename O::V grad) noexcept {
+        typename O::V e;
+        auto x2 = O::mul(x, x);
+        auto s = gelu_gate<O>(x, x2, e);
+
+        auto d_inner = O::mul(O::set1(2.0f * GELU_SQRT_2_OVER_PI), O::fmadd(O::set1(3.0f * GELU_COEF), x2, O::set1(1.0f)));
+        auto slope = O::mul(O::mul(O::mul(x, s), O::mul(e, s)), d_inner);
+        return O::mul(grad, O::add(s, slope));
+    }
+
+    // Row helpers for the softmax-shaped kernels
+
+    // max of x[0, n), -inf when n == 0
+    template <typename O = Native>
+    inline float max_of(const float* x, size_t n) noexcept {
+        constexpr float lowest = -std::numeric_limits<float>::infinity();
+        typename O::V acc = O::set1(lowest);
+        size_t i = 0;
+        for (; i + O::width <= n; i += O::width) acc = O::max(acc, O::load(x + i));
+        if (i < n) acc = O::max(acc, O::load_n(x + i, n - i, lowest));
+        return O::reduce_max(acc);
+    }
+
+    // sum of x[0, n), four accumulators to hide the add latency
+    template <typename O = Native>
+    inline float sum_of(const float* x, size_t n) noexcept {
+        constexpr size_t W = O::width;
+        typename O::V a0 = O::set1(0.0f), a1 = a0, a2 = a0, a3 = a0;
+        size_t i = 0;
+        for (; i + 4 * W <= n; i += 4 * W) {
+            a0 = O::add(a0, O::load(x + i));
+            a1 = O::add(a1, O::load(x + i + W));
+            a2 = O::add(a2, O::load(x + i + 2 * W));
+            a3 = O::add(a3, O::load(x + i + 3 * W));
+        }
+        for (; i + W <= n; i += W) a0 = O::add(a0, O::load(x + i));
+        if (i < n) a1 = O::add(a1, O::load_n(x + i, n - i));
+        return O::reduce_add(O::add(O::add(a0, a1), O::add(a2, a3)));
+    }
+
+    // sum of x[i] * y[i] over [0, n)
+    template <typename O = Native>
+    inline float dot(const float* x, const float* y, size_t n) noexcept {
+        constexpr size_t W = O::width;
+        typename O::V a0 = O::set1(0.0f), a1 = a0, a2 = a0, a3 = a0;
+        size_t i = 0;
+        for (; i + 4 * W <= n; i += 4 * W) {
+            a0 = O::fmadd(O::load(x + i), O::load(y + i), a0);
+            a1 = O::fmadd(O::load(x + i + W), O::load(y + i + W), a1);
+            a2 = O::fmadd(O::load(x + i + 2 * W), O::load(y + i + 2 * W), a2);
+            a3 = O::fmadd(O::load(x + i + 3 * W), O::load(y + i + 3 * W), a3);
+        }
+        for (; i + W <= n; i += W) a0 = O::fmadd(O::load(x + i), O::load(y + i), a0);
+        if (i < n) a1 = O::fmadd(O::load_n(x + i, n - i), O::load_n(y + i, n - i), a1);
+        return O::reduce_add(O::add(O::add(a0, a1), O::add(a2, a3)));
+    }
+
+    // out[i] = exp(x[i] - shift), returns the sum; out may be x
+    template <typename O = Native>
+    inline float exp_sub(const float* x, float shift, float* out, size_t n) noexcept {
+        size_t i = 0;
+        typename O::V acc = O::set1(0.0f), s = O::set1(shift);
+        for (; i + O::width <= n; i += O::width) {
+            typename O::V e = exp<O>(O::sub(O::load(x + i), s));
+            O::store(out + i, e);
+            acc = O::add(acc, e);
+        }
+        if (i < n) {
+            // the lanes past n would add exp(-shift)
+            typename O::V e = exp<O>(O::sub(O::load_n(x + i, n - i), s));
+            e = O::select(O::first_n(n - i), e, O::set1(0.0f));
+            O::store_n(out + i, e, n - i);
+            acc = O::add(acc, e);
+        }
+        return O::reduce_add(acc);
+    }
+
+} // namespace axon::simd::AXON_SIMD_ABI
+
+#undef AXON_SIMD_ABI
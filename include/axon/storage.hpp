@@ -2,6 +2,7 @@
 
 #include "device.hpp"
 #include "allocator.hpp"
+#include "dtype.hpp"
 #include <memory>
 #include <cstring>
 
@@ -12,6 +13,13 @@ namespace axon {
         Device device;
         Allocator* allocator;
         bool owns_memory;
+        DType dtype = DType::Float32;
+        // output of an op recorded under LazyGuard, not computed yet: the first access to the
+        // data runs the trace (see lazy.hpp)
+        bool pending = false;
+
+        // keeps external memory alive for non-owning storage (e.g. a mapped checkpoint)
+        std::shared_ptr<void> keepalive;
 
 
         Storage(size_t num_bytes, Device dev = Device(DeviceType::CPU)) :
@@ -27,14 +35,39 @@ namespace axon {
             owns_memory(false) {}
 
         ~Storage() {
-            if (owns_memory && data && allocator) {
-                allocator -> deallocate(data);
-            }
+            release();
+        }
+
+        // Point at external memory instead, releasing what this storage owned.
+        // Every Tensor sharing this storage sees the new data.
+        void rebind(void* external_ptr, size_t num_bytes, std::shared_ptr<void> owner) {
+            release();
+            data = external_ptr;
+            nbytes = num_bytes;
+            allocator = nullptr;
+            owns_memory = false;
+            keepalive = std::move(owner);
+        }
+
+        // give storage created without memory (see nn::SkipInitGuard) a real buffer
+        void materialize() {
+            if (data) return;
+            allocator = get_allocator(device.type);
+            data = allocator -> allocate(nbytes);
+            owns_memory = true;
         }
 
         Storage(const Storage&) = delete;
         Storage& operator= (const Storage&) = delete;
 
+        void release() {
+            if (owns_memory && data && allocator) {
+                allocator -> deallocate(data);
+            }
+            data = nullptr;
+            keepalive.reset();
+        }
+
         template <typename T> 
         T* ptr() {
             return static_cast<T*>(data);
@@ -4,12 +4,21 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace axon {
 
     struct GradFn;
     class Tensor;
 
+    namespace lazy {
+        void sync();
+    }
+
+    namespace trace {
+        [[noreturn]] void read_traced();
+    }
+
     struct TensorState {
         bool requires_grad = false;
         std::shared_ptr<Tensor> grad = nullptr;
@@ -27,9 +36,25 @@ namespace axon {
 
         void calculate_strides();
 
+        // empty shell for from_storage: no Storage, no TensorState
+        Tensor() : offset(0), size(0) {}
+
+        // A tensor gets its TensorState when it is created, before any copy of the handle
+        // exists, so all copies share it. Tensors created under InferenceMode have none and
+        // refuse to be given any autograd data.
+        [[noreturn]] static void no_autograd_state();
+
+        TensorState& autograd_state() {
+            if (!state) no_autograd_state();
+            return *state;
+        }
+
     public:
-        Tensor(std::vector<int> shape, Device dev = Device(DeviceType::CPU));
+        Tensor(std::vector<int> shape, Device dev = Device(DeviceType::CPU), DType dtype = DType::Float32);
 
+        // uninitialized memory: only for outputs whose every element gets written
+        static Tensor empty(std::vector<int> shape, Device dev = Device(DeviceType::CPU));
+        static Tensor empty(std::vector<int> shape, DType dtype, Device dev = Device(DeviceType::CPU));
         static Tensor zeros(std::vector<int> shape, Device dev = Device(DeviceType::CPU));
         static Tensor ones(std::vector<int> shape, Device dev = Device(DeviceType::CPU));
 
@@ -58,42 +83,90 @@ namespace axon {
             return storage;
         }
 
+        // no other Tensor (a copy or a view) holds this tensor's storage
+        [[nodiscard]] bool is_unique() const {
+            return storage.use_count() == 1;
+        }
+
         Device device() const {
             return storage -> device;
         }
 
+        // the dtype lives on the Storage, so every view of it (and a module's own
+        // parameter) follows when it changes, see nn::Module::cast_weights
+        DType dtype() const {
+            return storage -> dtype;
+        }
+
+        // Float32 tensors only
         float* data_ptr() {
+            sync_pending();
             return storage -> ptr<float>() + offset;
         }
         
         const float* data_ptr() const {
+            sync_pending();
             return storage -> ptr<float>() + offset;
         }
 
+        // typed access for the other dtypes, e.g. data_as<int32_t>() on an Int32 tensor
+        template <typename T>
+        T* data_as() {
+            return static_cast<T*>(raw_data_ptr());
+        }
+
+        template <typename T>
+        const T* data_as() const {
+            return static_cast<const T*>(raw_data_ptr());
+        }
+
+        // first element, any dtype
+        void* raw_data_ptr() {
+            sync_pending();
+            return storage -> ptr<char>() + offset * dtype_size(storage -> dtype);
+        }
+
+        const void* raw_data_ptr() const {
+            sync_pending();
+            return storage -> ptr<char>() + offset * dtype_size(storage -> dtype);
+        }
+
+        // data recorded under LazyGuard gets computed before anyone looks at it
+        void sync_pending() const {
+            if (storage && storage -> pending) {
+                lazy::sync();
+                // still pending: a value compile() is tracing, it has no data
+                if (storage -> pending) trace::read_traced();
+            }
+        }
+
         bool requires_grad() const {
-            return state -> requires_grad;
+            return state && state -> requires_grad;
         }
 
         void set_requires_grad(bool b) {
-            state -> requires_grad = b;
+            if (!b && !state) return;
+            autograd_state().requires_grad = b;
         }
 
         
         std::shared_ptr<Tensor> get_grad() const {
-            return state -> grad;
+            return state ? state -> grad : nullptr;
         }
 
         void set_grad(std::shared_ptr<Tensor> g) {
-            state -> grad = g;
+            if (!g && !state) return;
+            autograd_state().grad = g;
         }
 
 
         std::shared_ptr<GradFn> get_grad_fn() const {
-            return state -> grad_fn;
+            return state ? state -> grad_fn : nullptr;
         }
 
         void set_grad_fn(std::shared_ptr<GradFn> fn) {
-            state -> grad_fn = fn;
+            if (!fn && !state) return;
+            autograd_state().grad_fn = fn;
         }
 
 
@@ -101,7 +174,7 @@ namespace axon {
         void add_grad(const Tensor& new_grad);
         void zero_grad();
         bool is_leaf() const { 
-            return state -> grad_fn == nullptr; 
+            return !state || state -> grad_fn == nullptr; 
         }
 
 
@@ -116,8 +189,25 @@ namespace axon {
 
         
         Tensor to(Device target_device) const;
+
+        // converted copy (CPU only), or *this if it already has `target` dtype.
+        // Integer targets are plain value casts (Int8 rounds and saturates); quantizing with
+        // scales is quantize_int8
+        Tensor to(DType target) const;
     };
 
+    // (name, tensor) pairs, e.g. from nn::Module::named_parameters()
+    using NamedTensors = std::vector<std::pair<std::string, Tensor>>;
+
+    // Positional save/load: save_model writes a current-format checkpoint with the tensors named
+    // "0", "1", ...; load_model fills params[i] from the i-th tensor of any format.
+    // Name-keyed loading and random access live in serialization.hpp.
     void save_model(const std::vector<Tensor>& params, const std::string& filepath);
     void load_model(std::vector<Tensor>& params, const std::string& filepath);
+
+    // Zero-copy load: maps the file and points each parameter's Storage at its data in the
+    // mapping (no read, no copy; pages are shared with other processes mapping the same
+    // file). Parameters must be contiguous CPU tensors; build the model under
+    // nn::SkipInitGuard to skip allocating and initializing them first.
+    void load_model_mmap(std::vector<Tensor>& params, const std::string& filepath);
 } // namespace axon
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <thread>
+
+namespace axon {
+
+    // Persistent intra-op thread pool.
+    //
+    // parallel_for splits [begin, end) into chunks of at least `grain` iterations and
+    // deals them round-robin onto per-worker deques. Workers drain their own deque
+    // from the front and steal from the back of the others, and the calling thread
+    // steals too until the whole range is done.
+    //
+    // Nested parallel_for calls (from inside a chunk) run inline on the current thread.
+    class ThreadPool {
+    public:
+        using RangeFn = std::function<void(size_t, size_t)>;
+
+        // `num_threads` counts the calling thread, so 1 means "no workers"
+        explicit ThreadPool(size_t num_threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator= (const ThreadPool&) = delete;
+
+        size_t num_threads() const {
+            return workers.size() + 1;
+        }
+
+        void parallel_for(size_t begin, size_t end, size_t grain, const RangeFn& fn);
+
+        // process-wide pool used by the CPU kernels
+        // sized from AXON_NUM_THREADS, else std::thread::hardware_concurrency()
+        static ThreadPool& global();
+
+        // true while the current thread is executing a parallel_for chunk
+        static bool in_parallel_region();
+
+    private:
+        struct Job;
+        struct Task;
+        struct WorkerQueue;
+        struct Shared;
+
+        std::vector<std::thread> workers;
+        std::shared_ptr<Shared> shared;
+
+        static void worker_loop(std::shared_ptr<Shared> shared, size_t id);
+    };
+
+    // Resizes the global pool. Must not race with running kernels.
+    void set_num_threads(size_t n);
+    size_t get_num_threads();
+
+    inline void parallel_for(size_t begin, size_t end, size_t grain, const ThreadPool::RangeFn& fn) {
+        ThreadPool::global().parallel_for(begin, end, grain, fn);
+    }
+
+} // namespace axon
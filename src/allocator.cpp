@@ -0,0 +1,448 @@
+#include "axon/allocator.hpp"
+#include <sys/mman.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace axon {
+
+    namespace {
+        // every block carries its rounded size in a header right before the payload,
+        // since Allocator::deallocate only gets the pointer back
+        constexpr size_t HEADER_BYTES = CachingCPUAllocator::ALIGNMENT;
+
+        constexpr size_t MIN_BLOCK = 64;
+        constexpr size_t SMALL_LIMIT = size_t(1) << 20;
+        constexpr int MIN_SHIFT = 6;   // 64B
+        constexpr int SMALL_CLASSES = 15; // 64B .. 1MB
+
+        // per-thread blocks kept per small class before spilling into the shared pool
+        constexpr size_t THREAD_CACHE_BLOCKS = 8;
+
+        struct BlockHeader {
+            size_t size;
+        };
+
+        int floor_log2(size_t n) {
+            return 63 - __builtin_clzll(n);
+        }
+
+        size_t round_size(size_t n) {
+            if (n <= MIN_BLOCK) return MIN_BLOCK;
+            if (n <= SMALL_LIMIT) {
+                return size_t(1) << (floor_log2(n - 1) + 1);
+            }
+            // four classes per doubling: at most 25% padding on large tensors
+            size_t step = size_t(1) << (floor_log2(n) - 2);
+            return (n + step - 1) & ~(step - 1);
+        }
+
+        int small_class(size_t rounded) {
+            return floor_log2(rounded) - MIN_SHIFT;
+        }
+
+        size_t block_size(void* ptr) {
+            return reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - HEADER_BYTES) -> size;
+        }
+
+        size_t default_cache_limit() {
+            if (const char* env = std::getenv("AXON_CPU_CACHE_LIMIT_MB")) {
+                try {
+                    return static_cast<size_t>(std::stoull(env)) << 20;
+                } catch (...) {
+                    std::cerr << "[ALLOCATOR] Warning: ignoring invalid AXON_CPU_CACHE_LIMIT_MB=" << env << "\n";
+                }
+            }
+            return size_t(1024) << 20;
+        }
+
+        struct Pool {
+            std::mutex mutex;
+            std::unordered_map<size_t, std::vector<void*>> free_blocks;
+
+            std::atomic<size_t> allocated{0};
+            std::atomic<size_t> peak{0};
+            std::atomic<size_t> cached{0};
+            std::atomic<size_t> system_allocs{0};
+            std::atomic<size_t> hits{0};
+            std::atomic<size_t> frees{0};
+            std::atomic<size_t> limit{default_cache_limit()};
+        };
+
+        // never destroyed: Storage freed from static destructors still needs it
+        Pool& pool() {
+            static Pool* p = new Pool();
+            return *p;
+        }
+
+        void* system_alloc(size_t size) {
+            void* raw = std::aligned_alloc(CachingCPUAllocator::ALIGNMENT, HEADER_BYTES + size);
+            if (!raw) {
+                // whatever is cached may be exactly what the system is missing
+                CachingCPUAllocator::instance().empty_cache();
+                raw = std::aligned_alloc(CachingCPUAllocator::ALIGNMENT, HEADER_BYTES + size);
+                if (!raw) {
+                    throw std::runtime_error("[ALLOCATOR] Error: CPU out of memory");
+                }
+            }
+
+            reinterpret_cast<BlockHeader*>(raw) -> size = size;
+            pool().system_allocs.fetch_add(1, std::memory_order_relaxed);
+            return static_cast<char*>(raw) + HEADER_BYTES;
+        }
+
+        void system_free(void* ptr) {
+            std::free(static_cast<char*>(ptr) - HEADER_BYTES);
+        }
+
+        // shared pool, or back to the system once the cache limit is reached
+        void pool_put(void* ptr, size_t size) {
+            Pool& p = pool();
+            {
+                std::lock_guard<std::mutex> lock(p.mutex);
+                if (p.cached.load(std::memory_order_relaxed) + size <= p.limit.load(std::memory_order_relaxed)) {
+                    p.free_blocks[size].push_back(ptr);
+                    p.cached.fetch_add(size, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            system_free(ptr);
+        }
+
+        void* pool_take(size_t size) {
+            Pool& p = pool();
+            std::lock_guard<std::mutex> lock(p.mutex);
+            auto it = p.free_blocks.find(size);
+            if (it == p.free_blocks.end() || it -> second.empty()) {
+                return nullptr;
+            }
+            void* ptr = it -> second.back();
+            it -> second.pop_back();
+            p.cached.fetch_sub(size, std::memory_order_relaxed);
+            return ptr;
+        }
+
+        struct ThreadCache {
+            std::vector<void*> bins[SMALL_CLASSES];
+
+            void flush(bool to_system) {
+                for (int c = 0; c < SMALL_CLASSES; c++) {
+                    size_t size = MIN_BLOCK << c;
+                    for (void* ptr : bins[c]) {
+                        pool().cached.fetch_sub(size, std::memory_order_relaxed);
+                        if (to_system) {
+                            system_free(ptr);
+                        } else {
+                            pool_put(ptr, size);
+                        }
+                    }
+                    bins[c].clear();
+                }
+            }
+
+            ~ThreadCache();
+        };
+
+        // frees that happen after this thread's cache is gone go straight to the pool
+        thread_local bool tl_cache_gone = false;
+        thread_local ThreadCache tl_cache;
+
+        ThreadCache::~ThreadCache() {
+            tl_cache_gone = true;
+            flush(false);
+        }
+
+        Allocator* default_cpu_allocator() {
+            static CPUAllocator system_alloc;
+            const char* env = std::getenv("AXON_CPU_ALLOCATOR");
+            if (env && std::string(env) == "system") {
+                return &system_alloc;
+            }
+            return &CachingCPUAllocator::instance();
+        }
+
+        std::atomic<Allocator*> g_cpu_allocator{nullptr};
+        std::atomic<Allocator*> g_cuda_allocator{nullptr};
+
+        // innermost ArenaScope of this thread
+        thread_local ArenaScope::Arena* tl_arena = nullptr;
+    } // namespace
+
+    // A stack of blocks over a list of chunks. The top block ends where the next allocation
+    // starts; chunks above the top one are empty.
+    struct ArenaScope::Arena : public Allocator {
+        struct Chunk {
+            char* base;
+            size_t bytes;
+        };
+
+        struct Block {
+            char* ptr;
+            size_t chunk;
+            size_t end;   // offset in the chunk right after this block
+            size_t bytes;
+            bool freed;
+        };
+
+        mutable std::mutex mutex;
+        std::vector<Chunk> chunks;
+        std::vector<Block> blocks;
+        size_t chunk_bytes;
+        size_t used = 0, peak = 0, reserved = 0;
+        // the scope is gone: the last free unmaps everything
+        bool closed = false;
+
+        explicit Arena(size_t chunk_bytes) : chunk_bytes(std::max<size_t>(chunk_bytes, CachingCPUAllocator::ALIGNMENT)) {}
+
+        ~Arena() override {
+            for (Chunk& c : chunks) {
+                munmap(c.base, c.bytes);
+            }
+        }
+
+        void* allocate(size_t nbytes) override {
+            size_t bytes = (std::max<size_t>(nbytes, 1) + CachingCPUAllocator::ALIGNMENT - 1) & ~(CachingCPUAllocator::ALIGNMENT - 1);
+            std::lock_guard<std::mutex> lock(mutex);
+
+            size_t c = blocks.empty() ? 0 : blocks.back().chunk;
+            size_t offset = blocks.empty() ? 0 : blocks.back().end;
+            while (c < chunks.size() && offset + bytes > chunks[c].bytes) {
+                c++;
+                offset = 0;
+            }
+            if (c == chunks.size()) {
+                // at least double what is mapped, so a long forward needs only a few chunks
+                size_t size = std::max({bytes, chunk_bytes, reserved});
+                void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (base == MAP_FAILED) {
+                    throw std::runtime_error("[ARENA] Error: Could not map a " + std::to_string(size) + " byte chunk");
+                }
+                chunks.push_back({static_cast<char*>(base), size});
+                reserved += size;
+            }
+
+            char* ptr = chunks[c].base + offset;
+            blocks.push_back({ptr, c, offset + bytes, bytes, false});
+            used += bytes;
+            peak = std::max(peak, used);
+            return ptr;
+        }
+
+        void deallocate(void* ptr) override {
+            bool last = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                // usually the top block, or close to it
+                for (size_t i = blocks.size(); i-- > 0;) {
+                    if (blocks[i].ptr == ptr) {
+                        blocks[i].freed = true;
+                        break;
+                    }
+                }
+                while (!blocks.empty() && blocks.back().freed) {
+                    used -= blocks.back().bytes;
+                    blocks.pop_back();
+                }
+                last = closed && blocks.empty();
+            }
+            if (last) delete this;
+        }
+
+        void set_zero(void* ptr, size_t nbytes) override {
+            std::memset(ptr, 0, nbytes);
+        }
+
+        // The scope closed: unmap the chunks nothing lives in any more, and everything once the
+        // last block is freed.
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                closed = true;
+                if (!blocks.empty()) {
+                    size_t keep = blocks.back().chunk + 1;
+                    for (size_t c = keep; c < chunks.size(); c++) {
+                        munmap(chunks[c].base, chunks[c].bytes);
+                        reserved -= chunks[c].bytes;
+                    }
+                    chunks.resize(keep);
+                    return;
+                }
+            }
+            delete this;
+        }
+    };
+
+    ArenaScope::ArenaScope(size_t chunk_bytes) : arena(new Arena(chunk_bytes)), prev(tl_arena) {
+        tl_arena = arena;
+    }
+
+    ArenaScope::~ArenaScope() {
+        tl_arena = prev;
+        arena -> close();
+    }
+
+    size_t ArenaScope::used_bytes() const {
+        std::lock_guard<std::mutex> lock(arena -> mutex);
+        return arena -> used;
+    }
+
+    size_t ArenaScope::peak_bytes() const {
+        std::lock_guard<std::mutex> lock(arena -> mutex);
+        return arena -> peak;
+    }
+
+    size_t ArenaScope::reserved_bytes() const {
+        std::lock_guard<std::mutex> lock(arena -> mutex);
+        return arena -> reserved;
+    }
+
+    CachingCPUAllocator& CachingCPUAllocator::instance() {
+        static CachingCPUAllocator* inst = new CachingCPUAllocator();
+        return *inst;
+    }
+
+    void* CachingCPUAllocator::allocate(size_t nbytes) {
+        size_t size = round_size(nbytes);
+        Pool& p = pool();
+        void* ptr = nullptr;
+
+        if (size <= SMALL_LIMIT && !tl_cache_gone) {
+            std::vector<void*>& bin = tl_cache.bins[small_class(size)];
+            if (!bin.empty()) {
+                ptr = bin.back();
+                bin.pop_back();
+                p.cached.fetch_sub(size, std::memory_order_relaxed);
+            }
+        }
+        if (!ptr) {
+            ptr = pool_take(size);
+        }
+
+        if (ptr) {
+            p.hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ptr = system_alloc(size);
+        }
+
+        size_t now = p.allocated.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t peak = p.peak.load(std::memory_order_relaxed);
+        while (now > peak && !p.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+
+        return ptr;
+    }
+
+    void CachingCPUAllocator::deallocate(void* ptr) {
+        if (!ptr) return;
+
+        size_t size = block_size(ptr);
+        Pool& p = pool();
+        p.allocated.fetch_sub(size, std::memory_order_relaxed);
+        p.frees.fetch_add(1, std::memory_order_relaxed);
+
+        // thread-cache bytes count against the limit like the shared pool's
+        if (size <= SMALL_LIMIT && !tl_cache_gone
+            && p.cached.load(std::memory_order_relaxed) + size <= p.limit.load(std::memory_order_relaxed)) {
+            std::vector<void*>& bin = tl_cache.bins[small_class(size)];
+            if (bin.size() < THREAD_CACHE_BLOCKS) {
+                bin.push_back(ptr);
+                p.cached.fetch_add(size, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        pool_put(ptr, size);
+    }
+
+    void CachingCPUAllocator::empty_cache() {
+        if (!tl_cache_gone) {
+            tl_cache.flush(true);
+        }
+
+        Pool& p = pool();
+        std::unordered_map<size_t, std::vector<void*>> blocks;
+        {
+            std::lock_guard<std::mutex> lock(p.mutex);
+            blocks.swap(p.free_blocks);
+            for (const auto& [size, list] : blocks) {
+                p.cached.fetch_sub(size * list.size(), std::memory_order_relaxed);
+            }
+        }
+
+        for (const auto& [size, list] : blocks) {
+            for (void* ptr : list) {
+                system_free(ptr);
+            }
+        }
+    }
+
+    AllocatorStats CachingCPUAllocator::stats() const {
+        const Pool& p = pool();
+        return {
+            p.allocated.load(std::memory_order_relaxed),
+            p.peak.load(std::memory_order_relaxed),
+            p.cached.load(std::memory_order_relaxed),
+            p.system_allocs.load(std::memory_order_relaxed),
+            p.hits.load(std::memory_order_relaxed),
+            p.frees.load(std::memory_order_relaxed)
+        };
+    }
+
+    void CachingCPUAllocator::reset_peak_stats() {
+        Pool& p = pool();
+        p.peak.store(p.allocated.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    void CachingCPUAllocator::set_cache_limit(size_t bytes) {
+        Pool& p = pool();
+        p.limit.store(bytes, std::memory_order_relaxed);
+
+        // trim what is already cached: the shared pool first, then the calling thread's cache
+        // (other threads' caches stop growing past the limit and drain as they allocate)
+        std::vector<void*> release;
+        {
+            std::lock_guard<std::mutex> lock(p.mutex);
+            for (auto& [size, list] : p.free_blocks) {
+                while (!list.empty() && p.cached.load(std::memory_order_relaxed) > bytes) {
+                    release.push_back(list.back());
+                    list.pop_back();
+                    p.cached.fetch_sub(size, std::memory_order_relaxed);
+                }
+            }
+        }
+        for (void* ptr : release) {
+            system_free(ptr);
+        }
+
+        if (!tl_cache_gone && p.cached.load(std::memory_order_relaxed) > bytes) {
+            tl_cache.flush(true);
+        }
+    }
+
+    Allocator* get_allocator(DeviceType device) {
+        if (device == DeviceType::CPU) {
+            if (tl_arena) return tl_arena;
+            Allocator* a = g_cpu_allocator.load(std::memory_order_acquire);
+            return a ? a : default_cpu_allocator();
+        } else if (device == DeviceType::CUDA) {
+            static CUDAAllocator cuda_alloc;
+            Allocator* a = g_cuda_allocator.load(std::memory_order_acquire);
+            return a ? a : &cuda_alloc;
+        }
+
+        throw std::runtime_error("[ALLOCATOR] Error: Unknown allocator");
+    }
+
+    void set_allocator(DeviceType device, Allocator* allocator) {
+        if (device == DeviceType::CPU) {
+            g_cpu_allocator.store(allocator, std::memory_order_release);
+        } else if (device == DeviceType::CUDA) {
+            g_cuda_allocator.store(allocator, std::memory_order_release);
+        } else {
+            throw std::runtime_error("[ALLOCATOR] Error: Unknown allocator");
+        }
+    }
+
+} // namespace axon
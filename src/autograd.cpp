@@ -4,5 +4,6 @@
 namespace axon {
 
     bool GradMode::enabled = true;
+    bool InferenceMode::enabled = false;
 
 }
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "axon/compile.hpp"
+#include "axon/nn.hpp"
+#include "axon/grad_mode.hpp"
+#include "axon/lazy.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace axon {
+
+    namespace {
+        // every buffer starts on a cache line
+        constexpr size_t ARENA_ALIGNMENT = 64;
+
+        struct Step {
+            const char* op;
+            std::vector<Tensor> reads, writes;
+            std::function<void()> fn;
+        };
+
+        struct Tracer {
+            std::vector<Step> steps;
+            // every trace::output, in the order the ops asked for them
+            std::vector<std::shared_ptr<Storage>> outputs;
+        };
+
+        thread_local Tracer* active = nullptr;
+
+        // a traced value's storage, the steps between its write and its last read, and its place
+        struct Buffer {
+            std::shared_ptr<Storage> storage;
+            int first = -1, last = -1;
+            size_t offset = 0;
+        };
+
+        size_t align_up(size_t n) {
+            return (n + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+        }
+
+        std::string shape_str(const std::vector<int>& shape) {
+            std::string s = "(";
+            for (size_t i = 0; i < shape.size(); i++) {
+                s += (i ? ", " : "") + std::to_string(shape[i]);
+            }
+            return s + ")";
+        }
+
+        std::string mb(size_t bytes) {
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(2) << bytes / (1024.0 * 1024.0) << " MB";
+            return os.str();
+        }
+
+        // Greedy by size, largest first: each buffer takes the lowest offset that does not overlap
+        // a placed buffer alive at the same time. Returns the arena size.
+        size_t place(std::vector<Buffer>& buffers) {
+            std::vector<size_t> order(buffers.size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+                return buffers[x].storage -> nbytes > buffers[y].storage -> nbytes;
+            });
+
+            size_t total = 0;
+            std::vector<size_t> placed, live;
+            for (size_t i : order) {
+                Buffer& b = buffers[i];
+                size_t bytes = b.storage -> nbytes;
+
+                live.clear();
+                for (size_t j : placed) {
+                    if (buffers[j].first <= b.last && b.first <= buffers[j].last) live.push_back(j);
+                }
+                std::sort(live.begin(), live.end(), [&](size_t x, size_t y) { return buffers[x].offset < buffers[y].offset; });
+
+                size_t offset = 0;
+                for (size_t j : live) {
+                    if (offset + bytes <= buffers[j].offset) break;
+                    offset = std::max(offset, align_up(buffers[j].offset + buffers[j].storage -> nbytes));
+                }
+
+                b.offset = offset;
+                total = std::max(total, offset + bytes);
+                placed.push_back(i);
+            }
+            return total;
+        }
+    } // namespace
+
+    struct CompiledModule::Plan {
+        std::vector<Step> steps;
+        Tensor input, output;
+        std::shared_ptr<Storage> arena;
+        size_t unshared_bytes = 0;
+        size_t num_buffers = 0;
+
+        Plan(Tensor in, Tensor out) : input(std::move(in)), output(std::move(out)) {}
+    };
+
+    namespace trace {
+        bool is_active() {
+            return active != nullptr;
+        }
+
+        Tensor output(const std::vector<int>& shape, DType dtype) {
+            if (!active) {
+                throw std::logic_error("[COMPILE] Error: trace::output outside compile()");
+            }
+
+            std::vector<int> stride(shape.size());
+            size_t numel = 1;
+            for (int i = static_cast<int>(shape.size()) - 1; i >= 0; --i) {
+                stride[i] = static_cast<int>(numel);
+                numel *= shape[i];
+            }
+
+            auto storage = std::make_shared<Storage>(nullptr, numel * dtype_size(dtype), Device(DeviceType::CPU));
+            storage -> dtype = dtype;
+            // nothing computes it before replay: reading it during the trace throws (read_traced)
+            storage -> pending = true;
+            active -> outputs.push_back(storage);
+            return Tensor::from_storage(storage, shape, stride, 0);
+        }
+
+        void record(const char* op, std::initializer_list<const Tensor*> reads, std::initializer_list<const Tensor*> writes, std::function<void()> fn) {
+            // nothing traced goes in: the outputs get real memory and the op runs once, now (the
+            // plan drops their buffers, as no step writes them)
+            bool folds = std::none_of(reads.begin(), reads.end(), [](const Tensor* t) { return t -> get_storage() -> pending; });
+            if (folds) {
+                for (const Tensor* t : writes) {
+                    Storage& st = *t -> get_storage();
+                    st.materialize();
+                    st.pending = false;
+                }
+                fn();
+                return;
+            }
+
+            Step s{op, {}, {}, std::move(fn)};
+            for (const Tensor* t : reads) s.reads.push_back(*t);
+            for (const Tensor* t : writes) s.writes.push_back(*t);
+            active -> steps.push_back(std::move(s));
+        }
+
+        [[noreturn]] void read_traced() {
+            throw std::runtime_error("[COMPILE] Error: forward() reads a traced value outside the ops compile() records "
+                                     "(see compile.hpp for the list)");
+        }
+    } // namespace trace
+
+    CompiledModule compile(nn::Module& module, const Tensor& example_input) {
+        if (active) {
+            throw std::logic_error("[COMPILE] Error: compile() while already tracing");
+        }
+        if (example_input.device().type != DeviceType::CPU) {
+            throw std::invalid_argument("[COMPILE] Error: Only CPU modules can be compiled");
+        }
+
+        // anything recorded under LazyGuard runs now; in the trace every op is a plain kernel call
+        lazy::sync();
+        InferenceModeGuard inference;
+
+        Tracer tracer;
+        active = &tracer;
+        Tensor input = trace::output(example_input.get_shape(), example_input.dtype());
+        std::optional<Tensor> traced;
+        try {
+            traced = module.forward(input);
+        } catch (...) {
+            active = nullptr;
+            throw;
+        }
+        active = nullptr;
+
+        auto plan = std::make_shared<CompiledModule::Plan>(input, *traced);
+        plan -> steps = std::move(tracer.steps);
+
+        // liveness: [first write, last read] in steps, the input from before the first step and
+        // the output past the last
+        std::vector<Buffer> buffers;
+        std::unordered_map<const Storage*, size_t> index;
+        for (auto& s : tracer.outputs) {
+            index[s.get()] = buffers.size();
+            buffers.push_back({s});
+        }
+        auto find = [&](const Tensor& t) -> Buffer* {
+            auto it = index.find(t.get_storage().get());
+            return it == index.end() ? nullptr : &buffers[it -> second];
+        };
+
+        Buffer* in = find(input);
+        in -> first = in -> last = 0;
+        int n_steps = static_cast<int>(plan -> steps.size());
+        for (int i = 0; i < n_steps; i++) {
+            for (const Tensor& t : plan -> steps[i].writes) {
+                Buffer* b = find(t);
+                if (b -> first < 0) b -> first = i;
+                b -> last = std::max(b -> last, i);
+            }
+            for (const Tensor& t : plan -> steps[i].reads) {
+                if (Buffer* b = find(t)) b -> last = std::max(b -> last, i);
+            }
+        }
+        if (Buffer* b = find(plan -> output)) {
+            b -> last = n_steps;
+        }
+
+        // outputs an op asked for but never wrote (nothing reads them either)
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const Buffer& b) { return b.first < 0; }), buffers.end());
+
+        size_t arena_bytes = place(buffers);
+        plan -> arena = std::make_shared<Storage>(std::max<size_t>(arena_bytes, 1));
+        plan -> num_buffers = buffers.size();
+        for (Buffer& b : buffers) {
+            Storage& s = *b.storage;
+            plan -> unshared_bytes += align_up(s.nbytes);
+            s.rebind(plan -> arena -> ptr<char>() + b.offset, s.nbytes, plan -> arena);
+            s.pending = false;
+        }
+
+        CompiledModule compiled;
+        compiled.plan = std::move(plan);
+        return compiled;
+    }
+
+    Tensor CompiledModule::run(const Tensor& input) {
+        Plan& p = *plan;
+        if (input.get_shape() != p.input.get_shape() || input.dtype() != p.input.dtype()) {
+            throw std::invalid_argument("[COMPILE] Error: Compiled for a " + shape_str(p.input.get_shape()) + " " + dtype_name(p.input.dtype()) +
+                                        " input, got " + shape_str(input.get_shape()) + " " + dtype_name(input.dtype()));
+        }
+        if (input.device().type != DeviceType::CPU) {
+            throw std::invalid_argument("[COMPILE] Error: Expected a CPU input");
+        }
+
+        Tensor src = input.is_contiguous() ? input : input.contiguous();
+        std::memcpy(p.input.raw_data_ptr(), src.raw_data_ptr(), src.numel() * dtype_size(src.dtype()));
+
+        for (Step& s : p.steps) {
+            s.fn();
+        }
+        return p.output;
+    }
+
+    size_t CompiledModule::arena_bytes() const {
+        return plan -> arena -> nbytes;
+    }
+
+    size_t CompiledModule::num_steps() const {
+        return plan -> steps.size();
+    }
+
+    std::string CompiledModule::describe() const {
+        const Plan& p = *plan;
+        const char* base = p.arena -> ptr<char>();
+        std::ostringstream os;
+        os << "[COMPILE] " << p.steps.size() << " steps, arena " << mb(p.arena -> nbytes) << " for " << p.num_buffers
+           << " buffers (" << mb(p.unshared_bytes) << " without reuse)\n";
+        os << "  input " << shape_str(p.input.get_shape()) << " @ " << p.input.get_storage() -> ptr<char>() - base << "\n";
+        for (size_t i = 0; i < p.steps.size(); i++) {
+            const Step& s = p.steps[i];
+            os << "  " << std::setw(4) << i << " " << std::left << std::setw(12) << s.op << std::right;
+            for (const Tensor& t : s.writes) {
+                os << " -> " << shape_str(t.get_shape()) << " @ " << t.get_storage() -> ptr<char>() - base;
+            }
+            os << "\n";
+        }
+        return os.str();
+    }
+
+} // namespace axon
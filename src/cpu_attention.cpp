@@ -0,0 +1,249 @@
+#include "axon/kernels.hpp"
+#include "axon/simd_math.hpp"
+#include "axon/thread_pool.hpp"
+#include "cpu_isa.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// Fused attention, flash-attention style.
+//
+// Forward: each task owns BLOCK_Q query rows of one (batch, head) and walks the keys
+// BLOCK_K at a time. A tile of scores S = scale * Q K^T is turned into probabilities
+// with a running (online) row max / row sum, and P @ V is accumulated into an
+// unnormalized BLOCK_Q x D output that gets rescaled whenever the row max grows.
+// Only one BLOCK_Q x BLOCK_K tile of scores is ever live, so memory is O(T), not O(T^2).
+//
+// Backward recomputes P from the saved row log-sum-exp instead of storing it.
+// Both matrix products of every tile go through gemm_f32 with strided operands.
+//
+// Built once per instruction set, see cpu_isa.hpp; gemm_f32 is the dispatching one (BLAS when
+// configured).
+
+namespace axon::kernels::cpu::AXON_CPU_ISA {
+
+    namespace {
+        constexpr size_t BLOCK_Q = 64;
+        constexpr size_t BLOCK_K = 128;
+
+        // stand-in for -inf: -ffast-math does not promise infinities survive
+        constexpr float NEG_LARGE = -std::numeric_limits<float>::max();
+
+        // number of keys in [j0, j0 + bc) that query row i may attend to
+        inline size_t visible_keys(bool causal, size_t i, long long offset, size_t j0, size_t bc) {
+            if (!causal) return bc;
+            long long limit = static_cast<long long>(i) + offset + 1 - static_cast<long long>(j0);
+            return static_cast<size_t>(std::clamp<long long>(limit, 0, static_cast<long long>(bc)));
+        }
+
+        // keys [0, end) cover every query row in [i0, i0 + br)
+        inline size_t key_end(bool causal, size_t i0, size_t br, long long offset, size_t Tk) {
+            if (!causal) return Tk;
+            long long end = static_cast<long long>(i0 + br) + offset;
+            return static_cast<size_t>(std::clamp<long long>(end, 0, static_cast<long long>(Tk)));
+        }
+
+        struct Workspace {
+            std::vector<float> s, dp, acc, m, l;
+        };
+    } // namespace
+
+    void attention_forward_f32(
+        size_t B, size_t H, size_t Tq, size_t Tk, size_t D, float scale, bool causal,
+        const float* q, AttentionStrides q_st,
+        const float* k, AttentionStrides k_st,
+        const float* v, AttentionStrides v_st,
+        float* out, AttentionStrides out_st,
+        float* lse) noexcept {
+
+        long long offset = static_cast<long long>(Tk) - static_cast<long long>(Tq);
+        size_t q_blocks = (Tq + BLOCK_Q - 1) / BLOCK_Q;
+
+        parallel_for(0, B * H * q_blocks, 1, [=](size_t task_begin, size_t task_end) {
+            thread_local Workspace ws;
+            ws.s.resize(BLOCK_Q * BLOCK_K);
+            ws.acc.resize(BLOCK_Q * D);
+            ws.m.resize(BLOCK_Q);
+            ws.l.resize(BLOCK_Q);
+
+            for (size_t task = task_begin; task < task_end; task++) {
+                size_t bh = task / q_blocks;
+                size_t b = bh / H, h = bh % H;
+                size_t i0 = (task % q_blocks) * BLOCK_Q;
+                size_t br = std::min(BLOCK_Q, Tq - i0);
+
+                const float* Q = q + b * q_st.batch + h * q_st.head + i0 * q_st.row;
+                const float* K = k + b * k_st.batch + h * k_st.head;
+                const float* V = v + b * v_st.batch + h * v_st.head;
+
+                float* s = ws.s.data();
+                float* acc = ws.acc.data();
+                float* m = ws.m.data();
+                float* l = ws.l.data();
+
+                std::fill(acc, acc + br * D, 0.0f);
+                std::fill(m, m + br, NEG_LARGE);
+                std::fill(l, l + br, 0.0f);
+
+                size_t kv_end = key_end(causal, i0, br, offset, Tk);
+
+                for (size_t j0 = 0; j0 < kv_end; j0 += BLOCK_K) {
+                    size_t bc = std::min(BLOCK_K, kv_end - j0);
+
+                    // S = scale * Q_blk @ K_tile^T
+                    gemm_f32(false, true, br, bc, D, scale, Q, q_st.row, K + j0 * k_st.row, k_st.row, 0.0f, s, bc);
+
+                    for (size_t r = 0; r < br; r++) {
+                        float* s_row = s + r * bc;
+                        size_t n = visible_keys(causal, i0 + r, offset, j0, bc);
+
+                        if (n == 0) {
+                            std::fill(s_row, s_row + bc, 0.0f);
+                            continue;
+                        }
+
+                        float m_new = std::max(m[r], simd::max_of(s_row, n));
+                        float correction = simd::exp<simd::Scalar>(m[r] - m_new);
+
+                        float row_sum = simd::exp_sub(s_row, m_new, s_row, n);
+                        std::fill(s_row + n, s_row + bc, 0.0f);
+
+                        l[r] = l[r] * correction + row_sum;
+                        m[r] = m_new;
+
+                        if (correction != 1.0f) {
+                            float* acc_row = acc + r * D;
+                            for (size_t d = 0; d < D; d++) {
+                                acc_row[d] *= correction;
+                            }
+                        }
+                    }
+
+                    // acc += P @ V_tile
+                    gemm_f32(false, false, br, D, bc, 1.0f, s, bc, V + j0 * v_st.row, v_st.row, 1.0f, acc, D);
+                }
+
+                float* O = out + b * out_st.batch + h * out_st.head + i0 * out_st.row;
+                float* row_lse = lse ? lse + bh * Tq + i0 : nullptr;
+
+                for (size_t r = 0; r < br; r++) {
+                    // a row that sees no keys at all (causal with Tq > Tk) comes out as zeros
+                    float inv = l[r] > 0.0f ? 1.0f / l[r] : 0.0f;
+                    float* o_row = O + r * out_st.row;
+                    const float* acc_row = acc + r * D;
+                    for (size_t d = 0; d < D; d++) {
+                        o_row[d] = acc_row[d] * inv;
+                    }
+                    if (row_lse) {
+                        row_lse[r] = l[r] > 0.0f ? m[r] + simd::log<simd::Scalar>(l[r]) : 0.0f;
+                    }
+                }
+            }
+        });
+    }
+
+    void attention_backward_f32(
+        size_t B, size_t H, size_t Tq, size_t Tk, size_t D, float scale, bool causal,
+        const float* q, AttentionStrides q_st,
+        const float* k, AttentionStrides k_st,
+        const float* v, AttentionStrides v_st,
+        const float* out, AttentionStrides out_st,
+        const float* grad_out, AttentionStrides gout_st,
+        const float* lse,
+        float* grad_q, AttentionStrides gq_st,
+        float* grad_k, AttentionStrides gk_st,
+        float* grad_v, AttentionStrides gv_st) noexcept {
+
+        long long offset = static_cast<long long>(Tk) - static_cast<long long>(Tq);
+
+        // one (batch, head) per task: dK/dV tiles are owned by the key loop and every dQ row
+        // by the head, so nothing is shared between tasks
+        parallel_for(0, B * H, 1, [=](size_t bh_begin, size_t bh_end) {
+            thread_local Workspace ws;
+            ws.s.resize(BLOCK_Q * BLOCK_K);
+            ws.dp.resize(BLOCK_Q * BLOCK_K);
+            ws.m.resize(Tq); // row-wise delta = dO . O
+
+            for (size_t bh = bh_begin; bh < bh_end; bh++) {
+                size_t b = bh / H, h = bh % H;
+
+                const float* Q = q + b * q_st.batch + h * q_st.head;
+                const float* K = k + b * k_st.batch + h * k_st.head;
+                const float* V = v + b * v_st.batch + h * v_st.head;
+                const float* O = out + b * out_st.batch + h * out_st.head;
+                const float* dO = grad_out + b * gout_st.batch + h * gout_st.head;
+                const float* L = lse + bh * Tq;
+
+                float* dQ = grad_q + b * gq_st.batch + h * gq_st.head;
+                float* dK = grad_k + b * gk_st.batch + h * gk_st.head;
+                float* dV = grad_v + b * gv_st.batch + h * gv_st.head;
+
+                float* delta = ws.m.data();
+                for (size_t i = 0; i < Tq; i++) {
+                    const float* o_row = O + i * out_st.row;
+                    const float* go_row = dO + i * gout_st.row;
+                    float acc = 0.0f;
+                    for (size_t d = 0; d < D; d++) {
+                        acc += o_row[d] * go_row[d];
+                    }
+                    delta[i] = acc;
+                }
+
+                float* p = ws.s.data();
+                float* ds = ws.dp.data();
+
+                for (size_t j0 = 0; j0 < Tk; j0 += BLOCK_K) {
+                    size_t bc = std::min(BLOCK_K, Tk - j0);
+                    const float* K_j = K + j0 * k_st.row;
+                    const float* V_j = V + j0 * v_st.row;
+                    float* dK_j = dK + j0 * gk_st.row;
+                    float* dV_j = dV + j0 * gv_st.row;
+
+                    // under the causal mask, earlier query rows cannot see this key tile
+                    size_t i_first = 0;
+                    if (causal) {
+                        long long first = static_cast<long long>(j0) - offset;
+                        i_first = static_cast<size_t>(std::clamp<long long>(first, 0, static_cast<long long>(Tq)));
+                    }
+
+                    for (size_t i0 = i_first; i0 < Tq; i0 += BLOCK_Q) {
+                        size_t br = std::min(BLOCK_Q, Tq - i0);
+                        const float* Q_i = Q + i0 * q_st.row;
+                        const float* dO_i = dO + i0 * gout_st.row;
+                        float* dQ_i = dQ + i0 * gq_st.row;
+
+                        // P = exp(scale * Q_i K_j^T - lse), recomputed
+                        gemm_f32(false, true, br, bc, D, scale, Q_i, q_st.row, K_j, k_st.row, 0.0f, p, bc);
+                        for (size_t r = 0; r < br; r++) {
+                            float* p_row = p + r * bc;
+                            size_t n = visible_keys(causal, i0 + r, offset, j0, bc);
+                            simd::exp_sub(p_row, L[i0 + r], p_row, n);
+                            std::fill(p_row + n, p_row + bc, 0.0f);
+                        }
+
+                        // dV_j += P^T @ dO_i
+                        gemm_f32(true, false, bc, D, br, 1.0f, p, bc, dO_i, gout_st.row, 1.0f, dV_j, gv_st.row);
+
+                        // dS = P * (dO_i @ V_j^T - delta)
+                        gemm_f32(false, true, br, bc, D, 1.0f, dO_i, gout_st.row, V_j, v_st.row, 0.0f, ds, bc);
+                        for (size_t r = 0; r < br; r++) {
+                            float* ds_row = ds + r * bc;
+                            const float* p_row = p + r * bc;
+                            float dl = delta[i0 + r];
+                            for (size_t c = 0; c < bc; c++) {
+                                ds_row[c] = p_row[c] * (ds_row[c] - dl);
+                            }
+                        }
+
+                        // dQ_i += scale * dS @ K_j,  dK_j += scale * dS^T @ Q_i
+                        gemm_f32(false, false, br, D, bc, scale, ds, bc, K_j, k_st.row, 1.0f, dQ_i, gq_st.row);
+                        gemm_f32(true, false, bc, D, br, scale, ds, bc, Q_i, q_st.row, 1.0f, dK_j, gk_st.row);
+                    }
+                }
+            }
+        });
+    }
+
+} // namespace axon::kernels::cpu::AXON_CPU_ISA
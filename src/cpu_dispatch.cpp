@@ -0,0 +1,463 @@
+#include "axon/kernels.hpp"
+#include "cpu_isa.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#else
+    #include <cpuid.h>
+#endif
+
+#ifdef AXON_HAS_CBLAS
+    #ifdef AXON_BLAS_MKL
+        #include <mkl_cblas.h>
+    #else
+        #include <cblas.h>
+    #endif
+#endif
+
+// Runtime choice between the scalar / AVX2 / AVX-512 builds of the CPU kernels (see cpu_isa.hpp).
+// This file is compiled for the baseline target like the rest of the library, so it is safe to
+// run anywhere and only jumps into a wider build once cpuid says the CPU (and the OS) has it.
+
+namespace axon::kernels::cpu {
+
+    namespace {
+        void cpuid(uint32_t leaf, uint32_t sub, uint32_t regs[4]) noexcept {
+#if defined(_MSC_VER)
+            int r[4];
+            __cpuidex(r, static_cast<int>(leaf), static_cast<int>(sub));
+            for (int i = 0; i < 4; i++) regs[i] = static_cast<uint32_t>(r[i]);
+#else
+            __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        }
+
+        // which register state the OS saves on a context switch
+        uint64_t xgetbv0() noexcept {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t lo, hi;
+            __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+            return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+        }
+
+        CpuIsa detect_isa() noexcept {
+            uint32_t r[4];
+            cpuid(0, 0, r);
+            if (r[0] < 7) return CpuIsa::Scalar;
+
+            cpuid(1, 0, r);
+            bool fma = r[2] & (1u << 12);
+            bool osxsave = r[2] & (1u << 27);
+            bool avx = r[2] & (1u << 28);
+            bool f16c = r[2] & (1u << 29);
+            // ymm state (bits 1, 2)
+            if (!osxsave || !avx || (xgetbv0() & 0x6) != 0x6) return CpuIsa::Scalar;
+
+            cpuid(7, 0, r);
+            bool avx2 = r[1] & (1u << 5);
+            bool avx512f = r[1] & (1u << 16);
+            if (!avx2 || !fma || !f16c) return CpuIsa::Scalar;
+
+            // plus opmask and zmm state (bits 5 - 7)
+            if (avx512f && (xgetbv0() & 0xE6) == 0xE6) return CpuIsa::Avx512;
+            return CpuIsa::Avx2;
+        }
+
+        const KernelTable& table_for(CpuIsa isa) noexcept {
+            switch (isa) {
+                case CpuIsa::Avx512: return avx512::kernel_table();
+                case CpuIsa::Avx2: return avx2::kernel_table();
+                default: return scalar::kernel_table();
+            }
+        }
+
+        struct Dispatch {
+            CpuIsa best;
+            std::atomic<CpuIsa> isa;
+            std::atomic<const KernelTable*> table;
+
+            Dispatch() : best(detect_isa()), isa(best), table(nullptr) {
+                if (const char* env = std::getenv("AXON_ISA")) {
+                    CpuIsa want = best;
+                    bool valid = true;
+                    if (std::strcmp(env, "scalar") == 0) {
+                        want = CpuIsa::Scalar;
+                    } else if (std::strcmp(env, "avx2") == 0) {
+                        want = CpuIsa::Avx2;
+                    } else if (std::strcmp(env, "avx512") == 0) {
+                        want = CpuIsa::Avx512;
+                    } else {
+                        valid = false;
+                        std::cerr << "[DISPATCH] Warning: ignoring invalid AXON_ISA=" << env << "\n";
+                    }
+
+                    if (valid && want > best) {
+                        std::cerr << "[DISPATCH] Warning: AXON_ISA=" << env << " is not supported by this CPU, using "
+                                  << cpu_isa_name(best) << "\n";
+                    } else if (valid) {
+                        isa = want;
+                    }
+                }
+                table = &table_for(isa);
+            }
+        };
+
+        Dispatch& dispatch() noexcept {
+            static Dispatch d;
+            return d;
+        }
+
+        const KernelTable& active() noexcept {
+            return *dispatch().table.load(std::memory_order_relaxed);
+        }
+    } // namespace
+
+    CpuIsa cpu_isa() noexcept {
+        return dispatch().isa.load(std::memory_order_relaxed);
+    }
+
+    bool cpu_isa_supported(CpuIsa isa) noexcept {
+        return isa <= dispatch().best;
+    }
+
+    std::vector<CpuIsa> supported_cpu_isas() {
+        std::vector<CpuIsa> out;
+        for (CpuIsa isa : {CpuIsa::Scalar, CpuIsa::Avx2, CpuIsa::Avx512}) {
+            if (cpu_isa_supported(isa)) out.push_back(isa);
+        }
+        return out;
+    }
+
+    bool set_cpu_isa(CpuIsa isa) noexcept {
+        if (!cpu_isa_supported(isa)) return false;
+        Dispatch& d = dispatch();
+        d.table.store(&table_for(isa), std::memory_order_relaxed);
+        d.isa.store(isa, std::memory_order_relaxed);
+        return true;
+    }
+
+    const char* cpu_isa_name(CpuIsa isa) noexcept {
+        switch (isa) {
+            case CpuIsa::Avx512: return "avx512";
+            case CpuIsa::Avx2: return "avx2";
+            default: return "scalar";
+        }
+    }
+
+    void add_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
+        active().add_f32(n, a, b, out);
+    }
+
+    void sub_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
+        active().sub_f32(n, a, b, out);
+    }
+
+    void mul_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
+        active().mul_f32(n, a, b, out);
+    }
+
+    void div_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
+        active().div_f32(n, a, b, out);
+    }
+
+    void binary_strided_f32(BinaryOp op, size_t n, const float* a, ptrdiff_t sa, const float* b, ptrdiff_t sb, float* out, ptrdiff_t so) noexcept {
+        active().binary_strided_f32(op, n, a, sa, b, sb, out, so);
+    }
+
+    void fused_elementwise_f32(const FusedInstr* code, size_t n_code, size_t n, float* const* operands, const ptrdiff_t* strides) noexcept {
+        active().fused_elementwise_f32(code, n_code, n, operands, strides);
+    }
+
+    void fill_f32(size_t n, float value, float* AXON_RESTRICT out) noexcept {
+        active().fill_f32(n, value, out);
+    }
+
+    void sum_f32(size_t n, const float* AXON_RESTRICT inp, float* AXON_RESTRICT out) noexcept {
+        active().sum_f32(n, inp, out);
+    }
+
+    void sum_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
+        active().sum_dim_f32(outer, dim, inner, input, output);
+    }
+
+    void max_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT values, int64_t* AXON_RESTRICT indices) noexcept {
+        active().max_dim_f32(outer, dim, inner, input, values, indices);
+    }
+
+    void min_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT values, int64_t* AXON_RESTRICT indices) noexcept {
+        active().min_dim_f32(outer, dim, inner, input, values, indices);
+    }
+
+    void relu_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT out) noexcept {
+        active().relu_f32(n, input, out);
+    }
+
+    void relu_backward_f32(size_t n, const float* AXON_RESTRICT input, const float* AXON_RESTRICT grad_out, float* AXON_RESTRICT grad_input) noexcept {
+        active().relu_backward_f32(n, input, grad_out, grad_input);
+    }
+
+    void sqrt_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
+        active().sqrt_f32(n, input, output);
+    }
+
+    void exp_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
+        active().exp_f32(n, input, output);
+    }
+
+    void neg_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
+        active().neg_f32(n, input, output);
+    }
+
+    void gelu_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
+        active().gelu_f32(n, input, output);
+    }
+
+    void gelu_backward_f32(size_t n, const float* AXON_RESTRICT input, const float* AXON_RESTRICT grad_out, float* AXON_RESTRICT grad_input) noexcept {
+        active().gelu_backward_f32(n, input, grad_out, grad_input);
+    }
+
+    void log_softmax_f32(size_t rows, size_t cols, const float* AXON_RESTRICT input, float* AXON_RESTRICT out) noexcept {
+        active().log_softmax_f32(rows, cols, input, out);
+    }
+
+    void log_softmax_backward_f32(size_t rows, size_t cols, const float* AXON_RESTRICT grad_output, const float* AXON_RESTRICT output, float* AXON_RESTRICT grad_input) noexcept {
+        active().log_softmax_backward_f32(rows, cols, grad_output, output, grad_input);
+    }
+
+    void softmax_f32(size_t rows, size_t cols, const float* AXON_RESTRICT input, float* AXON_RESTRICT out) noexcept {
+        active().softmax_f32(rows, cols, input, out);
+    }
+
+    void softmax_backward_f32(size_t rows, size_t cols, const float* AXON_RESTRICT grad_output, const float* AXON_RESTRICT output, float* AXON_RESTRICT grad_input) noexcept {
+        active().softmax_backward_f32(rows, cols, grad_output, output, grad_input);
+    }
+
+    void layernorm_forward_f32(
+        size_t rows, size_t cols, const float* AXON_RESTRICT input,
+        const float* AXON_RESTRICT gamma, const float* AXON_RESTRICT beta,
+        float* AXON_RESTRICT out, float eps) noexcept {
+
+        active().layernorm_forward_f32(rows, cols, input, gamma, beta, out, eps);
+    }
+
+    void layernorm_backward_f32(
+        size_t rows, size_t cols,
+        const float* AXON_RESTRICT grad_out, const float* AXON_RESTRICT input,
+        const float* AXON_RESTRICT gamma, float eps,
+        float* AXON_RESTRICT grad_input, float* AXON_RESTRICT grad_gamma, float* AXON_RESTRICT grad_beta) noexcept {
+
+        active().layernorm_backward_f32(rows, cols, grad_out, input, gamma, eps, grad_input, grad_gamma, grad_beta);
+    }
+
+    void cast_f32_to_f16(size_t n, const float* AXON_RESTRICT src, uint16_t* AXON_RESTRICT dst) noexcept {
+        active().cast_f32_to_f16(n, src, dst);
+    }
+
+    void cast_f16_to_f32(size_t n, const uint16_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept {
+        active().cast_f16_to_f32(n, src, dst);
+    }
+
+    void cast_f32_to_bf16(size_t n, const float* AXON_RESTRICT src, uint16_t* AXON_RESTRICT dst) noexcept {
+        active().cast_f32_to_bf16(n, src, dst);
+    }
+
+    void cast_bf16_to_f32(size_t n, const uint16_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept {
+        active().cast_bf16_to_f32(n, src, dst);
+    }
+
+    void cast_f32_to_i8(size_t n, const float* AXON_RESTRICT src, int8_t* AXON_RESTRICT dst) noexcept {
+        active().cast_f32_to_i8(n, src, dst);
+    }
+
+    void cast_i8_to_f32(size_t n, const int8_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept {
+        active().cast_i8_to_f32(n, src, dst);
+    }
+
+    template <typename Index>
+    void embedding_forward_f32(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const float* AXON_RESTRICT weight, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out) noexcept {
+
+        active().embedding<Index>().embedding_forward_f32(vocab_size, dim, num_indices, weight, indices, out);
+    }
+
+    template <typename Index>
+    void embedding_forward_f16(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const uint16_t* AXON_RESTRICT weight, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out) noexcept {
+
+        active().embedding<Index>().embedding_forward_f16(vocab_size, dim, num_indices, weight, indices, out);
+    }
+
+    template <typename Index>
+    void embedding_forward_bf16(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const uint16_t* AXON_RESTRICT weight, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out) noexcept {
+
+        active().embedding<Index>().embedding_forward_bf16(vocab_size, dim, num_indices, weight, indices, out);
+    }
+
+    template <typename Index>
+    void embedding_forward_i8(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const int8_t* AXON_RESTRICT weight, const float* AXON_RESTRICT row_scale,
+        const Index* AXON_RESTRICT indices, float* AXON_RESTRICT out) noexcept {
+
+        active().embedding<Index>().embedding_forward_i8(vocab_size, dim, num_indices, weight, row_scale, indices, out);
+    }
+
+    template <typename Index>
+    void embedding_backward_f32(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const float* AXON_RESTRICT grad_output, const Index* AXON_RESTRICT indices, float* AXON_RESTRICT grad_weight) noexcept {
+
+        active().embedding<Index>().embedding_backward_f32(vocab_size, dim, num_indices, grad_output, indices, grad_weight);
+    }
+
+    #define AXON_EMBEDDING_INSTANTIATE(Index) \
+        template void embedding_forward_f32<Index>(size_t, size_t, size_t, const float*, const Index*, float*) noexcept; \
+        template void embedding_forward_f16<Index>(size_t, size_t, size_t, const uint16_t*, const Index*, float*) noexcept; \
+        template void embedding_forward_bf16<Index>(size_t, size_t, size_t, const uint16_t*, const Index*, float*) noexcept; \
+        template void embedding_forward_i8<Index>(size_t, size_t, size_t, const int8_t*, const float*, const Index*, float*) noexcept; \
+        template void embedding_backward_f32<Index>(size_t, size_t, size_t, const float*, const Index*, float*) noexcept;
+
+    AXON_EMBEDDING_INSTANTIATE(int32_t)
+    AXON_EMBEDDING_INSTANTIATE(int64_t)
+
+    #undef AXON_EMBEDDING_INSTANTIATE
+
+    void matmul_f32(
+        size_t M, size_t N, size_t K,
+        const float* AXON_RESTRICT a,
+        const float* AXON_RESTRICT b,
+        float* AXON_RESTRICT out) noexcept {
+
+        gemm_f32(false, false, M, N, K, 1.0f, a, K, b, N, 0.0f, out, N);
+    }
+
+    void gemm_f32(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        float alpha,
+        const float* AXON_RESTRICT a, size_t lda,
+        const float* AXON_RESTRICT b, size_t ldb,
+        float beta,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+#ifdef AXON_HAS_CBLAS
+        // degenerate shapes stay on the built-in path: BLAS wants every ld >= 1
+        if (M > 0 && N > 0 && K > 0) {
+            cblas_sgemm(CblasRowMajor,
+                        trans_a ? CblasTrans : CblasNoTrans,
+                        trans_b ? CblasTrans : CblasNoTrans,
+                        static_cast<int>(M), static_cast<int>(N), static_cast<int>(K),
+                        alpha, a, static_cast<int>(lda), b, static_cast<int>(ldb),
+                        beta, out, static_cast<int>(ldc));
+            return;
+        }
+#endif
+        active().gemm_f32_builtin(trans_a, trans_b, M, N, K, alpha, a, lda, b, ldb, beta, out, ldc);
+    }
+
+    void gemm_f32_builtin(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        float alpha,
+        const float* AXON_RESTRICT a, size_t lda,
+        const float* AXON_RESTRICT b, size_t ldb,
+        float beta,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        active().gemm_f32_builtin(trans_a, trans_b, M, N, K, alpha, a, lda, b, ldb, beta, out, ldc);
+    }
+
+    void gemm_f32_f16(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        float alpha,
+        const float* AXON_RESTRICT a, size_t lda,
+        const uint16_t* AXON_RESTRICT b, size_t ldb,
+        float beta,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        active().gemm_f32_f16(trans_a, trans_b, M, N, K, alpha, a, lda, b, ldb, beta, out, ldc);
+    }
+
+    void gemm_f32_bf16(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        float alpha,
+        const float* AXON_RESTRICT a, size_t lda,
+        const uint16_t* AXON_RESTRICT b, size_t ldb,
+        float beta,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        active().gemm_f32_bf16(trans_a, trans_b, M, N, K, alpha, a, lda, b, ldb, beta, out, ldc);
+    }
+
+    void gemm_f32_i8(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        const float* AXON_RESTRICT a, size_t lda,
+        const int8_t* AXON_RESTRICT b, size_t ldb,
+        const float* AXON_RESTRICT scale,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        active().gemm_f32_i8(trans_a, trans_b, M, N, K, a, lda, b, ldb, scale, out, ldc);
+    }
+
+    void gemm_f32_bias_act(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        const float* AXON_RESTRICT a, size_t lda,
+        const float* AXON_RESTRICT b, size_t ldb,
+        const float* AXON_RESTRICT bias, Activation act,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        active().gemm_f32_bias_act(trans_a, trans_b, M, N, K, a, lda, b, ldb, bias, act, out, ldc);
+    }
+
+    const char* blas_backend() noexcept {
+#ifdef AXON_HAS_CBLAS
+        return AXON_BLAS_NAME;
+#else
+        return "builtin";
+#endif
+    }
+
+    void attention_forward_f32(
+        size_t B, size_t H, size_t Tq, size_t Tk, size_t D, float scale, bool causal,
+        const float* q, AttentionStrides q_st,
+        const float* k, AttentionStrides k_st,
+        const float* v, AttentionStrides v_st,
+        float* out, AttentionStrides out_st,
+        float* lse) noexcept {
+
+        active().attention_forward_f32(B, H, Tq, Tk, D, scale, causal, q, q_st, k, k_st, v, v_st, out, out_st, lse);
+    }
+
+    void attention_backward_f32(
+        size_t B, size_t H, size_t Tq, size_t Tk, size_t D, float scale, bool causal,
+        const float* q, AttentionStrides q_st,
+        const float* k, AttentionStrides k_st,
+        const float* v, AttentionStrides v_st,
+        const float* out, AttentionStrides out_st,
+        const float* grad_out, AttentionStrides gout_st,
+        const float* lse,
+        float* grad_q, AttentionStrides gq_st,
+        float* grad_k, AttentionStrides gk_st,
+        float* grad_v, AttentionStrides gv_st) noexcept {
+
+        active().attention_backward_f32(B, H, Tq, Tk, D, scale, causal, q, q_st, k, k_st, v, v_st, out, out_st,
+                                        grad_out, gout_st, lse, grad_q, gq_st, grad_k, gk_st, grad_v, gv_st);
+    }
+
+} // namespace axon::kernels::cpu
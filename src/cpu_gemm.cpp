@@ -0,0 +1,585 @@
+#include "axon/kernels.hpp"
+#include "axon/dtype.hpp"
+#include "axon/simd_math.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h> // AVX2 / FMA / F16C / AVX-512F
+#include "axon/thread_pool.hpp"
+#include "cpu_isa.hpp"
+
+// Packed, cache-blocked SGEMM (Goto / BLIS loop structure)
+//
+//   for jc in N step NC        B block  (KC x NC) lives in L3
+//     for pc in K step KC      packed once per (jc, pc)
+//       for ic in M step MC    A block  (MC x KC) lives in L2
+//         for jr in NC step NR B panel  (KC x NR) lives in L1
+//           for ir in MC step MR
+//             micro-kernel: MR x NR tile of C held in registers
+//
+// Threads split the (ic, jr) iteration space of each (jc, pc) step: B is packed once
+// (in parallel) and shared, every thread packs its own A blocks.
+//
+// Built once per instruction set (see cpu_isa.hpp). The micro-kernel keeps two vectors
+// per row of the tile:
+//   avx512  12 x 32: 24 zmm accumulators + 2 B vectors, the A broadcasts fold into the FMAs
+//   avx2     6 x 16: 12 ymm accumulators + 2 B vectors + 1 broadcast of A, 15 of 16 ymm
+//   scalar   4 x 8:  plain floats, left for the compiler to vectorize with baseline SSE2
+
+namespace axon::kernels::cpu::AXON_CPU_ISA {
+
+    namespace {
+        using Isa = simd::Native;
+        constexpr size_t LANES = Isa::width;
+
+        constexpr size_t MR = LANES == 16 ? 12 : LANES == 8 ? 6 : 4;
+        constexpr size_t NR = LANES == 1 ? 8 : 2 * LANES;
+
+        // KC * NR * 4B = 16KB B panel (L1; 32KB with AVX-512), MC * KC * 4B = 168KB A block
+        // (L2; 240KB with AVX-512), KC * NC * 4B = ~4MB B block (L3)
+        constexpr size_t KC = 256;
+        constexpr size_t MC = LANES == 16 ? 240 : 168;
+        constexpr size_t NC = 4080 / NR * NR;
+
+        // below this many rows the packing cost is not amortized,
+        // so we stream B once per row instead
+        constexpr size_t SMALL_M = 4;
+
+        constexpr size_t PACK_ALIGNMENT = 64;
+
+        // work split granularity: B panels per packing chunk, columns per small-M chunk
+        constexpr size_t PACK_B_GRAIN = 4;
+        constexpr size_t SMALL_M_COL_GRAIN = 256;
+        // narrowest column range handed to one thread in the blocked path
+        constexpr size_t MIN_TASK_COLS = 4 * NR;
+        // elements per chunk of the int8 dequantization pass
+        constexpr size_t SCALE_GRAIN = 1 << 15;
+
+        struct PackBuffer {
+            float* data = nullptr;
+            size_t capacity = 0;
+
+            ~PackBuffer() {
+                std::free(data);
+            }
+
+            float* get(size_t n) {
+                if (n > capacity) {
+                    std::free(data);
+                    size_t nbytes = (n * sizeof(float) + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+                    data = static_cast<float*>(std::aligned_alloc(PACK_ALIGNMENT, nbytes));
+                    capacity = data ? n : 0;
+                }
+                return data;
+            }
+        };
+
+        // How B elements become floats, LANES at a time. Packing widens 16-bit B once per block,
+        // so the micro-kernel only ever sees float32; the small-M path widens as it streams B.
+        struct LoadF32 {
+            using T = float;
+            static Isa::V load(const float* p) noexcept {
+                return Isa::load(p);
+            }
+            static float load1(const float* p) noexcept {
+                return *p;
+            }
+        };
+
+        struct LoadF16 {
+            using T = uint16_t;
+            static Isa::V load(const uint16_t* p) noexcept {
+#if defined(__AVX512F__)
+                return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+#elif defined(__AVX2__) && defined(AXON_SIMD_FMA)
+    #ifdef __F16C__
+                return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    #else
+                alignas(32) float tmp[8];
+                for (int i = 0; i < 8; i++) tmp[i] = f16_to_float(p[i]);
+                return _mm256_load_ps(tmp);
+    #endif
+#else
+                return load1(p);
+#endif
+            }
+            static float load1(const uint16_t* p) noexcept {
+                return f16_to_float(*p);
+            }
+        };
+
+        struct LoadBF16 {
+            using T = uint16_t;
+            static Isa::V load(const uint16_t* p) noexcept {
+#if defined(__AVX512F__)
+                __m512i wide = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+                return _mm512_castsi512_ps(_mm512_slli_epi32(wide, 16));
+#elif defined(__AVX2__) && defined(AXON_SIMD_FMA)
+                __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+                return _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16));
+#else
+                return load1(p);
+#endif
+            }
+            static float load1(const uint16_t* p) noexcept {
+                return bf16_to_float(*p);
+            }
+        };
+
+        struct LoadI8 {
+            using T = int8_t;
+            static Isa::V load(const int8_t* p) noexcept {
+#if defined(__AVX512F__)
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(bytes));
+#elif defined(__AVX2__) && defined(AXON_SIMD_FMA)
+                __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+                return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(bytes));
+#else
+                return load1(p);
+#endif
+            }
+            static float load1(const int8_t* p) noexcept {
+                return static_cast<float>(*p);
+            }
+        };
+
+        // bias + activation on finished values of C (gemm_f32_bias_act). bias is indexed by the
+        // column of whatever C pointer the epilogue travels with; at() moves it along.
+        struct Epilogue {
+            const float* bias = nullptr;
+            Activation act = Activation::None;
+
+            bool active() const noexcept {
+                return bias || act != Activation::None;
+            }
+
+            Epilogue at(size_t j) const noexcept {
+                return {bias ? bias + j : nullptr, act};
+            }
+
+            // x is columns [j, j + k) of a row, k < LANES on an edge
+            Isa::V apply(Isa::V x, size_t j, size_t k = LANES) const noexcept {
+                if (bias) {
+                    x = Isa::add(x, k == LANES ? Isa::load(bias + j) : Isa::load_n(bias + j, k));
+                }
+                if (act == Activation::Relu) {
+                    x = Isa::max(x, Isa::set1(0.0f));
+                } else if (act == Activation::Gelu) {
+                    x = simd::gelu<Isa>(x);
+                }
+                return x;
+            }
+
+            // C[0:M, j0:j1] in place, for the paths that finish C outside the micro-kernel
+            void apply_rows(size_t M, size_t j0, size_t j1, float* c, size_t ldc) const noexcept {
+                for (size_t i = 0; i < M; i++) {
+                    float* row = c + i * ldc;
+                    size_t j = j0;
+                    for (; j + LANES <= j1; j += LANES) {
+                        Isa::store(row + j, apply(Isa::load(row + j), j));
+                    }
+                    if (j < j1) {
+                        Isa::store_n(row + j, apply(Isa::load_n(row + j, j1 - j), j, j1 - j), j1 - j);
+                    }
+                }
+            }
+        };
+
+        // A block (mc x kc) -> ceil(mc / MR) panels, each laid out as [k][MR]
+        // rows past mc are zero padded so the micro-kernel never branches
+        void pack_a(size_t mc, size_t kc, const float* a, size_t rs, size_t cs, float* AXON_RESTRICT dst) noexcept {
+            for (size_t i = 0; i < mc; i += MR) {
+                size_t rows = std::min(MR, mc - i);
+                const float* src = a + i * rs;
+
+                if (rows == MR && cs == 1) {
+                    for (size_t k = 0; k < kc; k++) {
+                        for (size_t r = 0; r < MR; r++) {
+                            dst[r] = src[r * rs + k];
+                        }
+                        dst += MR;
+                    }
+                } else {
+                    for (size_t k = 0; k < kc; k++) {
+                        size_t r = 0;
+                        for (; r < rows; r++) {
+                            dst[r] = src[r * rs + k * cs];
+                        }
+                        for (; r < MR; r++) {
+                            dst[r] = 0.0f;
+                        }
+                        dst += MR;
+                    }
+                }
+            }
+        }
+
+        // B block (kc x nc) -> ceil(nc / NR) panels, each laid out as [k][NR]
+        template <typename L>
+        void pack_b(size_t kc, size_t nc, const typename L::T* b, size_t rs, size_t cs, float* AXON_RESTRICT dst) noexcept {
+            for (size_t j = 0; j < nc; j += NR) {
+                size_t cols = std::min(NR, nc - j);
+                const typename L::T* src = b + j * cs;
+
+                if (cols == NR && cs == 1) {
+                    for (size_t k = 0; k < kc; k++) {
+                        const typename L::T* row = src + k * rs;
+                        for (size_t v = 0; v < NR; v += LANES) {
+                            Isa::store(dst + v, L::load(row + v));
+                        }
+                        dst += NR;
+                    }
+                } else if (cols == NR && rs == 1) {
+                    // transposed B: walk each source row (a column of the panel) contiguously
+                    for (size_t c = 0; c < NR; c++) {
+                        const typename L::T* col = src + c * cs;
+                        for (size_t k = 0; k < kc; k++) {
+                            dst[k * NR + c] = L::load1(col + k);
+                        }
+                    }
+                    dst += kc * NR;
+                } else {
+                    for (size_t k = 0; k < kc; k++) {
+                        size_t c = 0;
+                        for (; c < cols; c++) {
+                            dst[c] = L::load1(src + k * rs + c * cs);
+                        }
+                        for (; c < NR; c++) {
+                            dst[c] = 0.0f;
+                        }
+                        dst += NR;
+                    }
+                }
+            }
+        }
+
+        // C[0:MR, 0:NR] = ep(alpha * A_panel @ B_panel + beta * C)
+        // beta == 0 never reads C, so the output does not need to be initialized
+        // (the loops have constant bounds and unroll completely, acc stays in registers)
+        // Edge tiles only write C[0:mr, 0:nr]: the panels are zero padded, so the tile is computed
+        // in full and the partial vector of each row goes out through a masked load / store.
+        template <bool Edge>
+        inline void micro_kernel(
+            size_t kc, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b,
+            float* c, size_t ldc, float alpha, float beta, Epilogue ep, size_t mr = MR, size_t nr = NR) noexcept {
+
+            constexpr size_t NV = NR / LANES;
+            Isa::V acc[MR][NV];
+            for (size_t r = 0; r < MR; r++) {
+                for (size_t v = 0; v < NV; v++) acc[r][v] = Isa::set1(0.0f);
+            }
+
+            for (size_t k = 0; k < kc; k++) {
+                Isa::V bv[NV];
+                for (size_t v = 0; v < NV; v++) bv[v] = Isa::load(b + v * LANES);
+
+                for (size_t r = 0; r < MR; r++) {
+                    Isa::V av = Isa::set1(a[r]);
+                    for (size_t v = 0; v < NV; v++) acc[r][v] = Isa::fmadd(av, bv[v], acc[r][v]);
+                }
+
+                a += MR;
+                b += NR;
+            }
+
+            Isa::V valpha = Isa::set1(alpha);
+            Isa::V vbeta = Isa::set1(beta);
+
+            for (size_t r = 0; r < MR; r++) {
+                if (Edge && r >= mr) break;
+
+                for (size_t v = 0; v < NV; v++) {
+                    float* dst = c + r * ldc + v * LANES;
+                    Isa::V x = Isa::mul(acc[r][v], valpha);
+
+                    if (Edge && nr < (v + 1) * LANES) {
+                        if (nr <= v * LANES) break;
+                        size_t k = nr - v * LANES;
+                        if (beta != 0.0f) {
+                            x = Isa::fmadd(vbeta, Isa::load_n(dst, k), x);
+                        }
+                        if (ep.active()) {
+                            x = ep.apply(x, v * LANES, k);
+                        }
+                        Isa::store_n(dst, x, k);
+                        continue;
+                    }
+
+                    if (beta != 0.0f) {
+                        x = Isa::fmadd(vbeta, Isa::load(dst), x);
+                    }
+                    if (ep.active()) {
+                        x = ep.apply(x, v * LANES);
+                    }
+                    Isa::store(dst, x);
+                }
+            }
+        }
+
+        void macro_kernel(
+            size_t mc, size_t nc, size_t kc,
+            const float* packed_a, const float* packed_b,
+            float* c, size_t ldc, float alpha, float beta, Epilogue ep) noexcept {
+
+            for (size_t jr = 0; jr < nc; jr += NR) {
+                size_t nr = std::min(NR, nc - jr);
+                const float* b_panel = packed_b + jr * kc;
+
+                for (size_t ir = 0; ir < mc; ir += MR) {
+                    size_t mr = std::min(MR, mc - ir);
+                    const float* a_panel = packed_a + ir * kc;
+                    float* c_tile = c + ir * ldc + jr;
+
+                    if (mr == MR && nr == NR) {
+                        micro_kernel<false>(kc, a_panel, b_panel, c_tile, ldc, alpha, beta, ep.at(jr));
+                    } else {
+                        micro_kernel<true>(kc, a_panel, b_panel, c_tile, ldc, alpha, beta, ep.at(jr), mr, nr);
+                    }
+                }
+            }
+        }
+
+        // C[i, j0:j1] (beta == 0: zero, else scale by beta) before accumulating into it
+        void scale_rows(size_t M, size_t j0, size_t j1, float beta, float* c, size_t ldc) noexcept {
+            for (size_t i = 0; i < M; i++) {
+                float* c_row = c + i * ldc;
+                if (beta == 0.0f) {
+                    std::memset(c_row + j0, 0, (j1 - j0) * sizeof(float));
+                } else if (beta != 1.0f) {
+                    for (size_t j = j0; j < j1; j++) {
+                        c_row[j] *= beta;
+                    }
+                }
+            }
+        }
+
+        // C[i, j] *= scale[j], the per-column dequantization after an int8 GEMM
+        void scale_cols(size_t M, size_t N, const float* scale, float* c, size_t ldc) noexcept {
+            parallel_for(0, M, std::max<size_t>(1, SCALE_GRAIN / std::max<size_t>(N, 1)), [=](size_t i0, size_t i1) {
+                for (size_t i = i0; i < i1; i++) {
+                    float* c_row = c + i * ldc;
+                    size_t j = 0;
+                    for (; j + LANES <= N; j += LANES) {
+                        Isa::store(c_row + j, Isa::mul(Isa::load(c_row + j), Isa::load(scale + j)));
+                    }
+                    if (j < N) {
+                        Isa::store_n(c_row + j, Isa::mul(Isa::load_n(c_row + j, N - j), Isa::load_n(scale + j, N - j)), N - j);
+                    }
+                }
+            });
+        }
+
+        // out[i, j0:j1] = alpha * sum_k a[i, k] * b[k, j0:j1] + beta * out[i, j0:j1] for a handful of rows
+        // each row of B is streamed once; the output row stays hot in cache
+        template <typename L>
+        void gemm_small_m(
+            size_t M, size_t j0, size_t j1, size_t K, float alpha,
+            const float* a, size_t rsa, size_t csa,
+            const typename L::T* b, size_t rsb,
+            float beta, float* out, size_t ldc) noexcept {
+
+            for (size_t i = 0; i < M; i++) {
+                float* c_row = out + i * ldc;
+                size_t k_begin = 0;
+
+                // with beta == 0 the first rank-1 update writes the row outright,
+                // so C is neither zeroed nor read beforehand (K >= 1 here)
+                if (beta == 0.0f) {
+                    float s = alpha * a[i * rsa];
+                    Isa::V va = Isa::set1(s);
+
+                    size_t j = j0;
+                    for (; j + LANES <= j1; j += LANES) {
+                        Isa::store(c_row + j, Isa::mul(va, L::load(b + j)));
+                    }
+                    for (; j < j1; j++) {
+                        c_row[j] = s * L::load1(b + j);
+                    }
+                    k_begin = 1;
+                } else {
+                    scale_rows(1, j0, j1, beta, c_row, ldc);
+                }
+
+                for (size_t k = k_begin; k < K; k++) {
+                    float s = alpha * a[i * rsa + k * csa];
+                    Isa::V va = Isa::set1(s);
+                    const typename L::T* b_row = b + k * rsb;
+
+                    size_t j = j0;
+                    for (; j + LANES <= j1; j += LANES) {
+                        Isa::store(c_row + j, Isa::fmadd(va, L::load(b_row + j), Isa::load(c_row + j)));
+                    }
+
+                    for (; j < j1; j++) {
+                        c_row[j] += s * L::load1(b_row + j);
+                    }
+                }
+            }
+        }
+
+        // C (M x N, row-major, leading dim ldc) = ep(alpha * op(A) @ op(B) + beta * C)
+        // A and B are addressed through (row stride, col stride) so packing absorbs any layout
+        template <typename L>
+        void gemm_blocked(
+            size_t M, size_t N, size_t K, float alpha,
+            const float* a, size_t rsa, size_t csa,
+            const typename L::T* b, size_t rsb, size_t csb,
+            float beta, float* c, size_t ldc, Epilogue ep = {}) noexcept {
+
+            if (K == 0 || alpha == 0.0f) {
+                scale_rows(M, 0, N, beta, c, ldc);
+                if (ep.active()) {
+                    ep.apply_rows(M, 0, N, c, ldc);
+                }
+                return;
+            }
+
+            if (M <= SMALL_M && csb == 1) {
+                parallel_for(0, N, SMALL_M_COL_GRAIN, [=](size_t j0, size_t j1) {
+                    gemm_small_m<L>(M, j0, j1, K, alpha, a, rsa, csa, b, rsb, beta, c, ldc);
+                    // the rows of this column range are still in cache
+                    if (ep.active()) {
+                        ep.apply_rows(M, j0, j1, c, ldc);
+                    }
+                });
+                return;
+            }
+
+            // one set of pack buffers per thread, reused across calls
+            thread_local PackBuffer b_buf;
+
+            size_t nc_max = std::min(NC, (N + NR - 1) / NR * NR);
+            size_t mc_max = std::min(MC, (M + MR - 1) / MR * MR);
+            size_t kc_max = std::min(KC, K);
+
+            float* packed_b = b_buf.get(kc_max * nc_max);
+
+            size_t num_threads = get_num_threads();
+            size_t m_blocks = (M + MC - 1) / MC;
+
+            for (size_t jc = 0; jc < N; jc += NC) {
+                size_t nc = std::min(NC, N - jc);
+                size_t n_panels = (nc + NR - 1) / NR;
+
+                // split columns until there are ~2 tasks per thread
+                size_t n_chunks = std::max<size_t>(1, (2 * num_threads + m_blocks - 1) / m_blocks);
+                n_chunks = std::min(n_chunks, std::max<size_t>(1, nc / MIN_TASK_COLS));
+                size_t chunk_cols = ((nc + n_chunks - 1) / n_chunks + NR - 1) / NR * NR;
+                n_chunks = (nc + chunk_cols - 1) / chunk_cols;
+
+                for (size_t pc = 0; pc < K; pc += KC) {
+                    size_t kc = std::min(KC, K - pc);
+                    // later K blocks add onto what the first one wrote, the last one finishes C
+                    float beta_block = pc == 0 ? beta : 1.0f;
+                    Epilogue ep_block = pc + KC >= K ? ep : Epilogue{};
+                    const typename L::T* b_block = b + pc * rsb + jc * csb;
+
+                    parallel_for(0, n_panels, PACK_B_GRAIN, [&](size_t p0, size_t p1) {
+                        size_t j0 = p0 * NR;
+                        size_t j1 = std::min(nc, p1 * NR);
+                        pack_b<L>(kc, j1 - j0, b_block + j0 * csb, rsb, csb, packed_b + j0 * kc);
+                    });
+
+                    parallel_for(0, m_blocks * n_chunks, 1, [&](size_t t0, size_t t1) {
+                        thread_local PackBuffer a_buf;
+                        float* packed_a = a_buf.get(mc_max * kc_max);
+                        size_t packed_block = SIZE_MAX;
+
+                        for (size_t t = t0; t < t1; t++) {
+                            size_t ib = t / n_chunks;
+                            size_t jb = t % n_chunks;
+
+                            size_t ic = ib * MC;
+                            size_t mc = std::min(MC, M - ic);
+                            size_t j0 = jb * chunk_cols;
+                            size_t j1 = std::min(nc, j0 + chunk_cols);
+
+                            // consecutive tasks share an A block, pack it once
+                            if (packed_block != ib) {
+                                pack_a(mc, kc, a + ic * rsa + pc * csa, rsa, csa, packed_a);
+                                packed_block = ib;
+                            }
+
+                            macro_kernel(mc, j1 - j0, kc, packed_a, packed_b + j0 * kc,
+                                         c + ic * ldc + jc + j0, ldc, alpha, beta_block, ep_block.at(jc + j0));
+                        }
+                    });
+                }
+            }
+        }
+    } // namespace
+
+    void gemm_f32_builtin(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        float alpha,
+        const float* AXON_RESTRICT a, size_t lda,
+        const float* AXON_RESTRICT b, size_t ldb,
+        float beta,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        size_t rsa = trans_a ? 1 : lda;
+        size_t csa = trans_a ? lda : 1;
+        size_t rsb = trans_b ? 1 : ldb;
+        size_t csb = trans_b ? ldb : 1;
+
+        gemm_blocked<LoadF32>(M, N, K, alpha, a, rsa, csa, b, rsb, csb, beta, out, ldc);
+    }
+
+    void gemm_f32_f16(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        float alpha,
+        const float* AXON_RESTRICT a, size_t lda,
+        const uint16_t* AXON_RESTRICT b, size_t ldb,
+        float beta,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        gemm_blocked<LoadF16>(M, N, K, alpha, a, trans_a ? 1 : lda, trans_a ? lda : 1,
+                              b, trans_b ? 1 : ldb, trans_b ? ldb : 1, beta, out, ldc);
+    }
+
+    void gemm_f32_bf16(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        float alpha,
+        const float* AXON_RESTRICT a, size_t lda,
+        const uint16_t* AXON_RESTRICT b, size_t ldb,
+        float beta,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        gemm_blocked<LoadBF16>(M, N, K, alpha, a, trans_a ? 1 : lda, trans_a ? lda : 1,
+                               b, trans_b ? 1 : ldb, trans_b ? ldb : 1, beta, out, ldc);
+    }
+
+    void gemm_f32_i8(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        const float* AXON_RESTRICT a, size_t lda,
+        const int8_t* AXON_RESTRICT b, size_t ldb,
+        const float* AXON_RESTRICT scale,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        // the scale is per column of B, so it factors out of the sum over k
+        gemm_blocked<LoadI8>(M, N, K, 1.0f, a, trans_a ? 1 : lda, trans_a ? lda : 1,
+                             b, trans_b ? 1 : ldb, trans_b ? ldb : 1, 0.0f, out, ldc);
+        if (scale) {
+            scale_cols(M, N, scale, out, ldc);
+        }
+    }
+
+    void gemm_f32_bias_act(
+        bool trans_a, bool trans_b,
+        size_t M, size_t N, size_t K,
+        const float* AXON_RESTRICT a, size_t lda,
+        const float* AXON_RESTRICT b, size_t ldb,
+        const float* AXON_RESTRICT bias, Activation act,
+        float* AXON_RESTRICT out, size_t ldc) noexcept {
+
+        gemm_blocked<LoadF32>(M, N, K, 1.0f, a, trans_a ? 1 : lda, trans_a ? lda : 1,
+                              b, trans_b ? 1 : ldb, trans_b ? ldb : 1, 0.0f, out, ldc, Epilogue{bias, act});
+    }
+
+} // namespace axon::kernels::cpu::AXON_CPU_ISA
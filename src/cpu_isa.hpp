@@ -0,0 +1,75 @@
+#pragma once
+
+#include "axon/kernels.hpp"
+
+// The CPU kernels are compiled once per instruction set: CMakeLists.txt builds cpu_kernels.cpp,
+// cpu_gemm.cpp and cpu_attention.cpp three times, with AXON_CPU_ISA set to scalar, avx2 or
+// avx512 and the matching -m flags, and each build puts its kernels in that namespace.
+// cpu_dispatch.cpp defines the public kernels, which forward through the table of whichever
+// build the CPU can run.
+
+// every kernel with its own build per instruction set
+#define AXON_CPU_KERNELS(X) \
+    X(add_f32) X(sub_f32) X(mul_f32) X(div_f32) X(binary_strided_f32) X(fused_elementwise_f32) X(fill_f32) \
+    X(sum_f32) X(sum_dim_f32) X(max_dim_f32) X(min_dim_f32) \
+    X(relu_f32) X(relu_backward_f32) X(sqrt_f32) X(exp_f32) X(neg_f32) \
+    X(gelu_f32) X(gelu_backward_f32) \
+    X(log_softmax_f32) X(log_softmax_backward_f32) X(softmax_f32) X(softmax_backward_f32) \
+    X(layernorm_forward_f32) X(layernorm_backward_f32) \
+    X(cast_f32_to_f16) X(cast_f16_to_f32) X(cast_f32_to_bf16) X(cast_bf16_to_f32) \
+    X(cast_f32_to_i8) X(cast_i8_to_f32) \
+    X(gemm_f32_builtin) X(gemm_f32_f16) X(gemm_f32_bf16) X(gemm_f32_i8) X(gemm_f32_bias_act) \
+    X(attention_forward_f32) X(attention_backward_f32)
+
+// the same for the kernels templated on the index type
+#define AXON_CPU_EMBEDDING_KERNELS(X) \
+    X(embedding_forward_f32) X(embedding_forward_f16) X(embedding_forward_bf16) \
+    X(embedding_forward_i8) X(embedding_backward_f32)
+
+namespace axon::kernels::cpu {
+
+    template <typename Index>
+    struct EmbeddingTable {
+        #define AXON_EMBEDDING_SLOT(name) decltype(&cpu::name<Index>) name;
+        AXON_CPU_EMBEDDING_KERNELS(AXON_EMBEDDING_SLOT)
+        #undef AXON_EMBEDDING_SLOT
+    };
+
+    struct KernelTable {
+        #define AXON_KERNEL_SLOT(name) decltype(&cpu::name) name;
+        AXON_CPU_KERNELS(AXON_KERNEL_SLOT)
+        #undef AXON_KERNEL_SLOT
+
+        EmbeddingTable<int32_t> embedding_i32;
+        EmbeddingTable<int64_t> embedding_i64;
+
+        template <typename Index>
+        const EmbeddingTable<Index>& embedding() const noexcept {
+            if constexpr (sizeof(Index) == sizeof(int32_t)) {
+                return embedding_i32;
+            } else {
+                return embedding_i64;
+            }
+        }
+    };
+
+    namespace scalar {
+        const KernelTable& kernel_table() noexcept;
+    }
+    namespace avx2 {
+        const KernelTable& kernel_table() noexcept;
+    }
+    namespace avx512 {
+        const KernelTable& kernel_table() noexcept;
+    }
+
+#ifdef AXON_CPU_ISA
+    // This build's own copies, so the kernels call each other without going back through the table
+    namespace AXON_CPU_ISA {
+        #define AXON_DECLARE_KERNEL(name) decltype(cpu::name) name;
+        AXON_CPU_KERNELS(AXON_DECLARE_KERNEL)
+        #undef AXON_DECLARE_KERNEL
+    }
+#endif
+
+} // namespace axon::kernels::cpu
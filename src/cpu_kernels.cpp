@@ -1,167 +1,354 @@
 #include "axon/kernels.hpp"    
+#include "axon/dtype.hpp"
+#include "axon/simd_math.hpp"
+#include "cpu_isa.hpp"
 #include <numeric>
 #include <cmath>
 #include <limits>
 #include <cstring>
 #include <algorithm>
-#include <immintrin.h> // AVX2 / FMA
+#include <vector>
+#include <immintrin.h> // AVX2 / FMA / F16C
+#include "axon/thread_pool.hpp"
 
-namespace axon::kernels::cpu {
+// Built once per instruction set, see cpu_isa.hpp
 
-    void add_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
-        size_t i = 0;
-        // process 8 floats at a time (8 * 32 = 256 bits)
-        for (; i + 8 <= n; i += 8) {
-            __m256 va = _mm256_loadu_ps(a + i);
-            __m256 vb = _mm256_loadu_ps(b + i);
-            _mm256_storeu_ps(out + i, _mm256_add_ps(va, vb));
-        }
+namespace axon::kernels::cpu::AXON_CPU_ISA {
+
+    namespace {
+        // below this many elements a kernel stays on the calling thread
+        constexpr size_t ELEMENTWISE_GRAIN = 1 << 15;
+
+        // row-wise kernels hand out at least this many elements per chunk
+        constexpr size_t ROW_GRAIN_ELEMS = 1 << 14;
 
-        // residual
-        for (; i < n; i++) {
-            out[i] = a[i] + b[i];
+        inline size_t row_grain(size_t cols) {
+            return std::max<size_t>(1, ROW_GRAIN_ELEMS / std::max<size_t>(cols, 1));
         }
-    }     
-    
-    void sub_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
-        size_t i = 0;
 
-        for (; i + 8 <= n; i += 8) {
-            __m256 va = _mm256_loadu_ps(a + i);
-            __m256 vb = _mm256_loadu_ps(b + i);
-            _mm256_storeu_ps(out + i, _mm256_sub_ps(va, vb));            
+        // the widest vectors this build has; loops end in one masked partial vector
+        // (Isa::load_n / store_n) rather than a scalar remainder
+        using Isa = simd::Native;
+        constexpr size_t LANES = Isa::width;
+
+        // sum_f32 adds blocks of this many elements in vector accumulators, then pairs up the block
+        // sums. (Kahan compensation would not survive -ffast-math, which cancels it out.)
+        constexpr size_t SUM_BLOCK = 1 << 12;
+
+        float pairwise_sum(const float* x, size_t n) noexcept {
+            if (n <= SUM_BLOCK) return simd::sum_of(x, n);
+            size_t half = (n / 2 + SUM_BLOCK - 1) / SUM_BLOCK * SUM_BLOCK;
+            return pairwise_sum(x, half) + pairwise_sum(x + half, n - half);
         }
 
-        for (; i < n; i++) {
-            out[i] = a[i] - b[i];
+        // fn(o, i0, i1) for each piece of the flat range [begin, end) over an (outer, inner) grid,
+        // split at the row ends
+        template <typename Fn>
+        inline void for_each_row_piece(size_t begin, size_t end, size_t inner, Fn fn) {
+            while (begin < end) {
+                size_t o = begin / inner, i0 = begin % inner;
+                size_t i1 = std::min(inner, i0 + (end - begin));
+                fn(o, i0, i1);
+                begin += i1 - i0;
+            }
         }
     }
+
+    void add_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(out + i, Isa::add(Isa::load(a + i), Isa::load(b + i)));
+            }
+
+            // residual
+            if (i < end) {
+                size_t k = end - i;
+                Isa::store_n(out + i, Isa::add(Isa::load_n(a + i, k), Isa::load_n(b + i, k)), k);
+            }
+        });
+    }
+    
+    void sub_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(out + i, Isa::sub(Isa::load(a + i), Isa::load(b + i)));
+            }
+
+            // residual
+            if (i < end) {
+                size_t k = end - i;
+                Isa::store_n(out + i, Isa::sub(Isa::load_n(a + i, k), Isa::load_n(b + i, k)), k);
+            }
+        });
+    }
     
     void mul_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
-        size_t i = 0;
-        
-        for (; i + 8 <= n; i += 8) {
-            __m256 va = _mm256_loadu_ps(a + i);
-            __m256 vb = _mm256_loadu_ps(b + i);
-            _mm256_storeu_ps(out + i, _mm256_mul_ps(va, vb));
-        }
-        
-        for (; i < n; i++) {
-            out[i] = a[i] * b[i];
-        }
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(out + i, Isa::mul(Isa::load(a + i), Isa::load(b + i)));
+            }
+
+            // residual
+            if (i < end) {
+                size_t k = end - i;
+                Isa::store_n(out + i, Isa::mul(Isa::load_n(a + i, k), Isa::load_n(b + i, k)), k);
+            }
+        });
     }
     
     void div_f32(size_t n, const float* AXON_RESTRICT a, const float* AXON_RESTRICT b, float* AXON_RESTRICT out) noexcept {
-        size_t i = 0;
-    
-        for (; i + 8 <= n; i += 8) {
-            __m256 va = _mm256_loadu_ps(a + i);
-            __m256 vb = _mm256_loadu_ps(b + i);
-            _mm256_storeu_ps(out + i, _mm256_div_ps(va, vb));
-        }
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(out + i, Isa::div(Isa::load(a + i), Isa::load(b + i)));
+            }
 
-        for (; i < n; i++) {
-            out[i] = a[i] / b[i];
+            // residual; the masked-off lanes divide 0 by 0 and are dropped
+            if (i < end) {
+                size_t k = end - i;
+                Isa::store_n(out + i, Isa::div(Isa::load_n(a + i, k), Isa::load_n(b + i, k)), k);
+            }
+        });
+    }
+
+    namespace {
+        struct AddOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x, typename O::V y) noexcept { return O::add(x, y); }
+        };
+        struct SubOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x, typename O::V y) noexcept { return O::sub(x, y); }
+        };
+        struct MulOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x, typename O::V y) noexcept { return O::mul(x, y); }
+        };
+        struct DivOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x, typename O::V y) noexcept { return O::div(x, y); }
+        };
+
+        // the stride patterns broadcasting produces get vector loops: both operands contiguous
+        // (including each row of a row broadcast), or one of them a single repeated value.
+        // Anything else (transposed inputs) walks element by element.
+        template <typename Op>
+        void binary_strided(size_t n, const float* a, ptrdiff_t sa, const float* b, ptrdiff_t sb, float* out, ptrdiff_t so) noexcept {
+            if (so == 1 && (sa == 1 || sa == 0) && (sb == 1 || sb == 0)) {
+                auto va = Isa::set1(*a), vb = Isa::set1(*b);
+                size_t i = 0;
+                for (; i + LANES <= n; i += LANES) {
+                    auto x = sa ? Isa::load(a + i) : va;
+                    auto y = sb ? Isa::load(b + i) : vb;
+                    Isa::store(out + i, Op::template apply<Isa>(x, y));
+                }
+                if (i < n) {
+                    size_t k = n - i;
+                    auto x = sa ? Isa::load_n(a + i, k) : va;
+                    auto y = sb ? Isa::load_n(b + i, k) : vb;
+                    Isa::store_n(out + i, Op::template apply<Isa>(x, y), k);
+                }
+                return;
+            }
+
+            for (size_t i = 0; i < n; i++) {
+                out[i * so] = Op::template apply<simd::Scalar>(a[i * sa], b[i * sb]);
+            }
         }
     }
 
-    void fill_f32(size_t n, float value, float* AXON_RESTRICT out) noexcept {
-        size_t i = 0;
-        __m256 v = _mm256_set1_ps(value);
+    void binary_strided_f32(BinaryOp op, size_t n, const float* a, ptrdiff_t sa, const float* b, ptrdiff_t sb, float* out, ptrdiff_t so) noexcept {
+        if (n == 0) return;
+        switch (op) {
+            case BinaryOp::Add: binary_strided<AddOp>(n, a, sa, b, sb, out, so); return;
+            case BinaryOp::Sub: binary_strided<SubOp>(n, a, sa, b, sb, out, so); return;
+            case BinaryOp::Mul: binary_strided<MulOp>(n, a, sa, b, sb, out, so); return;
+            case BinaryOp::Div: binary_strided<DivOp>(n, a, sa, b, sb, out, so); return;
+        }
+    }
 
-        for (; i + 8 <= n; i += 8) {
-            _mm256_storeu_ps(out + i, v);
+    namespace {
+        // the unary ops with the same shape as the binary ones above, matching their eager kernels
+        struct NegOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x) noexcept { return O::sub(O::set1(0.0f), x); }
+        };
+        struct SqrtOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x) noexcept { return O::sqrt(x); }
+        };
+        struct ExpOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x) noexcept { return simd::exp<O>(x); }
+        };
+        struct ReluOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x) noexcept { return O::max(x, O::set1(0.0f)); }
+        };
+        struct GeluOp {
+            template <typename O>
+            static typename O::V apply(typename O::V x) noexcept { return simd::gelu<O>(x); }
+        };
+
+        // registers are tiles of this many floats: 32 of them fill 16KB, half of L1
+        constexpr size_t FUSED_TILE = 128;
+
+        template <typename Op>
+        void fused_unary(size_t m, const float* x, float* out) noexcept {
+            size_t i = 0;
+            for (; i + LANES <= m; i += LANES) {
+                Isa::store(out + i, Op::template apply<Isa>(Isa::load(x + i)));
+            }
+            if (i < m) Isa::store_n(out + i, Op::template apply<Isa>(Isa::load_n(x + i, m - i)), m - i);
         }
 
-        for (; i < n; i++) {
-            out[i] = value;
+        template <typename Op>
+        void fused_binary(size_t m, const float* x, const float* y, float* out) noexcept {
+            size_t i = 0;
+            for (; i + LANES <= m; i += LANES) {
+                Isa::store(out + i, Op::template apply<Isa>(Isa::load(x + i), Isa::load(y + i)));
+            }
+            if (i < m) {
+                size_t k = m - i;
+                Isa::store_n(out + i, Op::template apply<Isa>(Isa::load_n(x + i, k), Isa::load_n(y + i, k)), k);
+            }
         }
     }
-    
-    void matmul_f32(
-        size_t M, size_t N, size_t K,
-        const float* AXON_RESTRICT a, 
-        const float* AXON_RESTRICT b,
-        float* AXON_RESTRICT out) noexcept {
-
-        std::memset(out, 0, M * N * sizeof(float));
-
-        for (size_t i = 0; i < M; i++) {
-            for (size_t k = 0; k < K; k++) {
-                float val_a = a[i * K + k];
-                __m256 va = _mm256_set1_ps(val_a);
-
-                size_t j = 0;
-
-                for (; j + 8 <= N; j += 8) {
-                    __m256 vc = _mm256_loadu_ps(&out[i * N + j]);
-                    __m256 vb = _mm256_loadu_ps(&b[k * N + j]);
-                    // c = c + a * b
-                    vc = _mm256_fmadd_ps(va, vb, vc);
-                    _mm256_storeu_ps(&out[i * N + j], vc);
-                }
-                
-                for (; j < N; j++) {
-                    out[i * N + j] += val_a * b[k * N + j];
+
+    void fused_elementwise_f32(const FusedInstr* code, size_t n_code, size_t n, float* const* operands, const ptrdiff_t* strides) noexcept {
+        alignas(64) float tiles[FUSED_MAX_OPERANDS][FUSED_TILE];
+        // a register is its tile, or the operand itself when that is contiguous
+        const float* regs[FUSED_MAX_OPERANDS];
+
+        for (size_t i0 = 0; i0 < n; i0 += FUSED_TILE) {
+            size_t m = std::min(FUSED_TILE, n - i0);
+
+            for (size_t pc = 0; pc < n_code; pc++) {
+                const FusedInstr& in = code[pc];
+                float* dst = tiles[in.dst];
+
+                switch (in.op) {
+                    case FusedOp::Load: {
+                        ptrdiff_t s = strides[in.a];
+                        const float* src = operands[in.a] + static_cast<ptrdiff_t>(i0) * s;
+                        if (s == 1) {
+                            regs[in.dst] = src;
+                            continue;
+                        }
+                        if (s == 0) {
+                            // the same value for every tile of the row
+                            if (i0 == 0) std::fill(dst, dst + FUSED_TILE, *src);
+                        } else {
+                            for (size_t i = 0; i < m; i++) dst[i] = src[i * s];
+                        }
+                        break;
+                    }
+                    case FusedOp::Store: {
+                        ptrdiff_t s = strides[in.dst];
+                        float* out = operands[in.dst] + static_cast<ptrdiff_t>(i0) * s;
+                        const float* src = regs[in.a];
+                        if (s == 1) {
+                            std::memcpy(out, src, m * sizeof(float));
+                        } else {
+                            for (size_t i = 0; i < m; i++) out[i * s] = src[i];
+                        }
+                        continue;
+                    }
+                    case FusedOp::Add: fused_binary<AddOp>(m, regs[in.a], regs[in.b], dst); break;
+                    case FusedOp::Sub: fused_binary<SubOp>(m, regs[in.a], regs[in.b], dst); break;
+                    case FusedOp::Mul: fused_binary<MulOp>(m, regs[in.a], regs[in.b], dst); break;
+                    case FusedOp::Div: fused_binary<DivOp>(m, regs[in.a], regs[in.b], dst); break;
+                    case FusedOp::Neg: fused_unary<NegOp>(m, regs[in.a], dst); break;
+                    case FusedOp::Sqrt: fused_unary<SqrtOp>(m, regs[in.a], dst); break;
+                    case FusedOp::Exp: fused_unary<ExpOp>(m, regs[in.a], dst); break;
+                    case FusedOp::Relu: fused_unary<ReluOp>(m, regs[in.a], dst); break;
+                    case FusedOp::Gelu: fused_unary<GeluOp>(m, regs[in.a], dst); break;
                 }
+                regs[in.dst] = dst;
             }
         }
     }
-        
+
+    void fill_f32(size_t n, float value, float* AXON_RESTRICT out) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            auto v = Isa::set1(value);
+
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(out + i, v);
+            }
+
+            if (i < end) Isa::store_n(out + i, v, end - i);
+        });
+    }
     
     void sum_f32(size_t n, const float* AXON_RESTRICT inp, float* AXON_RESTRICT out) noexcept {
-        float acc = 0.0f;
-        for (size_t i = 0; i < n; i++) {
-            acc += inp[i];
+        if (n <= ELEMENTWISE_GRAIN) {
+            *out = pairwise_sum(inp, n);
+            return;
         }
-        *out = acc;
+
+        // blocks are fixed, so the threads only decide who adds which block
+        size_t blocks = (n + SUM_BLOCK - 1) / SUM_BLOCK;
+        std::vector<float> partial(blocks);
+        float* p = partial.data();
+        parallel_for(0, blocks, ELEMENTWISE_GRAIN / SUM_BLOCK, [=](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; b++) {
+                p[b] = simd::sum_of(inp + b * SUM_BLOCK, std::min(SUM_BLOCK, n - b * SUM_BLOCK));
+            }
+        });
+        *out = pairwise_sum(p, blocks);
     }
 
     void relu_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT out) noexcept {
-        size_t i = 0;
-        __m256 zero = _mm256_setzero_ps();
-        for (i; i + 8 <= n; i += 8) {
-            __m256 v = _mm256_loadu_ps(input + i);
-            _mm256_storeu_ps(out + i, _mm256_max_ps(v, zero));
-        }
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            auto zero = Isa::set1(0.0f);
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(out + i, Isa::max(Isa::load(input + i), zero));
+            }
 
-        for (; i < n; i++) {
-            out[i] = input[i] > 0.0f ? input[i] : 0.0f;
-        }
+            if (i < end) Isa::store_n(out + i, Isa::max(Isa::load_n(input + i, end - i), zero), end - i);
+        });
     }
 
     void relu_backward_f32(size_t n, const float* AXON_RESTRICT input, const float* AXON_RESTRICT grad_out, float* AXON_RESTRICT grad_inp) noexcept {
-        for (size_t i = 0; i < n; ++i) {
-            grad_inp[i] = (input[i] > 0.0f) ? grad_out[i] : 0.0f;
-        }
-    }
-
-    void log_softmax_f32(size_t rows, size_t cols, const float* __restrict__ input, float* __restrict__ out) noexcept {
-        for (size_t r = 0; r < rows; r++) {
-            const float* row_input = input + r * cols;
-            float* row_out = out + r * cols;
-
-            float max_val = -std::numeric_limits<float>::infinity();
-            for (size_t c = 0; c < cols; c++) {
-                if (row_input[c] > max_val) {
-                    max_val = row_input[c];
-                }
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            auto zero = Isa::set1(0.0f);
+            for (; i + LANES <= end; i += LANES) {
+                auto pass = Isa::lt(zero, Isa::load(input + i));
+                Isa::store(grad_inp + i, Isa::select(pass, Isa::load(grad_out + i), zero));
             }
 
-            float sum_exp = 0.0f;
-
-            for (size_t c = 0; c < cols; c++) {
-                float val = std::exp(row_input[c] - max_val);
-                row_out[c] = val;
-                sum_exp += val;
+            if (i < end) {
+                size_t k = end - i;
+                auto pass = Isa::lt(zero, Isa::load_n(input + i, k));
+                Isa::store_n(grad_inp + i, Isa::select(pass, Isa::load_n(grad_out + i, k), zero), k);
             }
+        });
+    }
 
-            float log_sum = std::log(sum_exp);
-            
-            for (size_t c = 0; c < cols; c++) {
-                row_out[c] = (row_input[c] - max_val) - log_sum;
+    void log_softmax_f32(size_t rows, size_t cols, const float* __restrict__ input, float* __restrict__ out) noexcept {
+        parallel_for(0, rows, row_grain(cols), [=](size_t row_begin, size_t row_end) {
+            for (size_t r = row_begin; r < row_end; r++) {
+                const float* row_input = input + r * cols;
+                float* row_out = out + r * cols;
+
+                float max_val = simd::max_of(row_input, cols);
+                float sum_exp = simd::exp_sub(row_input, max_val, row_out, cols);
+                auto shift = Isa::set1(max_val + simd::log<simd::Scalar>(sum_exp));
+
+                size_t c = 0;
+                for (; c + LANES <= cols; c += LANES) {
+                    Isa::store(row_out + c, Isa::sub(Isa::load(row_input + c), shift));
+                }
+                if (c < cols) Isa::store_n(row_out + c, Isa::sub(Isa::load_n(row_input + c, cols - c), shift), cols - c);
             }
-        }
+        });
     }
 
     void log_softmax_backward_f32(size_t rows, size_t cols, 
@@ -169,135 +356,328 @@ namespace axon::kernels::cpu {
         const float* __restrict__ output, 
         float* __restrict__ grad_input) noexcept {
         // dL/dx_i = dL/dy_i - exp(y_i) * sum(dL/dy_j)
-        for (size_t r = 0; r < rows; ++r) {
-            const float* grad_row = grad_output + r * cols;
-            const float* out_row = output + r * cols;
-            float* inp_grad_row = grad_input + r * cols;
-
-            float sum_grad = 0.0f;
-            for(size_t c = 0; c < cols; c++) sum_grad += grad_row[c];
-
-            for(size_t c = 0; c < cols; c++) {
-                inp_grad_row[c] = grad_row[c] - std::exp(out_row[c]) * sum_grad;
+        parallel_for(0, rows, row_grain(cols), [=](size_t row_begin, size_t row_end) {
+            for (size_t r = row_begin; r < row_end; ++r) {
+                const float* grad_row = grad_output + r * cols;
+                const float* out_row = output + r * cols;
+                float* inp_grad_row = grad_input + r * cols;
+
+                float sum_grad = simd::sum_of(grad_row, cols);
+
+                size_t c = 0;
+                auto vsum = Isa::set1(sum_grad);
+                for (; c + LANES <= cols; c += LANES) {
+                    auto p = simd::exp<Isa>(Isa::load(out_row + c));
+                    Isa::store(inp_grad_row + c, Isa::fnmadd(p, vsum, Isa::load(grad_row + c)));
+                }
+                if (c < cols) {
+                    size_t k = cols - c;
+                    auto p = simd::exp<Isa>(Isa::load_n(out_row + c, k));
+                    Isa::store_n(inp_grad_row + c, Isa::fnmadd(p, vsum, Isa::load_n(grad_row + c, k)), k);
+                }
             }
-        }
+        });
     }
 
     void sum_dim_f32(size_t outer, size_t dim, size_t inner, const float* __restrict__ input, float* __restrict__ output) noexcept {
-        for (size_t i = 0; i < outer * inner; i++) {
-            output[i] = 0.0f;
+        // reducing the last dim: one contiguous row per output
+        if (inner == 1) {
+            parallel_for(0, outer, row_grain(dim), [=](size_t o0, size_t o1) {
+                for (size_t o = o0; o < o1; o++) {
+                    output[o] = pairwise_sum(input + o * dim, dim);
+                }
+            });
+            return;
         }
 
-        size_t input_idx, output_idx;
-
-        for (size_t o = 0; o < outer; o++) {
-            for (size_t d = 0; d < dim; d++) {
-                for (size_t i = 0; i < inner; i++) {
-                    input_idx = (o * dim * inner) + (d * inner) + i;
-                    output_idx = (o * inner) + i;
-                    output[output_idx] += input[input_idx];
+        // otherwise each output row adds up dim input rows; threads split the outer * inner outputs
+        parallel_for(0, outer * inner, row_grain(dim), [=](size_t begin, size_t end) {
+            for_each_row_piece(begin, end, inner, [=](size_t o, size_t i0, size_t i1) {
+                const float* in_block = input + o * dim * inner;
+                float* out_row = output + o * inner;
+
+                std::fill(out_row + i0, out_row + i1, 0.0f);
+                for (size_t d = 0; d < dim; d++) {
+                    const float* in_row = in_block + d * inner;
+                    size_t i = i0;
+                    for (; i + LANES <= i1; i += LANES) {
+                        Isa::store(out_row + i, Isa::add(Isa::load(out_row + i), Isa::load(in_row + i)));
+                    }
+                    if (i < i1) {
+                        size_t k = i1 - i;
+                        Isa::store_n(out_row + i, Isa::add(Isa::load_n(out_row + i, k), Isa::load_n(in_row + i, k)), k);
+                    }
                 }
+            });
+        });
+    }
+
+    namespace {
+        // positions ride along in float lanes, exact up to here
+        constexpr size_t MAX_LANE_POS = size_t(1) << 24;
+
+        template <bool Max>
+        inline bool better(float x, float best) noexcept {
+            return Max ? x > best : x < best;
+        }
+
+        template <bool Max>
+        inline Isa::Mask better_lanes(Isa::V x, Isa::V best) noexcept {
+            return Max ? Isa::lt(best, x) : Isa::lt(x, best);
+        }
+
+        // running best of each lane and the position it was first seen at
+        template <bool Max>
+        struct Extreme {
+            Isa::V best = Isa::set1(Max ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity());
+            Isa::V pos = Isa::set1(0.0f);
+
+            void update(Isa::V x, Isa::V at) noexcept {
+                auto m = better_lanes<Max>(x, best);
+                best = Isa::select(m, x, best);
+                pos = Isa::select(m, at, pos);
+            }
+        };
+
+        template <bool Max>
+        void extreme_dim(size_t outer, size_t dim, size_t inner, const float* input, float* values, int64_t* indices) noexcept {
+            constexpr float init = Max ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+
+            if (dim >= MAX_LANE_POS) {
+                parallel_for(0, outer * inner, 1, [=](size_t begin, size_t end) {
+                    for (size_t j = begin; j < end; j++) {
+                        const float* x = input + (j / inner) * dim * inner + j % inner;
+                        float v = init;
+                        size_t at = 0;
+                        for (size_t d = 0; d < dim; d++) {
+                            if (better<Max>(x[d * inner], v)) {
+                                v = x[d * inner];
+                                at = d;
+                            }
+                        }
+                        values[j] = v;
+                        if (indices) indices[j] = static_cast<int64_t>(at);
+                    }
+                });
+                return;
+            }
+
+            alignas(64) float lane_ids[LANES];
+            for (size_t l = 0; l < LANES; l++) lane_ids[l] = static_cast<float>(l);
+            const Isa::V first_ids = Isa::load(lane_ids);
+
+            // along a row: LANES columns at a time, then across the lanes (lowest position on ties)
+            if (inner == 1) {
+                parallel_for(0, outer, row_grain(dim), [=](size_t o0, size_t o1) {
+                    for (size_t o = o0; o < o1; o++) {
+                        const float* row = input + o * dim;
+                        Extreme<Max> e;
+                        Isa::V at = first_ids, step = Isa::set1(static_cast<float>(LANES));
+
+                        size_t c = 0;
+                        for (; c + LANES <= dim; c += LANES, at = Isa::add(at, step)) e.update(Isa::load(row + c), at);
+                        if (c < dim) e.update(Isa::load_n(row + c, dim - c, init), at);
+
+                        alignas(64) float best[LANES], pos[LANES];
+                        Isa::store(best, e.best);
+                        Isa::store(pos, e.pos);
+                        float v = best[0], p = pos[0];
+                        for (size_t l = 1; l < LANES; l++) {
+                            if (better<Max>(best[l], v) || (best[l] == v && pos[l] < p)) {
+                                v = best[l];
+                                p = pos[l];
+                            }
+                        }
+                        values[o] = v;
+                        if (indices) indices[o] = static_cast<int64_t>(p);
+                    }
+                });
+                return;
             }
+
+            // down the columns: LANES outputs at a time, one input row per step
+            parallel_for(0, outer * inner, row_grain(dim), [=](size_t begin, size_t end) {
+                for_each_row_piece(begin, end, inner, [=](size_t o, size_t i0, size_t i1) {
+                    const float* in_block = input + o * dim * inner;
+                    for (size_t i = i0; i < i1; i += LANES) {
+                        size_t k = std::min(LANES, i1 - i);
+                        Extreme<Max> e;
+                        for (size_t d = 0; d < dim; d++) {
+                            const float* x = in_block + d * inner + i;
+                            e.update(k == LANES ? Isa::load(x) : Isa::load_n(x, k, init), Isa::set1(static_cast<float>(d)));
+                        }
+
+                        size_t j = o * inner + i;
+                        if (k == LANES) {
+                            Isa::store(values + j, e.best);
+                        } else {
+                            Isa::store_n(values + j, e.best, k);
+                        }
+                        if (indices) {
+                            alignas(64) float pos[LANES];
+                            Isa::store(pos, e.pos);
+                            for (size_t l = 0; l < k; l++) indices[j + l] = static_cast<int64_t>(pos[l]);
+                        }
+                    }
+                });
+            });
         }
     }
 
+    void max_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT values, int64_t* AXON_RESTRICT indices) noexcept {
+        extreme_dim<true>(outer, dim, inner, input, values, indices);
+    }
+
+    void min_dim_f32(size_t outer, size_t dim, size_t inner, const float* AXON_RESTRICT input, float* AXON_RESTRICT values, int64_t* AXON_RESTRICT indices) noexcept {
+        extreme_dim<false>(outer, dim, inner, input, values, indices);
+    }
 
     void sqrt_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
-        size_t i = 0;
-        for (; i + 8 <= n; i += 8) {
-            __m256 v = _mm256_loadu_ps(input + i);
-            _mm256_storeu_ps(output + i, _mm256_sqrt_ps(v));
-        }
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(output + i, Isa::sqrt(Isa::load(input + i)));
+            }
 
-        for (; i < n; i++) output[i] = std::sqrt(input[i]);
+            if (i < end) Isa::store_n(output + i, Isa::sqrt(Isa::load_n(input + i, end - i)), end - i);
+        });
     }
     
     void exp_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
-        for (size_t i = 0; i < n; i++) {
-            output[i] = std::exp(input[i]);
-        }
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(output + i, simd::exp<Isa>(Isa::load(input + i)));
+            }
+
+            if (i < end) Isa::store_n(output + i, simd::exp<Isa>(Isa::load_n(input + i, end - i)), end - i);
+        });
     }
     
-    void neg_f32(size_t n, const float* input, float* output) noexcept {
-        size_t i = 0;
-        
-        __m256 zero = _mm256_setzero_ps();
-        
-        for (; i + 8 <= n; i += 8) {
-            __m256 v = _mm256_loadu_ps(input + i);
-            _mm256_storeu_ps(output + i, _mm256_sub_ps(zero, v));
-        }
-
-        for (; i < n; i++) {
-            output[i] = -input[i];
+    void neg_f32(size_t n, const float* AXON_RESTRICT input, float* AXON_RESTRICT output) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            
+            auto zero = Isa::set1(0.0f);
+            
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(output + i, Isa::sub(zero, Isa::load(input + i)));
+            }
 
-        }
+            if (i < end) Isa::store_n(output + i, Isa::sub(zero, Isa::load_n(input + i, end - i)), end - i);
+        });
     }
 
     // GPT-2 uses the approximation: 0.5 * x * (1 + tanh(sqrt(2/pi) * (x + 0.044715 * x^3)))
     void gelu_f32(size_t n, const float* __restrict__ input, float* __restrict__ output) noexcept {
-        const float SQRT_2_OVER_PI = 0.79788456080286535587989f;
-        const float COEF = 0.044715f;
-        
-        for (size_t i = 0; i < n; i++) {
-            float x = input[i];
-            float x3 = x * x * x;
-            float inner = SQRT_2_OVER_PI * (x + COEF * x3);
-            float arctan = std::tanh(inner);
-            output[i] = 0.5f * x * (1.0f + arctan);
-        }
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(output + i, simd::gelu<Isa>(Isa::load(input + i)));
+            }
+
+            if (i < end) Isa::store_n(output + i, simd::gelu<Isa>(Isa::load_n(input + i, end - i)), end - i);
+        });
     }
     
     void gelu_backward_f32(size_t n, const float* __restrict__ input, const float* __restrict__ grad_out, float* __restrict__ grad_input) noexcept {
-        const float SQRT_2_OVER_PI = 0.79788456080286535587989f;
-        const float COEF = 0.044715f;
-        
-        for (size_t i = 0; i < n; i++) {
-            float x = input[i];
-            float x3 = x * x * x;
-            float inner = SQRT_2_OVER_PI * (x + COEF * x3);
-            float tanh_inner = std::tanh(inner);
-            
-            float secl = 1.0f / (std::cosh(inner));
-            float sech2 = secl * secl;
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+            for (; i + LANES <= end; i += LANES) {
+                Isa::store(grad_input + i, simd::gelu_grad<Isa>(Isa::load(input + i), Isa::load(grad_out + i)));
+            }
 
-            float dx = 0.5f * (1.0f + tanh_inner) + 
-                       0.5f * x * sech2 * SQRT_2_OVER_PI * (1.0f + 3.0f * COEF * x * x);
-            
-            grad_input[i] = grad_out[i] * dx;
+            if (i < end) {
+                size_t k = end - i;
+                Isa::store_n(grad_input + i, simd::gelu_grad<Isa>(Isa::load_n(input + i, k), Isa::load_n(grad_out + i, k)), k);
+            }
+        });
+    }
+
+    namespace {
+        // ids outside the table read (or, backward, skip) row 0
+        template <typename Index>
+        inline size_t row_id(Index idx, size_t vocab_size) noexcept {
+            return idx < 0 || static_cast<size_t>(idx) >= vocab_size ? 0 : static_cast<size_t>(idx);
         }
     }
 
+    template <typename Index>
     void embedding_forward_f32(
         size_t vocab_size, size_t dim, size_t num_indices,
-        const float* __restrict__ weight, 
-        const float* __restrict__ indices, 
-        float* __restrict__ out
+        const float* AXON_RESTRICT weight,
+        const Index* AXON_RESTRICT indices,
+        float* AXON_RESTRICT out
+    ) noexcept {
+        for (size_t i = 0; i < num_indices; i++) {
+            std::memcpy(out + i * dim, weight + row_id(indices[i], vocab_size) * dim, dim * sizeof(float));
+        }
+    }
+
+    template <typename Index>
+    void embedding_forward_f16(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const uint16_t* AXON_RESTRICT weight,
+        const Index* AXON_RESTRICT indices,
+        float* AXON_RESTRICT out
     ) noexcept {
         for (size_t i = 0; i < num_indices; i++) {
-            int idx = static_cast<int>(indices[i]);
-            if (idx < 0 || idx >= vocab_size) idx = 0;
-            const float* src = weight + idx * dim;
+            cast_f16_to_f32(dim, weight + row_id(indices[i], vocab_size) * dim, out + i * dim);
+        }
+    }
+
+    template <typename Index>
+    void embedding_forward_bf16(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const uint16_t* AXON_RESTRICT weight,
+        const Index* AXON_RESTRICT indices,
+        float* AXON_RESTRICT out
+    ) noexcept {
+        for (size_t i = 0; i < num_indices; i++) {
+            cast_bf16_to_f32(dim, weight + row_id(indices[i], vocab_size) * dim, out + i * dim);
+        }
+    }
+
+    template <typename Index>
+    void embedding_forward_i8(
+        size_t vocab_size, size_t dim, size_t num_indices,
+        const int8_t* AXON_RESTRICT weight,
+        const float* AXON_RESTRICT row_scale,
+        const Index* AXON_RESTRICT indices,
+        float* AXON_RESTRICT out
+    ) noexcept {
+        for (size_t i = 0; i < num_indices; i++) {
+            size_t idx = row_id(indices[i], vocab_size);
+            const int8_t* src = weight + idx * dim;
             float* dst = out + i * dim;
-            // copy row
-            for (size_t r = 0; r < dim; r++) {
-                dst[r] = src[r];
+            float s = row_scale[idx];
+
+            size_t r = 0;
+#ifdef __AVX2__
+            __m256 vs = _mm256_set1_ps(s);
+            for (; r + 8 <= dim; r += 8) {
+                __m256i wide = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + r)));
+                _mm256_storeu_ps(dst + r, _mm256_mul_ps(_mm256_cvtepi32_ps(wide), vs));
+            }
+#endif
+            for (; r < dim; r++) {
+                dst[r] = static_cast<float>(src[r]) * s;
             }
         }
     }
 
+    template <typename Index>
     void embedding_backward_f32(
         size_t vocab_size, size_t dim, size_t num_indices,
-        const float* __restrict__ grad_output, 
-        const float* __restrict__ indices, 
-        float* __restrict__ grad_weight
+        const float* AXON_RESTRICT grad_output,
+        const Index* AXON_RESTRICT indices,
+        float* AXON_RESTRICT grad_weight
     ) noexcept {
         for (size_t i = 0; i < num_indices; i++) {
-            int idx = static_cast<int>(indices[i]);
-            if (idx < 0 || idx >= vocab_size) continue;
+            if (indices[i] < 0 || static_cast<size_t>(indices[i]) >= vocab_size) continue;
 
             const float* g_out_row = grad_output + i * dim;
-            float* g_weight_row = grad_weight + idx * dim;
+            float* g_weight_row = grad_weight + static_cast<size_t>(indices[i]) * dim;
 
             // scatter add - multiple indices might point to the same row 
             for (size_t r = 0; r < dim; r++) {
@@ -306,6 +686,41 @@ namespace axon::kernels::cpu {
         }
     }
 
+    #define AXON_EMBEDDING_INSTANTIATE(Index) \
+        template void embedding_forward_f32<Index>(size_t, size_t, size_t, const float*, const Index*, float*) noexcept; \
+        template void embedding_forward_f16<Index>(size_t, size_t, size_t, const uint16_t*, const Index*, float*) noexcept; \
+        template void embedding_forward_bf16<Index>(size_t, size_t, size_t, const uint16_t*, const Index*, float*) noexcept; \
+        template void embedding_forward_i8<Index>(size_t, size_t, size_t, const int8_t*, const float*, const Index*, float*) noexcept; \
+        template void embedding_backward_f32<Index>(size_t, size_t, size_t, const float*, const Index*, float*) noexcept;
+
+    AXON_EMBEDDING_INSTANTIATE(int32_t)
+    AXON_EMBEDDING_INSTANTIATE(int64_t)
+
+    #undef AXON_EMBEDDING_INSTANTIATE
+
+    namespace {
+        // mean and 1 / sqrt(var + eps) of one row; the tail reads `mean` into the masked-off
+        // lanes so they add nothing to the variance
+        inline void row_stats(const float* row, size_t cols, float eps, float& mean, float& inv_std) noexcept {
+            mean = simd::sum_of(row, cols) / cols;
+
+            auto vmean = Isa::set1(mean);
+            auto acc = Isa::set1(0.0f);
+            size_t c = 0;
+            for (; c + LANES <= cols; c += LANES) {
+                auto diff = Isa::sub(Isa::load(row + c), vmean);
+                acc = Isa::fmadd(diff, diff, acc);
+            }
+            if (c < cols) {
+                auto diff = Isa::sub(Isa::load_n(row + c, cols - c, mean), vmean);
+                acc = Isa::fmadd(diff, diff, acc);
+            }
+
+            float var = Isa::reduce_add(acc) / cols;
+            inv_std = 1.0f / std::sqrt(var + eps);
+        }
+    }
+
     void layernorm_forward_f32(
         size_t rows, size_t cols, 
         const float* __restrict__ input,
@@ -313,34 +728,29 @@ namespace axon::kernels::cpu {
         const float* __restrict__ beta,
         float* __restrict__ out, float eps
     ) noexcept {
-        for (size_t r = 0; r < rows; r++) {
-            const float* in_row = input + r * cols;
-            float* out_row = out + r * cols;
-
-            // mean
-            float sum = 0.0f;
-            for (size_t c = 0; c < cols; c++) {
-                sum += in_row[c];
-            }
-
-            float mean = sum / cols;
-
-            // variance
-            float sum_sq_diff = 0.0f;
-            for (size_t c = 0; c < cols; c++) {
-                float diff = in_row[c] - mean;
-                sum_sq_diff += diff * diff;
-            }
-
-            float var = sum_sq_diff / cols;
-            float inv_std = 1.0f / std::sqrt(var + eps);
-
-            // normalize 
-            for (size_t c = 0; c < cols; c++) {
-                float norm = (in_row[c] - mean) * inv_std;
-                out_row[c] = norm * gamma[c] + beta[c];
+        parallel_for(0, rows, row_grain(cols), [=](size_t row_begin, size_t row_end) {
+            for (size_t r = row_begin; r < row_end; r++) {
+                const float* in_row = input + r * cols;
+                float* out_row = out + r * cols;
+
+                float mean, inv_std;
+                row_stats(in_row, cols, eps, mean, inv_std);
+
+                // normalize 
+                auto vmean = Isa::set1(mean);
+                auto vinv = Isa::set1(inv_std);
+                size_t c = 0;
+                for (; c + LANES <= cols; c += LANES) {
+                    auto norm = Isa::mul(Isa::sub(Isa::load(in_row + c), vmean), vinv);
+                    Isa::store(out_row + c, Isa::fmadd(norm, Isa::load(gamma + c), Isa::load(beta + c)));
+                }
+                if (c < cols) {
+                    size_t k = cols - c;
+                    auto norm = Isa::mul(Isa::sub(Isa::load_n(in_row + c, k), vmean), vinv);
+                    Isa::store_n(out_row + c, Isa::fmadd(norm, Isa::load_n(gamma + c, k), Isa::load_n(beta + c, k)), k);
+                }
             }
-        }
+        });
     }
 
     void layernorm_backward_f32(
@@ -364,44 +774,63 @@ namespace axon::kernels::cpu {
             float* gin_row = grad_input + r * cols;
 
             // recompute the stats
-            float sum = 0.0f;
-            for (size_t c = 0; c < cols; c++) {
-                sum += in_row[c];
-            }
-
-            float mean = sum / cols;
-
-            float sum_sq_diff = 0.0f;
-
-            for (size_t c = 0; c < cols; c++) {
-                float diff = in_row[c] - mean;
-                sum_sq_diff += diff * diff;
-            }
-
-            float var = sum_sq_diff / cols;
-            float inv_std = 1.0f / std::sqrt(var + eps);
-
-            float sum_dout = 0.0f;
-            float sum_dout_xcap = 0.0f;
-
-            for (size_t c = 0; c < cols; c++) {
-                float x_cap = (in_row[c] - mean) * inv_std;
-                float dy = gout_row[c];
+            float mean, inv_std;
+            row_stats(in_row, cols, eps, mean, inv_std);
+
+            auto vmean = Isa::set1(mean);
+            auto vinv = Isa::set1(inv_std);
+            auto sum_dout = Isa::set1(0.0f);
+            auto sum_dout_xcap = Isa::set1(0.0f);
+
+            // masked-off lanes load dy = 0, so they add nothing
+            auto accumulate = [&](size_t c, size_t k) {
+                bool full = k == LANES;
+                auto x = full ? Isa::load(in_row + c) : Isa::load_n(in_row + c, k);
+                auto dy = full ? Isa::load(gout_row + c) : Isa::load_n(gout_row + c, k);
+                auto g = full ? Isa::load(gamma + c) : Isa::load_n(gamma + c, k);
+                auto gg = full ? Isa::load(grad_gamma + c) : Isa::load_n(grad_gamma + c, k);
+                auto gb = full ? Isa::load(grad_beta + c) : Isa::load_n(grad_beta + c, k);
+
+                auto x_cap = Isa::mul(Isa::sub(x, vmean), vinv);
+                gg = Isa::fmadd(dy, x_cap, gg);
+                gb = Isa::add(gb, dy);
+
+                auto dx_cap = Isa::mul(dy, g);
+                sum_dout = Isa::add(sum_dout, dx_cap);
+                sum_dout_xcap = Isa::fmadd(dx_cap, x_cap, sum_dout_xcap);
+
+                if (full) {
+                    Isa::store(grad_gamma + c, gg);
+                    Isa::store(grad_beta + c, gb);
+                } else {
+                    Isa::store_n(grad_gamma + c, gg, k);
+                    Isa::store_n(grad_beta + c, gb, k);
+                }
+            };
 
-                grad_gamma[c] += dy * x_cap;
-                grad_beta[c] += dy;
-            
-                float dx_cap = dy * gamma[c];
-                sum_dout += dx_cap;
-                sum_dout_xcap += dx_cap * x_cap;
-            }
+            size_t c = 0;
+            for (; c + LANES <= cols; c += LANES) accumulate(c, LANES);
+            if (c < cols) accumulate(c, cols - c);
 
             float inv_N = 1.0f / cols;
-            for (size_t c = 0; c < cols; c++) {
-                float x_cap = (in_row[c] - mean) * inv_std;
-                float dx_cap = gout_row[c] * gamma[c];
-                
-                gin_row[c] = inv_N * inv_std * ((cols * dx_cap) - sum_dout - (x_cap * sum_dout_xcap));
+            auto vcols = Isa::set1(static_cast<float>(cols));
+            auto vneg_sum_dout = Isa::set1(-Isa::reduce_add(sum_dout));
+            auto vsum_dout_xcap = Isa::set1(Isa::reduce_add(sum_dout_xcap));
+            auto vscale = Isa::set1(inv_N * inv_std);
+
+            auto input_grad = [&](auto x, auto dy, auto g) {
+                auto x_cap = Isa::mul(Isa::sub(x, vmean), vinv);
+                auto dx_cap = Isa::mul(dy, g);
+                auto t = Isa::fnmadd(x_cap, vsum_dout_xcap, Isa::fmadd(vcols, dx_cap, vneg_sum_dout));
+                return Isa::mul(vscale, t);
+            };
+
+            for (c = 0; c + LANES <= cols; c += LANES) {
+                Isa::store(gin_row + c, input_grad(Isa::load(in_row + c), Isa::load(gout_row + c), Isa::load(gamma + c)));
+            }
+            if (c < cols) {
+                size_t k = cols - c;
+                Isa::store_n(gin_row + c, input_grad(Isa::load_n(in_row + c, k), Isa::load_n(gout_row + c, k), Isa::load_n(gamma + c, k)), k);
             }
         }   
     }
@@ -411,28 +840,22 @@ namespace axon::kernels::cpu {
         const float* __restrict__ input,
         float* __restrict__ out
     ) noexcept {
-        for (size_t r = 0; r < rows; r++) {
-            const float* in_ptr = input + r * cols;
-            float* out_ptr = out + r * cols;
-
-            float max_val = -std::numeric_limits<float>::infinity();
-            for (size_t c = 0; c < cols; c++) {
-                max_val = std::max(in_ptr[c], max_val);
-            }
-
-            float sum = 0.0f;
-
-            for (size_t c = 0; c < cols; c++) {
-                float val = std::exp(in_ptr[c] - max_val);
-                out_ptr[c] = val;
-                sum += val;
-            }
-
-            float inv_sum = 1.0f / sum;
-            for (size_t c = 0; c < cols; c++) {
-                out_ptr[c] *= inv_sum;
+        parallel_for(0, rows, row_grain(cols), [=](size_t row_begin, size_t row_end) {
+            for (size_t r = row_begin; r < row_end; r++) {
+                const float* in_ptr = input + r * cols;
+                float* out_ptr = out + r * cols;
+
+                float max_val = simd::max_of(in_ptr, cols);
+                float sum = simd::exp_sub(in_ptr, max_val, out_ptr, cols);
+
+                auto inv_sum = Isa::set1(1.0f / sum);
+                size_t c = 0;
+                for (; c + LANES <= cols; c += LANES) {
+                    Isa::store(out_ptr + c, Isa::mul(Isa::load(out_ptr + c), inv_sum));
+                }
+                if (c < cols) Isa::store_n(out_ptr + c, Isa::mul(Isa::load_n(out_ptr + c, cols - c), inv_sum), cols - c);
             }
-        }
+        });
     }
 
     void softmax_backward_f32(
@@ -441,20 +864,159 @@ namespace axon::kernels::cpu {
         const float* __restrict__ output, 
         float* __restrict__ grad_input
     ) noexcept {
-        for (size_t r = 0; r < rows; r++) {
-            const float* gout_ptr = grad_output + r * cols;
-            const float* out_ptr = output + r * cols;
-            float* gin_ptr = grad_input + r * cols;
+        parallel_for(0, rows, row_grain(cols), [=](size_t row_begin, size_t row_end) {
+            for (size_t r = row_begin; r < row_end; r++) {
+                const float* gout_ptr = grad_output + r * cols;
+                const float* out_ptr = output + r * cols;
+                float* gin_ptr = grad_input + r * cols;
 
-            float dot = 0.0f;
+                auto dot = Isa::set1(simd::dot(gout_ptr, out_ptr, cols));
 
-            for (size_t c = 0; c < cols; c++) {
-                dot += gout_ptr[c] * out_ptr[c];
+                size_t c = 0;
+                for (; c + LANES <= cols; c += LANES) {
+                    Isa::store(gin_ptr + c, Isa::mul(Isa::load(out_ptr + c), Isa::sub(Isa::load(gout_ptr + c), dot)));
+                }
+                if (c < cols) {
+                    size_t k = cols - c;
+                    Isa::store_n(gin_ptr + c, Isa::mul(Isa::load_n(out_ptr + c, k), Isa::sub(Isa::load_n(gout_ptr + c, k), dot)), k);
+                }
             }
+        });
+    }
 
-            for (size_t c = 0; c < cols; c++) {
-                gin_ptr[c] = out_ptr[c] * (gout_ptr[c] - dot);
+    void cast_f32_to_f16(size_t n, const float* AXON_RESTRICT src, uint16_t* AXON_RESTRICT dst) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __F16C__
+            for (; i + 8 <= end; i += 8) {
+                __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
             }
-        }
+#endif
+            for (; i < end; i++) {
+                dst[i] = float_to_f16(src[i]);
+            }
+        });
+    }
+
+    void cast_f16_to_f32(size_t n, const uint16_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __F16C__
+            for (; i + 8 <= end; i += 8) {
+                _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+            }
+#endif
+            for (; i < end; i++) {
+                dst[i] = f16_to_float(src[i]);
+            }
+        });
+    }
+
+    void cast_f32_to_bf16(size_t n, const float* AXON_RESTRICT src, uint16_t* AXON_RESTRICT dst) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __AVX2__
+            const __m256i round = _mm256_set1_epi32(0x7FFF);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i quiet = _mm256_set1_epi32(0x40);
+            const __m256i abs_mask = _mm256_set1_epi32(0x7FFFFFFF);
+            const __m256i inf = _mm256_set1_epi32(0x7F800000);
+
+            for (; i + 8 <= end; i += 8) {
+                __m256i u = _mm256_castps_si256(_mm256_loadu_ps(src + i));
+
+                // round to nearest even: add 0x7FFF plus the lowest kept bit, then drop 16 bits
+                __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), one);
+                __m256i r = _mm256_srli_epi32(_mm256_add_epi32(u, _mm256_add_epi32(round, lsb)), 16);
+                __m256i nan = _mm256_or_si256(_mm256_srli_epi32(u, 16), quiet);
+                // on the bits: -ffast-math may assume an unordered float compare is never true
+                __m256i is_nan = _mm256_cmpgt_epi32(_mm256_and_si256(u, abs_mask), inf);
+                r = _mm256_blendv_epi8(r, nan, is_nan);
+
+                // 8 x u32 (all < 2^16) -> 8 x u16; packus works per 128-bit lane, so regroup the halves
+                __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(r, r), 0x08);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(packed));
+            }
+#endif
+
+            for (; i < end; i++) {
+                dst[i] = float_to_bf16(src[i]);
+            }
+        });
+    }
+
+    void cast_bf16_to_f32(size_t n, const uint16_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __AVX2__
+            for (; i + 8 <= end; i += 8) {
+                __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+                _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)));
+            }
+#endif
+            for (; i < end; i++) {
+                dst[i] = bf16_to_float(src[i]);
+            }
+        });
+    }
+
+    void cast_f32_to_i8(size_t n, const float* AXON_RESTRICT src, int8_t* AXON_RESTRICT dst) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __AVX2__
+            const __m256 lo = _mm256_set1_ps(-128.0f);
+            const __m256 hi = _mm256_set1_ps(127.0f);
+
+            for (; i + 8 <= end; i += 8) {
+                // clamp first: cvtps_epi32 turns anything out of int32 range into INT_MIN
+                __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), lo), hi);
+                __m256i v = _mm256_cvtps_epi32(x);
+                // 8 x i32 -> 8 x i8, per 128-bit lane: each lane's 4 bytes end up in its low dword
+                __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(v, v), _mm256_setzero_si256());
+                uint32_t low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_castsi256_si128(packed)));
+                uint32_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1)));
+                uint64_t bytes = low | (static_cast<uint64_t>(high) << 32);
+                std::memcpy(dst + i, &bytes, 8);
+            }
+#endif
+
+            for (; i < end; i++) {
+                float x = std::min(std::max(src[i], -128.0f), 127.0f);
+                dst[i] = static_cast<int8_t>(std::lrint(x));
+            }
+        });
+    }
+
+    void cast_i8_to_f32(size_t n, const int8_t* AXON_RESTRICT src, float* AXON_RESTRICT dst) noexcept {
+        parallel_for(0, n, ELEMENTWISE_GRAIN, [=](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __AVX2__
+            for (; i + 8 <= end; i += 8) {
+                __m256i wide = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+                _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(wide));
+            }
+#endif
+            for (; i < end; i++) {
+                dst[i] = static_cast<float>(src[i]);
+            }
+        });
+    }
+
+    const KernelTable& kernel_table() noexcept {
+        #define AXON_KERNEL_ENTRY(name) .name = &AXON_CPU_ISA::name,
+        #define AXON_EMBEDDING_ENTRY_I32(name) .name = &AXON_CPU_ISA::name<int32_t>,
+        #define AXON_EMBEDDING_ENTRY_I64(name) .name = &AXON_CPU_ISA::name<int64_t>,
+
+        static constexpr KernelTable table = {
+            AXON_CPU_KERNELS(AXON_KERNEL_ENTRY)
+            .embedding_i32 = { AXON_CPU_EMBEDDING_KERNELS(AXON_EMBEDDING_ENTRY_I32) },
+            .embedding_i64 = { AXON_CPU_EMBEDDING_KERNELS(AXON_EMBEDDING_ENTRY_I64) },
+        };
+
+        #undef AXON_KERNEL_ENTRY
+        #undef AXON_EMBEDDING_ENTRY_I32
+        #undef AXON_EMBEDDING_ENTRY_I64
+        return table;
     }
 }
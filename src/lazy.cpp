@@ -0,0 +1,380 @@
+#include "axon/lazy.hpp"
+#include "axon/thread_pool.hpp"
+#include "tensor_iterator.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+namespace axon::lazy {
+
+    namespace {
+        using kernels::cpu::FusedOp;
+        using kernels::cpu::FusedInstr;
+
+        constexpr size_t MAX_OPERANDS = kernels::cpu::FUSED_MAX_OPERANDS;
+
+        // below this many elements a fused loop stays on the calling thread
+        constexpr size_t FUSED_GRAIN = 1 << 15;
+
+        // an operand of a recorded op: another recorded op's value, or a tensor from outside
+        struct Ref {
+            bool is_node = false;
+            int index = -1;
+
+            bool operator== (const Ref& o) const {
+                return is_node == o.is_node && index == o.index;
+            }
+        };
+
+        struct Node {
+            FusedOp op;
+            Ref a, b;  // b.index < 0 for the unary ops
+            Tensor out;
+        };
+
+        struct Trace {
+            std::vector<Node> nodes;
+            std::vector<Tensor> leaves;
+            // pending storage -> the node computing it
+            std::unordered_map<const Storage*, int> producer;
+        };
+
+        thread_local Trace trace;
+        thread_local int depth = 0;
+
+        const char* op_name(FusedOp op) {
+            switch (op) {
+                case FusedOp::Add: return "add";
+                case FusedOp::Sub: return "sub";
+                case FusedOp::Mul: return "mul";
+                case FusedOp::Div: return "div";
+                case FusedOp::Neg: return "neg";
+                case FusedOp::Sqrt: return "sqrt";
+                case FusedOp::Exp: return "exp";
+                case FusedOp::Relu: return "relu";
+                case FusedOp::Gelu: return "gelu";
+                default: return "?";
+            }
+        }
+
+        std::string shape_str(const std::vector<int>& shape) {
+            std::string s = "(";
+            for (size_t i = 0; i < shape.size(); i++) {
+                s += (i ? ", " : "") + std::to_string(shape[i]);
+            }
+            return s + ")";
+        }
+
+        // a pending tensor can be read straight from its node only as the node wrote it;
+        // a view of it (transpose, expand, ...) needs the data to exist
+        bool needs_sync(const Tensor& t) {
+            if (!t.get_storage() -> pending) return false;
+            auto it = trace.producer.find(t.get_storage().get());
+            if (it == trace.producer.end()) return true;
+            const Tensor& out = trace.nodes[it -> second].out;
+            return t.get_shape() != out.get_shape() || t.get_stride() != out.get_stride() || t.get_offset() != 0;
+        }
+
+        Ref reference(const Tensor& t) {
+            if (t.get_storage() -> pending) {
+                return {true, trace.producer.at(t.get_storage().get())};
+            }
+
+            // the same view twice (x * x) is one operand
+            for (size_t i = 0; i < trace.leaves.size(); i++) {
+                const Tensor& l = trace.leaves[i];
+                if (l.get_storage() == t.get_storage() && l.get_offset() == t.get_offset() &&
+                    l.get_shape() == t.get_shape() && l.get_stride() == t.get_stride()) {
+                    return {false, static_cast<int>(i)};
+                }
+            }
+            trace.leaves.push_back(t);
+            return {false, static_cast<int>(trace.leaves.size() - 1)};
+        }
+
+        // A loop over one shape: the ops it computes, in recording order, and what it reads
+        // from outside (inputs, or values other loops store)
+        struct Group {
+            std::vector<int> shape;
+            std::vector<int> nodes;
+            std::vector<Ref> loads;
+            std::vector<int> deps;  // groups whose stored values this one loads
+        };
+
+        struct Plan {
+            std::vector<Group> groups;
+            std::vector<int> order;     // groups, dependencies first
+            std::vector<int> group_of;  // per node
+            std::vector<bool> stored;   // per node: written to its tensor
+            std::vector<bool> needed;   // per node: stored, or read by another op
+        };
+
+        // does group `from` (transitively) load something group `to` computes
+        bool depends_on(const std::vector<Group>& groups, int from, int to) {
+            if (from == to) return true;
+            for (int d : groups[from].deps) {
+                if (depends_on(groups, d, to)) return true;
+            }
+            return false;
+        }
+
+        Plan make_plan(const Trace& t) {
+            Plan p;
+            int n = static_cast<int>(t.nodes.size());
+            p.group_of.assign(n, -1);
+            p.stored.assign(n, false);
+            p.needed.assign(n, false);
+
+            for (int i = 0; i < n; i++) {
+                const Node& node = t.nodes[i];
+                std::vector<Ref> inputs = {node.a};
+                if (node.b.index >= 0 && !(node.b == node.a)) inputs.push_back(node.b);
+
+                // join the latest loop over the same shape, unless that overflows the registers
+                // or makes two loops wait on each other
+                int g = -1;
+                for (int k = static_cast<int>(p.groups.size()) - 1; k >= 0; k--) {
+                    if (p.groups[k].shape == node.out.get_shape()) {
+                        g = k;
+                        break;
+                    }
+                }
+
+                if (g >= 0) {
+                    const Group& group = p.groups[g];
+                    size_t new_loads = 0;
+                    bool cycle = false;
+                    for (const Ref& r : inputs) {
+                        if (r.is_node && p.group_of[r.index] == g) continue;
+                        if (std::find(group.loads.begin(), group.loads.end(), r) == group.loads.end()) new_loads++;
+                        if (r.is_node && depends_on(p.groups, p.group_of[r.index], g)) cycle = true;
+                    }
+                    // every load and every op gets a register, every store an operand
+                    if (cycle || group.loads.size() + new_loads + group.nodes.size() + 1 > MAX_OPERANDS) {
+                        g = -1;
+                    }
+                }
+
+                if (g < 0) {
+                    p.groups.push_back({node.out.get_shape(), {}, {}, {}});
+                    g = static_cast<int>(p.groups.size()) - 1;
+                }
+
+                Group& group = p.groups[g];
+                for (const Ref& r : inputs) {
+                    if (r.is_node && p.group_of[r.index] == g) continue;
+                    if (std::find(group.loads.begin(), group.loads.end(), r) == group.loads.end()) group.loads.push_back(r);
+                    if (r.is_node) {
+                        int h = p.group_of[r.index];
+                        if (std::find(group.deps.begin(), group.deps.end(), h) == group.deps.end()) group.deps.push_back(h);
+                    }
+                }
+                group.nodes.push_back(i);
+                p.group_of[i] = g;
+            }
+
+            // back to front: values the caller still holds (the trace owns one reference), what
+            // they are computed from, and which of those another loop has to load from memory
+            for (int i = n - 1; i >= 0; i--) {
+                const Node& node = t.nodes[i];
+                if (node.out.get_storage().use_count() > 2) p.stored[i] = true;
+                if (!p.stored[i] && !p.needed[i]) continue;
+                p.needed[i] = true;
+
+                for (const Ref& r : {node.a, node.b}) {
+                    if (!r.is_node) continue;
+                    p.needed[r.index] = true;
+                    if (p.group_of[r.index] != p.group_of[i]) p.stored[r.index] = true;
+                }
+            }
+
+            std::vector<bool> placed(p.groups.size(), false);
+            auto place = [&](auto&& self, int g) -> void {
+                if (placed[g]) return;
+                placed[g] = true;
+                for (int d : p.groups[g].deps) self(self, d);
+                p.order.push_back(g);
+            };
+            for (int g = 0; g < static_cast<int>(p.groups.size()); g++) place(place, g);
+
+            return p;
+        }
+
+        std::string ref_str(const Ref& r) {
+            return (r.is_node ? "%" : "x") + std::to_string(r.index);
+        }
+
+        std::string describe(const Trace& t, const Plan& p) {
+            std::ostringstream os;
+            size_t n_stored = std::count(p.stored.begin(), p.stored.end(), true);
+            os << "[LAZY] " << t.nodes.size() << " ops in " << p.groups.size() << " fused loops, " << n_stored << " outputs written\n";
+
+            for (int g : p.order) {
+                const Group& group = p.groups[g];
+                os << "  loop " << g << " over " << shape_str(group.shape) << ", reads";
+                for (const Ref& r : group.loads) {
+                    const Tensor& src = r.is_node ? t.nodes[r.index].out : t.leaves[r.index];
+                    os << " " << ref_str(r) << shape_str(src.get_shape());
+                }
+                os << "\n";
+
+                for (int i : group.nodes) {
+                    const Node& node = t.nodes[i];
+                    os << "    %" << i << " = " << op_name(node.op) << "(" << ref_str(node.a);
+                    if (node.b.index >= 0) os << ", " << ref_str(node.b);
+                    os << ")" << (p.stored[i] ? "  -> stored" : p.needed[i] ? "" : "  (unused, skipped)") << "\n";
+                }
+            }
+            return os.str();
+        }
+
+        void run_group(const Trace& t, const Plan& p, int g) {
+            const Group& group = p.groups[g];
+            std::vector<Tensor> operands;
+            std::vector<FusedInstr> code;
+            std::unordered_map<int, uint8_t> node_reg;
+            std::vector<uint8_t> load_reg;
+            uint8_t next_reg = 0;
+
+            for (const Ref& r : group.loads) {
+                // only read by ops nobody needs
+                if (r.is_node && !p.stored[r.index]) {
+                    load_reg.push_back(0);
+                    continue;
+                }
+                const Tensor& src = r.is_node ? t.nodes[r.index].out : t.leaves[r.index];
+                operands.push_back(src.get_shape() == group.shape ? src : src.expand(group.shape));
+                load_reg.push_back(next_reg);
+                code.push_back({FusedOp::Load, next_reg++, static_cast<uint8_t>(operands.size() - 1), 0});
+            }
+
+            auto reg = [&](const Ref& r) -> uint8_t {
+                if (r.is_node && p.group_of[r.index] == g) return node_reg.at(r.index);
+                return load_reg[std::find(group.loads.begin(), group.loads.end(), r) - group.loads.begin()];
+            };
+
+            for (int i : group.nodes) {
+                // nobody reads it: not computed at all
+                if (!p.needed[i]) continue;
+                const Node& node = t.nodes[i];
+                uint8_t dst = next_reg++;
+                code.push_back({node.op, dst, reg(node.a), node.b.index >= 0 ? reg(node.b) : uint8_t(0)});
+                node_reg[i] = dst;
+
+                if (p.stored[i]) {
+                    operands.push_back(node.out);
+                    code.push_back({FusedOp::Store, static_cast<uint8_t>(operands.size() - 1), dst, 0});
+                }
+            }
+
+            bool writes = std::any_of(code.begin(), code.end(), [](const FusedInstr& in) { return in.op == FusedOp::Store; });
+            if (!writes) return;
+
+            // every slot of the iterator needs strides; unused ones never move
+            std::vector<int> still(group.shape.size(), 0);
+            std::array<const std::vector<int>*, MAX_OPERANDS> strides;
+            std::array<float*, MAX_OPERANDS> base{};
+            for (size_t k = 0; k < MAX_OPERANDS; k++) {
+                strides[k] = k < operands.size() ? &operands[k].get_stride() : &still;
+                if (k < operands.size()) base[k] = operands[k].data_ptr();
+            }
+
+            TensorIterator<MAX_OPERANDS> it(group.shape, strides);
+            size_t n_operands = operands.size();
+            parallel_for(0, it.numel(), FUSED_GRAIN, [&](size_t begin, size_t end) {
+                it.for_each_piece(begin, end, [&](const TensorIterator<MAX_OPERANDS>::Offsets& off, size_t n) {
+                    float* ptrs[MAX_OPERANDS];
+                    ptrdiff_t inner[MAX_OPERANDS];
+                    for (size_t k = 0; k < n_operands; k++) {
+                        ptrs[k] = base[k] + off[k];
+                        inner[k] = it.inner_stride(k);
+                    }
+                    kernels::cpu::fused_elementwise_f32(code.data(), code.size(), n, ptrs, inner);
+                });
+            });
+        }
+
+        bool dump_enabled() {
+            static const bool enabled = [] {
+                const char* env = std::getenv("AXON_LAZY_DUMP");
+                return env && env[0] && env[0] != '0';
+            }();
+            return enabled;
+        }
+    } // namespace
+
+    bool is_enabled() {
+        return depth > 0;
+    }
+
+    Tensor record(FusedOp op, const std::vector<int>& shape, const Tensor& a, const Tensor* b) {
+        if (needs_sync(a) || (b && needs_sync(*b))) {
+            sync();
+        }
+
+        Ref ra = reference(a);
+        Ref rb = b ? reference(*b) : Ref{};
+
+        std::vector<int> stride(shape.size());
+        size_t numel = 1;
+        for (int i = static_cast<int>(shape.size()) - 1; i >= 0; i--) {
+            stride[i] = static_cast<int>(numel);
+            numel *= shape[i];
+        }
+
+        // no memory until the sync knows the value has to be written
+        auto storage = std::make_shared<Storage>(nullptr, numel * sizeof(float), Device(DeviceType::CPU));
+        storage -> pending = true;
+        Tensor out = Tensor::from_storage(storage, shape, stride, 0);
+
+        trace.producer[storage.get()] = static_cast<int>(trace.nodes.size());
+        trace.nodes.push_back({op, ra, rb, out});
+        return out;
+    }
+
+    void sync() {
+        if (trace.nodes.empty()) return;
+
+        // taken out first: reading the inputs below must not find a trace to run again
+        Trace t = std::move(trace);
+        trace = Trace{};
+
+        Plan p = make_plan(t);
+        if (dump_enabled()) {
+            std::cerr << describe(t, p);
+        }
+
+        for (size_t i = 0; i < t.nodes.size(); i++) {
+            Storage& s = *t.nodes[i].out.get_storage();
+            s.pending = false;
+            if (p.stored[i]) s.materialize();
+        }
+
+        for (int g : p.order) {
+            run_group(t, p, g);
+        }
+    }
+
+    std::string describe() {
+        if (trace.nodes.empty()) return "[LAZY] nothing pending\n";
+        return describe(trace, make_plan(trace));
+    }
+
+} // namespace axon::lazy
+
+namespace axon {
+
+    LazyGuard::LazyGuard() {
+        lazy::depth++;
+    }
+
+    LazyGuard::~LazyGuard() {
+        if (--lazy::depth == 0) {
+            lazy::sync();
+        }
+    }
+
+} // namespace axon
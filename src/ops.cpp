@@ -2,8 +2,14 @@
 #include "axon/kernels.hpp"    
 #include "axon/autograd.hpp"
 #include "axon/grad_mode.hpp"
-#include <functional>
+#include "axon/thread_pool.hpp"
+#include "axon/lazy.hpp"
+#include "axon/compile.hpp"
+#include "tensor_iterator.hpp"
+#include <cmath>
+#include <optional>
 #include <stdexcept>
+#include <string>
 #include <algorithm>
 
 namespace axon {
@@ -17,10 +23,12 @@ namespace axon {
 
     #define DISPATCH_UNARY_FALLBACK(op_name, tensor, out) \
         if (tensor.device().type == DeviceType::CPU) { \
-            kernels::cpu::op_name##_f32(tensor.numel(), tensor.data_ptr(), out.data_ptr()); \
+            size_t n = tensor.numel(); \
+            trace::DataRef src(tensor), dst(out); \
+            run_kernels(#op_name, {&tensor}, {&out}, [=] { kernels::cpu::op_name##_f32(n, src.f32(), dst.f32()); }); \
         } else { \
             Tensor t_cpu = tensor.to(Device(DeviceType::CPU)); \
-            Tensor out_cpu = Tensor::zeros(tensor.get_shape(), Device(DeviceType::CPU)); \
+            Tensor out_cpu = Tensor::empty(tensor.get_shape(), Device(DeviceType::CPU)); \
             kernels::cpu::op_name##_f32(t_cpu.numel(), t_cpu.data_ptr(), out_cpu.data_ptr()); \
             out = out_cpu.to(tensor.device()); \
         }
@@ -34,15 +42,76 @@ namespace axon {
 
     #define DISPATCH_BINARY_FALLBACK(op_name, a, b, out) \
         if (a.device().type == DeviceType::CPU) { \
-            kernels::cpu::op_name##_f32(out.numel(), a.data_ptr(), b.data_ptr(), out.data_ptr()); \
+            size_t n = out.numel(); \
+            trace::DataRef pa(a), pb(b), po(out); \
+            run_kernels(#op_name, {&a, &b}, {&out}, [=] { kernels::cpu::op_name##_f32(n, pa.f32(), pb.f32(), po.f32()); }); \
         } else { \
             Tensor a_cpu = a.to(Device(DeviceType::CPU)); \
             Tensor b_cpu = b.to(Device(DeviceType::CPU)); \
-            Tensor out_cpu = Tensor::zeros(out.get_shape(), Device(DeviceType::CPU)); \
+            Tensor out_cpu = Tensor::empty(out.get_shape(), Device(DeviceType::CPU)); \
             kernels::cpu::op_name##_f32(out.numel(), a_cpu.data_ptr(), b_cpu.data_ptr(), out_cpu.data_ptr()); \
             out = out_cpu.to(a.device()); \
         }
 
+    // An op's output. Under compile() it only gets a shape: the op records its kernel calls
+    // (run_kernels) and the plan places the output in its arena afterwards, unless none of the
+    // op's inputs is traced, in which case it gets memory then and the op runs while tracing.
+    Tensor new_output(const std::vector<int>& shape, Device dev, DType dtype = DType::Float32) {
+        if (!trace::is_active()) {
+            return Tensor::empty(shape, dtype, dev);
+        }
+        if (dev.type != DeviceType::CPU) {
+            throw std::invalid_argument("[COMPILE] Error: Only CPU modules can be compiled");
+        }
+        return trace::output(shape, dtype);
+    }
+
+    // Runs an op's kernel calls now, or under compile() keeps them for replay. fn must not hold
+    // references to locals, and reaches the data through trace::DataRef (or tensors it holds).
+    template <typename Fn>
+    void run_kernels(const char* op, std::initializer_list<const Tensor*> reads, std::initializer_list<const Tensor*> writes, Fn&& fn) {
+        if (trace::is_active()) {
+            trace::record(op, reads, writes, std::forward<Fn>(fn));
+        } else {
+            fn();
+        }
+    }
+
+    // Ops compute in float32. 16-bit tensors are only read directly by matmul (the right-hand
+    // operand) and embedding (the table), int8 ones by their quantized_ counterparts; anything
+    // else has to be converted first.
+    void require_f32(const Tensor& t, const char* op) {
+        if (t.dtype() != DType::Float32) {
+            throw std::invalid_argument(std::string("[") + op + "] Error: Expected a float32 tensor, got "
+                                        + dtype_name(t.dtype()) + " (convert with .to(DType::Float32))");
+        }
+    }
+
+    bool is_index_dtype(DType dtype) {
+        return dtype == DType::Int32 || dtype == DType::Int64;
+    }
+
+    // Calls fn with the row ids of a contiguous CPU index tensor: int32 / int64 as stored,
+    // float32 (the older convention, exact only below 2^24) converted to int32 first
+    template <typename Fn>
+    void with_indices(const Tensor& idx, const char* op, Fn&& fn) {
+        switch (idx.dtype()) {
+            case DType::Int32: fn(idx.data_as<int32_t>()); return;
+            case DType::Int64: fn(idx.data_as<int64_t>()); return;
+            case DType::Float32: {
+                std::vector<int32_t> ids(idx.numel());
+                const float* src = idx.data_ptr();
+                for (size_t i = 0; i < ids.size(); i++) {
+                    ids[i] = static_cast<int32_t>(src[i]);
+                }
+                fn(static_cast<const int32_t*>(ids.data()));
+                return;
+            }
+            default:
+                throw std::invalid_argument(std::string("[") + op + "] Error: Expected int32 / int64 indices, got " + dtype_name(idx.dtype()));
+        }
+    }
+
     std::vector<int> broadcast_shapes(const std::vector<int>& s1, const std::vector<int>& s2) {
         size_t len1 = s1.size();
         size_t len2 = s2.size();
@@ -67,40 +136,97 @@ namespace axon {
         return out_shape;
     }
 
-    void apply_binary_op_rec(
-        int dim, const std::vector<int>& shape,
-        int off_a, const std::vector<int>& stride_a,
-        int off_b, const std::vector<int>& stride_b,
-        int off_out, const std::vector<int>& stride_out,
-        const float* ptr_a, const float* ptr_b, float* ptr_out,
-        std::function<float(float, float)> op) {
-        
-        int dim_len = shape[dim];
-        if (dim == shape.size() - 1) {
-            for (int i = 0; i < dim_len; i++) {
-                ptr_out[off_out + i * stride_out[dim]] =
-                    op(ptr_a[off_a + i * stride_a[dim]], ptr_b[off_b + i * stride_b[dim]]);
+    // expand() without the extra tensor handle when nothing needs broadcasting
+    Tensor expand_to(const Tensor& t, const std::vector<int>& target_shape) {
+        return t.get_shape() == target_shape ? t : t.expand(target_shape);
+    }
+
+    // the broadcasting / strided path of add, sub, mul, div (and add_, with out being a); the iterator
+    // coalesces dims and picks out the inner rows, binary_strided_f32 vectorizes them when they are
+    // contiguous or broadcast. A compiled plan keeps the coalesced iterator.
+    auto strided_binary_kernels(const Tensor& a, const Tensor& b, const Tensor& out, kernels::cpu::BinaryOp op) {
+        TensorIterator<3> it(out.get_shape(), {&out.get_stride(), &a.get_stride(), &b.get_stride()});
+        trace::DataRef ra(a), rb(b), ro(out);
+
+        return [op, ra, rb, ro, it = std::move(it)] {
+            const float* pa = ra.f32();
+            const float* pb = rb.f32();
+            float* po = ro.f32();
+            parallel_for(0, it.numel(), 1 << 15, [&](size_t begin, size_t end) {
+                it.for_each_piece(begin, end, [&](const TensorIterator<3>::Offsets& off, size_t n) {
+                    kernels::cpu::binary_strided_f32(op, n, pa + off[1], it.inner_stride(1), pb + off[2], it.inner_stride(2), po + off[0], it.inner_stride(0));
+                });
+            });
+        };
+    }
+
+    void dispatch_binary_op(const Tensor& a, const Tensor& b, Tensor& out, kernels::cpu::BinaryOp op) {
+        run_kernels("binary_strided", {&a, &b}, {&out}, strided_binary_kernels(a, b, out, op));
+    }
+
+    // What an in-place op checks before overwriting a. Ops recorded under LazyGuard may still
+    // read a (or compute it), so they run first.
+    void check_in_place(const Tensor& a, const Tensor* b, const char* op) {
+        require_f32(a, op);
+        if (b) require_f32(*b, op);
+        if (a.device().type != DeviceType::CPU || (b && b -> device().type != DeviceType::CPU)) {
+            throw std::invalid_argument(std::string("[") + op + "] Error: In-place ops are CPU only");
+        }
+        if (GradMode::is_enabled() && (a.requires_grad() || (b && b -> requires_grad()))) {
+            throw std::invalid_argument(std::string("[") + op + "] Error: In-place op on a tensor that needs a gradient");
+        }
+        for (size_t d = 0; d < a.get_shape().size(); d++) {
+            if (a.get_stride()[d] == 0 && a.get_shape()[d] > 1) {
+                throw std::invalid_argument(std::string("[") + op + "] Error: In-place op on an expanded tensor (its elements overlap)");
             }
-        } else {
-            for (int i = 0; i < dim_len; i++) {
-                apply_binary_op_rec(dim + 1, shape,
-                    off_a + i * stride_a[dim], stride_a,
-                    off_b + i * stride_b[dim], stride_b,
-                    off_out + i * stride_out[dim], stride_out,
-                    ptr_a, ptr_b, ptr_out, op);
+        }
+        lazy::sync();
+    }
+
+    // In-place kernel calls. Under compile() a traced a is recorded like any output; a constant
+    // one (computed while tracing) is overwritten once, now, as replaying it would apply the op
+    // again on every run.
+    template <typename Fn>
+    void run_in_place(const char* op, const Tensor& a, std::initializer_list<const Tensor*> reads, Fn&& fn) {
+        if (trace::is_active() && !a.get_storage() -> pending) {
+            for (const Tensor* t : reads) {
+                if (t -> get_storage() -> pending) {
+                    throw std::runtime_error(std::string("[COMPILE] Error: ") + op + " writes a traced value into a constant");
+                }
             }
+            fn();
+            return;
         }
+        run_kernels(op, reads, {&a}, std::forward<Fn>(fn));
+    }
+
+    // relu_ / gelu_: a one-op fused program that loads and stores the same operand (the unary
+    // kernels are restrict-qualified, they can't run in place)
+    void unary_in_place(const char* op, kernels::cpu::FusedOp fop, const Tensor& a) {
+        using kernels::cpu::FusedOp;
+        TensorIterator<1> it(a.get_shape(), {&a.get_stride()});
+        trace::DataRef ra(a);
+
+        run_in_place(op, a, {&a}, [fop, ra, it = std::move(it)] {
+            const kernels::cpu::FusedInstr code[] = {{FusedOp::Load, 0, 0, 0}, {fop, 0, 0, 0}, {FusedOp::Store, 0, 0, 0}};
+            float* base = ra.f32();
+            parallel_for(0, it.numel(), 1 << 15, [&](size_t begin, size_t end) {
+                it.for_each_piece(begin, end, [&](const TensorIterator<1>::Offsets& off, size_t n) {
+                    float* ptr = base + off[0];
+                    ptrdiff_t stride = it.inner_stride(0);
+                    kernels::cpu::fused_elementwise_f32(code, 3, n, &ptr, &stride);
+                });
+            });
+        });
     }
 
-    void dispatch_binary_op(const Tensor& a, const Tensor& b, Tensor& out, std::function<float(float, float)> op) {
-        apply_binary_op_rec(
-            0, a.get_shape(),
-            0, a.get_stride(),
-            0, b.get_stride(),
-            0, out.get_stride(),
-            a.data_ptr(), b.data_ptr(), out.data_ptr(),
-            op
-        );
+    // under LazyGuard the op is recorded for a fused loop instead of run (see lazy.hpp);
+    // ops whose result needs a gradient still run now
+    std::optional<Tensor> trace_elementwise(kernels::cpu::FusedOp op, const std::vector<int>& shape, const Tensor& a, const Tensor* b = nullptr) {
+        if (!lazy::is_enabled() || trace::is_active()) return std::nullopt;
+        if (GradMode::is_enabled() && (a.requires_grad() || (b && b -> requires_grad()))) return std::nullopt;
+        if (a.device().type != DeviceType::CPU || (b && b -> device().type != DeviceType::CPU)) return std::nullopt;
+        return lazy::record(op, shape, a, b);
     }
 
     // Reduces `grad` to match `target_shape` by summing out broadcasted dimensions
@@ -151,7 +277,7 @@ namespace axon {
         std::vector<Tensor> apply(const Tensor& grad_output) override {
             // We need the original input to compute the mask
             // But 'input' might be strided.
-            Tensor grad_input = Tensor::zeros(input.get_shape());
+            Tensor grad_input = Tensor::empty(input.get_shape());
             
             // Force contiguous for kernel execution
             Tensor inp_c = input.is_contiguous() ? input : input.contiguous();
@@ -166,8 +292,12 @@ namespace axon {
     };
     
     Tensor relu(Tensor t) {
+        require_f32(t, "RELU");
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Relu, t.get_shape(), t)) {
+            return *lazy_out;
+        }
         Device dev = t.device();
-        Tensor out = Tensor::zeros(t.get_shape(), dev);
+        Tensor out = new_output(t.get_shape(), dev);
 
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
         DISPATCH_UNARY_FALLBACK(relu, t_c, out);
@@ -186,7 +316,7 @@ namespace axon {
         GeluBackward(Tensor in) : input(in) {}
 
         std::vector<Tensor> apply(const Tensor& grad_output) override {
-            Tensor grad_input = Tensor::zeros(input.get_shape());
+            Tensor grad_input = Tensor::empty(input.get_shape());
             Tensor input_c = input.is_contiguous() ? input : input.contiguous();
             Tensor g_c = grad_output.is_contiguous() ? grad_output : grad_output.contiguous();
             kernels::cpu::gelu_backward_f32(input_c.numel(), input_c.data_ptr(), g_c.data_ptr(), grad_input.data_ptr());
@@ -198,8 +328,12 @@ namespace axon {
     };
 
     Tensor gelu(Tensor t) {
+        require_f32(t, "GELU");
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Gelu, t.get_shape(), t)) {
+            return *lazy_out;
+        }
         Device dev = t.device();
-        Tensor out = Tensor::zeros(t.get_shape(), dev);
+        Tensor out = new_output(t.get_shape(), dev);
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
         DISPATCH_UNARY_FALLBACK(gelu, t_c, out);
 
@@ -213,12 +347,29 @@ namespace axon {
         return out;
     }
 
+    Tensor relu_(Tensor a) {
+        check_in_place(a, nullptr, "RELU_");
+        unary_in_place("relu_", kernels::cpu::FusedOp::Relu, a);
+        return a;
+    }
+
+    Tensor gelu_(Tensor a) {
+        check_in_place(a, nullptr, "GELU_");
+        unary_in_place("gelu_", kernels::cpu::FusedOp::Gelu, a);
+        return a;
+    }
+
+    bool can_modify_in_place(const Tensor& t) {
+        return t.is_unique() && t.dtype() == DType::Float32 && t.device().type == DeviceType::CPU
+               && !GradMode::is_enabled() && !lazy::is_enabled();
+    }
+
     struct LogSoftmaxBackward : public GradFn {
         Tensor output; 
         LogSoftmaxBackward(Tensor out) : output(out) {}
 
         std::vector<Tensor> apply(const Tensor& grad_output) override {
-            Tensor grad_input = Tensor::zeros(output.get_shape());
+            Tensor grad_input = Tensor::empty(output.get_shape());
             
             // Assume 2D (Batch, Class)
             int rows = output.get_shape()[0];
@@ -233,19 +384,20 @@ namespace axon {
     };
 
     Tensor log_softmax(Tensor t) {
+        require_f32(t, "LOG_SOFTMAX");
         if (t.get_shape().size() != 2) {
             throw std::invalid_argument("[DIM ERROR]: LogSoftmax expects 2D (Batch, Class)");
         }
 
         Device dev = t.device();
-        Tensor out = Tensor::zeros(t.get_shape(), dev);
+        Tensor out = Tensor::empty(t.get_shape(), dev);
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
 
         if (dev.type == DeviceType::CPU) {
             kernels::cpu::log_softmax_f32(t.get_shape()[0], t.get_shape()[1], t_c.data_ptr(), out.data_ptr());
         } else {
             Tensor t_cpu = t_c.to(Device(DeviceType::CPU));
-            Tensor out_cpu = Tensor::zeros(t.get_shape(), Device(DeviceType::CPU));
+            Tensor out_cpu = Tensor::empty(t.get_shape(), Device(DeviceType::CPU));
             kernels::cpu::log_softmax_f32(t.get_shape()[0], t.get_shape()[1], t_cpu.data_ptr(), out_cpu.data_ptr());
             out = out_cpu.to(dev);
         }
@@ -262,7 +414,81 @@ namespace axon {
     // NLL Loss (Negative Log Likelihood)
     // Expects LogSoftmax input.
     // Loss = - sum(target * input) / batch_size
+    struct NLLLossBackward : public GradFn {
+        Tensor target; // CPU copy of the indices
+        std::vector<int> input_shape;
+        Device dev;
+        NLLLossBackward(Tensor t, std::vector<int> shape, Device d) : target(t), input_shape(shape), dev(d) {}
+
+        // -1/N at each row's target class, zero elsewhere
+        std::vector<Tensor> apply(const Tensor& grad_output) override {
+            size_t N = input_shape[0];
+            size_t C = input_shape[1];
+            Device cpu(DeviceType::CPU);
+            Tensor grad_input = Tensor::zeros(input_shape);
+            Tensor g_cpu = grad_output.device().type == DeviceType::CPU ? grad_output : grad_output.to(cpu);
+            float g = -g_cpu.data_ptr()[0] / (float)N;
+            float* dst = grad_input.data_ptr();
+            with_indices(target, "NLL_LOSS", [&](auto ids) {
+                for (size_t i = 0; i < N; i++) {
+                    dst[i * C + ids[i]] = g;
+                }
+            });
+            if (dev.type != DeviceType::CPU) {
+                return {grad_input.to(dev)};
+            }
+            return {grad_input};
+        }
+    };
+
+    // class-index targets: -mean_i input[i, target[i]]
+    Tensor nll_loss_indexed(const Tensor& input, const Tensor& target) {
+        if (input.get_shape().size() != 2 || target.numel() != (size_t)input.get_shape()[0]) {
+            throw std::invalid_argument("[NLL_LOSS] Error: Expected (N, C) input and N class indices");
+        }
+        size_t N = input.get_shape()[0];
+        size_t C = input.get_shape()[1];
+
+        // the loop below reads host memory: other devices go through CPU copies
+        Device dev = input.device();
+        Device cpu(DeviceType::CPU);
+        Tensor in_c = dev.type == DeviceType::CPU ? input : input.to(cpu);
+        Tensor target_c = target.device().type == DeviceType::CPU ? target : target.to(cpu);
+        in_c = in_c.is_contiguous() ? in_c : in_c.contiguous();
+        target_c = target_c.is_contiguous() ? target_c : target_c.contiguous();
+
+        double total = 0.0;
+        const float* src = in_c.data_ptr();
+        with_indices(target_c, "NLL_LOSS", [&](auto ids) {
+            for (size_t i = 0; i < N; i++) {
+                if (ids[i] < 0 || static_cast<size_t>(ids[i]) >= C) {
+                    throw std::out_of_range("[NLL_LOSS] Error: Target " + std::to_string(ids[i]) + " out of range for " + std::to_string(C) + " classes");
+                }
+                total += src[i * C + ids[i]];
+            }
+        });
+
+        Tensor out = Tensor::empty({1});
+        out.data_ptr()[0] = static_cast<float>(-total / (double)N);
+        if (dev.type != DeviceType::CPU) {
+            out = out.to(dev);
+        }
+
+        if (input.requires_grad() && GradMode::is_enabled()) {
+            out.set_requires_grad(true);
+            auto fn = std::make_shared<NLLLossBackward>(target_c, input.get_shape(), dev);
+            fn -> next_edges.push_back({input.get_grad_fn(), std::make_shared<Tensor>(input)});
+            out.set_grad_fn(fn);
+        }
+        return out;
+    }
+
     Tensor nll_loss(Tensor input, Tensor target) {
+        require_f32(input, "NLL_LOSS");
+        if (is_index_dtype(target.dtype())) {
+            return nll_loss_indexed(input, target);
+        }
+        require_f32(target, "NLL_LOSS");
         // -1 * (target * input)
         Tensor prod = mul(target, input);
         Tensor s = sum(prod);
@@ -375,16 +601,21 @@ namespace axon {
     };
 
     Tensor add(Tensor a, Tensor b) {
+        require_f32(a, "ADD");
+        require_f32(b, "ADD");
         std::vector<int> target_shape = broadcast_shapes(a.get_shape(), b.get_shape());
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Add, target_shape, a, &b)) {
+            return *lazy_out;
+        }
         Device dev = a.device();
-        Tensor a_ex = a.expand(target_shape);
-        Tensor b_ex = b.expand(target_shape);
-        Tensor out = Tensor::zeros(target_shape, dev);
+        Tensor a_ex = expand_to(a, target_shape);
+        Tensor b_ex = expand_to(b, target_shape);
+        Tensor out = new_output(target_shape, dev);
 
         if (a_ex.is_contiguous() && b_ex.is_contiguous() && out.is_contiguous()) {
             DISPATCH_BINARY_FALLBACK(add, a_ex, b_ex, out);
         } else {
-            dispatch_binary_op(a_ex, b_ex, out, [](float x, float y) { return x + y; });
+            dispatch_binary_op(a_ex, b_ex, out, kernels::cpu::BinaryOp::Add);
         }
 
         if ((a.requires_grad() || b.requires_grad()) && GradMode::is_enabled()) {
@@ -396,6 +627,23 @@ namespace axon {
         }
         return out;
     }
+
+    Tensor add_(Tensor a, Tensor b) {
+        check_in_place(a, &b, "ADD_");
+        if (broadcast_shapes(a.get_shape(), b.get_shape()) != a.get_shape()) {
+            throw std::invalid_argument("[ADD_] Error: b must broadcast to a's shape");
+        }
+
+        Tensor b_ex = expand_to(b, a.get_shape());
+        // b reading a's storage through another view would see elements the loop already wrote:
+        // add a copy of it instead (the very same view is fine, each element reads itself)
+        if (b_ex.get_storage() == a.get_storage()
+            && (b_ex.get_offset() != a.get_offset() || b_ex.get_stride() != a.get_stride())) {
+            b_ex = b_ex.contiguous();
+        }
+        run_in_place("add_", a, {&a, &b_ex}, strided_binary_kernels(a, b_ex, a, kernels::cpu::BinaryOp::Add));
+        return a;
+    }
     
     struct SubBackward : public GradFn {
         // d(a-b)/da = 1, d(a-b)/db = -1
@@ -414,16 +662,21 @@ namespace axon {
     };
 
     Tensor sub(Tensor a, Tensor b) {
+        require_f32(a, "SUB");
+        require_f32(b, "SUB");
         std::vector<int> target_shape = broadcast_shapes(a.get_shape(), b.get_shape());
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Sub, target_shape, a, &b)) {
+            return *lazy_out;
+        }
         Device dev = a.device();
-        Tensor a_ex = a.expand(target_shape);
-        Tensor b_ex = b.expand(target_shape);
-        Tensor out = Tensor::zeros(target_shape, dev);
+        Tensor a_ex = expand_to(a, target_shape);
+        Tensor b_ex = expand_to(b, target_shape);
+        Tensor out = new_output(target_shape, dev);
 
         if (a_ex.is_contiguous() && b_ex.is_contiguous() && out.is_contiguous()) {
             DISPATCH_BINARY_FALLBACK(sub, a_ex, b_ex, out);
         } else {
-            dispatch_binary_op(a_ex, b_ex, out, [](float x, float y) { return x - y; });
+            dispatch_binary_op(a_ex, b_ex, out, kernels::cpu::BinaryOp::Sub);
         }
 
         if ((a.requires_grad() || b.requires_grad()) && GradMode::is_enabled()) {
@@ -450,16 +703,21 @@ namespace axon {
     };
 
     Tensor mul(Tensor a, Tensor b) {
+        require_f32(a, "MUL");
+        require_f32(b, "MUL");
         std::vector<int> target_shape = broadcast_shapes(a.get_shape(), b.get_shape());
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Mul, target_shape, a, &b)) {
+            return *lazy_out;
+        }
         Device dev = a.device();
-        Tensor a_ex = a.expand(target_shape);
-        Tensor b_ex = b.expand(target_shape);
-        Tensor out = Tensor::zeros(target_shape, dev);
+        Tensor a_ex = expand_to(a, target_shape);
+        Tensor b_ex = expand_to(b, target_shape);
+        Tensor out = new_output(target_shape, dev);
 
         if (a_ex.is_contiguous() && b_ex.is_contiguous() && out.is_contiguous()) {
             DISPATCH_BINARY_FALLBACK(mul, a_ex, b_ex, out);
         } else {
-            dispatch_binary_op(a_ex, b_ex, out, [](float x, float y) { return x * y; });
+            dispatch_binary_op(a_ex, b_ex, out, kernels::cpu::BinaryOp::Mul);
         }
 
         if ((a.requires_grad() || b.requires_grad()) && GradMode::is_enabled()) {
@@ -489,16 +747,21 @@ namespace axon {
     };
 
     Tensor div(Tensor a, Tensor b) {
+        require_f32(a, "DIV");
+        require_f32(b, "DIV");
         std::vector<int> target_shape = broadcast_shapes(a.get_shape(), b.get_shape());
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Div, target_shape, a, &b)) {
+            return *lazy_out;
+        }
         Device dev = a.device();
-        Tensor a_ex = a.expand(target_shape);
-        Tensor b_ex = b.expand(target_shape);
-        Tensor out = Tensor::zeros(target_shape, dev);
+        Tensor a_ex = expand_to(a, target_shape);
+        Tensor b_ex = expand_to(b, target_shape);
+        Tensor out = new_output(target_shape, dev);
 
         if (a_ex.is_contiguous() && b_ex.is_contiguous() && out.is_contiguous()) {
             DISPATCH_BINARY_FALLBACK(div, a_ex, b_ex, out);
         } else {
-            dispatch_binary_op(a_ex, b_ex, out, [](float x, float y) { return x / y; });
+            dispatch_binary_op(a_ex, b_ex, out, kernels::cpu::BinaryOp::Div);
         }
 
         if ((a.requires_grad() || b.requires_grad()) && GradMode::is_enabled()) {
@@ -521,8 +784,12 @@ namespace axon {
     };
 
     Tensor neg(Tensor t) {
+        require_f32(t, "NEG");
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Neg, t.get_shape(), t)) {
+            return *lazy_out;
+        }
         Device dev = t.device();
-        Tensor out = Tensor::zeros(t.get_shape(), dev);
+        Tensor out = new_output(t.get_shape(), dev);
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
         DISPATCH_UNARY_FALLBACK(neg, t_c, out);
 
@@ -552,8 +819,12 @@ namespace axon {
 
 
     Tensor sqrt(Tensor t) {
+        require_f32(t, "SQRT");
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Sqrt, t.get_shape(), t)) {
+            return *lazy_out;
+        }
         Device dev = t.device();
-        Tensor out = Tensor::zeros(t.get_shape(), dev);
+        Tensor out = new_output(t.get_shape(), dev);
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
         DISPATCH_UNARY_FALLBACK(sqrt, t_c, out);
 
@@ -579,8 +850,12 @@ namespace axon {
     };
 
     Tensor exp(Tensor t) {
+        require_f32(t, "EXP");
+        if (auto lazy_out = trace_elementwise(kernels::cpu::FusedOp::Exp, t.get_shape(), t)) {
+            return *lazy_out;
+        }
         Device dev = t.device();
-        Tensor out = Tensor::zeros(t.get_shape(), dev);
+        Tensor out = new_output(t.get_shape(), dev);
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
         DISPATCH_UNARY_FALLBACK(exp, t_c, out);
 
@@ -632,6 +907,127 @@ namespace axon {
         return off;
     }
 
+    // batched matmul runs one GEMM per task below this size (M * N * K)
+    constexpr size_t PARALLEL_GEMM_MIN_FLOPS = 1 << 21;
+
+    // A strided 2D matrix expressed the way gemm_f32 wants it
+    struct MatrixOperand {
+        bool direct;  // false if no (trans, ld) pair describes the strides
+        bool trans;
+        size_t ld;
+    };
+
+    MatrixOperand describe_operand(int rows, int cols, int row_stride, int col_stride) {
+        // row-major: unit column stride (a single column can use any stride)
+        if (col_stride == 1 || cols == 1) {
+            int ld = rows == 1 ? cols : row_stride;
+            if (ld >= cols) {
+                return {true, false, static_cast<size_t>(ld)};
+            }
+        }
+
+        // column-major, i.e. a transposed view
+        if (row_stride == 1 || rows == 1) {
+            int ld = cols == 1 ? rows : col_stride;
+            if (ld >= rows) {
+                return {true, true, static_cast<size_t>(ld)};
+            }
+        }
+
+        return {false, false, 0};
+    }
+
+    MatrixOperand gather_operand(int rows, int cols, const float* src, int row_stride, int col_stride, std::vector<float>& buf) {
+        buf.resize(static_cast<size_t>(rows) * cols);
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                buf[i * cols + j] = src[i * row_stride + j * col_stride];
+            }
+        }
+        return {true, false, static_cast<size_t>(cols)};
+    }
+
+    // sum over the batch of op(X_i) @ op(Y_i), with op = transpose when tx / ty is set
+    // x and y (CPU) have identical batch dims; returns the 2D gradient of an operand
+    // that was broadcast across that batch, without a per-batch temporary
+    Tensor gemm_reduce_batch(const Tensor& x, bool tx, const Tensor& y, bool ty) {
+        const std::vector<int>& xs = x.get_shape();
+        const std::vector<int>& ys = y.get_shape();
+        const std::vector<int>& x_st = x.get_stride();
+        const std::vector<int>& y_st = y.get_stride();
+        int rank = xs.size();
+
+        int R = tx ? xs[rank - 1] : xs[rank - 2];
+        int K = tx ? xs[rank - 2] : xs[rank - 1];
+        int C = ty ? ys[rank - 2] : ys[rank - 1];
+
+        size_t total_batch = 1;
+        for (int i = 0; i < rank - 2; i++) {
+            total_batch *= xs[i];
+        }
+        if (total_batch == 0 || K == 0) {
+            return Tensor::zeros({R, C}, x.device());
+        }
+
+        Tensor out = Tensor::empty({R, C}, x.device());
+
+        // batch dims fold into the row dim when they are laid out right above it
+        auto rows_fold = [rank](const std::vector<int>& shape, const std::vector<int>& st) {
+            long long expected = static_cast<long long>(st[rank - 2]) * shape[rank - 2];
+            for (int i = rank - 3; i >= 0; i--) {
+                if (shape[i] == 1) continue;
+                if (st[i] != expected) return false;
+                expected *= shape[i];
+            }
+            return true;
+        };
+
+        // a^T @ grad over (B, T, K) x (B, T, N): one GEMM with K = B * T
+        if (tx && !ty && rows_fold(xs, x_st) && rows_fold(ys, y_st)) {
+            int rows = static_cast<int>(total_batch) * K;
+            MatrixOperand X = describe_operand(rows, R, x_st[rank - 2], x_st[rank - 1]);
+            MatrixOperand Y = describe_operand(rows, C, y_st[rank - 2], y_st[rank - 1]);
+
+            if (X.direct && Y.direct) {
+                kernels::cpu::gemm_f32(!X.trans, Y.trans, R, C, rows,
+                                       1.0f, x.data_ptr(), X.ld, y.data_ptr(), Y.ld, 0.0f, out.data_ptr(), C);
+                return out;
+            }
+        }
+
+        auto batch_offset = [rank](size_t b_idx, const std::vector<int>& shape, const std::vector<int>& st) {
+            size_t off = 0;
+            for (int i = rank - 3; i >= 0; i--) {
+                off += (b_idx % shape[i]) * st[i];
+                b_idx /= shape[i];
+            }
+            return off;
+        };
+
+        std::vector<float> x_buf, y_buf;
+        for (size_t b_idx = 0; b_idx < total_batch; b_idx++) {
+            const float* pX = x.data_ptr() + batch_offset(b_idx, xs, x_st);
+            const float* pY = y.data_ptr() + batch_offset(b_idx, ys, y_st);
+
+            MatrixOperand X = describe_operand(xs[rank - 2], xs[rank - 1], x_st[rank - 2], x_st[rank - 1]);
+            MatrixOperand Y = describe_operand(ys[rank - 2], ys[rank - 1], y_st[rank - 2], y_st[rank - 1]);
+
+            if (!X.direct) {
+                X = gather_operand(xs[rank - 2], xs[rank - 1], pX, x_st[rank - 2], x_st[rank - 1], x_buf);
+                pX = x_buf.data();
+            }
+            if (!Y.direct) {
+                Y = gather_operand(ys[rank - 2], ys[rank - 1], pY, y_st[rank - 2], y_st[rank - 1], y_buf);
+                pY = y_buf.data();
+            }
+
+            kernels::cpu::gemm_f32(X.trans != tx, Y.trans != ty, R, C, K,
+                                   1.0f, pX, X.ld, pY, Y.ld, b_idx == 0 ? 0.0f : 1.0f, out.data_ptr(), C);
+        }
+
+        return out;
+    }
+
     struct MatMulBackward : public GradFn {
         Tensor a, b;
         MatMulBackward(Tensor a_in, Tensor b_in) : a(a_in), b(b_in) {}
@@ -639,18 +1035,23 @@ namespace axon {
         std::vector<Tensor> apply(const Tensor& grad_output) override {
             int a_rank = a.get_shape().size();
             int b_rank = b.get_shape().size();
+            bool cpu = a.device().type == DeviceType::CPU;
 
             // transpose the last two dimensions
             Tensor a_t = axon::transpose(a, a_rank - 2, a_rank - 1);
             Tensor b_t = axon::transpose(b, b_rank - 2, b_rank - 1);
-        
-            Tensor grad_a = axon::matmul(grad_output, b_t);
-            Tensor grad_b = axon::matmul(a_t, grad_output);
 
-            return {
-                unbroadcast(grad_a, a.get_shape()),
-                unbroadcast(grad_b, b.get_shape())
-            };
+            // a 2D operand shared across the batch (e.g. a Linear weight) gets its
+            // gradient summed inside the GEMM instead of via a batched temporary
+            Tensor grad_a = (cpu && a_rank == 2 && b_rank > 2)
+                ? gemm_reduce_batch(grad_output, false, b, true)
+                : unbroadcast(axon::matmul(grad_output, b_t), a.get_shape());
+
+            Tensor grad_b = (cpu && b_rank == 2 && a_rank > 2)
+                ? gemm_reduce_batch(a, true, grad_output, false)
+                : unbroadcast(axon::matmul(a_t, grad_output), b.get_shape());
+
+            return {grad_a, grad_b};
         }
     };
 
@@ -684,6 +1085,13 @@ namespace axon {
     }
 
     Tensor matmul_impl(Tensor a, Tensor b) {
+        require_f32(a, "MATMUL");
+        if (b.dtype() == DType::Int8) {
+            throw std::invalid_argument("[MATMUL] Error: int8 weights need their scales, use quantized_matmul");
+        }
+        if (b.dtype() != DType::Float32 && b.requires_grad() && GradMode::is_enabled()) {
+            throw std::invalid_argument(std::string("[MATMUL] Error: No gradients for ") + dtype_name(b.dtype()) + " tensors, they are for inference");
+        }
         int a_rank = a.get_shape().size();
         int b_rank = b.get_shape().size();
    
@@ -715,7 +1123,7 @@ namespace axon {
         out_shape.push_back(N);
 
         Device dev = a.device();
-        Tensor out = Tensor::zeros(out_shape, dev);
+        Tensor out = new_output(out_shape, dev);
 
         std::vector<int> shape_a_exp = batch_out;
         shape_a_exp.push_back(M);
@@ -725,103 +1133,355 @@ namespace axon {
         shape_b_exp.push_back(K);
         shape_b_exp.push_back(N);
 
-        Tensor a_ex = a.expand(shape_a_exp);
-        Tensor b_ex = b.expand(shape_b_exp);
+        Tensor a_ex = expand_to(a, shape_a_exp);
+        Tensor b_ex = expand_to(b, shape_b_exp);
 
         size_t total_batch = 1;
         for (auto i : batch_out) {
             total_batch *= i;
         } 
 
-        size_t batch_out_size = batch_out.size();
+        size_t ax_rank = a_ex.get_shape().size();
+        size_t bx_rank = b_ex.get_shape().size();
 
-        std::vector<int> a_batch_strides(batch_out_size);
-        std::vector<int> b_batch_strides(batch_out_size);
-    
-        std::vector<int> out_batch_stides(batch_out_size);
-        std::vector<int> current_indices(batch_out_size, 0);
+        MatrixOperand opA = describe_operand(M, K, a_ex.get_stride()[ax_rank - 2], a_ex.get_stride()[ax_rank - 1]);
+        MatrixOperand opB = describe_operand(K, N, b_ex.get_stride()[bx_rank - 2], b_ex.get_stride()[bx_rank - 1]);
+
+        // 16-bit B (typically a weight) is widened inside the GEMM, which needs it addressable
+        // through (trans, ld); any other layout, or a non-CPU device, takes a float32 copy
+        if (b_ex.dtype() != DType::Float32 && (dev.type != DeviceType::CPU || !opB.direct)) {
+            b_ex = expand_to(b.to(DType::Float32), shape_b_exp);
+            opB = describe_operand(K, N, b_ex.get_stride()[bx_rank - 2], b_ex.get_stride()[bx_rank - 1]);
+        }
+        DType b_dtype = b_ex.dtype();
+
+        // flat batch index -> element offset, using the leading (batch) strides
+        auto batch_offset = [](size_t b_idx, const std::vector<int>& batch, const std::vector<int>& strides) {
+            size_t off = 0;
+            for (int i = static_cast<int>(batch.size()) - 1; i >= 0; i--) {
+                off += (b_idx % batch[i]) * strides[i];
+                b_idx /= batch[i];
+            }
+            return off;
+        };
 
-        for (size_t i = 0; i < batch_out_size; i++) {
-            a_batch_strides[i] = a_ex.get_stride()[i];
-            b_batch_strides[i] = b_ex.get_stride()[i];
-            out_batch_stides[i] = out.get_stride()[i];
+        if (dev.type == DeviceType::CPU) {
+            trace::DataRef ra(a_ex), rb(b_ex), ro(out);
+
+            // the shapes come in as arguments, so running it now copies none of them
+            auto kernel = [=](const std::vector<int>& batch, const std::vector<int>& a_st, const std::vector<int>& b_st, const std::vector<int>& o_st) {
+                const float* a_ptr_base = ra.f32();
+                const float* b_ptr_base = b_dtype == DType::Float32 ? rb.f32() : nullptr;
+                const uint16_t* b16_ptr_base = b_dtype == DType::Float32 ? nullptr : rb.as<const uint16_t>();
+                float* out_ptr_base = ro.f32();
+
+                auto run_batches = [&](size_t begin, size_t end) {
+                    // gather buffers are only touched for operands that no lda/transpose can describe
+                    thread_local std::vector<float> a_buf, b_buf;
+
+                    for (size_t b_idx = begin; b_idx < end; b_idx++) {
+                        const float* pA = a_ptr_base + batch_offset(b_idx, batch, a_st);
+                        float* pOut = out_ptr_base + batch_offset(b_idx, batch, o_st);
+                        MatrixOperand A = opA, B = opB;
+
+                        if (!A.direct) {
+                            A = gather_operand(M, K, pA, a_st[ax_rank - 2], a_st[ax_rank - 1], a_buf);
+                            pA = a_buf.data();
+                        }
+
+                        if (b_dtype != DType::Float32) {
+                            const uint16_t* pB16 = b16_ptr_base + batch_offset(b_idx, batch, b_st);
+                            if (b_dtype == DType::Float16) {
+                                kernels::cpu::gemm_f32_f16(A.trans, B.trans, M, N, K, 1.0f, pA, A.ld, pB16, B.ld, 0.0f, pOut, N);
+                            } else {
+                                kernels::cpu::gemm_f32_bf16(A.trans, B.trans, M, N, K, 1.0f, pA, A.ld, pB16, B.ld, 0.0f, pOut, N);
+                            }
+                            continue;
+                        }
+
+                        const float* pB = b_ptr_base + batch_offset(b_idx, batch, b_st);
+                        if (!B.direct) {
+                            B = gather_operand(K, N, pB, b_st[bx_rank - 2], b_st[bx_rank - 1], b_buf);
+                            pB = b_buf.data();
+                        }
+
+                        kernels::cpu::gemm_f32(A.trans, B.trans, M, N, K, 1.0f, pA, A.ld, pB, B.ld, 0.0f, pOut, N);
+                    }
+                };
 
+                // Many small (batch, head) GEMMs: one per task, each GEMM single-threaded.
+                // A few big ones: run them in order and let each GEMM use the whole pool.
+                size_t flops = static_cast<size_t>(M) * N * K;
+                if (total_batch > 1 && (total_batch >= get_num_threads() || flops < PARALLEL_GEMM_MIN_FLOPS)) {
+                    parallel_for(0, total_batch, 1, run_batches);
+                } else {
+                    run_batches(0, total_batch);
+                }
+            };
+
+            if (trace::is_active()) {
+                trace::record("matmul", {&a_ex, &b_ex}, {&out}, [kernel, batch_out, a_st = a_ex.get_stride(), b_st = b_ex.get_stride(), o_st = out.get_stride()] {
+                    kernel(batch_out, a_st, b_st, o_st);
+                });
+            } else {
+                kernel(batch_out, a_ex.get_stride(), b_ex.get_stride(), out.get_stride());
+            }
+        } else {
+            Tensor a_cpu = a_ex.to(Device(DeviceType::CPU));
+            Tensor b_cpu = b_ex.to(Device(DeviceType::CPU));
+            Tensor out_cpu = Tensor::empty({M, N}, Device(DeviceType::CPU));
+
+            std::vector<float> a_buf, b_buf;
+
+            for (size_t b_idx = 0; b_idx < total_batch; b_idx++) {
+                const float* pA = a_cpu.data_ptr() + batch_offset(b_idx, batch_out, a_cpu.get_stride());
+                const float* pB = b_cpu.data_ptr() + batch_offset(b_idx, batch_out, b_cpu.get_stride());
+
+                MatrixOperand A = gather_operand(M, K, pA, a_cpu.get_stride()[ax_rank - 2], a_cpu.get_stride()[ax_rank - 1], a_buf);
+                MatrixOperand B = gather_operand(K, N, pB, b_cpu.get_stride()[bx_rank - 2], b_cpu.get_stride()[bx_rank - 1], b_buf);
+
+                kernels::cpu::gemm_f32(A.trans, B.trans, M, N, K, 1.0f, a_buf.data(), A.ld, b_buf.data(), B.ld, 0.0f, out_cpu.data_ptr(), N);
+                cudaMemcpy(out.data_ptr() + batch_offset(b_idx, batch_out, out.get_stride()), out_cpu.data_ptr(), M * N * sizeof(float), axon::MemcpyHostToDevice);
+            }
         }
 
-        float* a_ptr_base = a_ex.data_ptr();
-        float* b_ptr_base = b_ex.data_ptr();
-        float* out_ptr_base = out.data_ptr();
+        if ((a.requires_grad() || b.requires_grad()) && GradMode::is_enabled()) {
+            out.set_requires_grad(true);
+            auto fn = std::make_shared<MatMulBackward>(a, b);
+            fn -> next_edges.push_back({a.get_grad_fn(), std::make_shared<Tensor>(a)});
+            fn -> next_edges.push_back({b.get_grad_fn(), std::make_shared<Tensor>(b)});
 
-        size_t ax_rank = a_ex.get_shape().size();
-        size_t bx_rank = b_ex.get_shape().size();
-    
+            out.set_grad_fn(fn);
+        }
 
-        for (size_t b_idx = 0; b_idx < total_batch; b_idx++) {
-            size_t off_a = 0;
-            size_t off_b = 0;
-            size_t off_o = 0;
-       
-            for (size_t i = 0; i < batch_out.size(); i++) {
-                off_a += current_indices[i] * a_batch_strides[i];
-                off_b += current_indices[i] * b_batch_strides[i];
-                off_o += current_indices[i] * out_batch_stides[i];
+        return out;
+    }
+
+    std::pair<Tensor, Tensor> quantize_int8(Tensor w, int dim) {
+        require_f32(w, "QUANTIZE_INT8");
+        if (w.get_shape().size() != 2 || (dim != 0 && dim != 1)) {
+            throw std::invalid_argument("[QUANTIZE_INT8] Error: Expected a 2D weight and dim 0 or 1");
+        }
+        if (w.device().type != DeviceType::CPU) {
+            throw std::invalid_argument("[QUANTIZE_INT8] Error: Only supported on CPU");
+        }
+
+        size_t rows = w.get_shape()[0];
+        size_t cols = w.get_shape()[1];
+        Tensor w_c = w.is_contiguous() ? w : w.contiguous();
+        const float* src = w_c.data_ptr();
+
+        Tensor q = Tensor::empty(w.get_shape(), DType::Int8);
+        Tensor scale = dim == 1 ? Tensor::empty({1, (int)cols}) : Tensor::empty({(int)rows, 1});
+        int8_t* dst = static_cast<int8_t*>(q.raw_data_ptr());
+        float* s = scale.data_ptr();
+
+        // symmetric: the largest magnitude of each slice maps to +-127, zero stays exactly zero
+        std::vector<float> absmax(dim == 1 ? cols : rows, 0.0f);
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < cols; j++) {
+                float& m = absmax[dim == 1 ? j : i];
+                m = std::max(m, std::abs(src[i * cols + j]));
             }
+        }
 
-            std::vector<int> stA = {a_ex.get_stride()[ax_rank - 2], a_ex.get_stride()[ax_rank - 1]};
-            std::vector<int> stB = {b_ex.get_stride()[bx_rank - 2], b_ex.get_stride()[bx_rank - 1]};
+        std::vector<float> inv(absmax.size());
+        for (size_t k = 0; k < absmax.size(); k++) {
+            s[k] = absmax[k] / 127.0f;
+            inv[k] = absmax[k] > 0.0f ? 127.0f / absmax[k] : 0.0f;
+        }
 
-            bool a_contig = (stA[1] == 1 && stA[0] == K);
-            bool b_contig = (stB[1] == 1 && stB[0] == N);
-        
-            std::vector<float> a_buf, b_buf;
-            const float* pA = a_ptr_base + off_a;
-            const float* pB = b_ptr_base + off_b;
-
-            if (!a_contig) {
-                a_buf.resize(M * K);
-                for (int i = 0; i < M; i++) {
-                    for (int j = 0; j < K; j++) {
-                        a_buf[i * K + j] = pA[i * stA[0] + j * stA[1]];
-                    }
+        parallel_for(0, rows, 64, [&](size_t r0, size_t r1) {
+            for (size_t i = r0; i < r1; i++) {
+                for (size_t j = 0; j < cols; j++) {
+                    float x = src[i * cols + j] * inv[dim == 1 ? j : i];
+                    dst[i * cols + j] = static_cast<int8_t>(std::lrint(std::min(std::max(x, -127.0f), 127.0f)));
                 }
-                pA = a_buf.data();
             }
+        });
 
-            if (!b_contig) {
-                b_buf.resize(K * N);
-                for (int i = 0; i < K; i++) {
-                    for (int j = 0; j < N; j++) {
-                        b_buf[i * N + j] = pB[i * stB[0] + j * stB[1]];
-                    }
+        return {q, scale};
+    }
+
+    struct QuantizedMatMulBackward : public GradFn {
+        Tensor w, scale;
+        std::vector<int> a_shape;
+        QuantizedMatMulBackward(Tensor w_in, Tensor s_in, std::vector<int> shape) : w(w_in), scale(s_in), a_shape(shape) {}
+
+        // d(a @ (w * s))/da = (grad * s) @ w^T; the weight itself is frozen
+        std::vector<Tensor> apply(const Tensor& grad_output) override {
+            size_t K = w.get_shape()[0];
+            size_t N = w.get_shape()[1];
+            size_t rows = grad_output.numel() / N;
+
+            Tensor g_c = grad_output.is_contiguous() ? grad_output : grad_output.contiguous();
+            Tensor scaled = Tensor::empty({(int)rows, (int)N});
+            const float* g = g_c.data_ptr();
+            const float* s = scale.data_ptr();
+            float* dst = scaled.data_ptr();
+            for (size_t i = 0; i < rows; i++) {
+                for (size_t j = 0; j < N; j++) {
+                    dst[i * N + j] = g[i * N + j] * s[j];
                 }
-                pB = b_buf.data();
             }
 
-            if (dev.type == DeviceType::CPU) {
-                kernels::cpu::matmul_f32(M, N, K, pA, pB, out_ptr_base + off_o);
-            } else {
-                Tensor a_cpu = a_ex.to(Device(DeviceType::CPU));
-                Tensor b_cpu = b_ex.to(Device(DeviceType::CPU));
-                Tensor out_cpu = Tensor::zeros({M, N}, Device(DeviceType::CPU));
-                kernels::cpu::matmul_f32(M, N, K, a_cpu.data_ptr() + off_a, b_cpu.data_ptr() + off_b, out_cpu.data_ptr());
-                cudaMemcpy(out_ptr_base + off_o, out_cpu.data_ptr(), M * N * sizeof(float), axon::MemcpyHostToDevice);
-            }
-            
-            for (int i = static_cast<int>(batch_out.size()) - 1; i >= 0; i--) {
-                current_indices[i]++;
-                if (current_indices[i] < batch_out[i]) {
-                    break;
+            Tensor grad_a = Tensor::empty(a_shape);
+            kernels::cpu::gemm_f32_i8(false, true, rows, K, N, scaled.data_ptr(), N,
+                                      static_cast<const int8_t*>(w.raw_data_ptr()), N, nullptr, grad_a.data_ptr(), K);
+            return {grad_a};
+        }
+    };
+
+    Tensor quantized_matmul(Tensor a, Tensor w, Tensor scale) {
+        require_f32(a, "QUANTIZED_MATMUL");
+        require_f32(scale, "QUANTIZED_MATMUL");
+        if (w.dtype() != DType::Int8 || w.get_shape().size() != 2) {
+            throw std::invalid_argument("[QUANTIZED_MATMUL] Error: Expected a 2D int8 weight, got " + std::string(dtype_name(w.dtype())));
+        }
+        if (a.device().type != DeviceType::CPU || w.device().type != DeviceType::CPU) {
+            throw std::invalid_argument("[QUANTIZED_MATMUL] Error: Only supported on CPU");
+        }
+
+        int K = w.get_shape()[0];
+        int N = w.get_shape()[1];
+        if (a.get_shape().empty() || a.get_shape().back() != K) {
+            throw std::invalid_argument("[QUANTIZED_MATMUL] Error: Inner shape mismatch");
+        }
+        if (scale.numel() != (size_t)N) {
+            throw std::invalid_argument("[QUANTIZED_MATMUL] Error: Expected " + std::to_string(N) + " scales, got " + std::to_string(scale.numel()));
+        }
+
+        Tensor a_c = a.is_contiguous() ? a : a.contiguous();
+        Tensor w_c = w.is_contiguous() ? w : w.contiguous();
+        Tensor s_c = scale.is_contiguous() ? scale : scale.contiguous();
+
+        std::vector<int> out_shape = a.get_shape();
+        out_shape.back() = N;
+        Tensor out = new_output(out_shape, a.device());
+        size_t rows = a.numel() / K;
+
+        trace::DataRef pa(a_c), pw(w_c), ps(s_c), po(out);
+        run_kernels("quantized_matmul", {&a_c, &w_c, &s_c}, {&out}, [=] {
+            kernels::cpu::gemm_f32_i8(false, false, rows, N, K, pa.f32(), K, pw.as<const int8_t>(), N, ps.f32(), po.f32(), N);
+        });
+
+        if (a.requires_grad() && GradMode::is_enabled()) {
+            out.set_requires_grad(true);
+            auto fn = std::make_shared<QuantizedMatMulBackward>(w_c, s_c, a.get_shape());
+            fn -> next_edges.push_back({a.get_grad_fn(), std::make_shared<Tensor>(a)});
+            out.set_grad_fn(fn);
+        }
+
+        return out;
+    }
+
+    struct LinearBackward : public GradFn {
+        // x as (rows, K), w as passed to the GEMM; `saved` is what the activation backward
+        // needs: the output for ReLU (out > 0 exactly where the input was), the pre-activation
+        // for GELU
+        Tensor x, w, saved;
+        bool w_trans;
+        size_t w_ld;
+        Activation act;
+        std::vector<int> x_shape, bias_shape;
+
+        LinearBackward(Tensor x_in, Tensor w_in, bool trans, size_t ld, Tensor s, Activation a, std::vector<int> xs, std::vector<int> bs)
+            : x(x_in), w(w_in), saved(s), w_trans(trans), w_ld(ld), act(a), x_shape(xs), bias_shape(bs) {}
+
+        // with g = grad * act'(pre): dx = g @ w^T, dw = x^T @ g, db = sum of g over the rows
+        std::vector<Tensor> apply(const Tensor& grad_output) override {
+            size_t rows = x.get_shape()[0];
+            size_t K = x.get_shape()[1];
+            size_t N = bias_shape.back();
+
+            Tensor g = grad_output.is_contiguous() ? grad_output : grad_output.contiguous();
+            if (act != Activation::None) {
+                Tensor d = Tensor::empty(g.get_shape());
+                if (act == Activation::Relu) {
+                    kernels::cpu::relu_backward_f32(g.numel(), saved.data_ptr(), g.data_ptr(), d.data_ptr());
+                } else {
+                    kernels::cpu::gelu_backward_f32(g.numel(), saved.data_ptr(), g.data_ptr(), d.data_ptr());
                 }
-                current_indices[i] = 0;
+                g = d;
             }
+
+            Tensor grad_x = Tensor::empty(x_shape);
+            Tensor grad_w = Tensor::empty({(int)K, (int)N});
+            Tensor grad_b = Tensor::empty(bias_shape);
+            kernels::cpu::gemm_f32(false, !w_trans, rows, K, N, 1.0f, g.data_ptr(), N, w.data_ptr(), w_ld, 0.0f, grad_x.data_ptr(), K);
+            kernels::cpu::gemm_f32(true, false, K, N, rows, 1.0f, x.data_ptr(), K, g.data_ptr(), N, 0.0f, grad_w.data_ptr(), N);
+            kernels::cpu::sum_dim_f32(1, rows, N, g.data_ptr(), grad_b.data_ptr());
+
+            return {grad_x, grad_w, grad_b};
         }
+    };
 
-        if ((a.requires_grad() || b.requires_grad()) && GradMode::is_enabled()) {
+    Tensor linear(Tensor x, Tensor w, Tensor b, Activation act) {
+        require_f32(x, "LINEAR");
+        require_f32(b, "LINEAR");
+        if (w.get_shape().size() != 2) {
+            throw std::invalid_argument("[LINEAR] Error: Expected a 2D (in, out) weight");
+        }
+
+        int K = w.get_shape()[0];
+        int N = w.get_shape()[1];
+        if (x.get_shape().empty() || x.get_shape().back() != K) {
+            throw std::invalid_argument("[LINEAR] Error: Inner shape mismatch");
+        }
+        if (b.numel() != (size_t)N || b.get_shape().back() != N) {
+            throw std::invalid_argument("[LINEAR] Error: Expected a bias of " + std::to_string(N) + " values");
+        }
+
+        // other devices and 16-bit weights keep the unfused ops
+        if (x.device().type != DeviceType::CPU || w.dtype() != DType::Float32) {
+            Tensor out = add(matmul(x, w), b);
+            if (act == Activation::Relu) return relu(out);
+            if (act == Activation::Gelu) return gelu(out);
+            return out;
+        }
+
+        size_t rows = 1;
+        for (size_t i = 0; i + 1 < x.get_shape().size(); i++) rows *= x.get_shape()[i];
+        Tensor x_c = x.is_contiguous() ? x : x.contiguous();
+        x_c = axon::view(x_c, {(int)rows, K});
+        Tensor b_c = b.is_contiguous() ? b : b.contiguous();
+
+        // a transposed weight view goes in as is
+        MatrixOperand W = describe_operand(K, N, w.get_stride()[0], w.get_stride()[1]);
+        Tensor w_c = w;
+        if (!W.direct) {
+            w_c = w.contiguous();
+            W = {true, false, static_cast<size_t>(N)};
+        }
+
+        std::vector<int> out_shape = x.get_shape();
+        out_shape.back() = N;
+        Tensor out = new_output(out_shape, x.device());
+
+        bool record = (x.requires_grad() || w.requires_grad() || b.requires_grad()) && GradMode::is_enabled();
+        // a handle on the output's data without its autograd state, which would point back at the GradFn
+        Tensor saved = Tensor::from_storage(out.get_storage(), out.get_shape(), out.get_stride(), 0);
+        if (record && act == Activation::Gelu) {
+            // the backward needs the pre-activation: keep it, and run GELU as a second pass
+            saved = Tensor::empty(out_shape);
+            kernels::cpu::gemm_f32_bias_act(false, W.trans, rows, N, K, x_c.data_ptr(), K, w_c.data_ptr(), W.ld,
+                                            b_c.data_ptr(), Activation::None, saved.data_ptr(), N);
+            kernels::cpu::gelu_f32(out.numel(), saved.data_ptr(), out.data_ptr());
+        } else {
+            trace::DataRef px(x_c), pw(w_c), pb(b_c), po(out);
+            bool w_trans = W.trans;
+            size_t w_ld = W.ld;
+            run_kernels("linear", {&x_c, &w_c, &b_c}, {&out}, [=] {
+                kernels::cpu::gemm_f32_bias_act(false, w_trans, rows, N, K, px.f32(), K, pw.f32(), w_ld, pb.f32(), act, po.f32(), N);
+            });
+        }
+
+        if (record) {
             out.set_requires_grad(true);
-            auto fn = std::make_shared<MatMulBackward>(a, b);
-            fn -> next_edges.push_back({a.get_grad_fn(), std::make_shared<Tensor>(a)});
+            auto fn = std::make_shared<LinearBackward>(x_c, w_c, W.trans, W.ld, saved, act, x.get_shape(), b.get_shape());
+            fn -> next_edges.push_back({x.get_grad_fn(), std::make_shared<Tensor>(x)});
+            fn -> next_edges.push_back({w.get_grad_fn(), std::make_shared<Tensor>(w)});
             fn -> next_edges.push_back({b.get_grad_fn(), std::make_shared<Tensor>(b)});
-
             out.set_grad_fn(fn);
         }
 
@@ -839,15 +1499,16 @@ namespace axon {
     };
 
     Tensor sum(Tensor a) {
+        require_f32(a, "SUM");
         Device dev = a.device();
-        Tensor out = Tensor::zeros({1}, dev);
+        Tensor out = Tensor::empty({1}, dev);
 
         if (a.is_contiguous()) {
             if (dev.type == DeviceType::CPU) {
                 kernels::cpu::sum_f32(a.numel(), a.data_ptr(), out.data_ptr());
             } else {
                 Tensor a_cpu = a.to(Device(DeviceType::CPU));
-                Tensor out_cpu = Tensor::zeros({1}, Device(DeviceType::CPU));
+                Tensor out_cpu = Tensor::empty({1}, Device(DeviceType::CPU));
                 kernels::cpu::sum_f32(a_cpu.numel(), a_cpu.data_ptr(), out_cpu.data_ptr());
                 cudaMemcpy(out.data_ptr(), out_cpu.data_ptr(), sizeof(float), axon::MemcpyHostToDevice);
             }
@@ -866,61 +1527,135 @@ namespace axon {
         return out;
     }
 
-    Tensor sum(Tensor t, int dim, bool keepdim) {
-        std::vector<int> shape = t.get_shape();
+    // A reduction over one dim seen as (outer, size, inner) over the contiguous input
+    struct ReduceDims {
+        size_t outer = 1, size = 1, inner = 1;
+        std::vector<int> out_shape;
+    };
+
+    ReduceDims reduce_dims(const std::vector<int>& shape, int dim, bool keepdim, const char* op) {
         // Handle negative dims (-1)
         if (dim < 0) {
             dim += shape.size();
         }
-    
-        if (dim < 0 || dim >= shape.size()) {
-            throw std::invalid_argument("[SUM] Error: Invalid dimensions");
+
+        if (dim < 0 || dim >= (int)shape.size()) {
+            throw std::invalid_argument(std::string("[") + op + "] Error: Invalid dimensions");
         }
 
-        size_t outer = 1;
+        ReduceDims r;
         for (int i = 0; i < dim; i++) {
-            outer *= shape[i];
+            r.outer *= shape[i];
         }
-
-        size_t target_dim_size = shape[dim];
-
-        size_t inner = 1;
-
+        r.size = shape[dim];
         for (size_t i = dim + 1; i < shape.size(); i++) {
-            inner *= shape[i];
+            r.inner *= shape[i];
         }
 
-        std::vector<int> out_shape;
-        for(size_t i = 0; i < shape.size(); ++i) {
-            if (i == dim) {
+        for (size_t i = 0; i < shape.size(); ++i) {
+            if (i == (size_t)dim) {
                 if (keepdim) {
-                    out_shape.push_back(1);
-                }                    
+                    r.out_shape.push_back(1);
+                }
             } else {
-                out_shape.push_back(shape[i]);
+                r.out_shape.push_back(shape[i]);
             }
         }
-        
-        if (out_shape.empty() && !keepdim) {
-            out_shape.push_back(1);
+
+        if (r.out_shape.empty() && !keepdim) {
+            r.out_shape.push_back(1);
         }
+        return r;
+    }
+
+    // the whole tensor as one row
+    ReduceDims reduce_all(const Tensor& t) {
+        ReduceDims r;
+        r.size = t.numel();
+        r.out_shape = {1};
+        return r;
+    }
+
+    Tensor sum(Tensor t, int dim, bool keepdim) {
+        require_f32(t, "SUM");
+        ReduceDims r = reduce_dims(t.get_shape(), dim, keepdim, "SUM");
 
         Device dev = t.device();
-        Tensor out = Tensor::zeros(out_shape, dev);
+        Tensor out = Tensor::empty(r.out_shape, dev);
 
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
         if (dev.type == DeviceType::CPU) {
-            kernels::cpu::sum_dim_f32(outer, target_dim_size, inner, t_c.data_ptr(), out.data_ptr());
+            kernels::cpu::sum_dim_f32(r.outer, r.size, r.inner, t_c.data_ptr(), out.data_ptr());
         } else {
             Tensor t_cpu = t_c.to(Device(DeviceType::CPU));
-            Tensor out_cpu = Tensor::zeros(out_shape, Device(DeviceType::CPU));
-            kernels::cpu::sum_dim_f32(outer, target_dim_size, inner, t_cpu.data_ptr(), out_cpu.data_ptr());
+            Tensor out_cpu = Tensor::empty(r.out_shape, Device(DeviceType::CPU));
+            kernels::cpu::sum_dim_f32(r.outer, r.size, r.inner, t_cpu.data_ptr(), out_cpu.data_ptr());
             out = out_cpu.to(dev);
         }
 
         return out;
     }
 
+    // sum times 1 / count, through mul so sum's gradient carries over
+    Tensor scale_by_count(Tensor s, size_t count) {
+        Tensor scale = Tensor::empty({1});
+        scale.data_ptr()[0] = 1.0f / count;
+        return axon::mul(s, scale.to(s.device()));
+    }
+
+    Tensor mean(Tensor a) {
+        require_f32(a, "MEAN");
+        return scale_by_count(sum(a), a.numel());
+    }
+
+    Tensor mean(Tensor t, int dim, bool keepdim) {
+        require_f32(t, "MEAN");
+        ReduceDims r = reduce_dims(t.get_shape(), dim, keepdim, "MEAN");
+        return scale_by_count(sum(t, dim, keepdim), r.size);
+    }
+
+    // max / min values, or the (int64) positions of the first ones, computed on the host
+    Tensor reduce_extreme(const Tensor& t, const ReduceDims& r, bool is_max, bool positions, const char* op) {
+        require_f32(t, op);
+        if (r.size == 0) {
+            throw std::invalid_argument(std::string("[") + op + "] Error: Reduction over an empty dimension");
+        }
+
+        Tensor t_c = t.is_contiguous() ? t : t.contiguous();
+        Tensor t_cpu = t_c.to(Device(DeviceType::CPU));
+
+        Tensor values = Tensor::empty(r.out_shape);
+        Tensor idx = Tensor::empty(positions ? r.out_shape : std::vector<int>{0}, DType::Int64);
+        auto kernel = is_max ? kernels::cpu::max_dim_f32 : kernels::cpu::min_dim_f32;
+        kernel(r.outer, r.size, r.inner, t_cpu.data_ptr(), values.data_ptr(), positions ? idx.data_as<int64_t>() : nullptr);
+
+        return (positions ? idx : values).to(t.device());
+    }
+
+    Tensor max(Tensor t) {
+        return reduce_extreme(t, reduce_all(t), true, false, "MAX");
+    }
+
+    Tensor max(Tensor t, int dim, bool keepdim) {
+        return reduce_extreme(t, reduce_dims(t.get_shape(), dim, keepdim, "MAX"), true, false, "MAX");
+    }
+
+    Tensor min(Tensor t) {
+        return reduce_extreme(t, reduce_all(t), false, false, "MIN");
+    }
+
+    Tensor min(Tensor t, int dim, bool keepdim) {
+        return reduce_extreme(t, reduce_dims(t.get_shape(), dim, keepdim, "MIN"), false, false, "MIN");
+    }
+
+    Tensor argmax(Tensor t) {
+        return reduce_extreme(t, reduce_all(t), true, true, "ARGMAX");
+    }
+
+    Tensor argmax(Tensor t, int dim, bool keepdim) {
+        return reduce_extreme(t, reduce_dims(t.get_shape(), dim, keepdim, "ARGMAX"), true, true, "ARGMAX");
+    }
+
     // * CUSTOM LAYERS
 
     struct EmbeddingBackward : public GradFn {
@@ -936,7 +1671,9 @@ namespace axon {
             size_t dim = weight.get_shape()[1];
             size_t num_idx = indices.numel();
 
-            kernels::cpu::embedding_backward_f32(vocab, dim, num_idx, grad_out_c.data_ptr(), idx_c.data_ptr(), grad_weight.data_ptr());
+            with_indices(idx_c, "EMBEDDING", [&](auto ids) {
+                kernels::cpu::embedding_backward_f32(vocab, dim, num_idx, grad_out_c.data_ptr(), ids, grad_weight.data_ptr());
+            });
 
             return {
                 Tensor::zeros(indices.get_shape()),
@@ -952,27 +1689,54 @@ namespace axon {
 
         std::vector<int> out_shape = input.get_shape();
         Device dev = weight.device();
+        size_t vocab = weight.get_shape()[0];
+        size_t dim = weight.get_shape()[1];
 
         out_shape.push_back(weight.get_shape()[1]);
-        Tensor out = Tensor::zeros(out_shape, dev);
+        Tensor out = new_output(out_shape, dev);
 
+        // the kernels read the ids on the host
         Tensor input_c = input.is_contiguous() ? input : input.contiguous();
+        if (input_c.device().type != DeviceType::CPU) {
+            input_c = input_c.to(Device(DeviceType::CPU));
+        }
 
-        if (dev.type == DeviceType::CPU) {
-            kernels::cpu::embedding_forward_f32(
-                weight.get_shape()[0], weight.get_shape()[1],
-                input.numel(), weight.data_ptr(),
-                input_c.data_ptr(), out.data_ptr()
-            );
+        if (weight.dtype() == DType::Int8) {
+            throw std::invalid_argument("[EMBEDDING] Error: int8 tables need their scales, use quantized_embedding");
+        }
+
+        if (weight.dtype() != DType::Float32) {
+            if (dev.type != DeviceType::CPU) {
+                throw std::invalid_argument("[EMBEDDING] Error: 16-bit weights are only supported on CPU");
+            }
+            if (weight.requires_grad() && GradMode::is_enabled()) {
+                throw std::invalid_argument(std::string("[EMBEDDING] Error: No gradients for ") + dtype_name(weight.dtype()) + " tensors, they are for inference");
+            }
+            Tensor weight_c = weight.is_contiguous() ? weight : weight.contiguous();
+            trace::DataRef table(weight_c), po(out);
+            bool f16 = weight.dtype() == DType::Float16;
+            run_kernels("embedding", {&input_c, &weight_c}, {&out}, [=] {
+                with_indices(input_c, "EMBEDDING", [&](auto ids) {
+                    if (f16) {
+                        kernels::cpu::embedding_forward_f16(vocab, dim, input_c.numel(), table.as<const uint16_t>(), ids, po.f32());
+                    } else {
+                        kernels::cpu::embedding_forward_bf16(vocab, dim, input_c.numel(), table.as<const uint16_t>(), ids, po.f32());
+                    }
+                });
+            });
+        } else if (dev.type == DeviceType::CPU) {
+            trace::DataRef table(weight), po(out);
+            run_kernels("embedding", {&input_c, &weight}, {&out}, [=] {
+                with_indices(input_c, "EMBEDDING", [&](auto ids) {
+                    kernels::cpu::embedding_forward_f32(vocab, dim, input_c.numel(), table.f32(), ids, po.f32());
+                });
+            });
         } else {
-            Tensor input_cpu = input_c.to(Device(DeviceType::CPU));
             Tensor weight_cpu = weight.to(Device(DeviceType::CPU));
-            Tensor out_cpu = Tensor::zeros(out_shape, Device(DeviceType::CPU));
-            kernels::cpu::embedding_forward_f32(
-                weight.get_shape()[0], weight.get_shape()[1],
-                input.numel(), weight_cpu.data_ptr(),
-                input_cpu.data_ptr(), out_cpu.data_ptr()
-            );
+            Tensor out_cpu = Tensor::empty(out_shape, Device(DeviceType::CPU));
+            with_indices(input_c, "EMBEDDING", [&](auto ids) {
+                kernels::cpu::embedding_forward_f32(vocab, dim, input.numel(), weight_cpu.data_ptr(), ids, out_cpu.data_ptr());
+            });
             out = out_cpu.to(dev);
         }
 
@@ -988,6 +1752,36 @@ namespace axon {
         return out;
     }
 
+    Tensor quantized_embedding(Tensor input, Tensor weight, Tensor scale) {
+        require_f32(scale, "QUANTIZED_EMBEDDING");
+        if (weight.dtype() != DType::Int8 || weight.get_shape().size() != 2) {
+            throw std::invalid_argument("[QUANTIZED_EMBEDDING] Error: Expected a 2D int8 table, got " + std::string(dtype_name(weight.dtype())));
+        }
+        if (weight.device().type != DeviceType::CPU) {
+            throw std::invalid_argument("[QUANTIZED_EMBEDDING] Error: Only supported on CPU");
+        }
+        if (scale.numel() != (size_t)weight.get_shape()[0]) {
+            throw std::invalid_argument("[QUANTIZED_EMBEDDING] Error: Expected one scale per row");
+        }
+
+        std::vector<int> out_shape = input.get_shape();
+        out_shape.push_back(weight.get_shape()[1]);
+        Tensor out = new_output(out_shape, weight.device());
+
+        Tensor input_c = input.is_contiguous() ? input : input.contiguous();
+        Tensor weight_c = weight.is_contiguous() ? weight : weight.contiguous();
+        Tensor scale_c = scale.is_contiguous() ? scale : scale.contiguous();
+        size_t vocab = weight.get_shape()[0];
+        size_t dim = weight.get_shape()[1];
+        trace::DataRef table(weight_c), ps(scale_c), po(out);
+        run_kernels("quantized_embedding", {&input_c, &weight_c, &scale_c}, {&out}, [=] {
+            with_indices(input_c, "QUANTIZED_EMBEDDING", [&](auto ids) {
+                kernels::cpu::embedding_forward_i8(vocab, dim, input_c.numel(), table.as<const int8_t>(), ps.f32(), ids, po.f32());
+            });
+        });
+        return out;
+    }
+
     struct LayerNormBackward : public GradFn {
         Tensor input, gamma;
         float eps;
@@ -995,9 +1789,9 @@ namespace axon {
         LayerNormBackward(Tensor in, Tensor g, float e) : input(in), gamma(g), eps(e) {}
 
         std::vector<Tensor> apply(const Tensor& grad_output) override {
-            Tensor grad_input = Tensor::zeros(input.get_shape());
-            Tensor grad_gamma = Tensor::zeros(gamma.get_shape());
-            Tensor grad_beta = Tensor::zeros(gamma.get_shape());
+            Tensor grad_input = Tensor::empty(input.get_shape());
+            Tensor grad_gamma = Tensor::empty(gamma.get_shape());
+            Tensor grad_beta = Tensor::empty(gamma.get_shape());
 
             size_t cols = input.get_shape().back();
             size_t rows = input.numel() / cols;
@@ -1018,6 +1812,9 @@ namespace axon {
     };
 
     Tensor layer_norm(Tensor input, Tensor gamma, Tensor beta, float eps) {
+        require_f32(input, "LAYER_NORM");
+        require_f32(gamma, "LAYER_NORM");
+        require_f32(beta, "LAYER_NORM");
 
         int dim = input.get_shape().back();
         if (gamma.numel() != dim || beta.numel() != dim) {
@@ -1025,7 +1822,7 @@ namespace axon {
         }
 
         Device dev = input.device();
-        Tensor out = Tensor::zeros(input.get_shape(), dev);
+        Tensor out = new_output(input.get_shape(), dev);
 
         size_t cols = dim;
         size_t rows = input.numel() / cols;
@@ -1035,12 +1832,15 @@ namespace axon {
         Tensor bet_c = beta.is_contiguous() ? beta : beta.contiguous();
 
         if (dev.type == DeviceType::CPU) {
-            kernels::cpu::layernorm_forward_f32(rows, cols, in_c.data_ptr(), gam_c.data_ptr(), bet_c.data_ptr(), out.data_ptr(), eps);
+            trace::DataRef pi(in_c), pg(gam_c), pb(bet_c), po(out);
+            run_kernels("layer_norm", {&in_c, &gam_c, &bet_c}, {&out}, [=] {
+                kernels::cpu::layernorm_forward_f32(rows, cols, pi.f32(), pg.f32(), pb.f32(), po.f32(), eps);
+            });
         } else {
             Tensor in_cpu = in_c.to(Device(DeviceType::CPU));
             Tensor gam_cpu = gam_c.to(Device(DeviceType::CPU));
             Tensor bet_cpu = bet_c.to(Device(DeviceType::CPU));
-            Tensor out_cpu = Tensor::zeros(input.get_shape(), Device(DeviceType::CPU));
+            Tensor out_cpu = Tensor::empty(input.get_shape(), Device(DeviceType::CPU));
             kernels::cpu::layernorm_forward_f32(rows, cols, in_cpu.data_ptr(), gam_cpu.data_ptr(), bet_cpu.data_ptr(), out_cpu.data_ptr(), eps);
             out = out_cpu.to(dev);
         }
@@ -1062,7 +1862,7 @@ namespace axon {
         SoftmaxBackward(Tensor out) : output(out) {}
     
         std::vector<Tensor> apply(const Tensor& grad_output) override {
-            Tensor grad_input = Tensor::zeros(output.get_shape());
+            Tensor grad_input = Tensor::empty(output.get_shape());
             
             size_t cols = output.get_shape().back();
             size_t rows = output.numel() / cols;
@@ -1077,17 +1877,19 @@ namespace axon {
     };
 
     Tensor softmax(Tensor t) {
+        require_f32(t, "SOFTMAX");
         Device dev = t.device();
-        Tensor out = Tensor::zeros(t.get_shape(), dev);
+        Tensor out = new_output(t.get_shape(), dev);
         size_t cols = t.get_shape().back();
         size_t rows = t.numel() / cols;
 
         Tensor t_c = t.is_contiguous() ? t : t.contiguous();
         if (dev.type == DeviceType::CPU) {
-            kernels::cpu::softmax_f32(rows, cols, t_c.data_ptr(), out.data_ptr());
+            trace::DataRef pi(t_c), po(out);
+            run_kernels("softmax", {&t_c}, {&out}, [=] { kernels::cpu::softmax_f32(rows, cols, pi.f32(), po.f32()); });
         } else {
             Tensor t_cpu = t_c.to(Device(DeviceType::CPU));
-            Tensor out_cpu = Tensor::zeros(t.get_shape(), Device(DeviceType::CPU));
+            Tensor out_cpu = Tensor::empty(t.get_shape(), Device(DeviceType::CPU));
             kernels::cpu::softmax_f32(rows, cols, t_cpu.data_ptr(), out_cpu.data_ptr());
             out = out_cpu.to(dev);
         }
@@ -1101,4 +1903,111 @@ namespace axon {
         return out;
     }
 
+
+    kernels::cpu::AttentionStrides attention_strides(const Tensor& t) {
+        const std::vector<int>& st = t.get_stride();
+        return {static_cast<size_t>(st[0]), static_cast<size_t>(st[1]), static_cast<size_t>(st[2])};
+    }
+
+    // the attention kernels take any (batch, head, row) strides but need unit stride along D
+    Tensor unit_inner_stride(const Tensor& t) {
+        return t.get_stride()[3] == 1 ? t : t.contiguous();
+    }
+
+    struct AttentionBackward : public GradFn {
+        // the saved tensors are the CPU copies the forward ran on; dev is where q/k/v live
+        Tensor q, k, v, out, lse;
+        float scale;
+        bool causal;
+        Device dev;
+
+        AttentionBackward(Tensor q_in, Tensor k_in, Tensor v_in, Tensor out_in, Tensor lse_in, float s, bool c, Device d)
+            : q(q_in), k(k_in), v(v_in), out(out_in), lse(lse_in), scale(s), causal(c), dev(d) {}
+
+        std::vector<Tensor> apply(const Tensor& grad_output) override {
+            const std::vector<int>& qs = q.get_shape();
+            const std::vector<int>& ks = k.get_shape();
+            bool on_cpu = dev.type == DeviceType::CPU;
+
+            Tensor g = unit_inner_stride(on_cpu ? grad_output : grad_output.to(Device(DeviceType::CPU)));
+            Tensor grad_q = Tensor::zeros(qs);
+            Tensor grad_k = Tensor::zeros(ks);
+            Tensor grad_v = Tensor::zeros(ks);
+
+            kernels::cpu::attention_backward_f32(
+                qs[0], qs[1], qs[2], ks[2], qs[3], scale, causal,
+                q.data_ptr(), attention_strides(q),
+                k.data_ptr(), attention_strides(k),
+                v.data_ptr(), attention_strides(v),
+                out.data_ptr(), attention_strides(out),
+                g.data_ptr(), attention_strides(g),
+                lse.data_ptr(),
+                grad_q.data_ptr(), attention_strides(grad_q),
+                grad_k.data_ptr(), attention_strides(grad_k),
+                grad_v.data_ptr(), attention_strides(grad_v));
+
+            if (!on_cpu) {
+                return {grad_q.to(dev), grad_k.to(dev), grad_v.to(dev)};
+            }
+            return {grad_q, grad_k, grad_v};
+        }
+    };
+
+    Tensor scaled_dot_product_attention(Tensor q, Tensor k, Tensor v, bool causal) {
+        require_f32(q, "ATTENTION");
+        require_f32(k, "ATTENTION");
+        require_f32(v, "ATTENTION");
+        const std::vector<int>& qs = q.get_shape();
+        const std::vector<int>& ks = k.get_shape();
+
+        if (qs.size() != 4 || ks.size() != 4 || v.get_shape() != ks) {
+            throw std::invalid_argument("[SDPA] Error: q, k, v must be (B, H, T, D) with matching k/v shapes");
+        }
+        if (ks[0] != qs[0] || ks[1] != qs[1] || ks[3] != qs[3]) {
+            throw std::invalid_argument("[SDPA] Error: q and k differ in batch, heads or head dim");
+        }
+
+        int B = qs[0], H = qs[1], Tq = qs[2], Tk = ks[2], D = qs[3];
+        float scale = 1.0f / std::sqrt(static_cast<float>(D));
+
+        Device dev = q.device();
+        Device cpu(DeviceType::CPU);
+        bool on_cpu = dev.type == DeviceType::CPU;
+
+        Tensor q_c = unit_inner_stride(on_cpu ? q : q.to(cpu));
+        Tensor k_c = unit_inner_stride(on_cpu ? k : k.to(cpu));
+        Tensor v_c = unit_inner_stride(on_cpu ? v : v.to(cpu));
+
+        // written as (B, Tq, H, D) and returned as a (B, H, Tq, D) view, so the usual
+        // transpose(1, 2) + view back to (B, Tq, H * D) that follows attention is free
+        Tensor out_buf = new_output({B, Tq, H, D}, cpu);
+        Tensor out = Tensor::from_storage(out_buf.get_storage(), {B, H, Tq, D}, {Tq * H * D, D, H * D, 1}, 0);
+        Tensor lse = new_output({B, H, Tq}, cpu);
+
+        trace::DataRef pq(q_c), pk(k_c), pv(v_c), po(out), pl(lse);
+        kernels::cpu::AttentionStrides sq = attention_strides(q_c), sk = attention_strides(k_c), sv = attention_strides(v_c), so = attention_strides(out);
+        run_kernels("attention", {&q_c, &k_c, &v_c}, {&out, &lse}, [=] {
+            kernels::cpu::attention_forward_f32(B, H, Tq, Tk, D, scale, causal, pq.f32(), sq, pk.f32(), sk, pv.f32(), sv, po.f32(), so, pl.f32());
+        });
+
+        // a fresh handle on the (CPU) output for backward: saving `out` itself would make
+        // the result hold a reference to its own grad_fn
+        Tensor out_saved = Tensor::from_storage(out.get_storage(), out.get_shape(), out.get_stride(), out.get_offset());
+
+        if (!on_cpu) {
+            out = out.to(dev);
+        }
+
+        if ((q.requires_grad() || k.requires_grad() || v.requires_grad()) && GradMode::is_enabled()) {
+            out.set_requires_grad(true);
+            auto fn = std::make_shared<AttentionBackward>(q_c, k_c, v_c, out_saved, lse, scale, causal, dev);
+            fn -> next_edges.push_back({q.get_grad_fn(), std::make_shared<Tensor>(q)});
+            fn -> next_edges.push_back({k.get_grad_fn(), std::make_shared<Tensor>(k)});
+            fn -> next_edges.push_back({v.get_grad_fn(), std::make_shared<Tensor>(v)});
+            out.set_grad_fn(fn);
+        }
+
+        return out;
+    }
+
 }
@@ -1,106 +1,809 @@
-#include "axon/tensor.hpp"
+#include "axon/serialization.hpp"
+#include "axon/thread_pool.hpp"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <future>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <unordered_set>
 #include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace axon {
-    
-    const uint32_t MAGIC_NUMBER = 0x41584F4E;
-    void save_model(const std::vector<Tensor>& params, const std::string& filepath) {
-        std::ofstream file(filepath, std::ios::binary);
 
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open the file to save weights, file: " + filepath);
+    const uint32_t MAGIC_NUMBER = 0x41584F4E;         // "AXON", v1
+    const uint32_t MAGIC_NUMBER_ALIGNED = 0x41584F41; // "AXOA", v1 with 64-byte aligned data
+    const uint32_t MAGIC_NUMBER_V2 = 0x41584F32;      // "AXO2"
+    const uint32_t FORMAT_VERSION = 3;
+    const size_t DATA_ALIGNMENT = 64;
+
+    // unit of parallel I/O: big tensors are read/written (and checksummed) in pieces this size
+    const size_t IO_CHUNK = 4 << 20;
+
+    // u32 magic, u32 version, u32 count, u32 reserved, u64 data_start
+    const size_t V2_FIXED_HEADER = 24;
+
+    namespace {
+        size_t align_up(size_t n) {
+            return (n + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
         }
 
-        // write the header
-        file.write(reinterpret_cast<const char*>(&MAGIC_NUMBER), sizeof(MAGIC_NUMBER));
+        struct MappedFile {
+            void* addr = MAP_FAILED;
+            size_t length = 0;
+
+            ~MappedFile() {
+                if (addr != MAP_FAILED) {
+                    munmap(addr, length);
+                }
+            }
+        };
+
+        template <typename T>
+        void put(std::vector<char>& buf, T value) {
+            const char* p = reinterpret_cast<const char*>(&value);
+            buf.insert(buf.end(), p, p + sizeof(T));
+        }
 
-        // write the number of tensors
-        uint32_t num_tensors = static_cast<uint32_t>(params.size());
-        file.write(reinterpret_cast<const char*>(&num_tensors), sizeof(num_tensors));
+        // little cursor over the header bytes, every read bounds-checked
+        struct HeaderCursor {
+            const std::vector<char>& buf;
+            size_t pos;
+            const std::string& path;
 
-        // write the data
-        for (const auto& t : params) {
-            uint32_t rank = static_cast<uint32_t>(t.get_shape().size());
-            file.write(reinterpret_cast<const char*>(&rank), sizeof(rank));
+            template <typename T>
+            T get() {
+                if (pos + sizeof(T) > buf.size()) {
+                    throw std::runtime_error("Corrupt checkpoint header: " + path);
+                }
+                T value;
+                std::memcpy(&value, buf.data() + pos, sizeof(T));
+                pos += sizeof(T);
+                return value;
+            }
 
-            // Write Shape Dims
-            for (int s : t.get_shape()) {
-                uint32_t dim = static_cast<uint32_t>(s);
-                file.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+            std::string get_string(size_t len) {
+                if (pos + len > buf.size()) {
+                    throw std::runtime_error("Corrupt checkpoint header: " + path);
+                }
+                std::string s(buf.data() + pos, len);
+                pos += len;
+                return s;
             }
+        };
 
-            // Write Data
-            // We force contiguous before saving to ensure byte-stream is clean
-            Tensor t_c = t.is_contiguous() ? t : t.contiguous();
-            file.write(reinterpret_cast<const char*>(t_c.data_ptr()), t_c.numel() * sizeof(float));
+        bool pread_full(int fd, void* dst, size_t nbytes, uint64_t offset) {
+            char* p = static_cast<char*>(dst);
+            while (nbytes > 0) {
+                ssize_t got = pread(fd, p, nbytes, static_cast<off_t>(offset));
+                if (got <= 0) {
+                    if (got < 0 && errno == EINTR) continue;
+                    return false;
+                }
+                p += got;
+                nbytes -= got;
+                offset += got;
+            }
+            return true;
         }
 
-        file.close();
-        std::cout << "[Axon] Saved " << num_tensors << " tensors to " << filepath << std::endl;
-    }
+        bool pwrite_full(int fd, const void* src, size_t nbytes, uint64_t offset) {
+            const char* p = static_cast<const char*>(src);
+            while (nbytes > 0) {
+                ssize_t put = pwrite(fd, p, nbytes, static_cast<off_t>(offset));
+                if (put <= 0) {
+                    if (put < 0 && errno == EINTR) continue;
+                    return false;
+                }
+                p += put;
+                nbytes -= put;
+                offset += put;
+            }
+            return true;
+        }
 
-    void load_model(std::vector<Tensor>& params, const std::string& filepath) {
-        std::ifstream file(filepath, std::ios::binary);
-        if (!file.is_open()) {
+        // makes a rename into the directory holding `path` durable
+        bool fsync_parent_dir(const std::string& path) {
+            size_t slash = path.find_last_of('/');
+            std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+            int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+            if (fd < 0) return false;
+            bool ok = fsync(fd) == 0;
+            int err = errno;
+            close(fd);
+            errno = err;
+            return ok;
+        }
+
+        // CRC32C (Castagnoli), reflected polynomial
+        const uint32_t CRC32C_POLY = 0x82F63B78;
+
+        struct Crc32cTable {
+            uint32_t t[256];
+
+            Crc32cTable() {
+                for (uint32_t i = 0; i < 256; i++) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; k++) {
+                        c = (c >> 1) ^ (CRC32C_POLY & (0u - (c & 1)));
+                    }
+                    t[i] = c;
+                }
+            }
+        };
+
+        uint32_t crc32c_sw(uint32_t crc, const char* p, size_t n) {
+            static const Crc32cTable table;
+            for (size_t i = 0; i < n; i++) {
+                crc = table.t[(crc ^ static_cast<uint8_t>(p[i])) & 0xFF] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+        // crc1 of A, crc2 of B, len2 = |B|  ->  crc of A followed by B (zlib's crc32_combine)
+        uint32_t gf2_times(const uint32_t* mat, uint32_t vec) {
+            uint32_t sum = 0;
+            while (vec) {
+                if (vec & 1) sum ^= *mat;
+                vec >>= 1;
+                mat++;
+            }
+            return sum;
+        }
+
+        void gf2_square(uint32_t* square, const uint32_t* mat) {
+            for (int n = 0; n < 32; n++) {
+                square[n] = gf2_times(mat, mat[n]);
+            }
+        }
+
+        uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, uint64_t len2) {
+            if (len2 == 0) return crc1;
+
+            uint32_t even[32], odd[32];
+            odd[0] = CRC32C_POLY; // operator for one zero bit
+            uint32_t row = 1;
+            for (int n = 1; n < 32; n++) {
+                odd[n] = row;
+                row <<= 1;
+            }
+            gf2_square(even, odd); // two zero bits
+            gf2_square(odd, even); // four
+
+            // apply len2 zero bytes to crc1, squaring up the operator one bit of len2 at a time
+            do {
+                gf2_square(even, odd);
+                if (len2 & 1) crc1 = gf2_times(even, crc1);
+                len2 >>= 1;
+                if (len2 == 0) break;
+
+                gf2_square(odd, even);
+                if (len2 & 1) crc1 = gf2_times(odd, crc1);
+                len2 >>= 1;
+            } while (len2);
+
+            return crc1 ^ crc2;
+        }
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+        __attribute__((target("sse4.2")))
+        uint32_t crc32c_hw_stream(uint32_t crc, const char* p, size_t n) {
+            uint64_t c = crc;
+            for (; n >= 8; n -= 8, p += 8) {
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                c = __builtin_ia32_crc32di(c, v);
+            }
+            uint32_t c32 = static_cast<uint32_t>(c);
+            for (; n > 0; n--, p++) {
+                c32 = __builtin_ia32_crc32qi(c32, static_cast<uint8_t>(*p));
+            }
+            return c32;
+        }
+
+        // The crc32 instruction has a 3 cycle latency but issues every cycle, so three
+        // independent streams over thirds of the buffer, combined at the end, run ~3x faster
+        __attribute__((target("sse4.2")))
+        uint32_t crc32c_hw(const char* p, size_t n) {
+            if (n < 3 * 4096) {
+                return ~crc32c_hw_stream(~0u, p, n);
+            }
+
+            size_t lane = (n / 24) * 8;
+            const char* p1 = p + lane;
+            const char* p2 = p + 2 * lane;
+            uint64_t c0 = ~0u, c1 = ~0u, c2 = ~0u;
+            for (size_t i = 0; i < lane; i += 8) {
+                uint64_t v0, v1, v2;
+                std::memcpy(&v0, p + i, 8);
+                std::memcpy(&v1, p1 + i, 8);
+                std::memcpy(&v2, p2 + i, 8);
+                c0 = __builtin_ia32_crc32di(c0, v0);
+                c1 = __builtin_ia32_crc32di(c1, v1);
+                c2 = __builtin_ia32_crc32di(c2, v2);
+            }
+
+            uint32_t crc = crc32c_combine(~static_cast<uint32_t>(c0), ~static_cast<uint32_t>(c1), lane);
+            crc = crc32c_combine(crc, ~static_cast<uint32_t>(c2), lane);
+            size_t tail = n - 3 * lane;
+            return crc32c_combine(crc, ~crc32c_hw_stream(~0u, p + 3 * lane, tail), tail);
+        }
+#endif
+
+        uint32_t crc32c(const void* data, size_t n) {
+            const char* p = static_cast<const char*>(data);
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+            static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+            if (has_sse42) {
+                return crc32c_hw(p, n);
+            }
+#endif
+            return ~crc32c_sw(~0u, p, n);
+        }
+
+        // one IO_CHUNK-sized slice of a tensor's bytes
+        struct Piece {
+            size_t tensor;
+            uint64_t file_offset;
+            char* mem;
+            size_t nbytes;
+        };
+
+        void split_into_pieces(std::vector<Piece>& pieces, size_t tensor, uint64_t file_offset, char* mem, size_t nbytes) {
+            for (size_t off = 0; off < nbytes; off += IO_CHUNK) {
+                pieces.push_back({tensor, file_offset + off, mem ? mem + off : nullptr, std::min(IO_CHUNK, nbytes - off)});
+            }
+        }
+
+        // per-tensor checksums from per-piece ones; pieces of a tensor are consecutive and in order
+        std::vector<uint32_t> combine_pieces(const std::vector<Piece>& pieces, const std::vector<uint32_t>& piece_crcs, size_t num_tensors) {
+            std::vector<uint32_t> crcs(num_tensors, 0);
+            for (size_t k = 0; k < pieces.size(); k++) {
+                uint32_t& c = crcs[pieces[k].tensor];
+                c = crc32c_combine(c, piece_crcs[k], pieces[k].nbytes);
+            }
+            return crcs;
+        }
+
+        // contiguous CPU views of every tensor, copying only what is not one already
+        std::vector<Tensor> as_cpu_contiguous(const NamedTensors& tensors) {
+            std::vector<Tensor> out;
+            for (const auto& [name, t] : tensors) {
+                Tensor t_c = t.is_contiguous() ? t : t.contiguous();
+                if (t_c.device().type != DeviceType::CPU) {
+                    t_c = t_c.to(Device(DeviceType::CPU));
+                }
+                out.push_back(t_c);
+            }
+            return out;
+        }
+
+        // Data goes out first, in IO_CHUNK pieces at precomputed offsets (in parallel unless
+        // `parallel` is false), checksummed on the way; the header with the checksums is
+        // written last. Everything goes to `filepath`.tmp, renamed over `filepath` only once
+        // complete, so a crash mid-save never leaves a half-written checkpoint behind.
+        void write_checkpoint(const NamedTensors& tensors, const std::string& filepath, bool parallel) {
+            std::unordered_set<std::string> seen;
+            for (const auto& [name, t] : tensors) {
+                if (name.empty() || name.size() > UINT16_MAX || !seen.insert(name).second) {
+                    throw std::invalid_argument("Invalid or duplicate tensor name in checkpoint: '" + name + "'");
+                }
+            }
+
+            std::vector<Tensor> data = as_cpu_contiguous(tensors);
+
+            // the header size is known up front, which fixes every data offset
+            size_t header_bytes = V2_FIXED_HEADER;
+            for (const auto& [name, t] : tensors) {
+                header_bytes += sizeof(uint16_t) + name.size() + 2 * sizeof(uint8_t) + (t.get_shape().size() + 2) * sizeof(uint64_t) + sizeof(uint32_t);
+            }
+
+            uint64_t data_start = align_up(header_bytes);
+            uint64_t offset = data_start;
+            uint64_t file_end = data_start;
+
+            std::vector<uint64_t> offsets;
+            std::vector<Piece> pieces;
+            for (size_t i = 0; i < data.size(); i++) {
+                size_t nbytes = data[i].numel() * dtype_size(data[i].dtype());
+                offsets.push_back(offset);
+                split_into_pieces(pieces, i, offset, static_cast<char*>(data[i].raw_data_ptr()), nbytes);
+                file_end = offset + nbytes;
+                offset = align_up(offset + nbytes);
+            }
+
+            std::string tmp_path = filepath + ".tmp";
+            int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to open the file to save weights, file: " + filepath);
+            }
+
+            try {
+                std::vector<uint32_t> piece_crcs(pieces.size());
+                auto write_pieces = [&](size_t begin, size_t end) {
+                    for (size_t k = begin; k < end; k++) {
+                        const Piece& pc = pieces[k];
+                        piece_crcs[k] = crc32c(pc.mem, pc.nbytes);
+                        if (!pwrite_full(fd, pc.mem, pc.nbytes, pc.file_offset)) {
+                            throw std::runtime_error("Failed writing weights to " + filepath + ": " + std::strerror(errno));
+                        }
+                    }
+                };
+                if (parallel) {
+                    parallel_for(0, pieces.size(), 1, write_pieces);
+                } else {
+                    write_pieces(0, pieces.size());
+                }
+                std::vector<uint32_t> crcs = combine_pieces(pieces, piece_crcs, data.size());
+
+                std::vector<char> header;
+                header.reserve(data_start);
+                put<uint32_t>(header, MAGIC_NUMBER_V2);
+                put<uint32_t>(header, FORMAT_VERSION);
+                put<uint32_t>(header, static_cast<uint32_t>(tensors.size()));
+                put<uint32_t>(header, 0);
+                put<uint64_t>(header, data_start);
+
+                for (size_t i = 0; i < tensors.size(); i++) {
+                    const auto& [name, t] = tensors[i];
+                    put<uint16_t>(header, static_cast<uint16_t>(name.size()));
+                    header.insert(header.end(), name.begin(), name.end());
+                    put<uint8_t>(header, static_cast<uint8_t>(data[i].dtype()));
+                    put<uint8_t>(header, static_cast<uint8_t>(t.get_shape().size()));
+                    for (int s : t.get_shape()) {
+                        put<uint64_t>(header, static_cast<uint64_t>(s));
+                    }
+                    put<uint64_t>(header, offsets[i]);
+                    put<uint64_t>(header, data[i].numel() * dtype_size(data[i].dtype()));
+                    put<uint32_t>(header, crcs[i]);
+                }
+                header.resize(data_start, 0);
+
+                // padding between tensors is never written: the file is sparse there, which reads as zeros
+                if (!pwrite_full(fd, header.data(), header.size(), 0) || ftruncate(fd, static_cast<off_t>(file_end)) != 0) {
+                    throw std::runtime_error("Failed writing weights to " + filepath + ": " + std::strerror(errno));
+                }
+                // the data has to be on disk before the rename is: otherwise a crash can leave the
+                // new name pointing at blocks that were never written
+                if (fsync(fd) != 0) {
+                    throw std::runtime_error("Failed syncing weights to " + filepath + ": " + std::strerror(errno));
+                }
+            } catch (...) {
+                close(fd);
+                unlink(tmp_path.c_str());
+                throw;
+            }
+
+            if (close(fd) != 0 || std::rename(tmp_path.c_str(), filepath.c_str()) != 0) {
+                unlink(tmp_path.c_str());
+                throw std::runtime_error("Failed writing weights to " + filepath + ": " + std::strerror(errno));
+            }
+            // and the rename itself
+            if (!fsync_parent_dir(filepath)) {
+                throw std::runtime_error("Failed syncing the directory of " + filepath + ": " + std::strerror(errno));
+            }
+        }
+
+        // private copies, so the caller may keep training while a background save runs
+        NamedTensors snapshot(const NamedTensors& tensors) {
+            std::vector<Tensor> data = as_cpu_contiguous(tensors);
+            NamedTensors out;
+            for (size_t i = 0; i < tensors.size(); i++) {
+                Tensor copy = Tensor::empty(data[i].get_shape(), data[i].dtype());
+                std::memcpy(copy.raw_data_ptr(), data[i].raw_data_ptr(), data[i].numel() * dtype_size(data[i].dtype()));
+                out.push_back({tensors[i].first, copy});
+            }
+            return out;
+        }
+
+        // Points each parameter's Storage at its bytes in a private mapping of the file.
+        // `params` names refer to entries of `reader` (already resolved by the caller).
+        void map_into(const CheckpointReader& reader, NamedTensors& params, const std::string& filepath) {
+            // validate everything before touching any parameter: a mismatch must not leave the
+            // model half pointing into the file
+            for (auto& [name, t] : params) {
+                const TensorInfo* info = reader.find(name);
+                if (info -> numel() != t.numel()) {
+                    throw std::runtime_error("Shape mismatch loading parameter " + name);
+                }
+                if (t.device().type != DeviceType::CPU || !t.is_contiguous() || t.get_offset() != 0) {
+                    throw std::runtime_error("Cannot map into parameter " + name + ": needs a contiguous CPU tensor");
+                }
+                if ((info -> dtype == DType::Int8) != (t.dtype() == DType::Int8)) {
+                    throw std::runtime_error("Cannot map " + std::string(dtype_name(info -> dtype)) + " tensor " + name + " into a "
+                                             + dtype_name(t.dtype()) + " parameter (quantize the model to match the checkpoint)");
+                }
+            }
+
+            int fd = open(filepath.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to open file for loading: " + filepath);
+            }
+
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                throw std::runtime_error("Failed to stat file for loading: " + filepath);
+            }
+
+            auto mapping = std::make_shared<MappedFile>();
+            mapping -> length = static_cast<size_t>(st.st_size);
+            if (mapping -> length > 0) {
+                // private + writable: pages stay shared with the page cache (and every other
+                // process mapping the file) until someone writes to a parameter, which then
+                // only copies that page and never touches the file
+                mapping -> addr = mmap(nullptr, mapping -> length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            }
+            close(fd);
+
+            if (mapping -> addr == MAP_FAILED) {
+                throw std::runtime_error("Failed to map file for loading: " + filepath);
+            }
+
+            char* base = static_cast<char*>(mapping -> addr);
+            for (auto& [name, t] : params) {
+                const TensorInfo* info = reader.find(name);
+                // every Tensor sharing this storage (the module's own parameter included) now
+                // reads straight from the mapping, which stays alive as long as any of them does
+                // a bf16 / fp16 tensor in the file makes a bf16 / fp16 parameter, there is nothing to convert into
+                t.get_storage() -> rebind(base + info -> offset, info -> nbytes, mapping);
+                t.get_storage() -> dtype = info -> dtype;
+            }
+        }
+
+        // params[i] <-> i-th tensor of the file, for the positional load_model API
+        NamedTensors by_position(const CheckpointReader& reader, std::vector<Tensor>& params) {
+            const auto& entries = reader.tensors();
+            if (entries.size() != params.size()) {
+                std::cerr << "[Warning] Model has " << params.size() << " params but file contains " << entries.size() << ".\n";
+                // We continue, but this usually indicates a mismatch.
+            }
+            if (entries.size() < params.size()) {
+                throw std::runtime_error("Checkpoint has only " + std::to_string(entries.size()) + " tensors, model needs " + std::to_string(params.size()));
+            }
+
+            NamedTensors named;
+            for (size_t i = 0; i < params.size(); i++) {
+                named.push_back({entries[i].name, params[i]});
+            }
+            return named;
+        }
+
+        NamedTensors present(const CheckpointReader& reader, NamedTensors& params, bool strict) {
+            NamedTensors found;
+            for (auto& [name, t] : params) {
+                if (reader.find(name)) {
+                    found.push_back({name, t});
+                } else if (strict) {
+                    throw std::runtime_error("Checkpoint has no tensor named " + name);
+                }
+            }
+            return found;
+        }
+    } // namespace
+
+    CheckpointReader::CheckpointReader(const std::string& filepath) : fd(-1), path(filepath), format_version(0), file_size(0) {
+        fd = open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
             throw std::runtime_error("Failed to open file for loading: " + filepath);
         }
 
-        // 1. Check Magic Number
-        uint32_t magic;
-        file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-        if (magic != MAGIC_NUMBER) {
-            throw std::runtime_error("Invalid file format: Magic number mismatch.");
+        try {
+            struct stat st;
+            if (fstat(fd, &st) != 0) {
+                throw std::runtime_error("Failed to stat file for loading: " + filepath);
+            }
+            file_size = static_cast<uint64_t>(st.st_size);
+
+            uint32_t magic = 0;
+            if (!pread_full(fd, &magic, sizeof(magic), 0)) {
+                throw std::runtime_error("Truncated file: " + filepath);
+            }
+
+            if (magic == MAGIC_NUMBER || magic == MAGIC_NUMBER_ALIGNED) {
+                format_version = 1;
+                read_v1_index(magic == MAGIC_NUMBER_ALIGNED);
+            } else if (magic == MAGIC_NUMBER_V2) {
+                read_v2_index();
+            } else {
+                throw std::runtime_error("Invalid file format: Magic number mismatch.");
+            }
+        } catch (...) {
+            close(fd);
+            throw;
         }
 
-        // 2. Check Count
-        uint32_t num_tensors;
-        file.read(reinterpret_cast<char*>(&num_tensors), sizeof(num_tensors));
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (!by_name.emplace(entries[i].name, i).second) {
+                close(fd);
+                throw std::runtime_error("Duplicate tensor name " + entries[i].name + " in " + filepath);
+            }
+        }
+    }
 
-        if (num_tensors != params.size()) {
-            std::cerr << "[Warning] Model has " << params.size() << " params but file contains " << num_tensors << ".\n";
-            // We continue, but this usually indicates a mismatch.
+    CheckpointReader::~CheckpointReader() {
+        if (fd >= 0) {
+            close(fd);
         }
+    }
 
-        // 3. Read Tensors
-        for (size_t i = 0; i < params.size(); ++i) {
-            Tensor& t = params[i];
+    void CheckpointReader::read_v1_index(bool aligned) {
+        uint64_t pos = sizeof(uint32_t);
 
-            // Read Rank
-            uint32_t rank;
-            file.read(reinterpret_cast<char*>(&rank), sizeof(rank));
+        auto read_u32 = [&]() {
+            uint32_t value;
+            if (!pread_full(fd, &value, sizeof(value), pos)) {
+                throw std::runtime_error("Truncated file: " + path);
+            }
+            pos += sizeof(value);
+            return value;
+        };
+
+        uint32_t num_tensors = read_u32();
+        for (uint32_t i = 0; i < num_tensors; i++) {
+            TensorInfo info;
+            info.name = std::to_string(i);
+            info.dtype = DType::Float32;
 
-            // Read Shape
-            std::vector<int> file_shape;
-            uint32_t dim_val;
-            size_t file_numel = 1;
+            uint32_t rank = read_u32();
+            for (uint32_t r = 0; r < rank; r++) {
+                info.shape.push_back(static_cast<int>(read_u32()));
+            }
 
-            for (uint32_t r = 0; r < rank; ++r) {
-                file.read(reinterpret_cast<char*>(&dim_val), sizeof(dim_val));
-                file_shape.push_back(static_cast<int>(dim_val));
-                file_numel *= dim_val;
+            if (aligned) {
+                pos = align_up(pos);
             }
+            info.offset = pos;
+            info.nbytes = info.numel() * sizeof(float);
+            pos += info.nbytes;
 
-            // Verify Shape
-            if (file_numel != t.numel()) {
-                throw std::runtime_error("Shape mismatch loading parameter " + std::to_string(i));
+            if (pos > file_size) {
+                throw std::runtime_error("Truncated file: " + path);
             }
+            entries.push_back(std::move(info));
+        }
+    }
+
+    void CheckpointReader::read_v2_index() {
+        std::vector<char> fixed(V2_FIXED_HEADER);
+        if (!pread_full(fd, fixed.data(), fixed.size(), 0)) {
+            throw std::runtime_error("Truncated file: " + path);
+        }
+
+        HeaderCursor head{fixed, sizeof(uint32_t), path};
+        format_version = head.get<uint32_t>();
+        uint32_t num_tensors = head.get<uint32_t>();
+        head.get<uint32_t>(); // reserved
+        uint64_t data_start = head.get<uint64_t>();
+
+        if (format_version < 2 || format_version > FORMAT_VERSION) {
+            throw std::runtime_error("Unsupported checkpoint version " + std::to_string(format_version) + ": " + path);
+        }
+        if (data_start < V2_FIXED_HEADER || data_start > file_size) {
+            throw std::runtime_error("Corrupt checkpoint header: " + path);
+        }
+
+        // the whole table in one read
+        std::vector<char> table(data_start - V2_FIXED_HEADER);
+        if (!pread_full(fd, table.data(), table.size(), V2_FIXED_HEADER)) {
+            throw std::runtime_error("Truncated file: " + path);
+        }
+
+        HeaderCursor cur{table, 0, path};
+        entries.reserve(num_tensors);
+        for (uint32_t i = 0; i < num_tensors; i++) {
+            TensorInfo info;
+            info.name = cur.get_string(cur.get<uint16_t>());
+            info.dtype = static_cast<DType>(cur.get<uint8_t>());
+            uint8_t rank = cur.get<uint8_t>();
+            for (uint8_t r = 0; r < rank; r++) {
+                info.shape.push_back(static_cast<int>(cur.get<uint64_t>()));
+            }
+            info.offset = cur.get<uint64_t>();
+            info.nbytes = cur.get<uint64_t>();
+            if (format_version >= 3) {
+                info.checksum = cur.get<uint32_t>();
+                info.has_checksum = true;
+            }
+
+            if (info.nbytes != info.numel() * dtype_size(info.dtype)) {
+                throw std::runtime_error("Corrupt checkpoint header: size of " + info.name + " does not match its shape");
+            }
+            if (info.offset % DATA_ALIGNMENT != 0 || info.offset < data_start || info.offset + info.nbytes > file_size) {
+                throw std::runtime_error("Truncated file or bad offset for " + info.name + ": " + path);
+            }
+            entries.push_back(std::move(info));
+        }
+    }
+
+    const TensorInfo* CheckpointReader::find(const std::string& name) const {
+        auto it = by_name.find(name);
+        return it == by_name.end() ? nullptr : &entries[it -> second];
+    }
+
+    Tensor CheckpointReader::load(const std::string& name) const {
+        const TensorInfo* info = find(name);
+        if (!info) {
+            throw std::runtime_error("Checkpoint has no tensor named " + name);
+        }
+        Tensor t = Tensor::empty(info -> shape, info -> dtype);
+        load_into(*info, t);
+        return t;
+    }
+
+    void CheckpointReader::load_into(const std::string& name, Tensor& dst) const {
+        const TensorInfo* info = find(name);
+        if (!info) {
+            throw std::runtime_error("Checkpoint has no tensor named " + name);
+        }
+        load_into(*info, dst);
+    }
 
-            // Read Data directly into the Tensor's memory
+    void CheckpointReader::load_into(const TensorInfo& info, Tensor& dst) const {
+        NamedTensors one{{info.name, dst}};
+        read_tensors({&info}, one);
+    }
+
+    void CheckpointReader::read_tensors(const std::vector<const TensorInfo*>& infos, NamedTensors& dsts) const {
+        // validate everything before touching any data
+        for (size_t i = 0; i < infos.size(); i++) {
+            const TensorInfo& info = *infos[i];
+            Tensor& dst = dsts[i].second;
+            if (info.numel() != dst.numel()) {
+                throw std::runtime_error("Shape mismatch loading parameter " + info.name);
+            }
             // Note: We assume the target tensor is contiguous for loading.
             // If it's a parameter in a module, it usually is.
-            if (!t.is_contiguous()) {
-                // If this happens, we must load into a buffer and copy element-wise.
-                // For simplified parameters, we can assume contiguity or throw.
-                throw std::runtime_error("Cannot load into non-contiguous parameter " + std::to_string(i));
+            if (dst.device().type != DeviceType::CPU || !dst.is_contiguous()) {
+                throw std::runtime_error("Cannot load into non-contiguous parameter " + info.name);
+            }
+            // int8 values mean nothing without their scales, a value cast would be wrong
+            if (info.dtype != dst.dtype() && (info.dtype == DType::Int8 || dst.dtype() == DType::Int8)) {
+                throw std::runtime_error("Cannot load " + std::string(dtype_name(info.dtype)) + " tensor " + info.name + " into a "
+                                         + dtype_name(dst.dtype()) + " parameter (quantize the model to match the checkpoint)");
+            }
+        }
+
+        // a tensor stored in another dtype than its destination's is read into a staging
+        // tensor, then converted
+        std::vector<Tensor> targets;
+        std::vector<Piece> pieces;
+        for (size_t i = 0; i < infos.size(); i++) {
+            Tensor& dst = dsts[i].second;
+            // parameters built under nn::SkipInitGuard have no memory yet
+            dst.get_storage() -> materialize();
+            targets.push_back(infos[i] -> dtype == dst.dtype() ? dst : Tensor::empty(infos[i] -> shape, infos[i] -> dtype));
+            split_into_pieces(pieces, i, infos[i] -> offset, static_cast<char*>(targets[i].raw_data_ptr()), infos[i] -> nbytes);
+        }
+
+        // pieces rather than whole tensors, so one huge embedding does not serialize the load
+        std::vector<uint32_t> piece_crcs(pieces.size());
+        parallel_for(0, pieces.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; k++) {
+                const Piece& pc = pieces[k];
+                if (!pread_full(fd, pc.mem, pc.nbytes, pc.file_offset)) {
+                    throw std::runtime_error("Failed reading " + infos[pc.tensor] -> name + " from " + path);
+                }
+                if (infos[pc.tensor] -> has_checksum) {
+                    piece_crcs[k] = crc32c(pc.mem, pc.nbytes);
+                }
+            }
+        });
+
+        std::vector<uint32_t> crcs = combine_pieces(pieces, piece_crcs, infos.size());
+        for (size_t i = 0; i < infos.size(); i++) {
+            if (infos[i] -> has_checksum && crcs[i] != infos[i] -> checksum) {
+                throw std::runtime_error("Checksum mismatch for tensor " + infos[i] -> name + " in " + path);
+            }
+        }
+
+        for (size_t i = 0; i < infos.size(); i++) {
+            Tensor& dst = dsts[i].second;
+            if (targets[i].dtype() != dst.dtype()) {
+                Tensor converted = targets[i].to(dst.dtype());
+                std::memcpy(dst.raw_data_ptr(), converted.raw_data_ptr(), dst.numel() * dtype_size(dst.dtype()));
+            }
+        }
+    }
+
+    size_t CheckpointReader::load_named(NamedTensors& params, bool strict) const {
+        NamedTensors found = present(*this, params, strict);
+
+        std::vector<const TensorInfo*> infos;
+        for (auto& [name, t] : found) {
+            infos.push_back(find(name));
+        }
+        read_tensors(infos, found);
+        return found.size();
+    }
+
+    void CheckpointReader::verify() const {
+        std::vector<Piece> pieces;
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].has_checksum) {
+                split_into_pieces(pieces, i, entries[i].offset, nullptr, entries[i].nbytes);
+            }
+        }
+
+        std::vector<uint32_t> piece_crcs(pieces.size());
+        parallel_for(0, pieces.size(), 1, [&](size_t begin, size_t end) {
+            std::vector<char> scratch(IO_CHUNK);
+            for (size_t k = begin; k < end; k++) {
+                const Piece& pc = pieces[k];
+                if (!pread_full(fd, scratch.data(), pc.nbytes, pc.file_offset)) {
+                    throw std::runtime_error("Failed reading " + entries[pc.tensor].name + " from " + path);
+                }
+                piece_crcs[k] = crc32c(scratch.data(), pc.nbytes);
+            }
+        });
+
+        // tensors without a checksum contribute no pieces and stay 0 here
+        std::vector<uint32_t> crcs = combine_pieces(pieces, piece_crcs, entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].has_checksum && crcs[i] != entries[i].checksum) {
+                throw std::runtime_error("Checksum mismatch for tensor " + entries[i].name + " in " + path);
             }
-            
-            file.read(reinterpret_cast<char*>(t.data_ptr()), file_numel * sizeof(float));
         }
+    }
+
+    void save_model(const std::vector<Tensor>& params, const std::string& filepath) {
+        NamedTensors named;
+        for (size_t i = 0; i < params.size(); i++) {
+            named.push_back({std::to_string(i), params[i]});
+        }
+        write_checkpoint(named, filepath, true);
+        std::cout << "[Axon] Saved " << params.size() << " tensors to " << filepath << std::endl;
+    }
 
-        file.close();
+    void save_checkpoint(const NamedTensors& tensors, const std::string& filepath) {
+        write_checkpoint(tensors, filepath, true);
+    }
+
+    std::future<void> save_model_async(const std::vector<Tensor>& params, const std::string& filepath) {
+        NamedTensors named;
+        for (size_t i = 0; i < params.size(); i++) {
+            named.push_back({std::to_string(i), params[i]});
+        }
+        return save_checkpoint_async(named, filepath);
+    }
+
+    std::future<void> save_checkpoint_async(const NamedTensors& tensors, const std::string& filepath) {
+        NamedTensors copy = snapshot(tensors);
+        // The writer stays off the kernel pool: a thread calling parallel_for helps with any
+        // queued chunk, so pool-based I/O chunks could end up stalling the training thread
+        return std::async(std::launch::async, [copy = std::move(copy), filepath]() {
+            write_checkpoint(copy, filepath, false);
+        });
+    }
+
+    void load_model(std::vector<Tensor>& params, const std::string& filepath) {
+        CheckpointReader reader(filepath);
+        NamedTensors named = by_position(reader, params);
+        reader.load_named(named);
         std::cout << "[Axon] Loaded weights from " << filepath << "\n";
     }
-} // namespace axon
\ No newline at end of file
+
+    void load_model_mmap(std::vector<Tensor>& params, const std::string& filepath) {
+        CheckpointReader reader(filepath);
+        NamedTensors named = by_position(reader, params);
+        map_into(reader, named, filepath);
+        std::cout << "[Axon] Mapped weights from " << filepath << "\n";
+    }
+
+    void load_checkpoint(NamedTensors& params, const std::string& filepath, bool strict) {
+        CheckpointReader reader(filepath);
+        reader.load_named(params, strict);
+    }
+
+    void load_checkpoint_mmap(NamedTensors& params, const std::string& filepath, bool strict) {
+        CheckpointReader reader(filepath);
+        NamedTensors found = present(reader, params, strict);
+        map_into(reader, found, filepath);
+    }
+} // namespace axon
@@ -3,6 +3,7 @@
 #include "axon/autograd.hpp"
 #include "axon/grad_mode.hpp"
 #include "axon/ops.hpp"
+#include "axon/compile.hpp"
 #include <iostream>
 #include <numeric>
 #include <algorithm>
@@ -13,11 +14,16 @@
 
 namespace axon {
 
-    Tensor::Tensor(std::vector<int> shape, Device dev) 
+    Tensor::Tensor(std::vector<int> shape, Device dev, DType dtype) 
         : shape(shape), offset(0) {
         calculate_strides();
-        storage = std::make_shared<Storage>(size * sizeof(float), dev);
-        state = std::make_shared<TensorState>();
+        storage = std::make_shared<Storage>(size * dtype_size(dtype), dev);
+        storage -> dtype = dtype;
+        // created with the tensor, so every copy of this handle shares it; inference tensors
+        // never get one (see autograd_state)
+        if (!InferenceMode::is_enabled()) {
+            state = std::make_shared<TensorState>();
+        }
     }
 
     Tensor Tensor::from_storage(
@@ -25,20 +31,27 @@ namespace axon {
         std::vector<int> shape, std::vector<int> stride, 
         int offset) {
         
-        Tensor t({1}); 
+        Tensor t;
         
-        t.storage = storage;
-        t.shape = shape;
-        t.stride = stride;
+        t.storage = std::move(storage);
+        t.shape = std::move(shape);
+        t.stride = std::move(stride);
         t.offset = offset;
-        t.state = std::make_shared<TensorState>();
+        if (!InferenceMode::is_enabled()) {
+            t.state = std::make_shared<TensorState>();
+        }
         
         t.size = 1;
-        for(int s : shape) t.size *= s;
+        for(int s : t.shape) t.size *= s;
         
         return t;
     }
 
+    void Tensor::no_autograd_state() {
+        throw std::runtime_error("[AUTOGRAD] Error: Tensor was created under InferenceMode and can't take part in autograd "
+                                 "(create it outside the guard, or copy it there with contiguous())");
+    }
+
     void Tensor::calculate_strides() {
         stride.resize(shape.size());
         size_t running_size = 1;
@@ -53,6 +66,14 @@ namespace axon {
         this -> size = running_size;
     }
 
+    Tensor Tensor::empty(std::vector<int> shape, Device dev) {
+        return Tensor(std::move(shape), dev);
+    }
+
+    Tensor Tensor::empty(std::vector<int> shape, DType dtype, Device dev) {
+        return Tensor(std::move(shape), dev, dtype);
+    }
+
     Tensor Tensor::zeros(std::vector<int> shape, Device dev) {
         Tensor t(shape, dev);
         if (t.size > 0 && t.device().type == DeviceType::CPU) {
@@ -85,10 +106,14 @@ namespace axon {
     }
 
     float& Tensor::at(const std::vector<int>& indices) {
+        if (dtype() != DType::Float32) {
+            throw std::invalid_argument("[AT] Error: at() needs a float32 tensor, got " + std::string(dtype_name(dtype())));
+        }
         if (indices.size() != shape.size()) {
             throw std::invalid_argument("[AT]: Dim mismatch");
         }
 
+        sync_pending();
         int flat = offset;
         for (size_t i = 0; i < indices.size(); i++) {
             flat += stride[i] * indices[i];
@@ -134,7 +159,13 @@ namespace axon {
         for(auto s : stride) std::cout << s << ",";
         std::cout << "}\n";
 
-        if (numel() > 0) {
+        if (numel() > 0 && dtype() != DType::Float32) {
+            std::cout << "dtype=" << dtype_name(dtype()) << "\n";
+            Tensor wide = to(DType::Float32);
+            std::vector<int> indices;
+            print_recursive(wide, 0, 0, indices);
+            std::cout << "\n";
+        } else if (numel() > 0) {
             std::vector<int> indices;
             print_recursive(*this, 0, 0, indices); 
             std::cout << "\n";
@@ -179,36 +210,62 @@ namespace axon {
         return Tensor::from_storage(storage, target_shape, new_strides, offset);
     }
 
+    template <typename T>
     void copy_recursive(
-        int dim, const Tensor& src, int src_offset,
-        float* dst_ptr, int& dst_index) {
+        int dim, const Tensor& src, const T* src_ptr, int src_offset,
+        T* dst_ptr, int& dst_index) {
         int dim_len = src.get_shape()[dim];
         int dim_stride = src.get_stride()[dim];
 
         if (dim == src.get_shape().size() - 1) {
             // Base Case
             for (int i = 0; i < dim_len; i++) {
-                dst_ptr[dst_index++] = src.data_ptr()[src_offset + i * dim_stride];
+                dst_ptr[dst_index++] = src_ptr[src_offset + i * dim_stride];
             }
         } else {
             for (int i = 0; i < dim_len; i++) {
-                copy_recursive(dim + 1, src, src_offset + i * dim_stride, dst_ptr, dst_index);
+                copy_recursive(dim + 1, src, src_ptr, src_offset + i * dim_stride, dst_ptr, dst_index);
             }
         }
     }
 
     Tensor Tensor::contiguous() const {
+        // under compile() the copy is recorded for replay instead (see compile.hpp)
+        bool tracing = trace::is_active();
         if (is_contiguous()) {
             // Deep copy
-            Tensor out = Tensor::zeros(shape); // Allocates new storage
-            if (device().type == DeviceType::CPU) {
-                std::memcpy(out.data_ptr(), this->data_ptr(), size * sizeof(float));
-            } 
+            if (device().type != DeviceType::CPU) {
+                return Tensor::zeros(shape);
+            }
+            Tensor out = tracing ? trace::output(shape, dtype()) : Tensor::empty(shape, dtype()); // Allocates new storage
+            trace::DataRef src(*this), dst(out);
+            size_t nbytes = size * dtype_size(dtype());
+            auto copy = [=] { std::memcpy(dst.as<char>(), src.as<const char>(), nbytes); };
+            if (tracing) {
+                trace::record("contiguous", {this}, {&out}, copy);
+            } else {
+                copy();
+            }
             return out;
         } else {
-            Tensor out = Tensor::zeros(shape);
-            int dst_index = 0;
-            copy_recursive(0, *this, 0, out.data_ptr(), dst_index);
+            Tensor out = tracing ? trace::output(shape, dtype()) : Tensor::empty(shape, dtype());
+            trace::DataRef src(*this), dst(out);
+            size_t width = dtype_size(dtype());
+            auto copy = [view = *this, src, dst, width] {
+                int dst_index = 0;
+                // only the element width matters for a copy
+                switch (width) {
+                    case 1: copy_recursive(0, view, src.as<const uint8_t>(), 0, dst.as<uint8_t>(), dst_index); break;
+                    case 2: copy_recursive(0, view, src.as<const uint16_t>(), 0, dst.as<uint16_t>(), dst_index); break;
+                    case 4: copy_recursive(0, view, src.as<const uint32_t>(), 0, dst.as<uint32_t>(), dst_index); break;
+                    default: copy_recursive(0, view, src.as<const uint64_t>(), 0, dst.as<uint64_t>(), dst_index); break;
+                }
+            };
+            if (tracing) {
+                trace::record("contiguous", {this}, {&out}, copy);
+            } else {
+                copy();
+            }
             return out;
         }
     }
@@ -219,17 +276,18 @@ namespace axon {
         // Ensure contiguous 
         Tensor src = this -> is_contiguous() ? *this : this -> contiguous();
         // Allocate memory on target device
-        Tensor dst = Tensor::zeros(src.get_shape(), target_device);
+        Tensor dst = Tensor::empty(src.get_shape(), dtype(), target_device);
+        size_t nbytes = src.numel() * dtype_size(dtype());
 
         // Copy the data
 
         // 1. CPU -> GPU
         if (src.device().type == DeviceType::CPU && target_device.type == DeviceType::CUDA) {
-            cudaMemcpy(dst.data_ptr(), src.data_ptr(), src.numel() * sizeof(float), axon::MemcpyHostToDevice);
+            cudaMemcpy(dst.raw_data_ptr(), src.raw_data_ptr(), nbytes, axon::MemcpyHostToDevice);
         }
         // 2. GPU -> CPU
         else if (src.device().type == DeviceType::CUDA && target_device.type == DeviceType::CPU) {
-            cudaMemcpy(dst.data_ptr(), src.data_ptr(), src.numel() * sizeof(float), axon::MemcpyDeviceToHost);
+            cudaMemcpy(dst.raw_data_ptr(), src.raw_data_ptr(), nbytes, axon::MemcpyDeviceToHost);
         }
 
         else {
@@ -239,6 +297,67 @@ namespace axon {
         return dst;
     }
 
+    // index dtypes: plain element-wise casts (float -> int truncates)
+    template <typename S, typename D>
+    void cast_values(size_t n, const S* src, D* dst) {
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = static_cast<D>(src[i]);
+        }
+    }
+
+    Tensor Tensor::to(DType target) const {
+        if (dtype() == target) return *this;
+        if (device().type != DeviceType::CPU) {
+            throw std::runtime_error("[TO] Error: dtype conversion is only implemented on CPU");
+        }
+
+        Tensor src = is_contiguous() ? *this : contiguous();
+        Tensor dst = Tensor::empty(shape, target);
+
+        // int32 <-> int64 directly, float32 would lose ids above 2^24
+        if (src.dtype() == DType::Int32 && target == DType::Int64) {
+            cast_values(size, src.data_as<int32_t>(), dst.data_as<int64_t>());
+            return dst;
+        }
+        if (src.dtype() == DType::Int64 && target == DType::Int32) {
+            cast_values(size, src.data_as<int64_t>(), dst.data_as<int32_t>());
+            return dst;
+        }
+
+        // anything else not float32 on either side goes through float32
+        Tensor wide = src;
+        if (src.dtype() == DType::Int32 || src.dtype() == DType::Int64) {
+            wide = target == DType::Float32 ? dst : Tensor::empty(shape);
+            if (src.dtype() == DType::Int32) {
+                cast_values(size, src.data_as<int32_t>(), wide.data_ptr());
+            } else {
+                cast_values(size, src.data_as<int64_t>(), wide.data_ptr());
+            }
+        } else if (src.dtype() == DType::Int8) {
+            wide = target == DType::Float32 ? dst : Tensor::empty(shape);
+            kernels::cpu::cast_i8_to_f32(size, static_cast<const int8_t*>(src.raw_data_ptr()), wide.data_ptr());
+        } else if (src.dtype() == DType::Float16) {
+            wide = target == DType::Float32 ? dst : Tensor::empty(shape);
+            kernels::cpu::cast_f16_to_f32(size, static_cast<const uint16_t*>(src.raw_data_ptr()), wide.data_ptr());
+        } else if (src.dtype() == DType::BFloat16) {
+            wide = target == DType::Float32 ? dst : Tensor::empty(shape);
+            kernels::cpu::cast_bf16_to_f32(size, static_cast<const uint16_t*>(src.raw_data_ptr()), wide.data_ptr());
+        }
+
+        if (target == DType::Float16) {
+            kernels::cpu::cast_f32_to_f16(size, wide.data_ptr(), static_cast<uint16_t*>(dst.raw_data_ptr()));
+        } else if (target == DType::BFloat16) {
+            kernels::cpu::cast_f32_to_bf16(size, wide.data_ptr(), static_cast<uint16_t*>(dst.raw_data_ptr()));
+        } else if (target == DType::Int8) {
+            kernels::cpu::cast_f32_to_i8(size, wide.data_ptr(), static_cast<int8_t*>(dst.raw_data_ptr()));
+        } else if (target == DType::Int32) {
+            cast_values(size, wide.data_ptr(), dst.data_as<int32_t>());
+        } else if (target == DType::Int64) {
+            cast_values(size, wide.data_ptr(), dst.data_as<int64_t>());
+        }
+        return dst;
+    }
+
     void Tensor::zero_grad() {
         set_grad(nullptr);
     }
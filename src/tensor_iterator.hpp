@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace axon {
+
+    // Walks N operands of one shape, each given by its strides (0 along a broadcast dim), without
+    // recursion or per-element dispatch. Size-1 dims are dropped and neighbouring dims merged
+    // wherever every operand steps through them evenly, so e.g. a (B, T, C) + (C) bias add becomes
+    // B*T rows of C, and x * scalar one row of x.numel(). The innermost of what remains is handed
+    // to the loop body a row (or part of one) at a time, with the operands' strides along it:
+    //
+    //   TensorIterator<3> it(out.get_shape(), {&out.get_stride(), &a.get_stride(), &b.get_stride()});
+    //   it.for_each_piece(0, it.numel(), [&](const std::array<ptrdiff_t, 3>& off, size_t n) {
+    //       // elements off[k], off[k] + inner_stride(k), ... of operand k, n of them
+    //   });
+    //
+    // for_each_piece takes any sub-range of [0, numel()), so a parallel_for can split the work.
+    template <size_t N>
+    class TensorIterator {
+    public:
+        using Offsets = std::array<ptrdiff_t, N>;
+
+        TensorIterator(const std::vector<int>& shape, const std::array<const std::vector<int>*, N>& strides) {
+            // innermost first while coalescing
+            for (size_t d = shape.size(); d-- > 0;) {
+                if (shape[d] == 1) continue;
+                total *= shape[d];
+
+                Offsets st;
+                for (size_t k = 0; k < N; k++) st[k] = (*strides[k])[d];
+
+                bool merge = !sizes.empty();
+                for (size_t k = 0; k < N && merge; k++) {
+                    merge = st[k] == dim_strides.back()[k] * static_cast<ptrdiff_t>(sizes.back());
+                }
+
+                if (merge) {
+                    sizes.back() *= shape[d];
+                } else {
+                    sizes.push_back(shape[d]);
+                    dim_strides.push_back(st);
+                }
+            }
+            if (sizes.empty()) {
+                sizes.push_back(1);
+                dim_strides.push_back(Offsets{});
+            }
+        }
+
+        size_t numel() const { return total; }
+        // length of the innermost loop, and each operand's stride along it
+        size_t inner_size() const { return sizes[0]; }
+        ptrdiff_t inner_stride(size_t k) const { return dim_strides[0][k]; }
+        // dims left after coalescing
+        size_t ndim() const { return sizes.size(); }
+
+        // fn(offsets, n) for the elements [begin, end) in row-major order, one call per piece of a row
+        template <typename Fn>
+        void for_each_piece(size_t begin, size_t end, Fn&& fn) const {
+            if (begin >= end) return;
+
+            // odometer over the outer dims, started at begin's row
+            size_t inner = sizes[0];
+            std::vector<size_t> idx(sizes.size(), 0);
+            Offsets base{};
+            size_t row = begin / inner;
+            for (size_t d = 1; d < sizes.size(); d++) {
+                idx[d] = row % sizes[d];
+                row /= sizes[d];
+                for (size_t k = 0; k < N; k++) base[k] += static_cast<ptrdiff_t>(idx[d]) * dim_strides[d][k];
+            }
+
+            size_t pos = begin % inner;
+            while (begin < end) {
+                size_t n = std::min(inner - pos, end - begin);
+                Offsets off = base;
+                for (size_t k = 0; k < N; k++) off[k] += static_cast<ptrdiff_t>(pos) * dim_strides[0][k];
+                fn(off, n);
+
+                begin += n;
+                pos = 0;
+                for (size_t d = 1; d < sizes.size(); d++) {
+                    for (size_t k = 0; k < N; k++) base[k] += dim_strides[d][k];
+                    if (++idx[d] < sizes[d]) break;
+                    for (size_t k = 0; k < N; k++) base[k] -= static_cast<ptrdiff_t>(sizes[d]) * dim_strides[d][k];
+                    idx[d] = 0;
+                }
+            }
+        }
+
+    private:
+        // coalesced dims, innermost first
+        std::vector<size_t> sizes;
+        std::vector<Offsets> dim_strides;
+        size_t total = 1;
+    };
+
+} // namespace axon
@@ -0,0 +1,232 @@
+#include "axon/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace axon {
+
+    namespace {
+        thread_local bool tl_in_parallel = false;
+
+        // cap on chunks per worker: enough slack for stealing to balance uneven chunks
+        constexpr size_t CHUNKS_PER_THREAD = 4;
+
+        size_t default_num_threads() {
+            if (const char* env = std::getenv("AXON_NUM_THREADS")) {
+                try {
+                    long n = std::stol(env);
+                    if (n > 0) {
+                        return static_cast<size_t>(n);
+                    }
+                } catch (...) {}
+                std::cerr << "[THREADPOOL] Warning: ignoring invalid AXON_NUM_THREADS=" << env << "\n";
+            }
+            size_t hw = std::thread::hardware_concurrency();
+            return hw > 0 ? hw : 1;
+        }
+
+        std::mutex g_pool_mutex;
+        std::unique_ptr<ThreadPool> g_pool;
+        std::atomic<ThreadPool*> g_pool_ptr{nullptr};
+    }
+
+    struct ThreadPool::Job {
+        const RangeFn* fn;
+        std::atomic<size_t> remaining{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    struct ThreadPool::Task {
+        Job* job;
+        size_t begin;
+        size_t end;
+    };
+
+    struct ThreadPool::WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct ThreadPool::Shared {
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+        std::atomic<size_t> pending{0};
+        bool stop = false;
+
+        bool pop_front(size_t id, Task& out) {
+            WorkerQueue& q = *queues[id];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) return false;
+            out = q.tasks.front();
+            q.tasks.pop_front();
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool steal(size_t thief, Task& out) {
+            size_t n = queues.size();
+            for (size_t i = 1; i <= n; i++) {
+                WorkerQueue& q = *queues[(thief + i) % n];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if (q.tasks.empty()) continue;
+                out = q.tasks.back();
+                q.tasks.pop_back();
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        static void run(const Task& t) {
+            bool prev = tl_in_parallel;
+            tl_in_parallel = true;
+            try {
+                (*t.job -> fn)(t.begin, t.end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(t.job -> error_mutex);
+                if (!t.job -> error) {
+                    t.job -> error = std::current_exception();
+                }
+            }
+            tl_in_parallel = prev;
+            t.job -> remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    };
+
+    ThreadPool::ThreadPool(size_t num_threads) : shared(std::make_shared<Shared>()) {
+        size_t n_workers = num_threads > 1 ? num_threads - 1 : 0;
+
+        for (size_t i = 0; i < n_workers; i++) {
+            shared -> queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < n_workers; i++) {
+            workers.emplace_back(worker_loop, shared, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(shared -> sleep_mutex);
+            shared -> stop = true;
+        }
+        shared -> wake.notify_all();
+
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    void ThreadPool::worker_loop(std::shared_ptr<Shared> shared, size_t id) {
+        while (true) {
+            Task t;
+            if (shared -> pop_front(id, t) || shared -> steal(id, t)) {
+                Shared::run(t);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(shared -> sleep_mutex);
+            shared -> wake.wait(lock, [&] {
+                return shared -> stop || shared -> pending.load(std::memory_order_relaxed) > 0;
+            });
+
+            if (shared -> stop && shared -> pending.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+        }
+    }
+
+    void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, const RangeFn& fn) {
+        if (begin >= end) return;
+
+        size_t n = end - begin;
+        grain = grain > 0 ? grain : 1;
+
+        if (workers.empty() || tl_in_parallel || n <= grain) {
+            fn(begin, end);
+            return;
+        }
+
+        size_t max_chunks = num_threads() * CHUNKS_PER_THREAD;
+        size_t chunk = std::max(grain, (n + max_chunks - 1) / max_chunks);
+        size_t num_chunks = (n + chunk - 1) / chunk;
+
+        Job job;
+        job.fn = &fn;
+        job.remaining.store(num_chunks, std::memory_order_relaxed);
+
+        size_t n_queues = shared -> queues.size();
+        for (size_t c = 0; c < num_chunks; c++) {
+            size_t b = begin + c * chunk;
+            size_t e = std::min(end, b + chunk);
+
+            WorkerQueue& q = *shared -> queues[c % n_queues];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back({&job, b, e});
+            shared -> pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        {
+            // pairs with the predicate check in worker_loop so no wake-up is lost
+            std::lock_guard<std::mutex> lock(shared -> sleep_mutex);
+        }
+        shared -> wake.notify_all();
+
+        // the caller works too, then spins until stolen chunks finish elsewhere
+        size_t start = 0;
+        while (job.remaining.load(std::memory_order_acquire) > 0) {
+            Task t;
+            if (shared -> steal(start++ % n_queues, t)) {
+                Shared::run(t);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    ThreadPool& ThreadPool::global() {
+        ThreadPool* pool = g_pool_ptr.load(std::memory_order_acquire);
+        if (pool) return *pool;
+
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        if (!g_pool) {
+            g_pool = std::make_unique<ThreadPool>(default_num_threads());
+            g_pool_ptr.store(g_pool.get(), std::memory_order_release);
+        }
+        return *g_pool;
+    }
+
+    bool ThreadPool::in_parallel_region() {
+        return tl_in_parallel;
+    }
+
+    void set_num_threads(size_t n) {
+        if (n == 0) {
+            throw std::invalid_argument("[THREADPOOL] Error: thread count must be >= 1");
+        }
+
+        std::lock_guard<std::mutex> lock(g_pool_mutex);
+        g_pool_ptr.store(nullptr, std::memory_order_release);
+        g_pool.reset();
+        g_pool = std::make_unique<ThreadPool>(n);
+        g_pool_ptr.store(g_pool.get(), std::memory_order_release);
+    }
+
+    size_t get_num_threads() {
+        return ThreadPool::global().num_threads();
+    }
+
+} // namespace axon